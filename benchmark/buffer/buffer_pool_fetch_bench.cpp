@@ -0,0 +1,73 @@
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+
+/**
+ * FetchPage/UnpinPage throughput of a single buffer pool and of a sharded one, from 1 to 32 threads.
+ * All pages fit in the buffer pool, so the benchmark measures the cost of the latches rather than I/O.
+ *
+ * Usage: buffer_pool_fetch_bench [ops_per_thread] [num_instances] [page_nums]
+ */
+static double RunThreads(BufferPoolManager *bpm, const std::vector<page_id_t> &page_ids, int num_threads,
+                         long ops_per_thread) {
+  std::vector<std::thread> threads;
+  BenchmarkTimer timer;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 rng(t);
+      for (long i = 0; i < ops_per_thread; i++) {
+        page_id_t page_id = page_ids[rng() % page_ids.size()];
+        if (bpm->FetchPage(page_id) != nullptr) {
+          bpm->UnpinPage(page_id, false);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return timer.Elapsed();
+}
+
+int main(int argc, char **argv) {
+  const long ops_per_thread = BenchmarkArg(argc, argv, 1, 200000);
+  const long num_instances = BenchmarkArg(argc, argv, 2, 16);
+  const long page_nums = BenchmarkArg(argc, argv, 3, 1024);
+  const std::string db_name = "buffer_pool_fetch_bench.db";
+  remove(db_name.c_str());
+  DiskManager disk_manager(db_name);
+  // pool sizes leave room for every page in every instance
+  std::unique_ptr<BufferPoolManager> single(new BufferPoolManagerInstance(2 * page_nums, &disk_manager));
+  std::unique_ptr<BufferPoolManager> parallel(
+          new ParallelBufferPoolManager(num_instances, 2 * page_nums / num_instances + 1, &disk_manager));
+  std::vector<page_id_t> page_ids;
+  for (long i = 0; i < page_nums; i++) {
+    page_id_t page_id;
+    if (single->NewPage(page_id) == nullptr) {
+      fprintf(stderr, "failed to allocate page %ld\n", i);
+      return 1;
+    }
+    single->UnpinPage(page_id, true);
+    page_ids.push_back(page_id);
+  }
+  single->FlushAllPages();
+
+  printf("%ld pages, %ld fetches per thread, %ld instances\n", page_nums, ops_per_thread, num_instances);
+  printf("%8s %20s %20s\n", "threads", "single(Mops/s)", "parallel(Mops/s)");
+  for (int num_threads = 1; num_threads <= 32; num_threads *= 2) {
+    double total_ops = static_cast<double>(num_threads) * ops_per_thread;
+    double single_elapsed = RunThreads(single.get(), page_ids, num_threads, ops_per_thread);
+    double parallel_elapsed = RunThreads(parallel.get(), page_ids, num_threads, ops_per_thread);
+    printf("%8d %20.3f %20.3f\n", num_threads, total_ops / single_elapsed / 1e6,
+           total_ops / parallel_elapsed / 1e6);
+  }
+  parallel.reset();
+  single.reset();
+  disk_manager.Close();
+  remove(db_name.c_str());
+  return 0;
+}
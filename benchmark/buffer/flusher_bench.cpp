@@ -0,0 +1,71 @@
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "buffer/buffer_pool_manager_instance.h"
+
+/**
+ * Random page updates on a working set larger than the buffer pool, with and without the background
+ * flusher. Every fetch of a page which is not resident evicts a victim; the benchmark reports how many
+ * victims had to be written back on the eviction path and how many pages the flusher wrote ahead.
+ *
+ * Usage: flusher_bench [ops] [page_nums] [pool_size] [update_percent]
+ */
+static void Run(const char *name, BufferPoolManager *bpm, const std::vector<page_id_t> &page_ids, long ops,
+                long update_percent) {
+  std::mt19937 rng(2022);
+  size_t foreground = bpm->GetForegroundWriteCount(), background = bpm->GetBackgroundWriteCount();
+  BenchmarkTimer timer;
+  for (long i = 0; i < ops; i++) {
+    page_id_t page_id = page_ids[rng() % page_ids.size()];
+    Page *page = bpm->FetchPage(page_id);
+    if (page == nullptr) {
+      fprintf(stderr, "failed to fetch page %d\n", page_id);
+      return;
+    }
+    bool is_dirty = static_cast<long>(rng() % 100) < update_percent;
+    if (is_dirty) {
+      page->GetData()[i % PAGE_SIZE]++;
+    }
+    bpm->UnpinPage(page_id, is_dirty);
+  }
+  double elapsed = timer.Elapsed();
+  printf("%-10s %14.0f %18zu %18zu\n", name, ops / elapsed, bpm->GetForegroundWriteCount() - foreground,
+         bpm->GetBackgroundWriteCount() - background);
+}
+
+int main(int argc, char **argv) {
+  const long ops = BenchmarkArg(argc, argv, 1, 200000);
+  const long page_nums = BenchmarkArg(argc, argv, 2, 4096);
+  const long pool_size = BenchmarkArg(argc, argv, 3, 1024);
+  const long update_percent = BenchmarkArg(argc, argv, 4, 30);
+  const std::string db_name = "flusher_bench.db";
+
+  printf("%ld operations, %ld pages, %ld frames, %ld%% updates\n", ops, page_nums, pool_size, update_percent);
+  printf("%-10s %14s %18s %18s\n", "flusher", "ops/s", "foreground writes", "background writes");
+  for (bool flusher : {false, true}) {
+    remove(db_name.c_str());
+    DiskManager disk_manager(db_name);
+    std::unique_ptr<BufferPoolManager> bpm(new BufferPoolManagerInstance(pool_size, &disk_manager));
+    std::vector<page_id_t> page_ids;
+    for (long i = 0; i < page_nums; i++) {
+      page_id_t page_id;
+      if (bpm->NewPage(page_id) == nullptr) {
+        fprintf(stderr, "failed to allocate page %ld\n", i);
+        return 1;
+      }
+      bpm->UnpinPage(page_id, true);
+      page_ids.push_back(page_id);
+    }
+    bpm->FlushAllPages();
+    if (flusher) {
+      bpm->StartFlusher();
+    }
+    Run(flusher ? "on" : "off", bpm.get(), page_ids, ops, update_percent);
+    bpm.reset();
+    disk_manager.Close();
+  }
+  remove(db_name.c_str());
+  return 0;
+}
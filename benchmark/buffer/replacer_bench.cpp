@@ -0,0 +1,108 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "index/b_plus_tree_index.h"
+#include "index/generic_key.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+using BP_TREE_INDEX = BPlusTreeIndex<GenericKey<8>, RowId, GenericComparator<8>>;
+
+struct PhaseStats {
+  size_t hits{0};
+  size_t misses{0};
+  double elapsed{0};
+
+  double HitRatio() const { return hits + misses == 0 ? 0 : static_cast<double>(hits) / (hits + misses); }
+};
+
+/**
+ * Mixed workload of point lookups on a small hot set of rows through a B+ tree index, interleaved with
+ * full table scans, run once for every replacement policy. The scans are larger than the buffer pool,
+ * so a policy which is not scan resistant loses the hot pages after every scan.
+ *
+ * Usage: replacer_bench [row_nums] [hot_rows] [lookups_per_round] [rounds] [pool_size]
+ */
+int main(int argc, char **argv) {
+  const long row_nums = BenchmarkArg(argc, argv, 1, 50000);
+  const long hot_rows = BenchmarkArg(argc, argv, 2, 3000);
+  const long lookups_per_round = BenchmarkArg(argc, argv, 3, 500);
+  const long rounds = BenchmarkArg(argc, argv, 4, 20);
+  const long pool_size = BenchmarkArg(argc, argv, 5, 256);
+  const std::vector<std::pair<std::string, ReplacerType>> policies = {
+          {"LRU", ReplacerType::kLRU},
+          {"CLOCK", ReplacerType::kClock},
+          {"LRU-K", ReplacerType::kLRUK},
+          {"2Q", ReplacerType::k2Q}
+  };
+
+  printf("%ld rows, %ld hot rows, %ld lookups and 1 scan per round, %ld rounds, %ld frames\n", row_nums, hot_rows,
+         lookups_per_round, rounds, pool_size);
+  printf("%-8s %14s %16s %14s %12s %12s\n", "policy", "lookup hit", "lookups/s", "scan hit", "scan(s)",
+         "total(s)");
+  for (auto &policy : policies) {
+    DBStorageEngine engine("replacer_bench.db", true, pool_size, 1, policy.second);
+    SimpleMemHeap heap;
+    std::vector<Column *> columns = {
+            ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+            ALLOC_COLUMN(heap)("payload", TypeId::kTypeChar, 100, 1, false, false)
+    };
+    Schema schema(columns);
+    std::vector<uint32_t> key_map{0};
+    auto *key_schema = Schema::ShallowCopySchema(&schema, key_map, &heap);
+    TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr, &heap);
+    BP_TREE_INDEX index(0, key_schema, engine.bpm_);
+    char payload[100];
+    memset(payload, 'x', sizeof(payload));
+    for (long i = 0; i < row_nums; i++) {
+      std::vector<Field> fields{
+              Field(TypeId::kTypeInt, static_cast<int32_t>(i)),
+              Field(TypeId::kTypeChar, payload, sizeof(payload), false)
+      };
+      Row row(fields);
+      table_heap->InsertTuple(row, nullptr);
+      std::vector<Field> key_fields{Field(TypeId::kTypeInt, static_cast<int32_t>(i))};
+      Row key(key_fields);
+      index.InsertEntry(key, row.GetRowId(), nullptr);
+    }
+
+    std::mt19937 rng(2022);
+    PhaseStats lookup, scan;
+    BenchmarkTimer total;
+    for (long round = 0; round < rounds; round++) {
+      size_t hits = engine.bpm_->GetHitCount(), misses = engine.bpm_->GetMissCount();
+      BenchmarkTimer timer;
+      std::vector<RowId> result;
+      for (long i = 0; i < lookups_per_round; i++) {
+        std::vector<Field> key_fields{Field(TypeId::kTypeInt, static_cast<int32_t>(rng() % hot_rows))};
+        Row key(key_fields);
+        result.clear();
+        index.ScanKey(key, result, nullptr);
+        Row row(result[0]);
+        table_heap->GetTuple(&row, nullptr);
+      }
+      lookup.elapsed += timer.Elapsed();
+      lookup.hits += engine.bpm_->GetHitCount() - hits;
+      lookup.misses += engine.bpm_->GetMissCount() - misses;
+
+      hits = engine.bpm_->GetHitCount(), misses = engine.bpm_->GetMissCount();
+      timer.Reset();
+      long scanned = 0;
+      for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+        scanned++;
+      }
+      scan.elapsed += timer.Elapsed();
+      scan.hits += engine.bpm_->GetHitCount() - hits;
+      scan.misses += engine.bpm_->GetMissCount() - misses;
+      if (scanned != row_nums) {
+        fprintf(stderr, "scan returned %ld of %ld rows\n", scanned, row_nums);
+      }
+    }
+    printf("%-8s %13.2f%% %16.0f %13.2f%% %12.3f %12.3f\n", policy.first.c_str(), lookup.HitRatio() * 100,
+           lookups_per_round * rounds / lookup.elapsed, scan.HitRatio() * 100, scan.elapsed, total.Elapsed());
+  }
+  return 0;
+}
@@ -0,0 +1,91 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "executor/executors/filter_executor.h"
+#include "executor/executors/projection_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+
+/**
+ * select c0 from t where c1 < x on a table of wide rows, with half int and half char columns. Once by
+ * SeqScan -> Filter -> Projection, which deserializes every row in full before the filter sees it, and
+ * once by a sequential scan with the predicate and the projection pushed down into it, which evaluates
+ * the predicate on the tuples in the pages and only reads the projected column of the matching rows.
+ *
+ * Usage: pushdown_bench [row_nums] [column_nums] [selectivity_percent] [rounds]
+ */
+static long Drain(AbstractExecutor &executor) {
+  long count = 0;
+  Row *row = nullptr;
+  executor.Init();
+  while (executor.Next(row)) {
+    count += row->GetField(0)->IsNull() ? 0 : 1;
+  }
+  return count;
+}
+
+int main(int argc, char **argv) {
+  const long row_nums = BenchmarkArg(argc, argv, 1, 100000);
+  const long column_nums = BenchmarkArg(argc, argv, 2, 20);
+  const long selectivity = BenchmarkArg(argc, argv, 3, 10);
+  const long rounds = BenchmarkArg(argc, argv, 4, 3);
+  const std::string db_name = "pushdown_bench.db";
+  SimpleMemHeap heap;
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns;
+  for (long i = 0; i < column_nums; i++) {
+    std::string name = "c" + std::to_string(i);
+    if (i % 2 == 0 || i == 1) {
+      columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeInt, i, true, false));
+    } else {
+      columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeChar, 16, i, true, false));
+    }
+  }
+  TableInfo *table_info = nullptr;
+  engine.catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info);
+  char value[16] = "pushdown_bench";
+  for (long i = 0; i < row_nums; i++) {
+    std::vector<Field> fields;
+    for (long j = 0; j < column_nums; j++) {
+      if (j == 1) {
+        fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(i % 100));
+      } else if (j % 2 == 0) {
+        fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(i + j));
+      } else {
+        fields.emplace_back(TypeId::kTypeChar, value, 14, false);
+      }
+    }
+    Row row(fields);
+    table_info->GetTableHeap()->InsertTuple(row, nullptr);
+  }
+  const std::vector<uint32_t> projection = {0};
+  auto make_predicate = [selectivity]() {
+    return std::make_unique<ComparePredicate>(1, CompareType::kLessThan,
+                                              Field(TypeId::kTypeInt, static_cast<int32_t>(selectivity)));
+  };
+
+  printf("%ld rows of %ld columns, %ld%% selected\n", row_nums, column_nums, selectivity);
+  printf("%-8s %16s %16s %8s %10s\n", "round", "operators(ms)", "pushdown(ms)", "speedup", "rows");
+  for (long round = 0; round < rounds; round++) {
+    BenchmarkTimer timer;
+    auto filter = std::make_unique<FilterExecutor>(std::make_unique<SeqScanExecutor>(table_info, nullptr),
+                                                   make_predicate());
+    ProjectionExecutor operators(std::move(filter), projection);
+    long count = Drain(operators);
+    double operators_time = timer.Elapsed();
+    timer.Reset();
+    SeqScanExecutor pushdown(table_info, nullptr, make_predicate(), projection);
+    long pushdown_count = Drain(pushdown);
+    double pushdown_time = timer.Elapsed();
+    if (count != pushdown_count) {
+      fprintf(stderr, "the plans disagree: %ld vs %ld rows\n", count, pushdown_count);
+      return 1;
+    }
+    printf("%-8ld %16.1f %16.1f %8.2f %10ld\n", round, operators_time * 1e3, pushdown_time * 1e3,
+           operators_time / pushdown_time, count);
+  }
+  remove(db_name.c_str());
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include <memory>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "executor/executors/filter_executor.h"
+#include "executor/executors/index_range_scan_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+
+/**
+ * select * from events where ts >= a and ts < b, a time window over a table with an index on ts,
+ * executed by SeqScan -> Filter and by IndexRangeScan -> Filter, for windows of several widths.
+ *
+ * Usage: range_scan_bench [row_nums] [repeats]
+ */
+static std::unique_ptr<Predicate> Window(int32_t lo, int32_t hi) {
+  return std::make_unique<LogicalPredicate>(
+          true, std::make_unique<ComparePredicate>(0, CompareType::kGreaterThanOrEqual, Field(TypeId::kTypeInt, lo)),
+          std::make_unique<ComparePredicate>(0, CompareType::kLessThan, Field(TypeId::kTypeInt, hi)));
+}
+
+static long Run(AbstractExecutor *executor) {
+  long count = 0;
+  Row *row = nullptr;
+  executor->Init();
+  while (executor->Next(row)) {
+    count++;
+  }
+  return count;
+}
+
+int main(int argc, char **argv) {
+  const long row_nums = BenchmarkArg(argc, argv, 1, 200000);
+  const long repeats = BenchmarkArg(argc, argv, 2, 5);
+  const std::string db_name = "range_scan_bench.db";
+  SimpleMemHeap heap;
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("ts", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("payload", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  TableInfo *table_info = nullptr;
+  engine.catalog_mgr_->CreateTable("events", new Schema(columns), nullptr, table_info);
+  IndexInfo *index_info = nullptr;
+  engine.catalog_mgr_->CreateIndex("events", "events_ts", {"ts"}, nullptr, index_info);
+  char payload[64] = "range_scan_bench";
+  for (long i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, static_cast<int32_t>(i)),
+            Field(TypeId::kTypeChar, payload, 64, false)
+    };
+    Row row(fields);
+    table_info->GetTableHeap()->InsertTuple(row, nullptr);
+    index_info->GetIndex()->InsertEntry(index_info->GetIndexKey(row), row.GetRowId(), nullptr);
+  }
+
+  printf("%ld rows, %ld repeats\n", row_nums, repeats);
+  printf("%-10s %10s %16s %16s %9s\n", "window", "rows", "seq scan(ms)", "range scan(ms)", "speedup");
+  for (double width : {0.001, 0.01, 0.1, 0.5}) {
+    auto lo = static_cast<int32_t>(row_nums / 4);
+    auto hi = static_cast<int32_t>(lo + row_nums * width);
+    Field lo_field(TypeId::kTypeInt, lo), hi_field(TypeId::kTypeInt, hi);
+    long seq_count = 0, range_count = 0;
+    BenchmarkTimer timer;
+    for (long r = 0; r < repeats; r++) {
+      FilterExecutor executor(std::make_unique<SeqScanExecutor>(table_info, nullptr), Window(lo, hi));
+      seq_count = Run(&executor);
+    }
+    double seq_ms = timer.Elapsed() * 1e3 / repeats;
+    timer.Reset();
+    for (long r = 0; r < repeats; r++) {
+      FilterExecutor executor(std::make_unique<IndexRangeScanExecutor>(table_info, index_info, &lo_field, true,
+                                                                       &hi_field, false, nullptr),
+                              Window(lo, hi));
+      range_count = Run(&executor);
+    }
+    double range_ms = timer.Elapsed() * 1e3 / repeats;
+    if (seq_count != range_count) {
+      printf("row counts differ: %ld, %ld\n", seq_count, range_count);
+      return 1;
+    }
+    printf("%9.1f%% %10ld %16.2f %16.2f %8.1fx\n", width * 100, seq_count, seq_ms, range_ms, seq_ms / range_ms);
+  }
+  remove(db_name.c_str());
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include <memory>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "executor/executors/filter_executor.h"
+#include "executor/executors/index_scan_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+
+/**
+ * select * from orders where customer_id = x, over a non-unique index on customer_id, executed by
+ * SeqScan -> Filter and by IndexScan -> Filter.
+ *
+ * Usage: secondary_index_bench [row_nums] [customer_nums] [repeats]
+ */
+static long Run(AbstractExecutor *executor) {
+  long count = 0;
+  Row *row = nullptr;
+  executor->Init();
+  while (executor->Next(row)) {
+    count++;
+  }
+  return count;
+}
+
+int main(int argc, char **argv) {
+  const long row_nums = BenchmarkArg(argc, argv, 1, 200000);
+  const long customer_nums = BenchmarkArg(argc, argv, 2, 1000);
+  const long repeats = BenchmarkArg(argc, argv, 3, 20);
+  const std::string db_name = "secondary_index_bench.db";
+  SimpleMemHeap heap;
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("customer_id", TypeId::kTypeInt, 1, false, false),
+          ALLOC_COLUMN(heap)("note", TypeId::kTypeChar, 64, 2, true, false)
+  };
+  TableInfo *table_info = nullptr;
+  engine.catalog_mgr_->CreateTable("orders", new Schema(columns), nullptr, table_info);
+  char note[64] = "secondary_index_bench";
+  for (long i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, static_cast<int32_t>(i)),
+            Field(TypeId::kTypeInt, static_cast<int32_t>(i * 7919 % customer_nums)),
+            Field(TypeId::kTypeChar, note, 64, false)
+    };
+    Row row(fields);
+    table_info->GetTableHeap()->InsertTuple(row, nullptr);
+  }
+  IndexInfo *index_info = nullptr;
+  BenchmarkTimer timer;
+  if (engine.catalog_mgr_->CreateIndex("orders", "orders_customer_id", {"customer_id"}, nullptr, index_info,
+                                       false) != DB_SUCCESS) {
+    printf("create index failed\n");
+    return 1;
+  }
+  printf("%ld rows, %ld customers, index built in %.1f ms\n", row_nums, customer_nums, timer.Elapsed() * 1e3);
+  printf("%-12s %10s %12s\n", "plan", "rows", "time(ms)");
+  auto predicate = [](int32_t customer_id) {
+    return std::make_unique<ComparePredicate>(1, CompareType::kEqual, Field(TypeId::kTypeInt, customer_id));
+  };
+  long seq_count = 0, index_count = 0;
+  timer.Reset();
+  for (long r = 0; r < repeats; r++) {
+    FilterExecutor executor(std::make_unique<SeqScanExecutor>(table_info, nullptr), predicate(r));
+    seq_count += Run(&executor);
+  }
+  printf("%-12s %10ld %12.2f\n", "seq scan", seq_count / repeats, timer.Elapsed() * 1e3 / repeats);
+  timer.Reset();
+  for (long r = 0; r < repeats; r++) {
+    std::vector<Field> key{Field(TypeId::kTypeInt, static_cast<int32_t>(r))};
+    FilterExecutor executor(std::make_unique<IndexScanExecutor>(table_info, index_info, key, nullptr), predicate(r));
+    index_count += Run(&executor);
+  }
+  printf("%-12s %10ld %12.2f\n", "index scan", index_count / repeats, timer.Elapsed() * 1e3 / repeats);
+  remove(db_name.c_str());
+  return seq_count == index_count ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+#include <malloc.h>
+#include <memory>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "executor/executors/filter_executor.h"
+#include "executor/executors/projection_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+
+/**
+ * select id, name from t where account < x, executed the way ExecuteSelect used to, by copying every
+ * row of the table into a vector and the matching rows into another, and by the operator pipeline
+ * SeqScan -> Filter -> Projection. Peak memory is the largest growth of the heap during the query.
+ *
+ * Usage: select_bench [row_nums] [selectivity_percent]
+ */
+static long HeapInUse() {
+  return static_cast<long>(mallinfo2().uordblks);
+}
+
+static long Materialized(TableInfo *table_info, const Predicate &predicate, const std::vector<uint32_t> &columns,
+                         long *peak) {
+  long base = HeapInUse();
+  TableHeap *table_heap = table_info->GetTableHeap();
+  std::vector<Row *> rows;
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); it++) {
+    rows.push_back(new Row(*it));
+  }
+  std::vector<Row *> result;
+  for (auto row : rows) {
+    if (predicate.Evaluate(*row)) {
+      result.push_back(new Row(*row));
+    }
+  }
+  long count = 0;
+  for (auto row : result) {
+    for (auto column : columns) {
+      count += row->GetField(column)->IsNull() ? 0 : 1;
+    }
+  }
+  *peak = HeapInUse() - base;
+  for (auto row : rows) {
+    delete row;
+  }
+  for (auto row : result) {
+    delete row;
+  }
+  return count / columns.size();
+}
+
+static long Pipeline(TableInfo *table_info, std::unique_ptr<Predicate> predicate, const std::vector<uint32_t> &columns,
+                     long *peak) {
+  long base = HeapInUse();
+  *peak = 0;
+  auto scan = std::make_unique<SeqScanExecutor>(table_info, nullptr);
+  auto filter = std::make_unique<FilterExecutor>(std::move(scan), std::move(predicate));
+  ProjectionExecutor executor(std::move(filter), columns);
+  long count = 0;
+  Row *row = nullptr;
+  executor.Init();
+  while (executor.Next(row)) {
+    for (auto field : row->GetFields()) {
+      count += field->IsNull() ? 0 : 1;
+    }
+    if (count % 1024 == 0) {
+      *peak = std::max(*peak, HeapInUse() - base);
+    }
+  }
+  *peak = std::max(*peak, HeapInUse() - base);
+  return count / columns.size();
+}
+
+int main(int argc, char **argv) {
+  const long row_nums = BenchmarkArg(argc, argv, 1, 200000);
+  const long selectivity = BenchmarkArg(argc, argv, 2, 10);
+  const std::string db_name = "select_bench.db";
+  SimpleMemHeap heap;
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  TableInfo *table_info = nullptr;
+  engine.catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info);
+  char name[64] = "select_bench";
+  for (long i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, static_cast<int32_t>(i)),
+            Field(TypeId::kTypeChar, name, 64, false),
+            Field(TypeId::kTypeFloat, static_cast<float>(i % 100))
+    };
+    Row row(fields);
+    table_info->GetTableHeap()->InsertTuple(row, nullptr);
+  }
+  const std::vector<uint32_t> projection = {0, 1};
+  auto make_predicate = [selectivity]() {
+    return std::make_unique<ComparePredicate>(2, CompareType::kLessThan,
+                                              Field(TypeId::kTypeFloat, static_cast<float>(selectivity)));
+  };
+
+  printf("%ld rows, %ld%% selected\n", row_nums, selectivity);
+  printf("%-14s %10s %12s %14s\n", "plan", "rows", "time(ms)", "peak heap(KB)");
+  long peak;
+  BenchmarkTimer timer;
+  long count = Materialized(table_info, *make_predicate(), projection, &peak);
+  printf("%-14s %10ld %12.1f %14.1f\n", "materialized", count, timer.Elapsed() * 1e3, peak / 1024.0);
+  timer.Reset();
+  count = Pipeline(table_info, make_predicate(), projection, &peak);
+  printf("%-14s %10ld %12.1f %14.1f\n", "pipeline", count, timer.Elapsed() * 1e3, peak / 1024.0);
+  remove(db_name.c_str());
+  return 0;
+}
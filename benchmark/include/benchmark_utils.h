@@ -0,0 +1,34 @@
+#ifndef MINISQL_BENCHMARK_UTILS_H
+#define MINISQL_BENCHMARK_UTILS_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/**
+ * Wall clock timer used by the benchmarks.
+ */
+class BenchmarkTimer {
+public:
+  BenchmarkTimer() { Reset(); }
+
+  void Reset() { start_ = std::chrono::steady_clock::now(); }
+
+  /** @return elapsed time in seconds */
+  double Elapsed() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @return the integer value of the i-th command line argument, default_value if absent
+ */
+inline long BenchmarkArg(int argc, char **argv, int i, long default_value) {
+  return argc > i ? std::strtol(argv[i], nullptr, 10) : default_value;
+}
+
+#endif //MINISQL_BENCHMARK_UTILS_H
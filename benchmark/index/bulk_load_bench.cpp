@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "index/b_plus_tree_index.h"
+#include "index/generic_key.h"
+
+/**
+ * Build an index over a table whose keys were inserted in random order, once by inserting the rows one
+ * by one and once by sorting them and building the tree bottom-up, then flush it. The leaf chain shows
+ * how full and how contiguous on disk the leaves are.
+ *
+ * Usage: bulk_load_bench [row_nums] [sort_buffer_kb]
+ */
+using BP_TREE_INDEX = BPlusTreeIndex<GenericKey<8>, RowId, GenericComparator<8>>;
+
+static void Report(const char *method, double seconds, const PageRunStats &stats, long row_nums) {
+  printf("%-12s %10.1f %12zu %14.1f %10zu %14.1f\n", method, seconds * 1e3, stats.num_pages,
+         static_cast<double>(row_nums) / stats.num_pages, stats.num_runs, stats.AverageRunLength());
+}
+
+int main(int argc, char **argv) {
+  const long row_nums = BenchmarkArg(argc, argv, 1, 500000);
+  const size_t sort_buffer_size = BenchmarkArg(argc, argv, 2, DEFAULT_SORT_BUFFER_SIZE >> 10) << 10;
+  const std::string db_name = "bulk_load_bench.db";
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false),
+  };
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr, &heap);
+  std::vector<int32_t> ids(row_nums);
+  for (long i = 0; i < row_nums; i++) {
+    ids[i] = static_cast<int32_t>(i);
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  char name[32] = "bulk_load_bench";
+  for (auto id : ids) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, 32, false)};
+    Row row(fields);
+    table_heap->InsertTuple(row, nullptr);
+  }
+  engine.bpm_->FlushAllPages();
+  const std::vector<uint32_t> key_map{0};
+  auto *key_schema = Schema::ShallowCopySchema(&schema, key_map, &heap);
+
+  printf("%ld rows, sort buffer %zu KB\n", row_nums, sort_buffer_size >> 10);
+  printf("%-12s %10s %12s %14s %10s %14s\n", "method", "time(ms)", "leaf pages", "keys per leaf", "leaf runs",
+         "avg run pages");
+  auto *one_by_one = ALLOC(heap, BP_TREE_INDEX)(0, key_schema, engine.bpm_);
+  BenchmarkTimer timer;
+  one_by_one->Index::BulkLoad(table_heap, key_map, nullptr);
+  engine.bpm_->FlushAllPages();
+  Report("insert", timer.Elapsed(), one_by_one->GetPageRunStats(), row_nums);
+
+  auto *bulk = ALLOC(heap, BP_TREE_INDEX)(1, key_schema, engine.bpm_, true, DEFAULT_FILL_FACTOR, sort_buffer_size);
+  timer.Reset();
+  if (bulk->BulkLoad(table_heap, key_map, nullptr) != DB_SUCCESS) {
+    printf("bulk load failed\n");
+    return 1;
+  }
+  engine.bpm_->FlushAllPages();
+  Report("bulk load", timer.Elapsed(), bulk->GetPageRunStats(), row_nums);
+  remove(db_name.c_str());
+  return 0;
+}
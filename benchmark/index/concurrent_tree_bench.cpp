@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "index/b_plus_tree.h"
+#include "index/basic_comparator.h"
+
+/**
+ * Throughput of a mix of inserts and point lookups on one B+ tree from 1 to 32 threads, once with
+ * every operation under a single mutex, the way the tree had to be shared before it latched its
+ * pages, and once relying on the latch crabbing of the tree. The tree is preloaded with key_nums
+ * keys; every thread inserts keys of its own and looks up preloaded ones.
+ *
+ * Usage: concurrent_tree_bench [key_nums] [ops_per_thread] [lookup_percent]
+ */
+using Tree = BPlusTree<int, int, BasicComparator<int>>;
+
+static double Run(Tree &tree, int num_threads, long key_nums, long ops, long lookup_percent, std::mutex *mutex) {
+  std::vector<std::thread> threads;
+  BenchmarkTimer timer;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 rng(t);
+      std::vector<int> found;
+      int next_key = static_cast<int>(key_nums) + t;
+      for (long i = 0; i < ops; i++) {
+        bool lookup = static_cast<long>(rng() % 100) < lookup_percent;
+        int key = lookup ? static_cast<int>(rng() % key_nums) : next_key;
+        std::unique_lock<std::mutex> lock;
+        if (mutex != nullptr) {
+          lock = std::unique_lock<std::mutex>(*mutex);
+        }
+        if (lookup) {
+          found.clear();
+          tree.GetValue(key, found);
+        } else {
+          tree.Insert(key, key);
+          next_key += num_threads;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return num_threads * ops / timer.Elapsed();
+}
+
+int main(int argc, char **argv) {
+  const long key_nums = BenchmarkArg(argc, argv, 1, 200000);
+  const long ops = BenchmarkArg(argc, argv, 2, 50000);
+  const long lookup_percent = BenchmarkArg(argc, argv, 3, 80);
+  const std::string db_name = "concurrent_tree_bench.db";
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  std::vector<int> keys(key_nums);
+  for (long i = 0; i < key_nums; i++) {
+    keys[i] = static_cast<int>(i);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+
+  printf("%ld keys, %ld ops per thread, %ld%% lookups\n", key_nums, ops, lookup_percent);
+  printf("%-8s %16s %16s %8s\n", "threads", "mutex(ops/s)", "latches(ops/s)", "speedup");
+  index_id_t index_id = 0;
+  for (int num_threads : {1, 2, 4, 8, 16, 32}) {
+    double throughput[2];
+    for (int latched = 0; latched < 2; latched++) {
+      Tree tree(index_id++, engine.bpm_, comparator);
+      for (auto key : keys) {
+        tree.Insert(key, key);
+      }
+      std::mutex mutex;
+      throughput[latched] = Run(tree, num_threads, key_nums, ops, lookup_percent, latched ? nullptr : &mutex);
+      tree.Destroy();
+    }
+    printf("%-8d %16.0f %16.0f %8.2f\n", num_threads, throughput[0], throughput[1], throughput[1] / throughput[0]);
+  }
+  remove(db_name.c_str());
+  return 0;
+}
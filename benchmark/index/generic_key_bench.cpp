@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "index/b_plus_tree.h"
+#include "index/generic_key.h"
+#include "record/schema.h"
+
+using KeyType = GenericKey<32>;
+using BPlusTreeType = BPlusTree<KeyType, RowId, GenericComparator<32>>;
+
+/**
+ * Comparator of key format version 1: both keys are deserialized into rows and compared field by field.
+ */
+class LegacyComparator {
+public:
+  explicit LegacyComparator(Schema *key_schema) : key_schema_(key_schema) {}
+
+  int operator()(const KeyType &lhs, const KeyType &rhs) const {
+    Row lhs_key(INVALID_ROWID);
+    Row rhs_key(INVALID_ROWID);
+    lhs_key.DeserializeFrom(const_cast<char *>(lhs.data), key_schema_);
+    rhs_key.DeserializeFrom(const_cast<char *>(rhs.data), key_schema_);
+    for (uint32_t i = 0; i < key_schema_->GetColumnCount(); i++) {
+      if (lhs_key.GetField(i)->CompareLessThan(*rhs_key.GetField(i)) == CmpBool::kTrue) {
+        return -1;
+      }
+      if (lhs_key.GetField(i)->CompareGreaterThan(*rhs_key.GetField(i)) == CmpBool::kTrue) {
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+private:
+  Schema *key_schema_;
+};
+
+template<typename Comparator>
+static double BinarySearchLookups(const std::vector<KeyType> &sorted, const std::vector<KeyType> &probes,
+                                  const Comparator &comparator) {
+  auto less = [&comparator](const KeyType &lhs, const KeyType &rhs) { return comparator(lhs, rhs) < 0; };
+  size_t found = 0;
+  BenchmarkTimer timer;
+  for (auto &probe : probes) {
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), probe, less);
+    found += (it != sorted.end() && comparator(*it, probe) == 0);
+  }
+  double elapsed = timer.Elapsed();
+  if (found != probes.size()) {
+    fprintf(stderr, "only %zu of %zu keys found\n", found, probes.size());
+  }
+  return elapsed;
+}
+
+/**
+ * Point lookups on an (int, char(16)) key, comparing the row based key format with the
+ * memcomparable one, first by binary search over a sorted key array and then through a B+ tree.
+ *
+ * Usage: generic_key_bench [key_nums] [lookup_nums]
+ */
+int main(int argc, char **argv) {
+  const long key_nums = BenchmarkArg(argc, argv, 1, 100000);
+  const long lookup_nums = BenchmarkArg(argc, argv, 2, 1000000);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, false, false)
+  };
+  Schema key_schema(columns);
+  std::vector<KeyType> legacy_keys(key_nums);
+  std::vector<KeyType> keys(key_nums);
+  std::mt19937 rng(2022);
+  for (long i = 0; i < key_nums; i++) {
+    char name[16];
+    snprintf(name, sizeof(name), "name_%010ld", static_cast<long>(rng() % 1000));
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, static_cast<int32_t>(i - key_nums / 2)),
+            Field(TypeId::kTypeChar, name, strlen(name), true)
+    };
+    Row row(fields);
+    memset(legacy_keys[i].data, 0, sizeof(legacy_keys[i].data));
+    row.SerializeTo(legacy_keys[i].data, &key_schema);
+    keys[i].SerializeFromKey(row, &key_schema);
+  }
+  std::vector<KeyType> legacy_probes;
+  std::vector<KeyType> probes;
+  legacy_probes.reserve(lookup_nums);
+  probes.reserve(lookup_nums);
+  for (long i = 0; i < lookup_nums; i++) {
+    long idx = rng() % key_nums;
+    legacy_probes.push_back(legacy_keys[idx]);
+    probes.push_back(keys[idx]);
+  }
+
+  LegacyComparator legacy_comparator(&key_schema);
+  GenericComparator<32> comparator(&key_schema);
+  std::sort(legacy_keys.begin(), legacy_keys.end(),
+            [&](const KeyType &lhs, const KeyType &rhs) { return legacy_comparator(lhs, rhs) < 0; });
+  std::sort(keys.begin(), keys.end(),
+            [&](const KeyType &lhs, const KeyType &rhs) { return comparator(lhs, rhs) < 0; });
+
+  printf("%ld keys, %ld point lookups\n", key_nums, lookup_nums);
+  printf("%-32s %12s %16s\n", "", "total(s)", "ns/lookup");
+  double legacy = BinarySearchLookups(legacy_keys, legacy_probes, legacy_comparator);
+  printf("%-32s %12.3f %16.1f\n", "binary search, row compare", legacy, legacy * 1e9 / lookup_nums);
+  double memcomparable = BinarySearchLookups(keys, probes, comparator);
+  printf("%-32s %12.3f %16.1f\n", "binary search, memcmp", memcomparable, memcomparable * 1e9 / lookup_nums);
+
+  DBStorageEngine engine("generic_key_bench.db");
+  BPlusTreeType tree(0, engine.bpm_, comparator);
+  for (long i = 0; i < key_nums; i++) {
+    tree.Insert(keys[i], RowId(static_cast<page_id_t>(i), 0), nullptr);
+  }
+  std::vector<RowId> result;
+  result.reserve(lookup_nums);
+  BenchmarkTimer timer;
+  for (auto &probe : probes) {
+    tree.GetValue(probe, result, nullptr);
+  }
+  double tree_elapsed = timer.Elapsed();
+  printf("%-32s %12.3f %16.1f\n", "b+ tree GetValue, memcmp", tree_elapsed, tree_elapsed * 1e9 / lookup_nums);
+  if (result.size() != static_cast<size_t>(lookup_nums)) {
+    fprintf(stderr, "only %zu of %ld keys found in b+ tree\n", result.size(), lookup_nums);
+  }
+  return 0;
+}
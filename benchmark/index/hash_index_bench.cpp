@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "index/b_plus_tree_index.h"
+#include "index/extendible_hash_index.h"
+#include "index/generic_key.h"
+
+/**
+ * Point lookups of single INT keys, inserted in random order, in a unique B+ tree index and a unique
+ * extendible hash index. Half of the lookups miss.
+ *
+ * Usage: hash_index_bench [key_nums] [lookup_nums]
+ */
+using BP_TREE_INDEX = BPlusTreeIndex<GenericKey<8>, RowId, GenericComparator<8>>;
+using HASH_INDEX = ExtendibleHashIndex<GenericKey<8>, RowId, GenericComparator<8>>;
+
+static void Run(const char *name, Index *index, const std::vector<int32_t> &keys, const std::vector<int32_t> &probes) {
+  BenchmarkTimer timer;
+  for (auto key : keys) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, key)};
+    index->InsertEntry(Row(fields), RowId(key, 0), nullptr);
+  }
+  double insert_time = timer.Elapsed();
+  timer.Reset();
+  long found = 0;
+  std::vector<RowId> result;
+  for (auto key : probes) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, key)};
+    result.clear();
+    found += index->ScanKey(Row(fields), result, nullptr) == DB_SUCCESS;
+  }
+  double lookup_time = timer.Elapsed();
+  printf("%-10s %12.1f %12.1f %14.1f %10ld\n", name, insert_time * 1e3, lookup_time * 1e3,
+         lookup_time * 1e9 / probes.size(), found);
+}
+
+int main(int argc, char **argv) {
+  const long key_nums = BenchmarkArg(argc, argv, 1, 500000);
+  const long lookup_nums = BenchmarkArg(argc, argv, 2, 1000000);
+  const std::string db_name = "hash_index_bench.db";
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)};
+  Schema schema(columns);
+  auto *key_schema = Schema::ShallowCopySchema(&schema, {0}, &heap);
+  std::vector<int32_t> keys(key_nums);
+  for (long i = 0; i < key_nums; i++) {
+    keys[i] = static_cast<int32_t>(2 * i);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  std::mt19937 rng(1);
+  std::vector<int32_t> probes(lookup_nums);
+  for (auto &probe : probes) {
+    probe = static_cast<int32_t>(rng() % (2 * key_nums));
+  }
+
+  printf("%ld keys, %ld lookups\n", key_nums, lookup_nums);
+  printf("%-10s %12s %12s %14s %10s\n", "index", "insert(ms)", "lookup(ms)", "ns per lookup", "found");
+  auto *b_plus_tree = ALLOC(heap, BP_TREE_INDEX)(0, key_schema, engine.bpm_);
+  Run("b+ tree", b_plus_tree, keys, probes);
+  b_plus_tree->Destroy();
+  auto *hash = ALLOC(heap, HASH_INDEX)(1, key_schema, engine.bpm_);
+  Run("hash", hash, keys, probes);
+  hash->Destroy();
+  remove(db_name.c_str());
+  return 0;
+}
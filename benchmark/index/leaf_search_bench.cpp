@@ -0,0 +1,88 @@
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "index/generic_key.h"
+#include "page/b_plus_tree_leaf_page.h"
+#include "record/schema.h"
+
+/**
+ * Point lookups in a full leaf page for every GenericKey size, comparing the linear scan which KeyIndex
+ * used before with the current KeyIndex: branch free binary search, and SIMD for GenericKey<8>.
+ * Keys are single INT columns; GenericKey<4> cannot hold the 5 byte INT key format and stores the
+ * big endian integer instead.
+ *
+ * Usage: leaf_search_bench [lookup_nums]
+ */
+template<size_t KeySize>
+static void Run(Schema *schema, long lookup_nums) {
+  using Key = GenericKey<KeySize>;
+  using Comparator = GenericComparator<KeySize>;
+  using LeafPage = BPlusTreeLeafPage<Key, RowId, Comparator>;
+  const int leaf_size = static_cast<int>((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<Key, RowId>) - 1);
+  auto make_key = [schema](int32_t value) {
+    Key key;
+    if (KeySize < 8) {
+      uint32_t big_endian = __builtin_bswap32(static_cast<uint32_t>(value) ^ 0x80000000u);
+      memset(key.data, 0, KeySize);
+      memcpy(key.data, &big_endian, sizeof(big_endian));
+    } else {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+      Row row(fields);
+      key.SerializeFromKey(row, schema);
+    }
+    return key;
+  };
+
+  Comparator comparator(schema);
+  std::unique_ptr<char[]> data(new char[PAGE_SIZE]);
+  auto *leaf = reinterpret_cast<LeafPage *>(data.get());
+  leaf->Init(0, INVALID_PAGE_ID, leaf_size);
+  for (int i = 0; i < leaf_size; i++) {
+    leaf->Insert(make_key(2 * i), RowId(i, 0), comparator);
+  }
+  std::mt19937 rng(2022);
+  std::vector<Key> probes;
+  probes.reserve(lookup_nums);
+  for (long i = 0; i < lookup_nums; i++) {
+    // half of the probes miss
+    probes.push_back(make_key(static_cast<int32_t>(rng() % (2 * leaf_size))));
+  }
+
+  long linear_sum = 0, search_sum = 0;
+  BenchmarkTimer timer;
+  for (auto &probe : probes) {
+    int i = 0;
+    while (i < leaf->GetSize() && comparator(leaf->KeyAt(i), probe) < 0) {
+      i++;
+    }
+    linear_sum += i;
+  }
+  double linear = timer.Elapsed();
+  timer.Reset();
+  for (auto &probe : probes) {
+    search_sum += leaf->KeyIndex(probe, comparator);
+  }
+  double search = timer.Elapsed();
+  if (linear_sum != search_sum) {
+    fprintf(stderr, "GenericKey<%zu>: results differ\n", KeySize);
+  }
+  printf("%-16s %10d %16.1f %16.1f %10.1fx\n", ("GenericKey<" + std::to_string(KeySize) + ">").c_str(), leaf_size,
+         linear * 1e9 / lookup_nums, search * 1e9 / lookup_nums, linear / search);
+}
+
+int main(int argc, char **argv) {
+  const long lookup_nums = BenchmarkArg(argc, argv, 1, 1000000);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)};
+  Schema schema(columns);
+  printf("%ld lookups in a full leaf page\n", lookup_nums);
+  printf("%-16s %10s %16s %16s %11s\n", "key", "entries", "linear(ns)", "KeyIndex(ns)", "speedup");
+  Run<4>(&schema, lookup_nums);
+  Run<8>(&schema, lookup_nums);
+  Run<16>(&schema, lookup_nums);
+  Run<32>(&schema, lookup_nums);
+  Run<64>(&schema, lookup_nums);
+  return 0;
+}
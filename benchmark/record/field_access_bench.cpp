@@ -0,0 +1,62 @@
+#include <string>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "record/row.h"
+
+/**
+ * Reading one field of a serialized row of a wide table, by deserializing the whole row and by reading
+ * the field alone, for a column at the start, in the middle and at the end of the row. Every other
+ * column is a char column.
+ *
+ * Usage: field_access_bench [column_nums] [reads]
+ */
+int main(int argc, char **argv) {
+  const long column_nums = BenchmarkArg(argc, argv, 1, 20);
+  const long reads = BenchmarkArg(argc, argv, 2, 1000000);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns;
+  std::vector<Field> fields;
+  std::string value = "field_access_bench";
+  for (long i = 0; i < column_nums; i++) {
+    std::string name = "c" + std::to_string(i);
+    if (i % 2 == 0) {
+      columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeInt, i, true, false));
+      fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(i));
+    } else {
+      columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeChar, 32, i, true, false));
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(value.c_str()), value.size(), false);
+    }
+  }
+  Schema schema(columns);
+  Row row(fields);
+  char buf[PAGE_SIZE];
+  row.SerializeTo(buf, &schema);
+
+  printf("%ld columns, %ld reads\n", column_nums, reads);
+  printf("%-8s %16s %16s %8s\n", "column", "row(ns/read)", "field(ns/read)", "speedup");
+  for (long column : {0L, column_nums / 2, column_nums - 1}) {
+    long checksum = 0;
+    BenchmarkTimer timer;
+    Row deserialized(INVALID_ROWID);
+    for (long i = 0; i < reads; i++) {
+      deserialized.Clear(INVALID_ROWID);
+      deserialized.DeserializeFrom(buf, &schema, false);
+      checksum += deserialized.GetField(column)->IsNull() ? 0 : 1;
+    }
+    double row_time = timer.Elapsed();
+    timer.Reset();
+    ArenaMemHeap arena;
+    for (long i = 0; i < reads; i++) {
+      arena.Reset();
+      checksum += Row::DeserializeField(buf, &schema, column, &arena, false)->IsNull() ? 0 : 1;
+    }
+    double field_time = timer.Elapsed();
+    printf("%-8ld %16.1f %16.1f %8.2f\n", column, row_time * 1e9 / reads, field_time * 1e9 / reads,
+           row_time / field_time);
+    if (checksum == 0) {
+      printf("unexpected checksum\n");
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "storage/disk_manager.h"
+
+/**
+ * Random page read IOPS of the DiskManager backends from 1 to 16 threads.
+ * The file is small enough to stay in the page cache, so the benchmark measures the read path itself.
+ *
+ * Usage: disk_manager_read_bench [reads_per_thread] [page_nums]
+ */
+static double RunThreads(DiskManager *disk_manager, int num_threads, long reads_per_thread, long page_nums) {
+  std::vector<std::thread> threads;
+  BenchmarkTimer timer;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([=]() {
+      std::mt19937 rng(t);
+      char page[PAGE_SIZE];
+      for (long i = 0; i < reads_per_thread; i++) {
+        disk_manager->ReadPage(static_cast<page_id_t>(rng() % page_nums), page);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return timer.Elapsed();
+}
+
+int main(int argc, char **argv) {
+  const long reads_per_thread = BenchmarkArg(argc, argv, 1, 100000);
+  const long page_nums = BenchmarkArg(argc, argv, 2, 8192);
+  const std::string db_name = "disk_manager_read_bench.db";
+  remove(db_name.c_str());
+  {
+    DiskManager disk_manager(db_name);
+    char page[PAGE_SIZE];
+    for (long i = 0; i < page_nums; i++) {
+      memset(page, static_cast<int>(i), PAGE_SIZE);
+      disk_manager.WritePage(static_cast<page_id_t>(i), page);
+    }
+  }
+
+  DiskManager fd_disk_manager(db_name, DiskIOBackend::kFileDescriptor);
+  DiskManager stream_disk_manager(db_name, DiskIOBackend::kFstream);
+  printf("%ld pages, %ld random reads per thread\n", page_nums, reads_per_thread);
+  printf("%8s %20s %20s\n", "threads", "pread(kIOPS)", "fstream(kIOPS)");
+  for (int num_threads = 1; num_threads <= 16; num_threads *= 2) {
+    double total_reads = static_cast<double>(num_threads) * reads_per_thread;
+    double fd_elapsed = RunThreads(&fd_disk_manager, num_threads, reads_per_thread, page_nums);
+    double stream_elapsed = RunThreads(&stream_disk_manager, num_threads, reads_per_thread, page_nums);
+    printf("%8d %20.1f %20.1f\n", num_threads, total_reads / fd_elapsed / 1e3, total_reads / stream_elapsed / 1e3);
+  }
+  fd_disk_manager.Close();
+  stream_disk_manager.Close();
+  remove(db_name.c_str());
+  return 0;
+}
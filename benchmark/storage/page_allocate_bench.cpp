@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "storage/disk_manager.h"
+
+/**
+ * Page allocation throughput of the DiskManager: allocate a number of pages, free a random half of
+ * them and allocate them again, like a heap growing after deletions.
+ *
+ * Usage: page_allocate_bench [page_nums]
+ */
+int main(int argc, char **argv) {
+  const long page_nums = BenchmarkArg(argc, argv, 1, 200000);
+  const std::string db_name = "page_allocate_bench.db";
+  remove(db_name.c_str());
+  DiskManager disk_manager(db_name);
+  std::vector<page_id_t> page_ids;
+  BenchmarkTimer timer;
+  for (long i = 0; i < page_nums; i++) {
+    page_ids.push_back(disk_manager.AllocatePage());
+  }
+  double allocate = timer.Elapsed();
+  std::mt19937 rng(2022);
+  std::shuffle(page_ids.begin(), page_ids.end(), rng);
+  timer.Reset();
+  for (long i = 0; i < page_nums / 2; i++) {
+    disk_manager.DeAllocatePage(page_ids[i]);
+  }
+  double deallocate = timer.Elapsed();
+  timer.Reset();
+  for (long i = 0; i < page_nums / 2; i++) {
+    disk_manager.AllocatePage();
+  }
+  double reallocate = timer.Elapsed();
+  timer.Reset();
+  disk_manager.Close();
+  double close = timer.Elapsed();
+  printf("%ld pages\n", page_nums);
+  printf("%12s %16s %16s %16s %12s\n", "", "allocate(k/s)", "free(k/s)", "reuse(k/s)", "close(ms)");
+  printf("%12s %16.1f %16.1f %16.1f %12.1f\n", "DiskManager", page_nums / allocate / 1e3,
+         page_nums / 2 / deallocate / 1e3, page_nums / 2 / reallocate / 1e3, close * 1e3);
+  remove(db_name.c_str());
+  return 0;
+}
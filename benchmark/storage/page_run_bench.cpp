@@ -0,0 +1,58 @@
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+/**
+ * Two tables with an index each grow at the same time, then the fragmentation report shows how
+ * contiguous the page chains of the tables and the leaf chains of the indexes are on disk.
+ *
+ * Usage: page_run_bench [rows_per_table]
+ */
+int main(int argc, char **argv) {
+  const long row_nums = BenchmarkArg(argc, argv, 1, 100000);
+  const std::string db_name = "page_run_bench.db";
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+  };
+  Schema schema(columns);
+  const std::vector<std::string> table_names = {"orders", "items"};
+  std::vector<TableInfo *> tables;
+  std::vector<IndexInfo *> indexes;
+  for (auto &table_name : table_names) {
+    TableInfo *table_info = nullptr;
+    IndexInfo *index_info = nullptr;
+    engine.catalog_mgr_->CreateTable(table_name, &schema, nullptr, table_info);
+    engine.catalog_mgr_->CreateIndex(table_name, table_name + "_id", {"id"}, nullptr, index_info);
+    tables.push_back(table_info);
+    indexes.push_back(index_info);
+  }
+  char name[64] = "page_run_bench";
+  BenchmarkTimer timer;
+  for (long i = 0; i < row_nums; i++) {
+    for (size_t t = 0; t < tables.size(); t++) {
+      std::vector<Field> fields{
+              Field(TypeId::kTypeInt, static_cast<int32_t>(i)),
+              Field(TypeId::kTypeChar, name, 64, false)
+      };
+      Row row(fields);
+      if (!tables[t]->GetTableHeap()->InsertTuple(row, nullptr)) {
+        fprintf(stderr, "insert failed at row %ld\n", i);
+        return 1;
+      }
+      std::vector<Field> key_fields{Field(TypeId::kTypeInt, static_cast<int32_t>(i))};
+      Row key(key_fields);
+      indexes[t]->GetIndex()->InsertEntry(key, row.GetRowId(), nullptr);
+    }
+  }
+  printf("%ld rows per table inserted in %.3f s\n", row_nums, timer.Elapsed());
+  engine.catalog_mgr_->ReportFragmentation(std::cout);
+  remove(db_name.c_str());
+  return 0;
+}
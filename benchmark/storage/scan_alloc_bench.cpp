@@ -0,0 +1,94 @@
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "executor/executors/filter_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+
+/**
+ * Heap allocations per row read from a table: by a full scan with the table iterator, by the pipeline
+ * SeqScan -> Filter of select * from t where account < x, and by fetching every row by its row id into
+ * a row of its own, the way the index scans read the rows they found. Allocations are counted by
+ * wrapping malloc, which operator new goes through as well.
+ *
+ * Usage: scan_alloc_bench [row_nums] [selectivity_percent]
+ */
+extern "C" void *__libc_malloc(size_t size);
+
+static std::atomic<long> malloc_calls{0};
+
+extern "C" void *malloc(size_t size) noexcept {
+  malloc_calls.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+static void Report(const char *name, long rows, long allocations, double elapsed) {
+  printf("%-14s %10ld %14.2f %12.1f\n", name, rows, static_cast<double>(allocations) / rows, elapsed * 1e3);
+}
+
+int main(int argc, char **argv) {
+  const long row_nums = BenchmarkArg(argc, argv, 1, 200000);
+  const long selectivity = BenchmarkArg(argc, argv, 2, 10);
+  const std::string db_name = "scan_alloc_bench.db";
+  SimpleMemHeap heap;
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  TableInfo *table_info = nullptr;
+  engine.catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info);
+  TableHeap *table_heap = table_info->GetTableHeap();
+  char name[64] = "scan_alloc_bench";
+  std::vector<RowId> row_ids;
+  for (long i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, static_cast<int32_t>(i)),
+            Field(TypeId::kTypeChar, name, 64, false),
+            Field(TypeId::kTypeFloat, static_cast<float>(i % 100))
+    };
+    Row row(fields);
+    table_heap->InsertTuple(row, nullptr);
+    row_ids.push_back(row.GetRowId());
+  }
+
+  printf("%ld rows, %ld%% selected\n", row_nums, selectivity);
+  printf("%-14s %10s %14s %12s\n", "read", "rows", "allocs per row", "time(ms)");
+  long count = 0;
+  long base = malloc_calls.load();
+  BenchmarkTimer timer;
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    count += it->GetField(1)->GetLength() > 0;
+  }
+  Report("iterator", count, malloc_calls.load() - base, timer.Elapsed());
+
+  count = 0;
+  base = malloc_calls.load();
+  timer.Reset();
+  {
+    auto scan = std::make_unique<SeqScanExecutor>(table_info, nullptr);
+    auto predicate = std::make_unique<ComparePredicate>(2, CompareType::kLessThan,
+                                                        Field(TypeId::kTypeFloat, static_cast<float>(selectivity)));
+    FilterExecutor executor(std::move(scan), std::move(predicate));
+    Row *row = nullptr;
+    executor.Init();
+    while (executor.Next(row)) {
+      count++;
+    }
+  }
+  Report("seq scan", row_nums, malloc_calls.load() - base, timer.Elapsed());
+
+  count = 0;
+  base = malloc_calls.load();
+  timer.Reset();
+  for (auto row_id : row_ids) {
+    Row row(row_id);
+    count += table_heap->GetTuple(&row, nullptr);
+  }
+  Report("fetch by id", count, malloc_calls.load() - base, timer.Elapsed());
+  remove(db_name.c_str());
+  return 0;
+}
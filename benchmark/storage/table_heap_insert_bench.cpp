@@ -0,0 +1,50 @@
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+/**
+ * Insert rows into an empty table and report the insert latency of every batch.
+ * With the free space map the latency of a batch should stay flat as the heap grows.
+ *
+ * Usage: table_heap_insert_bench [row_nums] [batch_size]
+ */
+int main(int argc, char **argv) {
+  const long row_nums = BenchmarkArg(argc, argv, 1, 1000000);
+  const long batch_size = BenchmarkArg(argc, argv, 2, 100000);
+  DBStorageEngine engine("table_heap_insert_bench.db");
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr, &heap);
+  char name[16] = "benchmark_row__";
+  BenchmarkTimer total;
+  BenchmarkTimer batch;
+  printf("%12s %12s %16s\n", "rows", "batch(s)", "us/insert");
+  for (long i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, static_cast<int32_t>(i)),
+            Field(TypeId::kTypeChar, name, 16, false),
+            Field(TypeId::kTypeFloat, static_cast<float>(i) / 3)
+    };
+    Row row(fields);
+    if (!table_heap->InsertTuple(row, nullptr)) {
+      fprintf(stderr, "insert failed at row %ld\n", i);
+      return 1;
+    }
+    if ((i + 1) % batch_size == 0) {
+      double elapsed = batch.Elapsed();
+      printf("%12ld %12.3f %16.3f\n", i + 1, elapsed, elapsed * 1e6 / batch_size);
+      batch.Reset();
+    }
+  }
+  printf("total: %ld rows in %.3f s\n", row_nums, total.Elapsed());
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+/**
+ * Full scans of a table on a cold cache, with and without read-ahead. Before every scan the table is
+ * reopened with an empty buffer pool and the file is dropped from the page cache.
+ *
+ * Usage: table_scan_bench [row_nums] [pool_size] [rounds]
+ */
+static void DropPageCache(const std::string &db_name) {
+  int fd = open(db_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+static double Scan(const std::string &db_name, Schema *schema, page_id_t first_page_id,
+                   page_id_t free_space_map_page_id, size_t pool_size, size_t window, size_t *prefetch_count) {
+  DropPageCache(db_name);
+  DiskManager disk_manager(db_name);
+  long count = 0;
+  double elapsed;
+  {
+    BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+    bpm.SetReadAheadWindow(window);
+    SimpleMemHeap heap;
+    TableHeap *table_heap = TableHeap::Create(&bpm, first_page_id, free_space_map_page_id, schema, nullptr,
+                                              nullptr, &heap);
+    BenchmarkTimer timer;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+      count++;
+    }
+    elapsed = timer.Elapsed();
+    *prefetch_count = bpm.GetPrefetchCount();
+  }
+  disk_manager.Close();
+  return count / elapsed;
+}
+
+int main(int argc, char **argv) {
+  const long row_nums = BenchmarkArg(argc, argv, 1, 500000);
+  const long pool_size = BenchmarkArg(argc, argv, 2, 1024);
+  const long rounds = BenchmarkArg(argc, argv, 3, 3);
+  const std::string db_name = "table_scan_bench.db";
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  Schema schema(columns);
+  page_id_t first_page_id, free_space_map_page_id;
+  {
+    DBStorageEngine engine(db_name);
+    TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr, &heap);
+    char name[64] = "table_scan_bench";
+    for (long i = 0; i < row_nums; i++) {
+      std::vector<Field> fields{
+              Field(TypeId::kTypeInt, static_cast<int32_t>(i)),
+              Field(TypeId::kTypeChar, name, 64, false),
+              Field(TypeId::kTypeFloat, static_cast<float>(i) / 3)
+      };
+      Row row(fields);
+      if (!table_heap->InsertTuple(row, nullptr)) {
+        fprintf(stderr, "insert failed at row %ld\n", i);
+        return 1;
+      }
+    }
+    first_page_id = table_heap->GetFirstPageId();
+    free_space_map_page_id = table_heap->GetFreeSpaceMapPageId();
+  }
+
+  printf("%ld rows, %ld pages in the buffer pool, cold cache\n", row_nums, pool_size);
+  printf("%8s %16s %16s %16s\n", "round", "off(rows/s)", "on(rows/s)", "prefetched");
+  for (long round = 0; round < rounds; round++) {
+    size_t off_prefetch, on_prefetch;
+    double off = Scan(db_name, &schema, first_page_id, free_space_map_page_id, pool_size, 0, &off_prefetch);
+    double on = Scan(db_name, &schema, first_page_id, free_space_map_page_id, pool_size,
+                     DEFAULT_READ_AHEAD_WINDOW, &on_prefetch);
+    printf("%8ld %16.0f %16.0f %16zu\n", round, off, on, on_prefetch);
+  }
+  remove(db_name.c_str());
+  return 0;
+}
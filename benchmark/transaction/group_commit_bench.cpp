@@ -0,0 +1,60 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "transaction/log_manager.h"
+
+/**
+ * Commit throughput of the log manager with a growing number of concurrent committers. Every commit
+ * appends the log record of a change of a row and a commit record, and waits until the commit record
+ * is on disk. Committers waiting at the same time share a write and sync of the log.
+ *
+ * Usage: group_commit_bench [commits_per_thread] [max_threads] [tuple_size]
+ */
+int main(int argc, char **argv) {
+  const long commits_per_thread = BenchmarkArg(argc, argv, 1, 500);
+  const long max_threads = BenchmarkArg(argc, argv, 2, 16);
+  const long tuple_size = BenchmarkArg(argc, argv, 3, 100);
+  const std::string db_name = "group_commit_bench.db";
+  const std::string tuple(tuple_size, 'x');
+
+  printf("%ld commits per thread, tuples of %ld bytes\n", commits_per_thread, tuple_size);
+  printf("%-8s %14s %16s %14s\n", "threads", "commits/s", "commits per sync", "latency(us)");
+  for (long num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    remove(db_name.c_str());
+    DiskManager disk_manager(db_name);
+    remove(disk_manager.GetLogFileName().c_str());
+    double elapsed;
+    size_t flush_count;
+    {
+      LogManager log_manager(&disk_manager);
+      BenchmarkTimer timer;
+      std::vector<std::thread> threads;
+      for (long t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+          for (long i = 0; i < commits_per_thread; i++) {
+            auto txn_id = static_cast<txn_id_t>(t * commits_per_thread + i);
+            LogRecord insert(txn_id, INVALID_LSN, LogRecordType::kInsert, RowId(static_cast<page_id_t>(t), i),
+                             tuple.data(), tuple.size());
+            lsn_t lsn = log_manager.AppendLogRecord(&insert);
+            LogRecord commit(txn_id, lsn, LogRecordType::kCommit);
+            log_manager.Flush(log_manager.AppendLogRecord(&commit));
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      elapsed = timer.Elapsed();
+      flush_count = log_manager.GetFlushCount();
+    }
+    double commits = static_cast<double>(num_threads * commits_per_thread);
+    printf("%-8ld %14.0f %16.2f %14.1f\n", num_threads, commits / elapsed, commits / flush_count,
+           elapsed / commits_per_thread * 1e6);
+    disk_manager.Close();
+    remove(disk_manager.GetLogFileName().c_str());
+  }
+  remove(db_name.c_str());
+  return 0;
+}
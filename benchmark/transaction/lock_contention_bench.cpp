@@ -0,0 +1,85 @@
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "transaction/lock_manager.h"
+
+/**
+ * Throughput of the lock manager against the number of threads, for a hot and a cold distribution of the rows
+ * locked, with a single latch for the lock table or with the default shards. A transaction locks its table IX,
+ * then ops rows, each shared or, one time in four, exclusive, and releases its locks. A transaction which dies
+ * yields and is retried under its id until it commits. In the hot distribution nine accesses in ten go to
+ * hot_rows rows.
+ *
+ * Usage: lock_contention_bench [max_threads] [txns_per_thread] [rows] [hot_rows] [ops]
+ */
+struct RunResult {
+  double elapsed_;
+  size_t waits_;
+  size_t dies_;
+};
+
+static RunResult Run(size_t shard_count, long threads, long txns_per_thread, long rows, long hot_rows, long ops,
+                     bool hot) {
+  LockManager lock_manager(shard_count);
+  std::atomic<txn_id_t> next_txn_id{0};
+  auto worker = [&](long seed) {
+    std::mt19937 random(static_cast<uint32_t>(seed));
+    std::vector<RowId> rids(ops);
+    std::vector<bool> exclusive(ops);
+    for (long i = 0; i < txns_per_thread; i++) {
+      for (long j = 0; j < ops; j++) {
+        long row = hot && random() % 10 != 0 ? random() % hot_rows : random() % rows;
+        rids[j] = RowId(static_cast<page_id_t>(row / 64), static_cast<uint32_t>(row % 64));
+        exclusive[j] = random() % 4 == 0;
+      }
+      Transaction txn(next_txn_id++);
+      bool done = false;
+      while (!done) {
+        done = lock_manager.LockTable(&txn, 0, LockMode::kIntentionExclusive);
+        for (long j = 0; j < ops && done; j++) {
+          done = exclusive[j] ? lock_manager.LockExclusive(&txn, rids[j]) : lock_manager.LockShared(&txn, rids[j]);
+        }
+        lock_manager.ReleaseAll(&txn);
+        if (!done) {
+          // the older transaction which killed this one is let run before the retry
+          txn.SetState(TransactionState::kActive);
+          std::this_thread::yield();
+        }
+      }
+    }
+  };
+  BenchmarkTimer timer;
+  std::vector<std::thread> workers;
+  for (long i = 0; i < threads; i++) {
+    workers.emplace_back(worker, i);
+  }
+  for (auto &thread : workers) {
+    thread.join();
+  }
+  return RunResult{timer.Elapsed(), lock_manager.GetWaitCount(), lock_manager.GetDieCount()};
+}
+
+int main(int argc, char **argv) {
+  const long max_threads = BenchmarkArg(argc, argv, 1, std::max(4u, std::thread::hardware_concurrency()));
+  const long txns_per_thread = BenchmarkArg(argc, argv, 2, 20000);
+  const long rows = BenchmarkArg(argc, argv, 3, 1000000);
+  const long hot_rows = BenchmarkArg(argc, argv, 4, 64);
+  const long ops = BenchmarkArg(argc, argv, 5, 8);
+
+  printf("%ld transactions per thread of %ld rows, %ld rows of which %ld hot\n", txns_per_thread, ops, rows,
+         hot_rows);
+  printf("%-6s %-8s %-8s %12s %10s %10s\n", "keys", "threads", "shards", "txn/s", "waits", "dies");
+  for (bool hot : {false, true}) {
+    for (long threads = 1; threads <= max_threads; threads *= 2) {
+      for (size_t shard_count : {static_cast<size_t>(1), DEFAULT_LOCK_SHARDS}) {
+        RunResult result = Run(shard_count, threads, txns_per_thread, rows, hot_rows, ops, hot);
+        printf("%-6s %-8ld %-8zu %12.0f %10zu %10zu\n", hot ? "hot" : "cold", threads, shard_count,
+               threads * txns_per_thread / result.elapsed_, result.waits_, result.dies_);
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+
+/**
+ * Throughput of writers against a reader scanning the whole table over and over, when the reader locks the rows
+ * it reads until its end or reads a snapshot without locks. A writer updates one random row per transaction,
+ * a transaction which dies or loses a conflict yields and is retried. The versions kept for the snapshots are
+ * collected in the background.
+ *
+ * Usage: mvcc_bench [rows] [writers] [txns_per_writer]
+ */
+static const std::string db_name = "mvcc_bench.db";
+
+struct RunResult {
+  double elapsed_;
+  size_t retries_;
+  size_t scans_;
+  size_t max_versions_;
+  size_t reclaimed_;
+};
+
+static Row MakeRow(int32_t id, int32_t value) {
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeInt, value)};
+  return Row(fields);
+}
+
+static RunResult Run(IsolationLevel reader_level, long rows, long writers, long txns_per_writer) {
+  SimpleMemHeap heap;
+  auto engine = new DBStorageEngine(db_name, true, 4096);
+  engine->version_mgr_->Stop();
+  engine->version_mgr_->Start(std::chrono::milliseconds(10));
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("value", TypeId::kTypeInt, 1, false, false)};
+  TableInfo *table_info = nullptr;
+  engine->catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info);
+  TableHeap *table_heap = table_info->GetTableHeap();
+  std::vector<RowId> rids;
+  Transaction *load = engine->txn_mgr_->Begin();
+  for (int32_t id = 0; id < rows; id++) {
+    Row row = MakeRow(id, 0);
+    table_heap->InsertTuple(row, load);
+    rids.push_back(row.GetRowId());
+  }
+  engine->txn_mgr_->Commit(load);
+
+  std::atomic<bool> done{false};
+  std::atomic<size_t> retries{0};
+  size_t scans = 0;
+  size_t max_versions = 0;
+  std::thread reader([&]() {
+    while (!done) {
+      Transaction *txn = engine->txn_mgr_->Begin(reader_level, reader_level == IsolationLevel::kSnapshot);
+      for (auto it = table_heap->Begin(txn); it != table_heap->End(); ++it) {
+      }
+      max_versions = std::max(max_versions, engine->version_mgr_->GetVersionCount());
+      if (txn->GetState() == TransactionState::kAborted) {
+        engine->txn_mgr_->Abort(txn);
+      } else {
+        engine->txn_mgr_->Commit(txn);
+        scans++;
+      }
+    }
+  });
+  auto writer = [&](long seed) {
+    std::mt19937 random(static_cast<uint32_t>(seed));
+    for (long i = 0; i < txns_per_writer; i++) {
+      int32_t id = static_cast<int32_t>(random() % rows);
+      while (true) {
+        Transaction *txn = engine->txn_mgr_->Begin();
+        Row row = MakeRow(id, static_cast<int32_t>(i));
+        if (table_heap->UpdateTuple(row, rids[id], txn)) {
+          engine->txn_mgr_->Commit(txn);
+          break;
+        }
+        engine->txn_mgr_->Abort(txn);
+        retries++;
+        std::this_thread::yield();
+      }
+    }
+  };
+  BenchmarkTimer timer;
+  std::vector<std::thread> threads;
+  for (long i = 0; i < writers; i++) {
+    threads.emplace_back(writer, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  double elapsed = timer.Elapsed();
+  done = true;
+  reader.join();
+  RunResult result{elapsed, retries.load(), scans, max_versions, 0};
+  engine->version_mgr_->CollectGarbage();
+  result.reclaimed_ = engine->version_mgr_->GetReclaimedCount();
+  std::string log_name = engine->disk_mgr_->GetLogFileName();
+  delete engine;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+  return result;
+}
+
+int main(int argc, char **argv) {
+  const long rows = BenchmarkArg(argc, argv, 1, 10000);
+  const long writers = BenchmarkArg(argc, argv, 2, std::max(2u, std::thread::hardware_concurrency()));
+  const long txns_per_writer = BenchmarkArg(argc, argv, 3, 5000);
+
+  printf("%ld rows, %ld writers of %ld transactions\n", rows, writers, txns_per_writer);
+  printf("%-16s %12s %10s %8s %14s %12s\n", "reader", "updates/s", "retries", "scans", "max versions", "reclaimed");
+  for (IsolationLevel level : {IsolationLevel::kRepeatableRead, IsolationLevel::kSnapshot}) {
+    RunResult result = Run(level, rows, writers, txns_per_writer);
+    printf("%-16s %12.0f %10zu %8zu %14zu %12zu\n",
+           level == IsolationLevel::kSnapshot ? "snapshot" : "repeatable read",
+           writers * txns_per_writer / result.elapsed_, result.retries_, result.scans_, result.max_versions_,
+           result.reclaimed_);
+  }
+  return 0;
+}
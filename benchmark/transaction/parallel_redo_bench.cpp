@@ -0,0 +1,97 @@
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+
+/**
+ * Redo time of a crashed database with a growing number of redo workers. A process inserts rows into a
+ * table with an index, in transactions of batch rows each, without a checkpoint, and dies without writing
+ * its buffer pool, so that redo reads the whole log. Every run redoes a fresh copy of the database.
+ *
+ * Usage: parallel_redo_bench [rows] [max_workers] [buffer_pool_size] [batch]
+ */
+static const std::string db_name = "parallel_redo_bench.db";
+static const std::string log_name = "parallel_redo_bench.log";
+
+static void RunChild(long rows, long batch) {
+  SimpleMemHeap heap;
+  auto engine = new DBStorageEngine(db_name, true, 256);
+  engine->checkpoint_mgr_->Stop();
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  engine->catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info);
+  engine->catalog_mgr_->CreateIndex("t", "t_id", {"id"}, nullptr, index_info);
+  char name[64] = "parallel_redo_bench";
+  for (int32_t id = 0; id < rows;) {
+    Transaction *txn = engine->txn_mgr_->Begin();
+    for (long i = 0; i < batch; i++, id++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, static_cast<int32_t>(id * 7919L % rows)),
+                                Field(TypeId::kTypeChar, name, 64, false)};
+      Row row(fields);
+      table_info->GetTableHeap()->InsertTuple(row, txn);
+      index_info->GetIndex()->InsertEntry(index_info->GetIndexKey(row), row.GetRowId(), txn);
+    }
+    engine->txn_mgr_->Commit(txn);
+  }
+  _exit(0);
+}
+
+int main(int argc, char **argv) {
+  const long rows = BenchmarkArg(argc, argv, 1, 200000);
+  const long max_workers = BenchmarkArg(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency()));
+  const long buffer_pool_size = BenchmarkArg(argc, argv, 3, 1024);
+  const long batch = BenchmarkArg(argc, argv, 4, 100);
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+  pid_t pid = fork();
+  if (pid < 0) {
+    return 1;
+  }
+  if (pid == 0) {
+    RunChild(rows, batch);
+  }
+  waitpid(pid, nullptr, 0);
+
+  printf("%ld rows, log of %.1f MB, %ld frames\n", rows, std::filesystem::file_size(log_name) / 1048576.0,
+         buffer_pool_size);
+  printf("%-8s %10s %10s %12s %10s %10s\n", "workers", "records", "redone", "prefetched", "time(ms)", "MB/s");
+  const std::string copy_name = "parallel_redo_bench_copy";
+  for (long workers = 1; workers <= max_workers; workers *= 2) {
+    std::filesystem::copy_file(db_name, copy_name + ".db", std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::copy_file(log_name, copy_name + ".log", std::filesystem::copy_options::overwrite_existing);
+    auto disk_manager = new DiskManager(copy_name + ".db");
+    auto log_manager = new LogManager(disk_manager);
+    auto bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, ReplacerType::kLRU, log_manager);
+    double elapsed;
+    size_t records;
+    size_t redone;
+    {
+      RecoveryManager recovery_manager(disk_manager, bpm, log_manager, workers);
+      BenchmarkTimer timer;
+      recovery_manager.Redo();
+      elapsed = timer.Elapsed();
+      records = recovery_manager.GetRedoRecordCount();
+      redone = recovery_manager.GetRedoneCount();
+    }
+    size_t prefetched = bpm->GetPrefetchCount();
+    delete bpm;
+    delete log_manager;
+    delete disk_manager;
+    printf("%-8ld %10zu %10zu %12zu %10.1f %10.1f\n", workers, records, redone, prefetched, elapsed * 1e3,
+           std::filesystem::file_size(log_name) / 1048576.0 / elapsed);
+  }
+  remove((copy_name + ".db").c_str());
+  remove((copy_name + ".log").c_str());
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+  remove("parallel_redo_bench.dat");
+  return 0;
+}
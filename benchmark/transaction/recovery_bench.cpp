@@ -0,0 +1,105 @@
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "benchmark_utils.h"
+#include "common/instance.h"
+
+/**
+ * Restart time after a crash against the size of the database. A process loads the rows in transactions
+ * of batch rows each, optionally takes a checkpoint, runs tail_txns more transactions and dies without
+ * writing its buffer pool. The restart reads the log from the last checkpoint, or from its begin without one.
+ *
+ * Usage: recovery_bench [min_rows] [max_rows] [tail_txns] [batch]
+ */
+static const std::string db_name = "recovery_bench.db";
+
+static void Insert(TableInfo *table_info, IndexInfo *index_info, int32_t id, Transaction *txn) {
+  char name[32];
+  snprintf(name, sizeof(name), "recovery_bench %d", id);
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, 32, false)};
+  Row row(fields);
+  table_info->GetTableHeap()->InsertTuple(row, txn);
+  index_info->GetIndex()->InsertEntry(index_info->GetIndexKey(row), row.GetRowId(), txn);
+}
+
+/**
+ * Load the database and crash
+ */
+static void RunChild(long rows, long tail_txns, long batch, bool checkpoint) {
+  SimpleMemHeap heap;
+  auto engine = new DBStorageEngine(db_name);
+  engine->checkpoint_mgr_->Stop();
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false)};
+  TableInfo *table_info = nullptr;
+  IndexInfo *index_info = nullptr;
+  engine->catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info);
+  engine->catalog_mgr_->CreateIndex("t", "t_id", {"id"}, nullptr, index_info);
+  int32_t id = 0;
+  auto run = [&]() {
+    Transaction *txn = engine->txn_mgr_->Begin();
+    for (long i = 0; i < batch; i++) {
+      Insert(table_info, index_info, id++, txn);
+    }
+    engine->txn_mgr_->Commit(txn);
+  };
+  while (id < rows) {
+    run();
+  }
+  if (checkpoint) {
+    engine->checkpoint_mgr_->Checkpoint();
+  }
+  for (long i = 0; i < tail_txns; i++) {
+    run();
+  }
+  _exit(0);
+}
+
+static long FileSize(const std::string &file_name) {
+  struct stat st;
+  return stat(file_name.c_str(), &st) == 0 ? static_cast<long>(st.st_size) : 0;
+}
+
+int main(int argc, char **argv) {
+  const long min_rows = BenchmarkArg(argc, argv, 1, 10000);
+  const long max_rows = BenchmarkArg(argc, argv, 2, 160000);
+  const long tail_txns = BenchmarkArg(argc, argv, 3, 100);
+  const long batch = BenchmarkArg(argc, argv, 4, 100);
+  const std::string log_name = "recovery_bench.log";
+  const std::string catalog_name = "recovery_bench.dat";
+
+  printf("%ld transactions of %ld rows after the checkpoint\n", tail_txns, batch);
+  printf("%-10s %-11s %10s %10s %14s\n", "rows", "checkpoint", "db(MB)", "log(MB)", "restart(ms)");
+  for (long rows = min_rows; rows <= max_rows; rows *= 4) {
+    for (bool checkpoint : {false, true}) {
+      remove(db_name.c_str());
+      remove(log_name.c_str());
+      remove(catalog_name.c_str());
+      pid_t pid = fork();
+      if (pid < 0) {
+        return 1;
+      }
+      if (pid == 0) {
+        RunChild(rows, tail_txns, batch, checkpoint);
+      }
+      waitpid(pid, nullptr, 0);
+      double db_size = FileSize(db_name) / 1048576.0;
+      double log_size = FileSize(log_name) / 1048576.0;
+      BenchmarkTimer timer;
+      auto engine = new DBStorageEngine(db_name, false);
+      double elapsed = timer.Elapsed();
+      engine->checkpoint_mgr_->Stop();
+      delete engine;
+      printf("%-10ld %-11s %10.1f %10.1f %14.1f\n", rows, checkpoint ? "yes" : "no", db_size, log_size,
+             elapsed * 1e3);
+    }
+  }
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+  remove(catalog_name.c_str());
+  return 0;
+}
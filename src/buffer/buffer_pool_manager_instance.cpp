@@ -0,0 +1,683 @@
+#include "buffer/buffer_pool_manager_instance.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "buffer/page_log_scope.h"
+#include "glog/logging.h"
+#include "page/bitmap_page.h"
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
+                                                     ReplacerType replacer_type, LogManager *log_manager)
+        : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager), flushing_(pool_size, false),
+          loading_(pool_size), rec_lsns_(pool_size, INVALID_LSN), log_copies_(pool_size),
+          write_lsns_(pool_size, INVALID_LSN), scope_pinned_(pool_size, false) {
+  pages_ = new Page[pool_size_];
+  replacer_ = Replacer::Create(replacer_type, pool_size_);
+  for (size_t i = 0; i < pool_size_; i++) {
+    free_list_.emplace_back(i);
+  }
+}
+
+BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  StopFlusher();
+  {
+    // prefetches write into the frames
+    std::unique_lock<std::recursive_mutex> lock(latch_);
+    while (WaitForLoad(lock)) {
+    }
+  }
+  for (auto page: page_table_) {
+    FlushPage(page.first);
+  }
+  delete[] pages_;
+  delete replacer_;
+}
+
+Page *BufferPoolManagerInstance::FetchPage(page_id_t page_id) {
+  // 1.     Search the page table for the requested page (P).
+  // 1.1    If P exists, pin it and return it immediately.
+  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
+  //        Note that pages are always found from the free list first.
+  // 2.     If R is dirty, write it back to the disk.
+  // 3.     Delete R from the page table and insert P.
+  // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+    std::unique_lock<std::recursive_mutex> lock(latch_);
+    Page *p = nullptr;
+    frame_id_t frame_id = -1;
+    while (true) {
+        auto iter = page_table_.find(page_id);
+        if (iter != page_table_.end()){
+            frame_id = iter->second;
+            p = &pages_[frame_id];
+            p->pin_count_++;
+            // the page is pinned, so its frame is kept while waiting for a prefetch
+            FinishLoad(frame_id, lock);
+            replacer_->Pin(frame_id);
+            TrackPin(frame_id);
+            hit_count_++;
+            return p;
+        }
+        if (FindFreeFrame(&frame_id))
+            break;
+        // all unpinned frames are being written by the flusher or filled by prefetches,
+        // the page may be fetched meanwhile
+        if (!WaitForFlusher(lock) && !WaitForLoad(lock))
+            return nullptr;
+    }
+    miss_count_++;
+    p = &pages_[frame_id];
+    if (page_id != INVALID_PAGE_ID)
+        page_table_.emplace(page_id, frame_id);
+    p->page_id_ = page_id;
+    disk_manager_->ReadPage(page_id, p->GetData());
+    p->pin_count_++;
+    replacer_->Load(frame_id, page_id);
+    replacer_->Pin(frame_id);
+    TrackPin(frame_id);
+    return p;
+}
+
+Page *BufferPoolManagerInstance::NewPageFrom(page_id_t &page_id, PageRunAllocator *allocator) {
+  // 0.   Make sure you call AllocatePage!
+  // 1.   If all the pages in the buffer pool are pinned, return nullptr.
+  // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
+  // 3.   Update P's metadata, zero out memory and add P to the page table.
+  // 4.   Set the page ID output parameter. Return a pointer to P.
+    std::unique_lock<std::recursive_mutex> lock(latch_);
+    frame_id_t frame_id = -1;
+    // find a frame first, so that no page is allocated on disk if all frames are pinned
+    while (!FindFreeFrame(&frame_id)) {
+        if (!WaitForFlusher(lock) && !WaitForLoad(lock))
+            return nullptr;
+    }
+    page_id = allocator == nullptr ? AllocatePage() : allocator->AllocatePage();
+    if (page_id == INVALID_PAGE_ID) {
+        free_list_.push_back(frame_id);
+        return nullptr;
+    }
+    return InitNewPage(page_id, frame_id, lock);
+}
+
+Page *BufferPoolManagerInstance::NewPageWithId(page_id_t page_id) {
+    std::unique_lock<std::recursive_mutex> lock(latch_);
+    frame_id_t frame_id = -1;
+    while (!FindFreeFrame(&frame_id)) {
+        if (!WaitForFlusher(lock) && !WaitForLoad(lock))
+            return nullptr;
+    }
+    return InitNewPage(page_id, frame_id, lock);
+}
+
+Page *BufferPoolManagerInstance::InitNewPage(page_id_t page_id, frame_id_t frame_id,
+                                     std::unique_lock<std::recursive_mutex> &lock) {
+    // a frame may still hold the page from before it was freed, e.g. read ahead through a stale pointer.
+    // The page keeps that frame, so that it is never in two of them
+    auto iter = page_table_.find(page_id);
+    while (iter != page_table_.end() && (loading_[iter->second] != nullptr || flushing_[iter->second])) {
+        if (loading_[iter->second] != nullptr)
+            FinishLoad(iter->second, lock);
+        else
+            WaitForFlusher(lock);
+        iter = page_table_.find(page_id);
+    }
+    Page *p = nullptr;
+    if (iter != page_table_.end()) {
+        free_list_.push_back(frame_id);
+        frame_id = iter->second;
+        p = &pages_[frame_id];
+        // the old content of the page is not needed any more
+        p->is_dirty_ = false;
+        p->ResetMemory();
+        if (p->pin_count_ == 0)
+            ResetFrame(frame_id);
+    } else {
+        p = &pages_[frame_id];
+        page_table_.emplace(page_id, frame_id);
+        p->page_id_ = page_id;
+        replacer_->Load(frame_id, page_id);
+    }
+    p->pin_count_++;
+    replacer_->Pin(frame_id);
+    // logged once the page is pinned, so that the page is in the dirty page table of a checkpoint after it
+    LogPageAllocation(LogRecordType::kAllocatePage, page_id);
+    TrackPin(frame_id);
+    return p;
+}
+
+bool BufferPoolManagerInstance::FindFreeFrame(frame_id_t *frame_id) {
+    if (!free_list_.empty()){
+        *frame_id = free_list_.front();
+        free_list_.pop_front();
+    } else {
+        // prefer a clean victim, whose frame is reused without a write
+        auto clean = [this](frame_id_t frame) { return !pages_[frame].IsDirty() && !flushing_[frame]; };
+        auto not_flushing = [this](frame_id_t frame) { return !flushing_[frame]; };
+        if (!replacer_->VictimIf(frame_id, clean) && !replacer_->VictimIf(frame_id, not_flushing))
+            return false;
+    }
+    Page *p = &pages_[*frame_id];
+    if (p->IsDirty()){
+        FlushLog(GetFrameLSN(*frame_id));
+        disk_manager_->WritePage(p->page_id_, p->GetData());
+        p->is_dirty_ = false;
+        foreground_write_count_++;
+    }
+    page_table_.erase(p->page_id_);
+    p->ResetMemory();
+    p->page_id_ = INVALID_PAGE_ID;
+    ResetFrame(*frame_id);
+    return true;
+}
+
+bool BufferPoolManagerInstance::DeletePage(page_id_t page_id) {
+  // 0.   Make sure you call DeallocatePage!
+  // 1.   Search the page table for the requested page (P).
+  // 1.   If P does not exist, return true.
+  // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
+  // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
+    std::unique_lock<std::recursive_mutex> lock(latch_);
+    // a write of the page by the flusher must not land after the page id is reused
+    WaitForFlusher(lock);
+    frame_id_t frame_id = -1;
+    Page *p = nullptr;
+    auto iter = page_table_.find(page_id);
+    while (iter != page_table_.end() && loading_[iter->second] != nullptr) {
+        FinishLoad(iter->second, lock);
+        iter = page_table_.find(page_id);
+    }
+    // within a page log scope the page is deallocated when the scope has logged its page write
+    PageLogScope *scope = PageLogScope::Current(log_manager_);
+    if (iter == page_table_.end()) {
+        if (scope != nullptr)
+            scope->AddDeletedPage(this, page_id);
+        else
+            DeallocatePage(page_id);
+        return true;
+    }
+    frame_id = iter->second;
+    p = &pages_[frame_id];
+    // apart from the pin of the scope
+    if (p->pin_count_ > (scope_pinned_[frame_id] ? 1 : 0))
+        return false;
+    if (scope != nullptr)
+        scope->AddDeletedPage(this, page_id);
+    else
+        DeallocatePage(page_id);
+    // the content of a deleted page is not needed any more
+    p->is_dirty_ = false;
+    p->pin_count_ = 0;
+    page_table_.erase(page_id);
+    p->ResetMemory();
+    p->page_id_ = INVALID_PAGE_ID;
+    ResetFrame(frame_id);
+    // the frame must not be chosen as a victim while it is in the free list
+    replacer_->Remove(frame_id);
+    free_list_.push_back(frame_id);
+    return true;
+}
+
+bool BufferPoolManagerInstance::UnpinPage(page_id_t page_id, bool is_dirty) {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    frame_id_t frame_id = -1;
+    Page *p = nullptr;
+    auto iter = page_table_.find(page_id);
+    if (iter == page_table_.end())
+        return false;
+    frame_id = iter->second;
+    p = &pages_[frame_id];
+    if (p->pin_count_ <= 0)
+        return false;
+    else{
+        p->pin_count_--;
+        if (p->pin_count_ == 0)
+            replacer_->Unpin(frame_id);
+        if (is_dirty == true)
+            p->is_dirty_ = true;
+        // a page which was only read is not in the dirty page table any more
+        if (p->pin_count_ == 0 && !p->is_dirty_ && !flushing_[frame_id])
+            rec_lsns_[frame_id] = INVALID_LSN;
+    }
+    return true;
+}
+
+bool BufferPoolManagerInstance::FlushPage(page_id_t page_id) {
+    std::unique_lock<std::recursive_mutex> lock(latch_);
+    // an older copy written by the flusher must not land after this write
+    WaitForFlusher(lock);
+    frame_id_t frame_id = -1;
+    Page *p = nullptr;
+    auto iter = page_table_.find(page_id);
+    while (iter != page_table_.end() && loading_[iter->second] != nullptr) {
+        FinishLoad(iter->second, lock);
+        iter = page_table_.find(page_id);
+    }
+    if (page_id == INVALID_PAGE_ID || iter == page_table_.end())
+        return false;
+    frame_id = iter->second;
+    p = &pages_[frame_id];
+    lsn_t next_lsn = GetNextLSN();
+    FlushLog(GetFrameLSN(frame_id));
+    disk_manager_->WritePage(p->page_id_, p->GetData());
+    p->is_dirty_ = false;
+    TrackWrite(frame_id, next_lsn);
+    return true;
+}
+
+void BufferPoolManagerInstance::FlushAllPages() {
+    lsn_t redo_lsn = GetNextLSN();
+    redo_lsn = std::min(redo_lsn, WriteAllPages());
+    // page allocations are persisted together with the pages
+    disk_manager_->FlushMetaData();
+    LogPagesFlushed(redo_lsn);
+}
+
+lsn_t BufferPoolManagerInstance::WriteAllPages() {
+    std::unique_lock<std::recursive_mutex> lock(latch_);
+    WaitForFlusher(lock);
+    Page *p = nullptr;
+    lsn_t next_lsn = GetNextLSN();
+    lsn_t max_lsn = INVALID_LSN;
+    for (size_t i = 0; i < pool_size_; i++) {
+        if (pages_[i].page_id_ != INVALID_PAGE_ID && pages_[i].IsDirty() && !scope_pinned_[i])
+            max_lsn = std::max(max_lsn, GetFrameLSN(i));
+    }
+    FlushLog(max_lsn);
+    lsn_t min_rec_lsn = INT32_MAX;
+    for (size_t i = 0; i < pool_size_; i++) {
+        p = &pages_[i];
+        // the changes of a page log scope are not logged yet
+        if (p->page_id_ != INVALID_PAGE_ID && p->IsDirty() && !scope_pinned_[i]) {
+            disk_manager_->WritePage(p->page_id_, p->GetData());
+            p->is_dirty_ = false;
+            TrackWrite(i, next_lsn);
+        }
+        if (rec_lsns_[i] != INVALID_LSN)
+            min_rec_lsn = std::min(min_rec_lsn, rec_lsns_[i]);
+    }
+    return min_rec_lsn;
+}
+
+void BufferPoolManagerInstance::FlushPagesBefore(lsn_t lsn) {
+    std::unique_lock<std::recursive_mutex> lock(latch_);
+    const size_t max_batch = FlusherOptions().max_pages_per_round;
+    std::vector<char> buffer(max_batch * PAGE_SIZE);
+    std::vector<std::pair<page_id_t, frame_id_t>> batch;
+    size_t cursor = 0;
+    while (cursor < pool_size_) {
+        batch.clear();
+        for (; cursor < pool_size_ && batch.size() < max_batch; cursor++) {
+            Page *p = &pages_[cursor];
+            if (p->page_id_ != INVALID_PAGE_ID && p->pin_count_ == 0 && p->IsDirty() && !flushing_[cursor] &&
+                rec_lsns_[cursor] != INVALID_LSN && rec_lsns_[cursor] < lsn) {
+                batch.emplace_back(p->page_id_, static_cast<frame_id_t>(cursor));
+            }
+        }
+        if (batch.empty())
+            continue;
+        std::sort(batch.begin(), batch.end());
+        WriteBatch(batch, buffer, lock);
+    }
+}
+
+void BufferPoolManagerInstance::GetDirtyPageTable(std::vector<std::pair<page_id_t, lsn_t>> &dirty_pages) {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    for (size_t i = 0; i < pool_size_; i++) {
+        if (pages_[i].page_id_ != INVALID_PAGE_ID && rec_lsns_[i] != INVALID_LSN)
+            dirty_pages.emplace_back(pages_[i].page_id_, rec_lsns_[i]);
+    }
+}
+
+void BufferPoolManagerInstance::LogPagesFlushed(lsn_t redo_lsn) {
+    if (log_manager_ == nullptr)
+        return;
+    disk_manager_->Sync();
+    char data[sizeof(lsn_t) + sizeof(uint64_t)];
+    MACH_WRITE_INT32(data, redo_lsn);
+    MACH_WRITE_TO(uint64_t, data + sizeof(lsn_t), log_manager_->GetOffsetBefore(redo_lsn));
+    LogRecord log_record(LogRecordType::kPagesFlushed, data, sizeof(data));
+    log_manager_->AppendLogRecord(&log_record);
+}
+
+page_id_t BufferPoolManagerInstance::AllocatePage() {
+  int next_page_id = disk_manager_->AllocatePage();
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::DeallocatePage(page_id_t page_id) {
+  disk_manager_->DeAllocatePage(page_id);
+  LogPageAllocation(LogRecordType::kDeallocatePage, page_id);
+}
+
+void BufferPoolManagerInstance::LogPageAllocation(LogRecordType type, page_id_t page_id) {
+  if (log_manager_ != nullptr) {
+    LogRecord log_record(type, page_id);
+    log_manager_->AppendLogRecord(&log_record);
+  }
+}
+
+void BufferPoolManagerInstance::TrackPin(frame_id_t frame_id) {
+  if (log_manager_ == nullptr) {
+    return;
+  }
+  // changes made from now on get an LSN not smaller than this
+  if (rec_lsns_[frame_id] == INVALID_LSN) {
+    rec_lsns_[frame_id] = log_manager_->GetNextLSN();
+  }
+  PageLogScope *scope = PageLogScope::Current(log_manager_);
+  if (scope == nullptr || scope_pinned_[frame_id]) {
+    return;
+  }
+  Page *p = &pages_[frame_id];
+  scope_pinned_[frame_id] = true;
+  p->pin_count_++;
+  if (log_copies_[frame_id] == nullptr) {
+    log_copies_[frame_id].reset(new char[PAGE_SIZE]);
+    memcpy(log_copies_[frame_id].get(), p->GetData(), PAGE_SIZE);
+  }
+  scope->AddFrame(this, frame_id);
+}
+
+void BufferPoolManagerInstance::ResetFrame(frame_id_t frame_id) {
+  if (log_manager_ == nullptr) {
+    return;
+  }
+  rec_lsns_[frame_id] = INVALID_LSN;
+  log_copies_[frame_id].reset();
+  write_lsns_[frame_id] = INVALID_LSN;
+  scope_pinned_[frame_id] = false;
+}
+
+void BufferPoolManagerInstance::TrackWrite(frame_id_t frame_id, lsn_t next_lsn) {
+  if (log_manager_ == nullptr) {
+    return;
+  }
+  // changes made after the content was taken have an LSN not smaller than next_lsn
+  Page *p = &pages_[frame_id];
+  rec_lsns_[frame_id] = p->pin_count_ == 0 && !p->is_dirty_ ? INVALID_LSN : next_lsn;
+}
+
+lsn_t BufferPoolManagerInstance::GetFrameLSN(frame_id_t frame_id) {
+  // the bytes of the page LSN hold other data in pages logged by page writes
+  if (log_manager_ != nullptr && log_copies_[frame_id] != nullptr) {
+    return write_lsns_[frame_id];
+  }
+  return pages_[frame_id].GetLSN();
+}
+
+lsn_t BufferPoolManagerInstance::GetNextLSN() const {
+  return log_manager_ == nullptr ? INVALID_LSN : log_manager_->GetNextLSN();
+}
+
+bool BufferPoolManagerInstance::DiffScopeFrame(frame_id_t frame_id, std::vector<char> &data) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  if (!scope_pinned_[frame_id]) {
+    return false;
+  }
+  Page *p = &pages_[frame_id];
+  return PageLogScope::DiffPage(p->page_id_, log_copies_[frame_id].get(), p->GetData(), data) > 0;
+}
+
+void BufferPoolManagerInstance::ReleaseScopeFrame(frame_id_t frame_id, lsn_t lsn) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  if (!scope_pinned_[frame_id]) {
+    return;
+  }
+  Page *p = &pages_[frame_id];
+  if (memcmp(log_copies_[frame_id].get(), p->GetData(), PAGE_SIZE) != 0) {
+    memcpy(log_copies_[frame_id].get(), p->GetData(), PAGE_SIZE);
+    write_lsns_[frame_id] = lsn;
+    p->is_dirty_ = true;
+  }
+  scope_pinned_[frame_id] = false;
+  p->pin_count_--;
+  if (p->pin_count_ == 0) {
+    replacer_->Unpin(frame_id);
+    if (!p->is_dirty_ && !flushing_[frame_id]) {
+      rec_lsns_[frame_id] = INVALID_LSN;
+    }
+  }
+}
+
+size_t BufferPoolManagerInstance::GetHitCount() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  return hit_count_;
+}
+
+size_t BufferPoolManagerInstance::GetMissCount() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  return miss_count_;
+}
+
+void BufferPoolManagerInstance::StartFlusher(const FlusherOptions &options) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  if (flusher_.joinable()) {
+    return;
+  }
+  flusher_options_ = options;
+  stop_flusher_ = false;
+  flusher_ = std::thread(&BufferPoolManagerInstance::RunFlusher, this);
+}
+
+void BufferPoolManagerInstance::StopFlusher() {
+  {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    if (!flusher_.joinable()) {
+      return;
+    }
+    stop_flusher_ = true;
+    flush_cv_.notify_all();
+  }
+  flusher_.join();
+}
+
+size_t BufferPoolManagerInstance::GetForegroundWriteCount() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  return foreground_write_count_;
+}
+
+size_t BufferPoolManagerInstance::GetBackgroundWriteCount() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  return background_write_count_;
+}
+
+PrefetchResult BufferPoolManagerInstance::PrefetchPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  ReapLoads();
+  auto iter = page_table_.find(page_id);
+  if (iter != page_table_.end()) {
+    return loading_[iter->second] != nullptr ? PrefetchResult::kLoading : PrefetchResult::kResident;
+  }
+  frame_id_t frame_id = -1;
+  // a free page may be named by a stale pointer, it is not read, it would be in the way once allocated again
+  if (page_id < 0 || disk_manager_->IsPageFree(page_id) || !FindFreeFrame(&frame_id)) {
+    return PrefetchResult::kFailed;
+  }
+  Page *p = &pages_[frame_id];
+  page_table_.emplace(page_id, frame_id);
+  p->page_id_ = page_id;
+  // the frame is neither in the free list nor in the replacer until the read completes
+  loading_[frame_id] = disk_manager_->ReadPageAsync(page_id, p->GetData());
+  loading_frames_.push_back(frame_id);
+  prefetch_count_++;
+  return PrefetchResult::kStarted;
+}
+
+bool BufferPoolManagerInstance::PeekPage(page_id_t page_id, const std::function<void(Page *)> &reader) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  ReapLoads();
+  auto iter = page_table_.find(page_id);
+  if (iter == page_table_.end() || loading_[iter->second] != nullptr) {
+    return false;
+  }
+  reader(&pages_[iter->second]);
+  return true;
+}
+
+size_t BufferPoolManagerInstance::GetPrefetchCount() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  return prefetch_count_;
+}
+
+void BufferPoolManagerInstance::ReapLoads() {
+  for (size_t i = 0; i < loading_frames_.size();) {
+    frame_id_t frame_id = loading_frames_[i];
+    if (!loading_[frame_id]->IsDone()) {
+      i++;
+      continue;
+    }
+    loading_[frame_id] = nullptr;
+    loading_frames_[i] = loading_frames_.back();
+    loading_frames_.pop_back();
+    replacer_->Load(frame_id, pages_[frame_id].page_id_);
+    if (pages_[frame_id].pin_count_ == 0) {
+      replacer_->Unpin(frame_id);
+    }
+  }
+}
+
+void BufferPoolManagerInstance::FinishLoad(frame_id_t frame_id, std::unique_lock<std::recursive_mutex> &lock) {
+  AsyncIOHandlePtr handle = loading_[frame_id];
+  if (handle == nullptr) {
+    return;
+  }
+  lock.unlock();
+  handle->Wait();
+  lock.lock();
+  // another thread may have finished the load meanwhile
+  ReapLoads();
+}
+
+bool BufferPoolManagerInstance::WaitForLoad(std::unique_lock<std::recursive_mutex> &lock) {
+  size_t loading_count = loading_frames_.size();
+  ReapLoads();
+  // the frames of the prefetches completed meanwhile can be evicted now
+  if (loading_frames_.size() < loading_count) {
+    return true;
+  }
+  if (loading_frames_.empty()) {
+    return false;
+  }
+  FinishLoad(loading_frames_.front(), lock);
+  return true;
+}
+
+bool BufferPoolManagerInstance::WaitForFlusher(std::unique_lock<std::recursive_mutex> &lock) {
+  if (num_flushing_ == 0) {
+    return false;
+  }
+  flush_cv_.wait(lock, [this]() { return num_flushing_ == 0; });
+  return true;
+}
+
+void BufferPoolManagerInstance::RunFlusher() {
+  std::unique_lock<std::recursive_mutex> lock(latch_);
+  const FlusherOptions options = flusher_options_;
+  const auto low_watermark = static_cast<size_t>(std::ceil(options.low_watermark * pool_size_));
+  const auto high_watermark = static_cast<size_t>(std::ceil(options.high_watermark * pool_size_));
+  // pages are copied out under the latch and written without it, the buffers are reused by every round
+  std::vector<char> buffer(options.max_pages_per_round * PAGE_SIZE);
+  std::vector<std::pair<page_id_t, frame_id_t>> batch;
+  batch.reserve(options.max_pages_per_round);
+  bool active = false;
+  size_t cursor = 0;
+  while (true) {
+    flush_cv_.wait_for(lock, options.interval, [this]() { return stop_flusher_; });
+    if (stop_flusher_) {
+      break;
+    }
+    size_t clean = free_list_.size();
+    for (size_t i = 0; i < pool_size_; i++) {
+      if (pages_[i].page_id_ != INVALID_PAGE_ID && pages_[i].pin_count_ == 0 && !pages_[i].IsDirty()) {
+        clean++;
+      }
+    }
+    if (clean < low_watermark) {
+      active = true;
+    } else if (clean >= high_watermark) {
+      active = false;
+    }
+    if (!active) {
+      continue;
+    }
+    // take dirty unpinned pages round robin over the frames
+    size_t target = std::min(high_watermark - clean, options.max_pages_per_round);
+    batch.clear();
+    for (size_t n = 0; n < pool_size_ && batch.size() < target; n++, cursor = (cursor + 1) % pool_size_) {
+      Page *p = &pages_[cursor];
+      // a checkpoint may be writing the page as well
+      if (p->page_id_ != INVALID_PAGE_ID && p->pin_count_ == 0 && p->IsDirty() && !flushing_[cursor]) {
+        batch.emplace_back(p->page_id_, static_cast<frame_id_t>(cursor));
+      }
+    }
+    if (batch.empty()) {
+      // every frame is pinned
+      continue;
+    }
+    // pages with consecutive ids are written together
+    std::sort(batch.begin(), batch.end());
+    WriteBatch(batch, buffer, lock);
+    background_write_count_ += batch.size();
+  }
+}
+
+void BufferPoolManagerInstance::WriteBatch(const std::vector<std::pair<page_id_t, frame_id_t>> &batch,
+                                   std::vector<char> &buffer, std::unique_lock<std::recursive_mutex> &lock) {
+  lsn_t next_lsn = GetNextLSN();
+  lsn_t max_lsn = INVALID_LSN;
+  for (size_t i = 0; i < batch.size(); i++) {
+    Page *p = &pages_[batch[i].second];
+    memcpy(buffer.data() + i * PAGE_SIZE, p->GetData(), PAGE_SIZE);
+    max_lsn = std::max(max_lsn, GetFrameLSN(batch[i].second));
+    // a page dirtied again during the write is dirty again when it is unpinned
+    p->is_dirty_ = false;
+    flushing_[batch[i].second] = true;
+  }
+  num_flushing_ += batch.size();
+  lock.unlock();
+  FlushLog(max_lsn);
+  // every run of consecutive pages is one write, all of them in flight at once
+  std::vector<PageIORequest> requests;
+  size_t begin = 0;
+  for (size_t i = 1; i <= batch.size(); i++) {
+    if (i == batch.size() || batch[i].first != batch[i - 1].first + 1) {
+      requests.push_back(PageIORequest{true, batch[begin].first, buffer.data() + begin * PAGE_SIZE, i - begin});
+      begin = i;
+    }
+  }
+  for (auto &handle : disk_manager_->SubmitBatch(requests)) {
+    handle->Wait();
+  }
+  lock.lock();
+  for (auto &entry : batch) {
+    flushing_[entry.second] = false;
+    TrackWrite(entry.second, next_lsn);
+  }
+  num_flushing_ -= batch.size();
+  flush_cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::FlushLog(lsn_t lsn) {
+  // a log manager only waits for records it has appended, so pages which are not logged do not wait
+  if (log_manager_ != nullptr && lsn != INVALID_LSN) {
+    log_manager_->Flush(lsn);
+  }
+}
+
+bool BufferPoolManagerInstance::IsPageFree(page_id_t page_id) {
+  return disk_manager_->IsPageFree(page_id);
+}
+
+// Only used for debug
+bool BufferPoolManagerInstance::CheckAllUnpinned() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  bool res = true;
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (pages_[i].pin_count_ != 0) {
+      res = false;
+      LOG(ERROR) << "page " << pages_[i].page_id_ << " pin count:" << pages_[i].pin_count_ << endl;
+    }
+  }
+  return res;
+}
\ No newline at end of file
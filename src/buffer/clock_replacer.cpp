@@ -0,0 +1,70 @@
+#include "buffer/clock_replacer.h"
+
+ClockReplacer::ClockReplacer(size_t num_pages)
+        : num_pages_(num_pages), in_replacer_(num_pages, false), referenced_(num_pages, false) {}
+
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  if (size_ == 0) {
+    return false;
+  }
+  // every frame in the replacer has its bit cleared after one round, so two rounds always find a victim
+  while (true) {
+    size_t frame = hand_;
+    hand_ = (hand_ + 1) % num_pages_;
+    if (!in_replacer_[frame]) {
+      continue;
+    }
+    if (referenced_[frame]) {
+      referenced_[frame] = false;
+      continue;
+    }
+    in_replacer_[frame] = false;
+    size_--;
+    *frame_id = static_cast<frame_id_t>(frame);
+    return true;
+  }
+}
+
+bool ClockReplacer::VictimIf(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &predicate) {
+  if (size_ == 0) {
+    return false;
+  }
+  // frames failing the predicate keep their bit, so give up if two rounds find no victim
+  for (size_t step = 0; step < 2 * num_pages_; step++) {
+    size_t frame = hand_;
+    hand_ = (hand_ + 1) % num_pages_;
+    if (!in_replacer_[frame] || !predicate(static_cast<frame_id_t>(frame))) {
+      continue;
+    }
+    if (referenced_[frame]) {
+      referenced_[frame] = false;
+      continue;
+    }
+    in_replacer_[frame] = false;
+    size_--;
+    *frame_id = static_cast<frame_id_t>(frame);
+    return true;
+  }
+  return false;
+}
+
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  if (!in_replacer_[frame_id]) {
+    return;
+  }
+  in_replacer_[frame_id] = false;
+  size_--;
+}
+
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  if (in_replacer_[frame_id]) {
+    return;
+  }
+  in_replacer_[frame_id] = true;
+  referenced_[frame_id] = true;
+  size_++;
+}
+
+size_t ClockReplacer::Size() {
+  return size_;
+}
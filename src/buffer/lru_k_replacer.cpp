@@ -0,0 +1,117 @@
+#include "buffer/lru_k_replacer.h"
+
+#include <algorithm>
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k)
+        : num_pages_(num_pages), k_(k), history_(num_pages * k, 0), ref_counts_(num_pages, 0),
+          evictable_(num_pages, false), page_ids_(num_pages, INVALID_PAGE_ID),
+          retained_history_(2 * num_pages * k, 0), retained_ref_counts_(2 * num_pages, 0),
+          retained_page_ids_(2 * num_pages, INVALID_PAGE_ID) {}
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  return VictimIf(frame_id, [](frame_id_t) { return true; });
+}
+
+bool LRUKReplacer::VictimIf(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &predicate) {
+  if (size_ == 0) {
+    return false;
+  }
+  frame_id_t victim = INVALID_FRAME_ID;
+  bool victim_infinite = false;
+  uint64_t victim_timestamp = 0;
+  for (size_t i = 0; i < num_pages_; i++) {
+    if (!evictable_[i] || !predicate(static_cast<frame_id_t>(i))) {
+      continue;
+    }
+    bool infinite = ref_counts_[i] < k_;
+    // least recent reference for infinite distances, K-th most recent reference otherwise
+    uint64_t timestamp = infinite ? (ref_counts_[i] == 0 ? 0 : history_[i * k_]) : history_[i * k_ + k_ - 1];
+    if (victim == INVALID_FRAME_ID || (infinite && !victim_infinite) ||
+        (infinite == victim_infinite && timestamp < victim_timestamp)) {
+      victim = static_cast<frame_id_t>(i);
+      victim_infinite = infinite;
+      victim_timestamp = timestamp;
+    }
+  }
+  if (victim == INVALID_FRAME_ID) {
+    return false;
+  }
+  evictable_[victim] = false;
+  size_--;
+  RetainHistory(victim);
+  ResetHistory(victim);
+  *frame_id = victim;
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  if (frame_id != last_accessed_frame_) {
+    uint64_t *history = &history_[frame_id * k_];
+    for (size_t i = k_ - 1; i > 0; i--) {
+      history[i] = history[i - 1];
+    }
+    history[0] = ++current_timestamp_;
+    if (ref_counts_[frame_id] < k_) {
+      ref_counts_[frame_id]++;
+    }
+    last_accessed_frame_ = frame_id;
+  }
+  if (evictable_[frame_id]) {
+    evictable_[frame_id] = false;
+    size_--;
+  }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  if (evictable_[frame_id]) {
+    return;
+  }
+  evictable_[frame_id] = true;
+  size_++;
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  if (evictable_[frame_id]) {
+    evictable_[frame_id] = false;
+    size_--;
+  }
+  ResetHistory(frame_id);
+}
+
+void LRUKReplacer::Load(frame_id_t frame_id, page_id_t page_id) {
+  page_ids_[frame_id] = page_id;
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  size_t slot = static_cast<size_t>(page_id) % retained_page_ids_.size();
+  if (retained_page_ids_[slot] != page_id) {
+    return;
+  }
+  std::copy_n(&retained_history_[slot * k_], k_, &history_[frame_id * k_]);
+  ref_counts_[frame_id] = retained_ref_counts_[slot];
+  retained_page_ids_[slot] = INVALID_PAGE_ID;
+}
+
+size_t LRUKReplacer::Size() {
+  return size_;
+}
+
+void LRUKReplacer::RetainHistory(frame_id_t frame_id) {
+  page_id_t page_id = page_ids_[frame_id];
+  if (page_id == INVALID_PAGE_ID || ref_counts_[frame_id] == 0) {
+    return;
+  }
+  // a collision simply overwrites the older entry
+  size_t slot = static_cast<size_t>(page_id) % retained_page_ids_.size();
+  std::copy_n(&history_[frame_id * k_], k_, &retained_history_[slot * k_]);
+  retained_ref_counts_[slot] = ref_counts_[frame_id];
+  retained_page_ids_[slot] = page_id;
+}
+
+void LRUKReplacer::ResetHistory(frame_id_t frame_id) {
+  ref_counts_[frame_id] = 0;
+  page_ids_[frame_id] = INVALID_PAGE_ID;
+  if (last_accessed_frame_ == frame_id) {
+    last_accessed_frame_ = INVALID_FRAME_ID;
+  }
+}
@@ -1,8 +1,7 @@
 #include "buffer/lru_replacer.h"
 
 
-LRUReplacer::LRUReplacer(size_t num_pages):_num_pages(num_pages){
-  lrumap.reserve(this->_num_pages);
+LRUReplacer::LRUReplacer(size_t num_pages):_num_pages(num_pages),lrulist(num_pages){
 }
 
 LRUReplacer::~LRUReplacer() = default;
@@ -11,29 +10,36 @@ bool LRUReplacer::Victim(frame_id_t *frame_id) {
   if(Size()==0){
     return false;
   }
-  *frame_id = lrulist.back();
-  lrumap.erase(*frame_id);
-  lrulist.pop_back();
+  *frame_id = lrulist.Back();
+  lrulist.Remove(*frame_id);
   return true;
 }
 
+bool LRUReplacer::VictimIf(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &predicate) {
+  for(frame_id_t frame = lrulist.Back(); frame != lrulist.End(); frame = lrulist.Prev(frame)){
+    if(predicate(frame)){
+      lrulist.Remove(frame);
+      *frame_id = frame;
+      return true;
+    }
+  }
+  return false;
+}
+
 void LRUReplacer::Pin(frame_id_t frame_id) {
   /**避免重复pin一个页面（找不到该page）*/
-  if(lrumap.find(frame_id) == lrumap.end()){return;}
-  lrulist.erase(lrumap[frame_id]);
-  lrumap.erase(frame_id);
+  if(!lrulist.Contains(frame_id)){return;}
+  lrulist.Remove(frame_id);
 }
 
 void LRUReplacer::Unpin(frame_id_t frame_id) {
   /**避免重复unpin（已有该page）*/
-  if(lrumap.count(frame_id)!=0){
+  if(lrulist.Contains(frame_id)){
     return;
   }
-  lrulist.push_front(frame_id);
-  lrumap.emplace(frame_id,lrulist.begin());
+  lrulist.PushFront(frame_id);
 }
 
 size_t LRUReplacer::Size() {
-  /**返回lrumap的大小作为现在的size*/
-  return lrumap.size();
-}
\ No newline at end of file
+  return lrulist.Size();
+}
@@ -0,0 +1,126 @@
+#include "buffer/page_log_scope.h"
+
+#include <algorithm>
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+thread_local PageLogScope *PageLogScope::current_ = nullptr;
+
+// equal bytes between two changes which are logged rather than starting a new range
+static constexpr size_t RANGE_MERGE_GAP = 8;
+
+PageLogScope::PageLogScope(LogManager *log_manager) {
+  if (log_manager == nullptr || current_ != nullptr) {
+    return;
+  }
+  log_manager_ = log_manager;
+  lock_ = std::unique_lock<std::mutex>(log_manager->page_log_latch_);
+  current_ = this;
+}
+
+PageLogScope::~PageLogScope() {
+  if (log_manager_ == nullptr) {
+    return;
+  }
+  std::vector<char> data(sizeof(uint32_t));
+  uint32_t page_count = 0;
+  for (auto &frame : frames_) {
+    page_count += frame.first->DiffScopeFrame(frame.second, data) ? 1 : 0;
+  }
+  lsn_t lsn = INVALID_LSN;
+  if (page_count > 0) {
+    MACH_WRITE_UINT32(data.data(), page_count);
+    LogRecord log_record(LogRecordType::kPageWrite, data.data(), static_cast<uint32_t>(data.size()));
+    lsn = log_manager_->AppendLogRecord(&log_record);
+  }
+  for (auto &frame : frames_) {
+    frame.first->ReleaseScopeFrame(frame.second, lsn);
+  }
+  for (auto &page : deleted_pages_) {
+    page.first->DeallocatePage(page.second);
+  }
+  current_ = nullptr;
+}
+
+PageLogScope *PageLogScope::Current(LogManager *log_manager) {
+  if (current_ == nullptr || log_manager == nullptr || current_->log_manager_ != log_manager) {
+    return nullptr;
+  }
+  return current_;
+}
+
+void PageLogScope::AddFrame(BufferPoolManagerInstance *buffer_pool_manager, frame_id_t frame_id) {
+  auto frame = std::make_pair(buffer_pool_manager, frame_id);
+  // a frame freed within the scope may be reused by it
+  if (std::find(frames_.begin(), frames_.end(), frame) == frames_.end()) {
+    frames_.push_back(frame);
+  }
+}
+
+void PageLogScope::AddDeletedPage(BufferPoolManagerInstance *buffer_pool_manager, page_id_t page_id) {
+  deleted_pages_.emplace_back(buffer_pool_manager, page_id);
+}
+
+uint32_t PageLogScope::DiffPage(page_id_t page_id, const char *old_data, const char *new_data,
+                                std::vector<char> &data) {
+  size_t header = data.size();
+  uint32_t range_count = 0;
+  size_t i = 0;
+  while (i < PAGE_SIZE) {
+    if (old_data[i] == new_data[i]) {
+      i++;
+      continue;
+    }
+    if (range_count == 0) {
+      data.resize(header + 2 * sizeof(uint32_t));
+    }
+    size_t begin = i;
+    size_t end = i + 1;
+    for (size_t j = end; j < PAGE_SIZE && j - end < RANGE_MERGE_GAP; j++) {
+      if (old_data[j] != new_data[j]) {
+        end = j + 1;
+      }
+    }
+    size_t offset = data.size();
+    data.resize(offset + 2 * sizeof(uint16_t) + (end - begin));
+    MACH_WRITE_TO(uint16_t, data.data() + offset, static_cast<uint16_t>(begin));
+    MACH_WRITE_TO(uint16_t, data.data() + offset + 2, static_cast<uint16_t>(end - begin));
+    memcpy(data.data() + offset + 4, new_data + begin, end - begin);
+    range_count++;
+    i = end;
+  }
+  if (range_count > 0) {
+    MACH_WRITE_INT32(data.data() + header, page_id);
+    MACH_WRITE_UINT32(data.data() + header + 4, range_count);
+  }
+  return range_count;
+}
+
+std::vector<PageLogScope::PageWrite> PageLogScope::ParsePageWrite(const char *data, uint32_t size) {
+  std::vector<PageWrite> pages;
+  const char *end = data + size;
+  uint32_t page_count = MACH_READ_UINT32(data);
+  data += sizeof(uint32_t);
+  for (uint32_t i = 0; i < page_count && data < end; i++) {
+    PageWrite page;
+    page.page_id_ = MACH_READ_INT32(data);
+    page.range_count_ = MACH_READ_UINT32(data + 4);
+    data += 2 * sizeof(uint32_t);
+    page.ranges_ = data;
+    for (uint32_t j = 0; j < page.range_count_; j++) {
+      data += 2 * sizeof(uint16_t) + MACH_READ_FROM(uint16_t, data + 2);
+    }
+    pages.push_back(page);
+  }
+  return pages;
+}
+
+void PageLogScope::ApplyPageWrite(const PageWrite &page_write, char *page_data) {
+  const char *range = page_write.ranges_;
+  for (uint32_t i = 0; i < page_write.range_count_; i++) {
+    uint16_t offset = MACH_READ_FROM(uint16_t, range);
+    uint16_t length = MACH_READ_FROM(uint16_t, range + 2);
+    memcpy(page_data + offset, range + 4, length);
+    range += 2 * sizeof(uint16_t) + length;
+  }
+}
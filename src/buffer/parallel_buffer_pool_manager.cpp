@@ -0,0 +1,170 @@
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, ReplacerType replacer_type,
+                                                     LogManager *log_manager)
+        : disk_manager_(disk_manager), log_manager_(log_manager), pool_size_per_instance_(pool_size) {
+  ASSERT(num_instances > 0, "Buffer pool needs at least one instance.");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.push_back(new BufferPoolManagerInstance(pool_size, disk_manager, replacer_type, log_manager));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  for (auto instance : instances_) {
+    delete instance;
+  }
+}
+
+Page *ParallelBufferPoolManager::FetchPage(page_id_t page_id) {
+  return GetInstance(page_id)->FetchPage(page_id);
+}
+
+bool ParallelBufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  return GetInstance(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPage(page_id_t page_id) {
+  return GetInstance(page_id)->FlushPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPageFrom(page_id_t &page_id, PageRunAllocator *allocator) {
+  // the id decides the instance, so it has to be allocated before a frame is taken. Ids of instances with all
+  // their frames pinned are held until a page is made, so that the following ids are handed out
+  std::vector<bool> full(instances_.size(), false);
+  size_t num_full = 0;
+  std::vector<page_id_t> skipped;
+  Page *page = nullptr;
+  while (page == nullptr && num_full < instances_.size()) {
+    page_id = allocator == nullptr ? disk_manager_->AllocatePage() : allocator->AllocatePage();
+    if (page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    size_t index = static_cast<size_t>(page_id) % instances_.size();
+    if (!full[index]) {
+      page = instances_[index]->NewPageWithId(page_id);
+    }
+    if (page == nullptr) {
+      if (!full[index]) {
+        full[index] = true;
+        num_full++;
+      }
+      skipped.push_back(page_id);
+    }
+  }
+  // logged like any deallocation, a skipped id may be allocated in the metadata on disk already
+  for (auto skipped_page_id : skipped) {
+    GetInstance(skipped_page_id)->DeallocatePage(skipped_page_id);
+  }
+  if (page == nullptr) {
+    page_id = INVALID_PAGE_ID;
+  }
+  return page;
+}
+
+bool ParallelBufferPoolManager::DeletePage(page_id_t page_id) {
+  return GetInstance(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPages() {
+  // one pages flushed record once every instance is written
+  lsn_t redo_lsn = instances_.front()->GetNextLSN();
+  for (auto instance : instances_) {
+    redo_lsn = std::min(redo_lsn, instance->WriteAllPages());
+  }
+  disk_manager_->FlushMetaData();
+  instances_.front()->LogPagesFlushed(redo_lsn);
+}
+
+void ParallelBufferPoolManager::FlushPagesBefore(lsn_t lsn) {
+  for (auto instance : instances_) {
+    instance->FlushPagesBefore(lsn);
+  }
+}
+
+void ParallelBufferPoolManager::GetDirtyPageTable(std::vector<std::pair<page_id_t, lsn_t>> &dirty_pages) {
+  for (auto instance : instances_) {
+    instance->GetDirtyPageTable(dirty_pages);
+  }
+}
+
+bool ParallelBufferPoolManager::IsPageFree(page_id_t page_id) {
+  return disk_manager_->IsPageFree(page_id);
+}
+
+bool ParallelBufferPoolManager::CheckAllUnpinned() {
+  bool res = true;
+  for (auto instance : instances_) {
+    res = instance->CheckAllUnpinned() && res;
+  }
+  return res;
+}
+
+size_t ParallelBufferPoolManager::GetHitCount() {
+  size_t count = 0;
+  for (auto instance : instances_) {
+    count += instance->GetHitCount();
+  }
+  return count;
+}
+
+size_t ParallelBufferPoolManager::GetMissCount() {
+  size_t count = 0;
+  for (auto instance : instances_) {
+    count += instance->GetMissCount();
+  }
+  return count;
+}
+
+PrefetchResult ParallelBufferPoolManager::PrefetchPage(page_id_t page_id) {
+  if (page_id < 0) {
+    return PrefetchResult::kFailed;
+  }
+  return GetInstance(page_id)->PrefetchPage(page_id);
+}
+
+bool ParallelBufferPoolManager::PeekPage(page_id_t page_id, const std::function<void(Page *)> &reader) {
+  if (page_id < 0) {
+    return false;
+  }
+  return GetInstance(page_id)->PeekPage(page_id, reader);
+}
+
+size_t ParallelBufferPoolManager::GetPrefetchCount() {
+  size_t count = 0;
+  for (auto instance : instances_) {
+    count += instance->GetPrefetchCount();
+  }
+  return count;
+}
+
+void ParallelBufferPoolManager::StartFlusher(const FlusherOptions &options) {
+  for (auto instance : instances_) {
+    instance->StartFlusher(options);
+  }
+}
+
+void ParallelBufferPoolManager::StopFlusher() {
+  for (auto instance : instances_) {
+    instance->StopFlusher();
+  }
+}
+
+size_t ParallelBufferPoolManager::GetForegroundWriteCount() {
+  size_t count = 0;
+  for (auto instance : instances_) {
+    count += instance->GetForegroundWriteCount();
+  }
+  return count;
+}
+
+size_t ParallelBufferPoolManager::GetBackgroundWriteCount() {
+  size_t count = 0;
+  for (auto instance : instances_) {
+    count += instance->GetBackgroundWriteCount();
+  }
+  return count;
+}
@@ -0,0 +1,53 @@
+#include "buffer/read_ahead.h"
+
+#include <algorithm>
+
+ScanReadAhead::ScanReadAhead(BufferPoolManager *buffer_pool_manager, NextPageFunc next_page_id, size_t max_window)
+        : buffer_pool_manager_(buffer_pool_manager), next_page_id_(std::move(next_page_id)), max_window_(max_window),
+          window_(std::min(MIN_WINDOW, max_window)) {}
+
+void ScanReadAhead::Advance(page_id_t page_id) {
+  if (max_window_ == 0) {
+    return;
+  }
+  if (page_id != current_page_id_) {
+    current_page_id_ = page_id;
+    auto iter = std::find(ahead_.begin(), ahead_.end(), page_id);
+    if (iter == ahead_.end()) {
+      // the scan left the chain read so far, e.g. a new page was linked in
+      ahead_.clear();
+      end_reached_ = false;
+    } else {
+      ahead_.erase(ahead_.begin(), iter + 1);
+      PrefetchResult result = buffer_pool_manager_->PrefetchPage(page_id);
+      if (result == PrefetchResult::kLoading) {
+        // the scan waits for the read, so read further ahead
+        window_ = std::min(window_ * 2, max_window_);
+      } else if (result == PrefetchResult::kStarted) {
+        // evicted before it was used, the read ahead pages do not fit into the buffer pool
+        window_ = std::max(window_ / 2, std::min(MIN_WINDOW, max_window_));
+      }
+    }
+  }
+  Fill();
+}
+
+void ScanReadAhead::Fill() {
+  page_id_t last_page_id = ahead_.empty() ? current_page_id_ : ahead_.back();
+  while (!end_reached_ && ahead_.size() < window_) {
+    page_id_t next_page_id = INVALID_PAGE_ID;
+    if (!buffer_pool_manager_->PeekPage(last_page_id, [&](Page *page) { next_page_id = next_page_id_(page); })) {
+      // the last page is still being read, continue on the next step
+      return;
+    }
+    if (next_page_id < 0) {
+      end_reached_ = true;
+      return;
+    }
+    if (buffer_pool_manager_->PrefetchPage(next_page_id) == PrefetchResult::kFailed) {
+      return;
+    }
+    ahead_.push_back(next_page_id);
+    last_page_id = next_page_id;
+  }
+}
@@ -0,0 +1,21 @@
+#include "buffer/replacer.h"
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/two_queue_replacer.h"
+
+Replacer *Replacer::Create(ReplacerType type, size_t num_pages) {
+  switch (type) {
+    case ReplacerType::kClock:
+      return new ClockReplacer(num_pages);
+    case ReplacerType::kLRUK:
+      return new LRUKReplacer(num_pages);
+    case ReplacerType::k2Q:
+      return new TwoQueueReplacer(num_pages);
+    case ReplacerType::kLRU:
+    default:
+      break;
+  }
+  return new LRUReplacer(num_pages);
+}
@@ -0,0 +1,97 @@
+#include "buffer/two_queue_replacer.h"
+
+#include <utility>
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_pages)
+        : a1_max_size_(num_pages / 4 > 0 ? num_pages / 4 : 1), a1_(num_pages), am_(num_pages),
+          queues_(num_pages, Queue::kNone) {}
+
+bool TwoQueueReplacer::Victim(frame_id_t *frame_id) {
+  if (Size() == 0) {
+    return false;
+  }
+  if (!a1_.Empty() && (a1_count_ > a1_max_size_ || am_.Empty())) {
+    *frame_id = a1_.Back();
+    a1_.Remove(*frame_id);
+  } else {
+    *frame_id = am_.Back();
+    am_.Remove(*frame_id);
+  }
+  Reset(*frame_id);
+  return true;
+}
+
+bool TwoQueueReplacer::VictimIf(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &predicate) {
+  FrameList *first = &am_, *second = &a1_;
+  if (!a1_.Empty() && (a1_count_ > a1_max_size_ || am_.Empty())) {
+    std::swap(first, second);
+  }
+  for (FrameList *queue : {first, second}) {
+    for (frame_id_t frame = queue->Back(); frame != queue->End(); frame = queue->Prev(frame)) {
+      if (predicate(frame)) {
+        queue->Remove(frame);
+        Reset(frame);
+        *frame_id = frame;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void TwoQueueReplacer::Pin(frame_id_t frame_id) {
+  if (a1_.Contains(frame_id)) {
+    a1_.Remove(frame_id);
+  } else if (am_.Contains(frame_id)) {
+    am_.Remove(frame_id);
+  }
+  if (frame_id == last_accessed_frame_) {
+    return;
+  }
+  last_accessed_frame_ = frame_id;
+  if (queues_[frame_id] == Queue::kNone) {
+    queues_[frame_id] = Queue::kA1;
+    a1_count_++;
+  } else if (queues_[frame_id] == Queue::kA1) {
+    queues_[frame_id] = Queue::kAm;
+    a1_count_--;
+  }
+}
+
+void TwoQueueReplacer::Unpin(frame_id_t frame_id) {
+  if (a1_.Contains(frame_id) || am_.Contains(frame_id)) {
+    return;
+  }
+  if (queues_[frame_id] == Queue::kAm) {
+    am_.PushFront(frame_id);
+    return;
+  }
+  if (queues_[frame_id] == Queue::kNone) {
+    queues_[frame_id] = Queue::kA1;
+    a1_count_++;
+  }
+  a1_.PushFront(frame_id);
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  if (a1_.Contains(frame_id)) {
+    a1_.Remove(frame_id);
+  } else if (am_.Contains(frame_id)) {
+    am_.Remove(frame_id);
+  }
+  Reset(frame_id);
+}
+
+size_t TwoQueueReplacer::Size() {
+  return a1_.Size() + am_.Size();
+}
+
+void TwoQueueReplacer::Reset(frame_id_t frame_id) {
+  if (queues_[frame_id] == Queue::kA1) {
+    a1_count_--;
+  }
+  queues_[frame_id] = Queue::kNone;
+  if (last_accessed_frame_ == frame_id) {
+    last_accessed_frame_ = INVALID_FRAME_ID;
+  }
+}
@@ -2,6 +2,8 @@
 //#include <iostream>
 //#include <fstream>
 #include<cstring>
+#include <fcntl.h>
+#include <unistd.h>
 
 void CatalogMeta::SerializeTo(char *buf) const {
   // ASSERT(false, "Not Implemented yet");
@@ -98,14 +100,16 @@ CatalogMeta::CatalogMeta(){}
 
 
 CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager,
-                               LogManager *log_manager, bool init)
+                               LogManager *log_manager, bool init, VersionManager *version_manager)
         : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager),
-          log_manager_(log_manager),heap_(new SimpleMemHeap()){
+          log_manager_(log_manager),version_manager_(version_manager),heap_(new SimpleMemHeap()){
   // ASSERT(false, "Not Implemented yet");
   if(init){
     next_table_id_ = 0;
     next_index_id_ = 0;
     catalog_meta_ = CatalogMeta::NewInstance(heap_);
+    //replace the catalog of an earlier database of the same name
+    WriteCatalog();
   }
   else{
     ReadCatalog();
@@ -127,7 +131,9 @@ void CatalogManager::WriteCatalog(){
   std::string db_file_name = buffer_pool_manager_->GetDiskManager()->GetFileName();
   db_file_name = db_file_name.substr(0,db_file_name.find_last_of('.'));
   db_file_name +=".dat";
-  outfile.open(db_file_name);
+  // written aside and renamed over the old one, so a crash leaves either of them whole
+  std::string tmp_file_name = db_file_name + ".tmp";
+  outfile.open(tmp_file_name, ios::out | ios::binary | ios::trunc);
   //catalog_size
   uint32_t catalog_size=catalog_meta_->GetSerializedSize();
   outfile<<catalog_size<<endl;
@@ -177,6 +183,12 @@ void CatalogManager::WriteCatalog(){
 
   }
   outfile.close();
+  int fd = open(tmp_file_name.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    fsync(fd);
+    close(fd);
+  }
+  rename(tmp_file_name.c_str(), db_file_name.c_str());
 }
 // store order: catalog_size->catalog_meta->next_table_id_->next_index_id_->table_size->
 // foreach(tables_id->table_meta_size->table_meta->index_size->
@@ -189,18 +201,23 @@ void CatalogManager::ReadCatalog(){
   db_file_name = db_file_name.substr(0,db_file_name.find_last_of('.'));
   db_file_name +=".dat";
   ifstream infile(db_file_name,ios::in|ios::binary);
+  //no catalog written yet: a database crashed before its first table was created
   if(!infile){
-    cout<<"ERROR"<<endl;
+    next_table_id_ = 0;
+    next_index_id_ = 0;
+    catalog_meta_ = CatalogMeta::NewInstance(heap_);
+    return;
   }
 //  infile.open(db_file_name,ios::in);
   //catalog_size
   char catalog_size_[MAX_FILE_SIZE];
-//  uint32_t catalog_size = 0;
   infile.getline(catalog_size_,MAX_FILE_SIZE);
-//  uint32_t catalog_size = atoi(catalog_size_);
-  //catalog_meta
+  uint32_t catalog_size = atoi(catalog_size_);
+  //catalog_meta, the serialized blobs may hold line breaks so they are read by their size
   char *catalog_meta = reinterpret_cast<char *>(heap_->Allocate(PAGE_SIZE));
-  infile.getline(catalog_meta,MAX_FILE_SIZE);
+  memset(catalog_meta,0,PAGE_SIZE);
+  infile.read(catalog_meta,catalog_size);
+  infile.ignore(1);
   catalog_meta_ = CatalogMeta::DeserializeFrom(catalog_meta,heap_);
 //  //flag
 //  char flag_[MAX_FILE_SIZE];
@@ -232,9 +249,18 @@ void CatalogManager::ReadCatalog(){
     uint32_t table_meta_size = atoi(table_meta_size_);
     //table_meta
     char *table_meta_ = reinterpret_cast<char *>(heap_->Allocate(PAGE_SIZE));
-    infile.getline(table_meta_,table_meta_size+1);
+    //the columns of a schema end at a zero byte
+    memset(table_meta_,0,PAGE_SIZE);
+    infile.read(table_meta_,table_meta_size);
+    infile.ignore(1);
     TableMetadata *table_meta;
     TableMetadata::DeserializeFrom(table_meta_,table_meta,heap_);
+    //the rows of a table in an older format would be misread as garbage, such a database is refused
+    if(table_meta->GetRowFormatVersion() != ROW_FORMAT_VERSION){
+      LOG(FATAL) << "Table " << table_meta->GetTableName() << " stores rows in format version "
+                 << table_meta->GetRowFormatVersion() << ", which can not be read, only version "
+                 << ROW_FORMAT_VERSION << " can. Recreate the database to open it." << std::endl;
+    }
     //load table
     LoadTable(table_id,INVALID_PAGE_ID,table_meta);
     //index_size
@@ -252,7 +278,9 @@ void CatalogManager::ReadCatalog(){
       uint32_t index_meta_size = atoi(index_meta_size_);
       //index_meta
       char *index_meta_ = reinterpret_cast<char *>(heap_->Allocate(PAGE_SIZE));
-      infile.getline(index_meta_,index_meta_size+1);
+      memset(index_meta_,0,PAGE_SIZE);
+      infile.read(index_meta_,index_meta_size);
+      infile.ignore(1);
       IndexMetadata *index_meta;
       IndexMetadata::DeserializeFrom(index_meta_,index_meta,heap_);
       //load index
@@ -290,14 +318,15 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   if(table_names_.count(table_name)!=0)return DB_TABLE_ALREADY_EXIST;
   //create table heap
   TableHeap *table = TableHeap::Create(buffer_pool_manager_,schema,txn,
-                                       log_manager_,lock_manager_,heap_);
+                                       log_manager_,lock_manager_,heap_,version_manager_);
   //fetch table_id
   const auto table_id = next_table_id_.fetch_add(1);
   //create table meta::tag::page_id分配问题
   page_id_t page_id;
   buffer_pool_manager_->NewPage(page_id);
-  auto table_meta = TableMetadata::Create(table_id,table_name,
-                                          page_id,schema,heap_);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  auto table_meta = TableMetadata::Create(table_id,table_name,table->GetFirstPageId(),
+                                          table->GetFreeSpaceMapPageId(),schema,heap_);
   //table_info
   table_info= TableInfo::Create(heap_);
   table_info->Init(table_meta,table);
@@ -307,7 +336,7 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   table_names_.emplace(table_name, table_id);
   index_names_.emplace(table_name, std::unordered_map<std::string, index_id_t>{});
   catalog_meta_->table_meta_pages_.insert(pair<table_id_t, page_id_t>(table_id,page_id));
-  return DB_SUCCESS;
+  return FlushCatalogMetaPage();
 }
 
 dberr_t CatalogManager::GetTable(const string &table_name, TableInfo *&table_info) {
@@ -334,9 +363,35 @@ dberr_t CatalogManager::GetTables(vector<TableInfo *> &tables) const {
   return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::ReportFragmentation(std::ostream &os) const {
+  char line[128];
+  snprintf(line, sizeof(line), "%-32s %10s %10s %10s", "object", "pages", "runs", "avg run");
+  os << line << std::endl;
+  // tables and their indexes by name
+  std::map<std::string, table_id_t> table_names(table_names_.begin(), table_names_.end());
+  for (auto &table : table_names) {
+    PageRunStats stats = tables_.at(table.second)->GetTableHeap()->GetPageRunStats();
+    snprintf(line, sizeof(line), "%-32s %10zu %10zu %10.1f", ("table " + table.first).c_str(), stats.num_pages,
+             stats.num_runs, stats.AverageRunLength());
+    os << line << std::endl;
+    auto index_names = index_names_.find(table.first);
+    if (index_names == index_names_.end()) {
+      continue;
+    }
+    std::map<std::string, index_id_t> sorted_index_names(index_names->second.begin(), index_names->second.end());
+    for (auto &index : sorted_index_names) {
+      stats = indexes_.at(index.second)->GetIndex()->GetPageRunStats();
+      snprintf(line, sizeof(line), "%-32s %10zu %10zu %10.1f", ("index " + table.first + "." + index.first).c_str(),
+               stats.num_pages, stats.num_runs, stats.AverageRunLength());
+      os << line << std::endl;
+    }
+  }
+  return DB_SUCCESS;
+}
+
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Transaction *txn,
-                                    IndexInfo *&index_info) {
+                                    IndexInfo *&index_info, bool unique, IndexType index_type) {
   // ASSERT(false, "Not Implemented yet");
   // table not exist
   if(table_names_.find(table_name) == table_names_.end()) return DB_TABLE_NOT_EXIST;
@@ -361,18 +416,35 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
     if(it == columns.end()) return DB_COLUMN_NAME_NOT_EXIST;
     key_map.push_back(oi);
   }
+  //a key has to fit in the largest generic key, with the row id at its end for a non-unique B+ tree index
+  std::vector<Column *> key_columns;
+  for(auto column_index : key_map) key_columns.push_back(columns[column_index]);
+  Schema key_schema(key_columns);
+  if(IndexInfo::GetKeyMaxSize(&key_schema, unique, index_type) > GENERIC_KEY_MAX_SIZE) return DB_INDEX_KEY_TOO_LONG;
 
   //index metadata
   const auto index_id = next_index_id_.fetch_add(1);
   const auto table_id = table_names_.find(table_name)->second;
-  auto meta = IndexMetadata::Create(index_id,index_name,table_id,key_map,heap_);
+  auto meta = IndexMetadata::Create(index_id,index_name,table_id,key_map,heap_,unique,index_type);
   //index info
   index_info = IndexInfo::Create(heap_);
   index_info->Init(meta,table,buffer_pool_manager_);
+  //build the index out of the rows already in the table, a unique one is not created if their keys are not
+  dberr_t ret = index_info->GetIndex()->BulkLoad(table->GetTableHeap(), key_map, txn);
+  if(ret != DB_SUCCESS){
+    //the pages built before the failure are given back, and the index is forgotten
+    index_info->GetIndex()->Destroy();
+    index_info->~IndexInfo();
+    heap_->Free(index_info);
+    meta->~IndexMetadata();
+    heap_->Free(meta);
+    index_info = nullptr;
+    return ret;
+  }
   //update internal tracking
   indexes_.emplace(index_id,index_info);
   table_indexes.emplace(index_name,index_id);
-  return DB_SUCCESS;
+  return FlushCatalogMetaPage();
 }
 
 dberr_t CatalogManager::GetIndex(const std::string &table_name, const std::string &index_name,
@@ -388,6 +460,13 @@ dberr_t CatalogManager::GetIndex(const std::string &table_name, const std::strin
   return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::GetIndex(index_id_t index_id, IndexInfo *&index_info) const {
+  auto index = indexes_.find(index_id);
+  if (index == indexes_.end()) return DB_INDEX_NOT_FOUND;
+  index_info = index->second;
+  return DB_SUCCESS;
+}
+
 dberr_t CatalogManager::GetTableIndexes(const std::string &table_name, std::vector<IndexInfo *> &indexes) const {
   // ASSERT(false, "Not Implemented yet");
   //ensure the table exists
@@ -411,6 +490,9 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
   if(table_names_.find(table_name)==table_names_.end()) return DB_TABLE_NOT_EXIST;
   //table_id
   auto table_id = table_names_.find(table_name)->second;
+  if (version_manager_ != nullptr) {
+    version_manager_->Forget(tables_[table_id]->GetTableHeap());
+  }
   //erase from table_names_
   table_names_.erase(table_name);
   //erase from tables_
@@ -422,7 +504,7 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
   //erase from indexes_
   for(auto i:indexes) indexes_.erase(i.second);
 
-  return DB_SUCCESS;
+  return FlushCatalogMetaPage();
 }
 
 dberr_t CatalogManager::DropIndex(const string &index_name) {
@@ -443,9 +525,12 @@ dberr_t CatalogManager::DropIndex(const string &index_name) {
   return DB_SUCCESS;
 }
 
-dberr_t CatalogManager::FlushCatalogMetaPage() const {
-  // ASSERT(false, "Not Implemented yet");
-  return DB_FAILED;
+dberr_t CatalogManager::FlushCatalogMetaPage() {
+  // the pages of a table or an index created meanwhile, e.g. by a bulk load, are not all in the log:
+  // they reach the disk before the catalog naming them does
+  buffer_pool_manager_->FlushAllPages();
+  WriteCatalog();
+  return DB_SUCCESS;
 }
 // map for tables
 //std::unordered_map<std::string, table_id_t> table_names_; //1
@@ -458,8 +543,9 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
   //table_names
   table_names_.emplace(table_meta->GetTableName(),table_id);
   //create table heap
-  TableHeap *table = TableHeap::Create(buffer_pool_manager_,table_meta->GetFirstPageId(),table_meta->GetSchema(),
-                                       log_manager_,lock_manager_,heap_);
+  TableHeap *table = TableHeap::Create(buffer_pool_manager_,table_meta->GetFirstPageId(),
+                                       table_meta->GetFreeSpaceMapPageId(),table_meta->GetSchema(),
+                                       log_manager_,lock_manager_,heap_,version_manager_);
   //TableInfo
   TableInfo *table_info;
   table_info= TableInfo::Create(heap_);
@@ -2,9 +2,9 @@
 
 IndexMetadata *IndexMetadata::Create(const index_id_t index_id, const string &index_name,
                                      const table_id_t table_id, const vector<uint32_t> &key_map,
-                                     MemHeap *heap) {
+                                     MemHeap *heap, bool unique, IndexType index_type) {
   void *buf = heap->Allocate(sizeof(IndexMetadata));
-  return new(buf)IndexMetadata(index_id, index_name, table_id, key_map);
+  return new(buf)IndexMetadata(index_id, index_name, table_id, key_map, unique, index_type);
 }
 
 uint32_t IndexMetadata::SerializeTo(char *buf) const {
@@ -18,6 +18,17 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
   //magic_num
   memcpy(newbuf,&INDEX_METADATA_MAGIC_NUM,sizeof(uint32_t));
   newbuf+=sizeof(uint32_t);
+  //key_format_version_
+  memcpy(newbuf,&key_format_version_,sizeof(uint32_t));
+  newbuf+=sizeof(uint32_t);
+  //unique_
+  uint32_t unique = unique_;
+  memcpy(newbuf,&unique,sizeof(uint32_t));
+  newbuf+=sizeof(uint32_t);
+  //index_type_
+  uint32_t index_type = static_cast<uint32_t>(index_type_);
+  memcpy(newbuf,&index_type,sizeof(uint32_t));
+  newbuf+=sizeof(uint32_t);
   //index_id
   memcpy(newbuf,&index_id_, sizeof(index_id_t));
   newbuf+=sizeof(index_id_t);
@@ -49,8 +60,8 @@ uint32_t IndexMetadata::GetSerializedSize() const {
   //  table_id_t table_id_;
   //  std::vector<uint32_t> key_map_;
   uint32_t size=0;
-  //magic_num
-  size += sizeof(uint32_t);
+  //magic_num, key_format_version, unique and index_type
+  size += 4*sizeof(uint32_t);
   //available data
   size += sizeof(index_id_t)+2*sizeof(uint32_t)+index_name_.length()+sizeof(table_id_t)+key_map_.size()*sizeof(uint32_t);
   return size;
@@ -70,8 +81,30 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta, M
   uint32_t  key_map_l;
   std::vector<uint32_t> _key_map_;
   //magic_num
-  //    uint32_t magic_num = MACH_READ_UINT32(newbuf);
+  uint32_t magic_num = MACH_READ_UINT32(newbuf);
   newbuf += sizeof(uint32_t);
+  //key_format_version_
+  uint32_t key_format_version = 1;
+  bool unique = true;
+  IndexType index_type = IndexType::kBPlusTree;
+  if(magic_num == INDEX_METADATA_MAGIC_NUM || magic_num == B_PLUS_TREE_INDEX_METADATA_MAGIC_NUM ||
+     magic_num == UNIQUE_INDEX_METADATA_MAGIC_NUM){
+    key_format_version = MACH_READ_UINT32(newbuf);
+    newbuf += sizeof(uint32_t);
+  }
+  //unique_
+  if(magic_num == INDEX_METADATA_MAGIC_NUM || magic_num == B_PLUS_TREE_INDEX_METADATA_MAGIC_NUM){
+    unique = MACH_READ_UINT32(newbuf) != 0;
+    newbuf += sizeof(uint32_t);
+  }
+  else if(magic_num != UNIQUE_INDEX_METADATA_MAGIC_NUM){
+    ASSERT(magic_num == LEGACY_INDEX_METADATA_MAGIC_NUM, "Invalid index metadata.");
+  }
+  //index_type_
+  if(magic_num == INDEX_METADATA_MAGIC_NUM){
+    index_type = static_cast<IndexType>(MACH_READ_UINT32(newbuf));
+    newbuf += sizeof(uint32_t);
+  }
   //index_id_
   _index_id_ = MACH_READ_FROM(index_id_t ,(newbuf));
   newbuf += sizeof(index_id_t);
@@ -92,6 +125,7 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta, M
   }
   //copy
   void *mem = heap->Allocate(sizeof(IndexMetadata));
-  index_meta = new(mem)IndexMetadata(_index_id_,_index_name_,_table_id_,_key_map_);
+  index_meta = new(mem)IndexMetadata(_index_id_,_index_name_,_table_id_,_key_map_,unique,index_type,
+                                         key_format_version);
   return newbuf - buf;
 }
\ No newline at end of file
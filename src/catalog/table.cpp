@@ -10,6 +10,9 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
   //magic_num
   memcpy(newbuf,&TABLE_METADATA_MAGIC_NUM,sizeof(uint32_t));
   newbuf += sizeof(uint32_t);
+  //row_format_version_
+  memcpy(newbuf,&row_format_version_,sizeof(uint32_t));
+  newbuf += sizeof(uint32_t);
   //  table_id_t table_id_;
   memcpy(newbuf,&table_id_,sizeof(table_id_t));
   newbuf += sizeof(table_id_t);
@@ -21,6 +24,9 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
   //  page_id_t root_page_id_;
   memcpy(newbuf,&root_page_id_,sizeof(page_id_t));
   newbuf += sizeof(page_id_t);
+  //  page_id_t free_space_map_page_id_;
+  memcpy(newbuf,&free_space_map_page_id_,sizeof(page_id_t));
+  newbuf += sizeof(page_id_t);
   //  Schema *schema_;
   newbuf += schema_->SerializeTo(newbuf);
   return newbuf-buf;
@@ -28,10 +34,10 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
 
 uint32_t TableMetadata::GetSerializedSize() const {
   uint32_t size=0;
-  //magic_num
-  size += sizeof(uint32_t);
+  //magic_num and row_format_version
+  size += 2*sizeof(uint32_t);
   //available data
-  size += sizeof(table_id_t)+sizeof(uint32_t)+table_name_.length()+sizeof(page_id_t)+schema_->GetSerializedSize();
+  size += sizeof(table_id_t)+sizeof(uint32_t)+table_name_.length()+2*sizeof(page_id_t)+schema_->GetSerializedSize();
   return size;
 }
 
@@ -49,11 +55,22 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
   uint32_t  table_name_l;
   std::string _table_name_;
   page_id_t _root_page_id_;
+  page_id_t _free_space_map_page_id_;
   std::vector<Column *> columns;
   auto *_schema_ = new Schema(columns);
   //magic_num
-  //    uint32_t magic_num = MACH_READ_UINT32(newbuf);
+  uint32_t magic_num = MACH_READ_UINT32(newbuf);
   newbuf += sizeof(uint32_t);
+  if(magic_num != TABLE_METADATA_MAGIC_NUM && magic_num != LEGACY_TABLE_METADATA_MAGIC_NUM){
+    LOG(FATAL) << "Invalid table metadata magic number " << magic_num << "." << std::endl;
+  }
+  bool legacy = magic_num == LEGACY_TABLE_METADATA_MAGIC_NUM;
+  //row_format_version_, legacy metadata has none and its rows are in format version 1
+  uint32_t row_format_version = 1;
+  if(!legacy){
+    row_format_version = MACH_READ_UINT32(newbuf);
+    newbuf += sizeof(uint32_t);
+  }
   //table_id_
   _table_id_ = MACH_READ_FROM(table_id_t ,(newbuf));
   newbuf += sizeof(table_id_t);
@@ -65,11 +82,18 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
   //root_page_id
   _root_page_id_ = MACH_READ_FROM(page_id_t,(newbuf));
   newbuf += sizeof(page_id_t);
+  //free_space_map_page_id, legacy metadata has none
+  _free_space_map_page_id_ = INVALID_PAGE_ID;
+  if(!legacy){
+    _free_space_map_page_id_ = MACH_READ_FROM(page_id_t,(newbuf));
+    newbuf += sizeof(page_id_t);
+  }
   //schema
   newbuf += _schema_->DeserializeFrom(newbuf, _schema_, heap);
   //copy
   void *mem = heap->Allocate(sizeof(TableMetadata));
-  table_meta = new(mem)TableMetadata(_table_id_,_table_name_,_root_page_id_,_schema_);
+  table_meta = new(mem)TableMetadata(_table_id_,_table_name_,_root_page_id_,_free_space_map_page_id_,_schema_,
+                                     row_format_version);
   return newbuf - buf;
 }
 
@@ -78,12 +102,15 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
  *
  * @param heap Memory heap passed by TableInfo
  */
-TableMetadata *TableMetadata::Create(table_id_t table_id, std::string table_name,
-                                     page_id_t root_page_id, TableSchema *schema, MemHeap *heap) {
+TableMetadata *TableMetadata::Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
+                                     page_id_t free_space_map_page_id, TableSchema *schema, MemHeap *heap) {
   // allocate space for table metadata
   void *buf = heap->Allocate(sizeof(TableMetadata));
-  return new(buf)TableMetadata(table_id, table_name, root_page_id, schema);
+  return new(buf)TableMetadata(table_id, table_name, root_page_id, free_space_map_page_id, schema);
 }
 
-TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema)
-        : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), schema_(schema) {}
+TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id,
+                             page_id_t free_space_map_page_id, TableSchema *schema, uint32_t row_format_version)
+        : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id),
+          free_space_map_page_id_(free_space_map_page_id), schema_(schema),
+          row_format_version_(row_format_version) {}
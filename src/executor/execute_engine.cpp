@@ -1,4 +1,16 @@
 #include "executor/execute_engine.h"
+
+#include <algorithm>
+
+#include "executor/executors/delete_executor.h"
+#include "executor/executors/filter_executor.h"
+#include "executor/executors/index_range_scan_executor.h"
+#include "executor/executors/index_scan_executor.h"
+#include "executor/executors/insert_executor.h"
+#include "executor/executors/projection_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+#include "executor/executors/update_executor.h"
+#include "executor/predicate.h"
 #include "glog/logging.h"
 extern "C" {
 int yyparse(void);
@@ -83,6 +95,10 @@ dberr_t ExecuteEngine::ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *cont
         cout << "Error : Can't drop database '" << ast->child_->val_ << "'; database doesn't exist";
         return DB_FAILED;
     }
+    if (context->txn_ != nullptr) {
+        cout << "Error : Transaction in progress";
+        return DB_FAILED;
+    }
     delete dbs_[ast->child_->val_];
     dbs_.erase(ast->child_->val_);
     cout << "Success!";
@@ -116,6 +132,10 @@ dberr_t ExecuteEngine::ExecuteUseDatabase(pSyntaxNode ast, ExecuteContext *conte
         cout << "Error : Unknown database '" << ast->child_->val_ << "'";
         return DB_FAILED;
     }
+    if (context->txn_ != nullptr) {
+        cout << "Error : Transaction in progress";
+        return DB_FAILED;
+    }
     current_db_ = ast->child_->val_;
     current_db = dbs_[current_db_];
     cout << "Success!";
@@ -216,7 +236,17 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
         }
         IndexInfo *index_info = nullptr;
         string primary_key_index_name = new_table_name + "_primary_key";
-        current_db->catalog_mgr_->CreateIndex(new_table_name, primary_key_index_name, primary_keys, nullptr, index_info);
+        dberr_t create_index = current_db->catalog_mgr_->CreateIndex(new_table_name, primary_key_index_name,
+                                                                     primary_keys, nullptr, index_info);
+        if (create_index != DB_SUCCESS) {
+            // a table is not kept without the index of its primary key
+            current_db->catalog_mgr_->DropTable(new_table_name);
+            if (create_index == DB_INDEX_KEY_TOO_LONG)
+                cout << "Error : Primary key is too long!";
+            else
+                cout << "Error : Create Primary Key Index Failed!";
+            return create_index;
+        }
     }
 //    //unique index
 //    for (auto & iterator : new_table_column){
@@ -279,14 +309,36 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
 //  Schema* table_schema = cur_table->GetSchema();
 //  MemHeap* cur_heap;
 //  mgr->GetHeap(cur_heap);
-  pointer = pointer->next_->child_;
+  pointer = pointer->next_;
+  IndexType index_type = IndexType::kBPlusTree;
+  if (pointer->next_ != nullptr && pointer->next_->type_ == kNodeIndexType) {
+    std::string type_name = pointer->next_->child_->val_;
+    if (type_name == "hash") {
+      index_type = IndexType::kHash;
+    } else if (type_name != "bptree" && type_name != "btree") {
+      cout << "Error : Unknown index type '" << type_name << "'" << endl;
+      return DB_FAILED;
+    }
+  }
+  pointer = pointer->child_;
   std::vector<std::string> index_child;
   while(pointer != nullptr && pointer->type_ == kNodeIdentifier) {
     index_child.push_back(pointer->val_);
     pointer = pointer->next_;
   }
   IndexInfo* index_info;
-  mgr->CreateIndex(new_index_table, new_index, index_child, nullptr, index_info);
+  // only the index of the primary key is unique
+  dberr_t ret = mgr->CreateIndex(new_index_table, new_index, index_child, nullptr, index_info, false, index_type);
+  if (ret == DB_FAILED) {
+    cout << "Error : Duplicate key for index!" << endl;
+    return ret;
+  } else if (ret == DB_INDEX_KEY_TOO_LONG) {
+    cout << "Error : Index key is too long!" << endl;
+    return ret;
+  } else if (ret != DB_SUCCESS) {
+    cout << "Create Index Failed!" << endl;
+    return ret;
+  }
   return DB_SUCCESS;
 }
 
@@ -306,404 +358,194 @@ dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context
   return DB_SUCCESS;
 }
 
-vector<Row*> rec_sel(pSyntaxNode sn, std::vector<Row*>& r, TableInfo* t, CatalogManager* c){
-    if(sn == nullptr) return r;
-    if(sn->type_ == kNodeConnector){
+/**
+ * @return the value of a column given in a statement, null if the statement gives none
+ */
+static Field ParseValue(TypeId type, const char *val) {
+    if (val == nullptr)
+        return Field(type);
+    if (type == kTypeInt)
+        return Field(kTypeInt, atoi(val));
+    if (type == kTypeFloat)
+        return Field(kTypeFloat, static_cast<float>(atof(val)));
+    return Field(kTypeChar, const_cast<char *>(val), strlen(val), true);
+}
 
-        vector<Row*> ans;
-        if(strcmp(sn->val_,"and") == 0){
-            auto r1 = rec_sel(sn->child_,r,t,c);
-            ans = rec_sel(sn->child_->next_,r1,t,c);
-            return ans;
-        }
-        else if(strcmp(sn->val_,"or") == 0){
-            auto r1 = rec_sel(sn->child_,r,t,c);
-            auto r2 = rec_sel(sn->child_->next_,r,t,c);
-            for(uint32_t i=0;i<r1.size();i++){
-                ans.push_back(r1[i]);
-            }
-            for(uint32_t i=0;i<r2.size();i++){
-                int flag=1;
-                for(uint32_t j=0;j<r1.size();j++){
-                    int f=1;
-                    for(uint32_t k=0;k<r1[i]->GetFieldCount();k++){
-                        if(!r1[i]->GetField(k)->CompareEquals(*r2[j]->GetField(k))){
-                            f=0;break;
-                        }
-                    }
-                    if(f==1){
-                        flag=0;//���ظ�
-                        break;}
-                }
-                if(flag==1) ans.push_back(r2[i]);
-            }
-            return ans;
-        }
+/**
+ * Build the predicate of the conditions of a where clause
+ */
+static dberr_t BuildPredicate(pSyntaxNode node, Schema *schema, std::unique_ptr<Predicate> &predicate) {
+    if (node->type_ == kNodeConnector) {
+        std::unique_ptr<Predicate> left, right;
+        dberr_t ret = BuildPredicate(node->child_, schema, left);
+        if (ret != DB_SUCCESS)
+            return ret;
+        ret = BuildPredicate(node->child_->next_, schema, right);
+        if (ret != DB_SUCCESS)
+            return ret;
+        predicate = std::make_unique<LogicalPredicate>(strcmp(node->val_, "and") == 0, std::move(left), std::move(right));
+        return DB_SUCCESS;
     }
-    if(sn->type_ == kNodeCompareOperator){
-        string op = sn->val_;
-        string col_name = sn->child_->val_;
-        string val = sn->child_->next_->val_;
-        uint32_t keymap;
-        vector<Row*> ans;
-        if(t->GetSchema()->GetColumnIndex(col_name, keymap)!=DB_SUCCESS){
-            cout<<"column not found"<<endl;
-            return ans;
-        }
-        const Column* key_col = t->GetSchema()->GetColumn(keymap);
-        TypeId type =  key_col->GetType();
-
-        if(op == "="){
-            if(type==kTypeInt)
-            {
-                int valint = std::stoi(val);
-                Field benchmk(type,int(valint));
-                vector<Field> vect_benchmk;
-                vect_benchmk.push_back(benchmk);
-
-                vector <IndexInfo*> indexes;
-                c->GetTableIndexes(t->GetTableName(),indexes);
-                for(auto p=indexes.begin();p<indexes.end();p++){
-                    if((*p)->GetIndexKeySchema()->GetColumnCount()==1){
-                        if((*p)->GetIndexKeySchema()->GetColumns()[0]->GetName()==col_name){
-                            // cout<<"--select using index--"<<endl;
-                            Row tmp_row(vect_benchmk);
-                            vector<RowId> result;
-                            (*p)->GetIndex()->ScanKey(tmp_row,result,nullptr);
-                            for(auto q:result){
-                                if(q.GetPageId()<0) continue;
-                                Row *tr = new Row(q);
-                                t->GetTableHeap()->GetTuple(tr,nullptr);
-                                ans.push_back(tr);
-                            }
-                            return ans;
-                        }
-                    }
-                }
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareEquals(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-
-            else if(type==kTypeFloat)
-            {
-                float valfloat = std::stof(val);
-                Field benchmk(type,float(valfloat));
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareEquals(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-
-            else if(type==kTypeChar){
-                char *ch = new char[val.size()];
-                strcpy(ch,val.c_str());
-                Field benchmk = Field(TypeId::kTypeChar, const_cast<char *>(ch), val.size(), true);
-                vector<Field> vect_benchmk;
-                vect_benchmk.push_back(benchmk);
-
-                vector <IndexInfo*> indexes;
-                c->GetTableIndexes(t->GetTableName(),indexes);
-                for(auto p=indexes.begin();p<indexes.end();p++){
-                    if((*p)->GetIndexKeySchema()->GetColumnCount()==1){
-                        if((*p)->GetIndexKeySchema()->GetColumns()[0]->GetName()==col_name){
-                            clock_t s,e;
-                            s=clock();
-                            Row tmp_row(vect_benchmk);
-                            vector<RowId> result;
-                            (*p)->GetIndex()->ScanKey(tmp_row,result,nullptr);
-                            e=clock();
-                            cout<<"name index select takes "<<double(e-s)/CLOCKS_PER_SEC<<"s to Execute."<<endl;
-                            for(auto q:result){
-                                if(q.GetPageId()<0) continue;
-                                Row *tr = new Row(q);
-                                t->GetTableHeap()->GetTuple(tr,nullptr);
-                                ans.push_back(tr);
-                            }
-                            return ans;
-                        }
-                    }
-                }
-
-                for(uint32_t i=0;i<r.size();i++){
-                    const char* test = r[i]->GetField(keymap)->GetData();
-
-                    if(strcmp(test,ch)==0){
-                        vector<Field> f;
-                        for(auto it:r[i]->GetFields()){
-                            f.push_back(*it);
-                        }
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-        }
-        else if(op == "<"){
-            if(type==kTypeInt)
-            {
-                int valint = std::stoi(val);
-                Field benchmk(type,int(valint));
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareLessThan(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-            else if(type==kTypeFloat)
-            {
-                float valfloat = std::stof(val);
-                Field benchmk(type,float(valfloat));
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareLessThan(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-            else if(type==kTypeChar){
-                char* ch = new char[key_col->GetLength()+2];
-                strcpy(ch,val.c_str());
-                for(uint32_t i=0;i<r.size();i++){
-                    const char* test = r[i]->GetField(keymap)->GetData();
-                    if(strcmp(test,ch)<0){
-                        vector<Field> f;
-                        for(auto it:r[i]->GetFields()){
-                            f.push_back(*it);
-                        }
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-        }
-        else if(op == ">"){
-            if(type==kTypeInt)
-            {
-                int valint = std::stoi(val);
-                Field benchmk(type,int(valint));
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareGreaterThan(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-            else if(type==kTypeFloat)
-            {
-                float valfloat = std::stof(val);
-                Field benchmk(type,float(valfloat));
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareGreaterThan(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-            else if(type==kTypeChar){
-                char* ch = new char[key_col->GetLength()];
-                strcpy(ch,val.c_str());//�Ƚ�Ŀ�����ch��
-
-                for(uint32_t i=0;i<r.size();i++){
-                    const char* test = r[i]->GetField(keymap)->GetData();
+    static const std::unordered_map<std::string, CompareType> compare_types = {
+            {"=", CompareType::kEqual}, {"<>", CompareType::kNotEqual},
+            {"<", CompareType::kLessThan}, {"<=", CompareType::kLessThanOrEqual},
+            {">", CompareType::kGreaterThan}, {">=", CompareType::kGreaterThanOrEqual},
+            {"is", CompareType::kIsNull}, {"not", CompareType::kIsNotNull}};
+    if (node->type_ != kNodeCompareOperator || compare_types.count(node->val_) == 0)
+        return DB_FAILED;
+    uint32_t column_index;
+    if (schema->GetColumnIndex(node->child_->val_, column_index) != DB_SUCCESS)
+        return DB_COLUMN_NAME_NOT_EXIST;
+    Field value = ParseValue(schema->GetColumn(column_index)->GetType(), node->child_->next_->val_);
+    predicate = std::make_unique<ComparePredicate>(column_index, compare_types.at(node->val_), value);
+    return DB_SUCCESS;
+}
 
-                    if(strcmp(test,ch)>0){
-                        vector<Field> f;
-                        for(auto it:r[i]->GetFields()){
-                            f.push_back(*it);
-                        }
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
+/**
+ * Collect the comparisons with a constant every row satisfying the predicate satisfies, the keys and
+ * bounds an index scan can look up
+ */
+static void CollectConjuncts(const Predicate *predicate, std::vector<const ComparePredicate *> &conjuncts) {
+    if (auto compare = dynamic_cast<const ComparePredicate *>(predicate)) {
+        if (!compare->GetValue().IsNull())
+            conjuncts.push_back(compare);
+    } else if (auto logical = dynamic_cast<const LogicalPredicate *>(predicate)) {
+        if (logical->IsAnd()) {
+            CollectConjuncts(logical->GetLeft(), conjuncts);
+            CollectConjuncts(logical->GetRight(), conjuncts);
         }
-        else if(op == "<="){
-            if(type==kTypeInt)
-            {
-                int valint = std::stoi(val);
-                Field benchmk(type,int(valint));
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareLessThanEquals(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-            else if(type==kTypeFloat)
-            {
-                float valfloat = std::stof(val);
-                Field benchmk(type,float(valfloat));
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareLessThanEquals(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-            else if(type==kTypeChar){
-                char* ch = new char[key_col->GetLength()];
-                strcpy(ch,val.c_str());
+    }
+}
 
-                for(uint32_t i=0;i<r.size();i++){
-                    const char* test = r[i]->GetField(keymap)->GetData();
+/**
+ * @param equality whether the index is probed for a single value, a hash index is preferred for it,
+ * and only a B+ tree can scan a range
+ * @return the index whose key is exactly the column, nullptr if there is none
+ */
+static IndexInfo *FindColumnIndex(const vector<IndexInfo *> &indexes, uint32_t column_index, bool equality) {
+    IndexInfo *found = nullptr;
+    for (auto index_info : indexes) {
+        const auto &key_map = index_info->GetIndexMeta()->GetKeyMapping();
+        if (key_map.size() != 1 || key_map[0] != column_index)
+            continue;
+        // a hash index probes a key in one bucket, but only answers lookups of whole keys
+        bool hash = index_info->GetIndexMeta()->GetIndexType() == IndexType::kHash;
+        if (hash && equality)
+            return index_info;
+        if (!hash && found == nullptr)
+            found = index_info;
+    }
+    return found;
+}
 
-                    if(strcmp(test,ch)<=0){
-                        vector<Field> f;
-                        for(auto it:r[i]->GetFields()){
-                            f.push_back(*it);
-                        }
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-        }
-        else if(op == ">="){
-            if(type==kTypeInt)
-            {
-                int valint = std::stoi(val);
-                Field benchmk(type,int(valint));
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareGreaterThanEquals(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-            else if(type==kTypeFloat)
-            {
-                float valfloat = std::stof(val);
-                Field benchmk(type,float(valfloat));
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareGreaterThanEquals(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
+/**
+ * Narrow the bounds of a column to the tightest ones the comparisons on it imply
+ * @return false if none of the comparisons bounds the column
+ */
+static bool CollectBounds(const std::vector<const ComparePredicate *> &conjuncts, uint32_t column_index,
+                          const Field *&lo, bool &lo_inclusive, const Field *&hi, bool &hi_inclusive) {
+    lo = hi = nullptr;
+    lo_inclusive = hi_inclusive = true;
+    for (auto compare : conjuncts) {
+        if (compare->GetColumnIndex() != column_index)
+            continue;
+        const Field &value = compare->GetValue();
+        switch (compare->GetCompareType()) {
+            case CompareType::kGreaterThan:
+            case CompareType::kGreaterThanOrEqual: {
+                bool inclusive = compare->GetCompareType() == CompareType::kGreaterThanOrEqual;
+                if (lo == nullptr || value.CompareGreaterThan(*lo) == CmpBool::kTrue ||
+                    (value.CompareEquals(*lo) == CmpBool::kTrue && !inclusive)) {
+                    lo = &value;
+                    lo_inclusive = inclusive;
                 }
-            }
-            else if(type==kTypeChar){
-                char* ch = new char[key_col->GetLength()];
-                strcpy(ch,val.c_str());
-
-                for(uint32_t i=0;i<r.size();i++){
-                    const char* test = r[i]->GetField(keymap)->GetData();
-
-                    if(strcmp(test,ch)>=0){
-                        vector<Field> f;
-                        for(auto it:r[i]->GetFields()){
-                            f.push_back(*it);
-                        }
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
+                break;
+            }
+            case CompareType::kLessThan:
+            case CompareType::kLessThanOrEqual: {
+                bool inclusive = compare->GetCompareType() == CompareType::kLessThanOrEqual;
+                if (hi == nullptr || value.CompareLessThan(*hi) == CmpBool::kTrue ||
+                    (value.CompareEquals(*hi) == CmpBool::kTrue && !inclusive)) {
+                    hi = &value;
+                    hi_inclusive = inclusive;
                 }
+                break;
             }
+            default:
+                break;
         }
-        else if(op == "<>"){
-            if(type==kTypeInt)
-            {
-                int valint = std::stoi(val);
-                Field benchmk(type,int(valint));
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareNotEquals(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-            else if(type==kTypeFloat)
-            {
-                float valfloat = std::stof(val);
-                Field benchmk(type,float(valfloat));
-                for(uint32_t i=0;i<r.size();i++){
-                    if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-                        cout<<"not comparable"<<endl;
-                        return ans;
-                    }
-                    if(r[i]->GetField(keymap)->CompareNotEquals(benchmk)){
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-            else if(type==kTypeChar){
-                char* ch = new char[key_col->GetLength()];
-                strcpy(ch,val.c_str());
-
-                for(uint32_t i=0;i<r.size();i++){
-                    const char* test = r[i]->GetField(keymap)->GetData();
+    }
+    return lo != nullptr || hi != nullptr;
+}
 
-                    if(strcmp(test,ch)!=0){
-                        vector<Field> f;
-                        for(auto it:r[i]->GetFields()){
-                            f.push_back(*it);
-                        }
-                        Row* tr = new Row(*r[i]);
-                        ans.push_back(tr);
-                    }
-                }
-            }
-        }
-        return ans;
+dberr_t ExecuteEngine::BuildScan(TableInfo *table_info, pSyntaxNode conditions, ExecuteContext *context,
+                                 std::unique_ptr<AbstractExecutor> &executor, bool read_only,
+                                 const std::vector<uint32_t> *columns) {
+    std::vector<uint32_t> scan_columns = columns != nullptr ? *columns : std::vector<uint32_t>();
+    if (conditions == nullptr) {
+        executor = std::make_unique<SeqScanExecutor>(table_info, context->txn_, nullptr, scan_columns);
+        return DB_SUCCESS;
     }
-    return r;
+    std::unique_ptr<Predicate> predicate;
+    dberr_t ret = BuildPredicate(conditions->child_, table_info->GetSchema(), predicate);
+    if (ret == DB_COLUMN_NAME_NOT_EXIST) {
+        cout << "column not found" << endl;
+        return ret;
+    } else if (ret != DB_SUCCESS) {
+        cout << "Error : Invalid condition!" << endl;
+        return ret;
+    }
+    std::vector<const ComparePredicate *> conjuncts;
+    CollectConjuncts(predicate.get(), conjuncts);
+    vector<IndexInfo *> indexes;
+    // the entries of the rows deleted since the snapshot read are gone from the indexes, the rows are not
+    Transaction *txn = context->txn_;
+    if (txn == nullptr || txn->GetIsolationLevel() != IsolationLevel::kSnapshot ||
+        !current_db->version_mgr_->HasDeletesAfter(table_info->GetTableHeap(), txn))
+        current_db->catalog_mgr_->GetTableIndexes(table_info->GetTableName(), indexes);
+    for (auto compare : conjuncts) {
+        if (compare->GetCompareType() != CompareType::kEqual)
+            continue;
+        IndexInfo *index_info = FindColumnIndex(indexes, compare->GetColumnIndex(), true);
+        if (index_info != nullptr) {
+            std::vector<Field> key_fields;
+            key_fields.emplace_back(compare->GetValue());
+            executor = std::make_unique<IndexScanExecutor>(table_info, index_info, key_fields, context->txn_);
+            break;
+        }
+    }
+    // a range scan holds its leaf while the rows are produced, under a delete or update it collects the row ids first
+    for (auto compare : conjuncts) {
+        if (executor != nullptr)
+            break;
+        IndexInfo *index_info = FindColumnIndex(indexes, compare->GetColumnIndex(), false);
+        const Field *lo, *hi;
+        bool lo_inclusive, hi_inclusive;
+        if (index_info != nullptr &&
+            CollectBounds(conjuncts, compare->GetColumnIndex(), lo, lo_inclusive, hi, hi_inclusive))
+            executor = std::make_unique<IndexRangeScanExecutor>(table_info, index_info, lo, lo_inclusive, hi,
+                                                                hi_inclusive, context->txn_, !read_only);
+    }
+    // the condition and the columns are pushed down into a sequential scan
+    if (executor == nullptr) {
+        executor = std::make_unique<SeqScanExecutor>(table_info, context->txn_, std::move(predicate), scan_columns);
+        return DB_SUCCESS;
+    }
+    // the index scans only cover the comparisons on one column, the filter checks all of the condition
+    executor = std::make_unique<FilterExecutor>(std::move(executor), std::move(predicate));
+    if (columns != nullptr)
+        executor = std::make_unique<ProjectionExecutor>(std::move(executor), *columns);
+    return DB_SUCCESS;
 }
 
 dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteSelect" << std::endl;
 #endif
+    if (!current_db) {
+        cout << "Error : No database selected";
+        return DB_FAILED;
+    }
     pSyntaxNode range = ast->child_;
     vector<uint32_t> columns;
     string table_name=range->next_->val_;
@@ -714,12 +556,10 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
         return DB_FAILED;
     }
     if(range->type_ == kNodeAllColumns){
-        // cout<<"select all"<<endl;
         for(uint32_t i=0;i<tableinfo->GetSchema()->GetColumnCount();i++)
             columns.push_back(i);
     }
     else if(range->type_ == kNodeColumnList){
-        // vector<Column*> all_columns = tableinfo->GetSchema()->GetColumns();
         pSyntaxNode col = range->child_;
         while(col!=nullptr){
             uint32_t pos;
@@ -733,133 +573,48 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
             col = col->next_;
         }
     }
-    cout<<"--------------------"<<endl;
-    //cout<<endl;
-    for(auto i:columns){
-        cout<<tableinfo->GetSchema()->GetColumn(i)->GetName()<<"   ";
-    }
-    cout<<endl;
-    cout<<"--------------------"<<endl;
-    if(range->next_->next_==nullptr)//û��ѡ������
-    {
-        int cnt=0;
-        for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
-            for(uint32_t j=0;j<columns.size();j++){
-                if(it->GetField(columns[j])->IsNull()){
-                    cout<<"null";
-                }
+    int cnt=0;
+    // a select outside of BEGIN ... COMMIT reads a snapshot in a read only transaction, without locks
+    dberr_t ret = RunInTransaction(context, tableinfo, LockMode::kIntentionShared, [&]() {
+        std::unique_ptr<AbstractExecutor> executor;
+        dberr_t scan_ret = BuildScan(tableinfo, range->next_->next_, context, executor, true, &columns);
+        if (scan_ret != DB_SUCCESS)
+            return scan_ret;
+        cout<<"--------------------"<<endl;
+        for(auto i:columns){
+            cout<<tableinfo->GetSchema()->GetColumn(i)->GetName()<<"   ";
+        }
+        cout<<endl;
+        cout<<"--------------------"<<endl;
+        Row *row = nullptr;
+        executor->Init();
+        while (executor->Next(row)) {
+            for (auto field : row->GetFields()) {
+                if (field->IsNull())
+                    cout << "null";
                 else
-                    it->GetField(columns[j])->fprint();
-                cout<<"  ";
-
+                    field->fprint();
+                cout << "  ";
             }
             cout<<endl;
             cnt++;
         }
-        cout<<"Select Success, Affects "<<cnt<<" Record!"<<endl;
         return DB_SUCCESS;
-    }
-    else if(range->next_->next_->type_ == kNodeConditions){
-        pSyntaxNode cond = range->next_->next_->child_;
-        vector<Row*> origin_rows;
-        string op = cond->val_;
-        if(cond->type_ == kNodeCompareOperator && op == "="){
-            string col_name = cond->child_->val_;//column name
-            string val = cond->child_->next_->val_;//compare value
-            uint32_t keymap;
-            if(tableinfo->GetSchema()->GetColumnIndex(col_name, keymap)!=DB_SUCCESS){
-                cout<<"column not found"<<endl;
-                return DB_SUCCESS;
-            }
-            const Column* key_col = tableinfo->GetSchema()->GetColumn(keymap);
-            TypeId type =  key_col->GetType();
-            if(type==kTypeInt)
-            {
-                int valint = std::stoi(val);
-                Field benchmk(type,int(valint));
-                vector<Field> vect_benchmk;
-                vect_benchmk.push_back(benchmk);
-                vector <IndexInfo*> indexes;
-
-                current_db->catalog_mgr_->GetTableIndexes(tableinfo->GetTableName(),indexes);
-                for(auto p=indexes.begin();p<indexes.end();p++){
-                    if((*p)->GetIndexKeySchema()->GetColumnCount()==1){
-                        if((*p)->GetIndexKeySchema()->GetColumns()[0]->GetName()==col_name){
-                            cout<<"--select int using index--"<<endl;
-                            Row tmp_row(vect_benchmk);
-                            vector<RowId> result;
-                            (*p)->GetIndex()->ScanKey(tmp_row,result,nullptr);
-                            for(auto q:result){
-                                if(q.GetPageId()<0) continue;
-                                Row *tr = new Row(q);
-                                tableinfo->GetTableHeap()->GetTuple(tr,nullptr);
-                                for(uint32_t j=0;j<columns.size();j++){
-                                    tr->GetField(columns[j])->fprint();
-                                    cout<<"  ";
-                                }
-                                cout<<endl;
-                            }
-                            return DB_SUCCESS;
-                        }
-                    }
-                }
-            }
-            else if(type==kTypeChar){
-                char *ch = new char[val.size()];
-                strcpy(ch,val.c_str());//input compare object
-                Field benchmk = Field(TypeId::kTypeChar, const_cast<char *>(ch), val.size(), true);
-                vector<Field> vect_benchmk;
-                vect_benchmk.push_back(benchmk);
-                vector <IndexInfo*> indexes;
-
-                current_db->catalog_mgr_->GetTableIndexes(tableinfo->GetTableName(),indexes);
-                for(auto p=indexes.begin();p<indexes.end();p++){
-                    if((*p)->GetIndexKeySchema()->GetColumnCount()==1){
-                        if((*p)->GetIndexKeySchema()->GetColumns()[0]->GetName()==col_name){
-                            cout<<"--select using char* index--"<<endl;
-                            Row tmp_row(vect_benchmk);
-                            vector<RowId> result;
-                            (*p)->GetIndex()->ScanKey(tmp_row,result,nullptr);
-                            for(auto q:result){
-                                if(q.GetPageId()<0) continue;
-                                Row *tr = new Row(q);
-                                tableinfo->GetTableHeap()->GetTuple(tr,nullptr);
-                                for(uint32_t j=0;j<columns.size();j++){
-                                    tr->GetField(columns[j])->fprint();
-                                    cout<<"  ";
-                                }
-                                cout<<endl;
-                            }
-                            return DB_SUCCESS;
-                        }
-                    }
-                }
-            }
-        }
-        for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
-            Row* tp = new Row(*it);
-            origin_rows.push_back(tp);
-        }
-        auto ptr_rows  = rec_sel(cond, *&origin_rows,tableinfo,current_db->catalog_mgr_);
-
-        for(auto it=ptr_rows.begin();it!=ptr_rows.end();it++){
-            for(uint32_t j=0;j<columns.size();j++){
-                (*it)->GetField(columns[j])->fprint();
-                cout<<"  ";
-            }
-            cout<<endl;
-        }
-        cout<<"Select Success, Affects "<<ptr_rows.size()<<" Record!"<<endl;
-    }
-
+    }, true);
+    if (ret != DB_SUCCESS)
+        return ret;
+    cout<<"Select Success, Affects "<<cnt<<" Record!"<<endl;
     return DB_SUCCESS;
-//  return DB_FAILED;
 }
 
 dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteInsert" << std::endl;
 #endif
+    if (!current_db) {
+        cout << "Error : No database selected";
+        return DB_FAILED;
+    }
     pSyntaxNode pointer = ast->child_;
     string table_name = pointer->val_;
     TableInfo* table_info = nullptr;
@@ -870,84 +625,26 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
     }
     vector<Field> new_fields;
     pointer = pointer->next_->child_;
-    int index = table_info->GetSchema()->GetColumnCount();
-    for (auto i = 0; i < index; i++){
-        TypeId index_type = table_info->GetSchema()->GetColumn(i)->GetType();
-        if(pointer->val_ == nullptr){
-            Field new_field(index_type);
-            new_fields.push_back(new_field);
-            pointer = pointer->next_;
-            continue;
-        }
-//        if (pointer == nullptr){
-//            for (auto j = i; j < index; j++){
-//                Field new_field(table_info->GetSchema()->GetColumn(j)->GetType());
-//                fields.push_back(new_field);
-//            }
-//            break;
-//        }
-        if (index_type == kTypeInt){
-            int int_value = atoi(pointer->val_);
-            Field new_field (kTypeInt, int_value);
-            new_fields.push_back(new_field);
-        }
-        else if(index_type==kTypeFloat){
-            float float_value = atof(pointer->val_);
-            Field new_field (kTypeFloat, float_value);
-            new_fields.push_back(new_field);
-        }
-        else {
-            char *char_value = new char[strlen(pointer->val_) + 1];
-            strcpy(char_value, pointer->val_);
-            Field new_field (kTypeChar, char_value, strlen(pointer->val_), true);
-            new_fields.push_back(new_field);
+    uint32_t column_count = table_info->GetSchema()->GetColumnCount();
+    for (uint32_t i = 0; i < column_count; i++){
+        if (pointer == nullptr) {
+            cout << "Error : Column Count doesn't match!";
+            return DB_FAILED;
         }
+        new_fields.emplace_back(ParseValue(table_info->GetSchema()->GetColumn(i)->GetType(), pointer->val_));
         pointer = pointer->next_;
     }
-//    if (pointer != nullptr){
-//        cout << "Error : Column Count doesn't match!";
-//        return DB_FAILED;
-//    }
-//    new_fields[0].fprint();
-//    new_fields[1].fprint();
-//    new_fields[2].fprint();
-    Row new_row(new_fields);
-    TableHeap* table_heap = table_info->GetTableHeap();
-    bool insert = table_heap->InsertTuple(new_row,nullptr);
-    if(!insert){
-        cout << "Error : Insert failed! Affects 0 record!";
-        return DB_FAILED;
-    }
     vector<IndexInfo *> indexes;
     current_db->catalog_mgr_->GetTableIndexes(table_name, indexes);
-    for (auto iter = indexes.begin(); iter != indexes.end() ; iter++) {
-        IndexSchema* index_schema = (*iter)->GetIndexKeySchema();
-        vector<Field> index_fields;
-        for(auto it:index_schema->GetColumns()){
-            index_id_t tmp;
-            if(table_info->GetSchema()->GetColumnIndex(it->GetName(),tmp)==DB_SUCCESS){
-                index_fields.push_back(new_fields[tmp]);
-            }
-        }
-        Row index_row(index_fields);
-        dberr_t IsInsert=(*iter)->GetIndex()->InsertEntry(index_row,new_row.GetRowId(),nullptr);
-        if(IsInsert == DB_FAILED){
-            cout<<"Insert Failed, Affects 0 Record!"<<endl;
-            for(auto q=indexes.begin();q!=iter;q++){
-                IndexSchema* index_schema_already = (*q)->GetIndexKeySchema();
-                vector<Field> index_fields_already;
-                for(auto it:index_schema_already->GetColumns()){
-                    index_id_t tmp_already;
-                    if(table_info->GetSchema()->GetColumnIndex(it->GetName(),tmp_already)==DB_SUCCESS){
-                        index_fields_already.push_back(new_fields[tmp_already]);
-                    }
-                }
-                Row index_row_already(index_fields_already);
-                (*q)->GetIndex()->RemoveEntry(index_row_already,new_row.GetRowId(),nullptr);
-            }
-            table_heap->MarkDelete(new_row.GetRowId(),nullptr);
-            return IsInsert;
-        }
+    dberr_t ret = RunInTransaction(context, table_info, LockMode::kIntentionExclusive, [&]() {
+        InsertExecutor executor(table_info, indexes, new_fields, context->txn_);
+        Row *row = nullptr;
+        executor.Init();
+        return executor.Next(row) ? DB_SUCCESS : DB_FAILED;
+    });
+    if (ret != DB_SUCCESS) {
+        cout<<"Insert Failed, Affects 0 Record!"<<endl;
+        return DB_FAILED;
     }
     cout<<"Insert Success, Affects 1 Record!"<<endl;
     return DB_SUCCESS;
@@ -957,6 +654,10 @@ dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteDelete" << std::endl;
 #endif
+    if (!current_db) {
+        cout << "Error : No database selected";
+        return DB_FAILED;
+    }
     string table_name=ast->child_->val_;
     TableInfo *tableinfo = nullptr;
     dberr_t GetRet = current_db->catalog_mgr_->GetTable(table_name, tableinfo);
@@ -964,53 +665,38 @@ dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
         cout<<"Table Not Exist!"<<endl;
         return DB_FAILED;
     }
-    TableHeap* tableheap=tableinfo->GetTableHeap();
-    auto del = ast->child_;
-    vector<Row*> tar;
-
-    if(del->next_==nullptr){
-        for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
-            Row* tp = new Row(*it);
-            tar.push_back(tp);
-        }
-    }
-    else{
-        vector<Row*> origin_rows;
-        for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
-            Row* tp = new Row(*it);
-            origin_rows.push_back(tp);
-        }
-        tar  = rec_sel(del->next_->child_, *&origin_rows,tableinfo,current_db->catalog_mgr_);
-    }
-    for(auto it:tar){
-        tableheap->ApplyDelete(it->GetRowId(),nullptr);
-    }
-    cout<<"Delete Success, Affects "<<tar.size()<<" Record!"<<endl;
-    vector <IndexInfo*> indexes;
-    current_db->catalog_mgr_->GetTableIndexes(table_name,indexes);
-    // int cnt=0;
-    for(auto p=indexes.begin();p!=indexes.end();p++){
-        for(auto j:tar){
-            vector<Field> index_fields;
-
-            for(auto it:(*p)->GetIndexKeySchema()->GetColumns()){
-                index_id_t tmp;
-                if(tableinfo->GetSchema()->GetColumnIndex(it->GetName(),tmp)==DB_SUCCESS){
-                    index_fields.push_back(*j->GetField(tmp));
-                }
-            }
-            Row index_row(index_fields);
-            (*p)->GetIndex()->RemoveEntry(index_row,j->GetRowId(),nullptr);
-        }
-    }
+    vector<IndexInfo *> indexes;
+    current_db->catalog_mgr_->GetTableIndexes(table_name, indexes);
+    int cnt = 0;
+    // the scan is built in the transaction, so that it locks the rows it reads
+    dberr_t ret = RunInTransaction(context, tableinfo, LockMode::kIntentionExclusive, [&]() {
+        std::unique_ptr<AbstractExecutor> scan;
+        dberr_t scan_ret = BuildScan(tableinfo, ast->child_->next_, context, scan);
+        if (scan_ret != DB_SUCCESS)
+            return scan_ret;
+        DeleteExecutor executor(tableinfo, indexes, std::move(scan), context->txn_);
+        Row *row = nullptr;
+        executor.Init();
+        while (executor.Next(row))
+            cnt++;
+        if (executor.GetStatus() != DB_SUCCESS)
+            cout << "Delete Failed, Affects 0 Record!" << endl;
+        return executor.GetStatus();
+    });
+    if (ret != DB_SUCCESS)
+        return ret;
+    cout<<"Delete Success, Affects "<<cnt<<" Record!"<<endl;
     return DB_SUCCESS;
-//  return DB_FAILED;
 }
 
 dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteUpdate" << std::endl;
 #endif
+    if (!current_db) {
+        cout << "Error : No database selected";
+        return DB_FAILED;
+    }
     string table_name=ast->child_->val_;
     TableInfo *tableinfo = nullptr;
     dberr_t GetRet = current_db->catalog_mgr_->GetTable(table_name, tableinfo);
@@ -1018,102 +704,122 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
         cout<<"Table Not Exist!"<<endl;
         return DB_FAILED;
     }
-    TableHeap* tableheap=tableinfo->GetTableHeap();
     auto updates = ast->child_->next_;
-    vector<Row*> tar;
-
-    if(updates->next_==nullptr){
-        for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
-            Row* tp = new Row(*it);
-            tar.push_back(tp);
-        }
-    }
-    else{
-        vector<Row*> origin_rows;
-        for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
-            Row* tp = new Row(*it);
-            origin_rows.push_back(tp);
+    vector<uint32_t> update_columns;
+    vector<Field> update_values;
+    for (auto update = updates->child_; update && update->type_ == kNodeUpdateValue; update = update->next_) {
+        uint32_t index;
+        if (tableinfo->GetSchema()->GetColumnIndex(update->child_->val_, index) != DB_SUCCESS) {
+            cout<<"column not found"<<endl;
+            return DB_FAILED;
         }
-        tar  = rec_sel(updates->next_->child_, *&origin_rows,tableinfo,current_db->catalog_mgr_);
+        update_columns.push_back(index);
+        update_values.emplace_back(ParseValue(tableinfo->GetSchema()->GetColumn(index)->GetType(),
+                                              update->child_->next_->val_));
     }
-    updates = updates->child_;
-    SyntaxNode* tmp_up = updates;
-    int flag=1;
     vector <IndexInfo*> indexes;
     current_db->catalog_mgr_->GetTableIndexes(tableinfo->GetTableName(),indexes);
-    while(tmp_up && tmp_up->type_ == kNodeUpdateValue){//ֱcheck if any index is being undated
-        string col = tmp_up->child_->val_;
-        for(auto p=indexes.begin();p<indexes.end();p++){
-            if((*p)->GetIndexKeySchema()->GetColumnCount()==1){
-                if((*p)->GetIndexKeySchema()->GetColumns()[0]->GetName()==col){
-                    flag=0;
-                    break;
-                }
-            }
-        }
-        tmp_up = tmp_up->next_;
-    }
-    if(flag==0){
-        cout<<"index cannot be updated!!"<<endl;
-        return DB_SUCCESS;
-    }
-
-    while(updates && updates->type_ == kNodeUpdateValue){
-        string col = updates->child_->val_;
-        string upval = updates->child_->next_->val_;
-        uint32_t index;
-        tableinfo->GetSchema()->GetColumnIndex(col,index);
-        TypeId tid = tableinfo->GetSchema()->GetColumn(index)->GetType();
-        if(tid == kTypeInt){
-            Field* newval = new Field(kTypeInt,stoi(upval));
-            for(auto it:tar){
-                it->GetFields()[index] = newval;
-            }
-        }
-        else if(tid == kTypeFloat){
-            Field* newval = new Field(kTypeFloat,stof(upval));
-            for(auto it:tar){
-                it->GetFields()[index] = newval;
-            }
-        }
-        else if(tid == kTypeChar){
-            uint32_t len = tableinfo->GetSchema()->GetColumn(index)->GetLength();
-            char* tc = new char[len];
-            strcpy(tc,upval.c_str());
-            Field* newval = new Field(kTypeChar,tc,len,true);
-            for(auto it:tar){
-                it->GetFields()[index] = newval;
+    for (auto index_info : indexes) {//check if any index is being updated
+        for (auto key_column : index_info->GetIndexMeta()->GetKeyMapping()) {
+            if (std::find(update_columns.begin(), update_columns.end(), key_column) != update_columns.end()) {
+                cout<<"index cannot be updated!!"<<endl;
+                return DB_FAILED;
             }
         }
-        updates = updates->next_;
     }
-    for(auto it:tar){
-        tableheap->UpdateTuple(*it,it->GetRowId(),nullptr);
-    }
-    cout<<"Update Success, Affects "<<tar.size()<<" Record!"<<endl;
+    int cnt = 0;
+    // the scan is built in the transaction, so that it locks the rows it reads
+    dberr_t ret = RunInTransaction(context, tableinfo, LockMode::kIntentionExclusive, [&]() {
+        std::unique_ptr<AbstractExecutor> scan;
+        dberr_t scan_ret = BuildScan(tableinfo, updates->next_, context, scan);
+        if (scan_ret != DB_SUCCESS)
+            return scan_ret;
+        UpdateExecutor executor(tableinfo, indexes, std::move(scan), update_columns, update_values, context->txn_);
+        Row *row = nullptr;
+        executor.Init();
+        while (executor.Next(row))
+            cnt++;
+        if (executor.GetStatus() != DB_SUCCESS)
+            cout << "Update Failed, Affects 0 Record!" << endl;
+        return executor.GetStatus();
+    });
+    if (ret != DB_SUCCESS)
+        return ret;
+    cout<<"Update Success, Affects "<<cnt<<" Record!"<<endl;
     return DB_SUCCESS;
-//  return DB_FAILED;
+}
+
+dberr_t ExecuteEngine::RunInTransaction(ExecuteContext *context, TableInfo *table_info, LockMode mode,
+                                        const std::function<dberr_t()> &statement, bool read_only) {
+    bool own_txn = context->txn_ == nullptr;
+    if (own_txn)
+        context->txn_ = current_db->txn_mgr_->Begin(IsolationLevel::kSnapshot, read_only);
+    Transaction *txn = context->txn_;
+    dberr_t ret = DB_FAILED;
+    if (txn->IsReadOnly() || current_db->lock_mgr_->LockTable(txn, table_info->GetTableId(), mode))
+        ret = statement();
+    if (txn->GetState() == TransactionState::kAborted) {
+        // the statement may have stopped short, and the locks of txn are in the way of an older transaction, or
+        // it changed a row changed since its snapshot
+        cout << "Error : Transaction rolled back on a conflict with another transaction!" << endl;
+        ret = DB_FAILED;
+    } else if (ret != DB_SUCCESS && !own_txn) {
+        // a statement is not rolled back alone, the changes it made so far go with the whole transaction
+        cout << "Error : Transaction rolled back!" << endl;
+    }
+    if (ret == DB_SUCCESS && !own_txn)
+        return ret;
+    if (ret == DB_SUCCESS)
+        current_db->txn_mgr_->Commit(txn);
+    else
+        current_db->txn_mgr_->Abort(txn);
+    context->txn_ = nullptr;
+    return ret;
 }
 
 dberr_t ExecuteEngine::ExecuteTrxBegin(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteTrxBegin" << std::endl;
 #endif
-  return DB_FAILED;
+    if (!current_db) {
+        cout << "Error : No database selected";
+        return DB_FAILED;
+    }
+    if (context->txn_ != nullptr) {
+        cout << "Error : Transaction already begun";
+        return DB_FAILED;
+    }
+    context->txn_ = current_db->txn_mgr_->Begin();
+    cout << "Success!";
+    return DB_SUCCESS;
 }
 
 dberr_t ExecuteEngine::ExecuteTrxCommit(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteTrxCommit" << std::endl;
 #endif
-  return DB_FAILED;
+    if (context->txn_ == nullptr) {
+        cout << "Error : No transaction begun";
+        return DB_FAILED;
+    }
+    current_db->txn_mgr_->Commit(context->txn_);
+    context->txn_ = nullptr;
+    cout << "Success!";
+    return DB_SUCCESS;
 }
 
 dberr_t ExecuteEngine::ExecuteTrxRollback(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteTrxRollback" << std::endl;
 #endif
-  return DB_FAILED;
+    if (context->txn_ == nullptr) {
+        cout << "Error : No transaction begun";
+        return DB_FAILED;
+    }
+    current_db->txn_mgr_->Abort(context->txn_);
+    context->txn_ = nullptr;
+    cout << "Success!";
+    return DB_SUCCESS;
 }
 
 dberr_t ExecuteEngine::ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context) {
@@ -1134,8 +840,11 @@ dberr_t ExecuteEngine::ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context)
             yy_switch_to_buffer(bp);
             MinisqlParserInit();
             yyparse();
+            // the statements of the file run in the transaction of the caller, or begin one for it
             ExecuteContext c;
+            c.txn_ = context->txn_;
             Execute(MinisqlGetParserRootNode(), &c);
+            context->txn_ = c.txn_;
         }
         return DB_SUCCESS;
     }
@@ -1150,6 +859,11 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
   LOG(INFO) << "ExecuteQuit" << std::endl;
 #endif
   ASSERT(ast->type_ == kNodeQuit, "Unexpected node type.");
+  // a transaction left open is rolled back
+  if (context->txn_ != nullptr) {
+    current_db->txn_mgr_->Abort(context->txn_);
+    context->txn_ = nullptr;
+  }
   context->flag_quit_ = true;
   return DB_SUCCESS;
 }
@@ -0,0 +1,25 @@
+#include "executor/executors/delete_executor.h"
+
+void DeleteExecutor::Init() {
+  child_->Init();
+  status_ = DB_SUCCESS;
+}
+
+bool DeleteExecutor::Next(Row *&row) {
+  if (!child_->Next(row)) {
+    return false;
+  }
+  // within a transaction the row is locked and only marked deleted, it is removed when the transaction commits
+  if (txn_ != nullptr && !table_info_->GetTableHeap()->MarkDelete(row->GetRowId(), txn_)) {
+    status_ = DB_FAILED;
+    return false;
+  }
+  for (auto index_info : indexes_) {
+    Row key = index_info->GetIndexKey(*row);
+    index_info->GetIndex()->RemoveEntry(key, row->GetRowId(), txn_);
+  }
+  if (txn_ == nullptr) {
+    table_info_->GetTableHeap()->ApplyDelete(row->GetRowId(), txn_);
+  }
+  return true;
+}
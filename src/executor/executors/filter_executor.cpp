@@ -0,0 +1,14 @@
+#include "executor/executors/filter_executor.h"
+
+void FilterExecutor::Init() {
+  child_->Init();
+}
+
+bool FilterExecutor::Next(Row *&row) {
+  while (child_->Next(row)) {
+    if (predicate_->Evaluate(*row)) {
+      return true;
+    }
+  }
+  return false;
+}
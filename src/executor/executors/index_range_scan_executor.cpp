@@ -0,0 +1,57 @@
+#include "executor/executors/index_range_scan_executor.h"
+
+/**
+ * @return a key of a single column index, nullptr for no field
+ */
+static std::unique_ptr<Row> MakeKey(const Field *field) {
+  if (field == nullptr) {
+    return nullptr;
+  }
+  std::vector<Field> fields;
+  fields.emplace_back(*field);
+  return std::make_unique<Row>(fields);
+}
+
+IndexRangeScanExecutor::IndexRangeScanExecutor(TableInfo *table_info, IndexInfo *index_info, const Field *lo,
+                                               bool lo_inclusive, const Field *hi, bool hi_inclusive,
+                                               Transaction *txn, bool collect)
+        : table_info_(table_info), index_info_(index_info), lo_(MakeKey(lo)), lo_inclusive_(lo_inclusive),
+          hi_(MakeKey(hi)), hi_inclusive_(hi_inclusive), txn_(txn), collect_(collect) {}
+
+void IndexRangeScanExecutor::Init() {
+  iterator_ = nullptr;
+  row_ids_.clear();
+  next_ = 0;
+  index_info_->GetIndex()->ScanRange(lo_.get(), lo_inclusive_, hi_.get(), hi_inclusive_, iterator_, txn_);
+  // the iterator latches the leaves the entries of the rows changed are removed from, it is done with first
+  if (collect_ && iterator_ != nullptr) {
+    RowId row_id;
+    while (iterator_->Next(row_id)) {
+      row_ids_.push_back(row_id);
+    }
+    iterator_ = nullptr;
+  }
+}
+
+bool IndexRangeScanExecutor::NextRowId(RowId &row_id) {
+  if (iterator_ != nullptr) {
+    return iterator_->Next(row_id);
+  }
+  if (next_ < row_ids_.size()) {
+    row_id = row_ids_[next_++];
+    return true;
+  }
+  return false;
+}
+
+bool IndexRangeScanExecutor::Next(Row *&row) {
+  RowId row_id;
+  while (NextRowId(row_id)) {
+    row_.Clear(row_id);
+    if (table_info_->GetTableHeap()->GetTuple(&row_, txn_)) {
+      row = &row_;
+      return true;
+    }
+  }
+  return false;
+}
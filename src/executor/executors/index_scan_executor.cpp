@@ -0,0 +1,22 @@
+#include "executor/executors/index_scan_executor.h"
+
+void IndexScanExecutor::Init() {
+  row_ids_.clear();
+  next_ = 0;
+  index_info_->GetIndex()->ScanKey(key_, row_ids_, txn_);
+}
+
+bool IndexScanExecutor::Next(Row *&row) {
+  while (next_ < row_ids_.size()) {
+    RowId row_id = row_ids_[next_++];
+    if (row_id.GetPageId() == INVALID_PAGE_ID) {
+      continue;
+    }
+    row_.Clear(row_id);
+    if (table_info_->GetTableHeap()->GetTuple(&row_, txn_)) {
+      row = &row_;
+      return true;
+    }
+  }
+  return false;
+}
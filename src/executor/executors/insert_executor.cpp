@@ -0,0 +1,33 @@
+#include "executor/executors/insert_executor.h"
+
+void InsertExecutor::Init() {
+  inserted_ = false;
+}
+
+bool InsertExecutor::Next(Row *&row) {
+  if (inserted_) {
+    return false;
+  }
+  inserted_ = true;
+  TableHeap *table_heap = table_info_->GetTableHeap();
+  if (!table_heap->InsertTuple(row_, txn_)) {
+    return false;
+  }
+  for (auto iter = indexes_.begin(); iter != indexes_.end(); iter++) {
+    Row key = (*iter)->GetIndexKey(row_);
+    if ((*iter)->GetIndex()->InsertEntry(key, row_.GetRowId(), txn_) != DB_SUCCESS) {
+      // the rollback of the transaction undoes the insert
+      if (txn_ != nullptr) {
+        return false;
+      }
+      for (auto inserted = indexes_.begin(); inserted != iter; inserted++) {
+        Row inserted_key = (*inserted)->GetIndexKey(row_);
+        (*inserted)->GetIndex()->RemoveEntry(inserted_key, row_.GetRowId(), txn_);
+      }
+      table_heap->ApplyDelete(row_.GetRowId(), txn_);
+      return false;
+    }
+  }
+  row = &row_;
+  return true;
+}
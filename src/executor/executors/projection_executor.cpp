@@ -0,0 +1,21 @@
+#include "executor/executors/projection_executor.h"
+
+void ProjectionExecutor::Init() {
+  child_->Init();
+}
+
+bool ProjectionExecutor::Next(Row *&row) {
+  Row *child_row = nullptr;
+  if (!child_->Next(child_row)) {
+    return false;
+  }
+  std::vector<Field> fields;
+  fields.reserve(column_indexes_.size());
+  for (auto column_index : column_indexes_) {
+    fields.emplace_back(*child_row->GetField(column_index));
+  }
+  row_ = std::make_unique<Row>(fields);
+  row_->SetRowId(child_row->GetRowId());
+  row = row_.get();
+  return true;
+}
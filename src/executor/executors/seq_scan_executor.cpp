@@ -0,0 +1,38 @@
+#include "executor/executors/seq_scan_executor.h"
+
+void SeqScanExecutor::Init() {
+  TableHeap *table_heap = table_info_->GetTableHeap();
+  if (predicate_ == nullptr && columns_.empty()) {
+    iter_ = table_heap->Begin(txn_);
+  } else {
+    Schema *schema = table_info_->GetSchema();
+    TupleFilter filter = nullptr;
+    if (predicate_ != nullptr) {
+      filter = [predicate = predicate_.get(), schema](char *tuple) {
+        return predicate->EvaluateTuple(tuple, schema);
+      };
+    }
+    std::vector<uint32_t> columns = columns_;
+    for (uint32_t i = 0; columns_.empty() && i < schema->GetColumnCount(); i++) {
+      columns.push_back(i);
+    }
+    iter_ = table_heap->Begin(txn_, filter, columns);
+  }
+  end_ = table_heap->End();
+  advance_ = false;
+}
+
+bool SeqScanExecutor::Next(Row *&row) {
+  if (iter_ == end_) {
+    return false;
+  }
+  if (advance_) {
+    ++iter_;
+    if (iter_ == end_) {
+      return false;
+    }
+  }
+  advance_ = true;
+  row = &*iter_;
+  return true;
+}
@@ -0,0 +1,53 @@
+#include "executor/executors/update_executor.h"
+
+UpdateExecutor::UpdateExecutor(TableInfo *table_info, std::vector<IndexInfo *> indexes,
+                               std::unique_ptr<AbstractExecutor> child, const std::vector<uint32_t> &column_indexes,
+                               std::vector<Field> &values, Transaction *txn)
+        : table_info_(table_info), indexes_(std::move(indexes)), child_(std::move(child)),
+          value_of_column_(table_info->GetSchema()->GetColumnCount(), -1), txn_(txn) {
+  ASSERT(column_indexes.size() == values.size(), "Every updated column needs a value.");
+  for (size_t i = 0; i < column_indexes.size(); i++) {
+    value_of_column_[column_indexes[i]] = static_cast<int>(i);
+    values_.emplace_back(values[i]);
+  }
+}
+
+void UpdateExecutor::Init() {
+  child_->Init();
+  moved_.clear();
+  status_ = DB_SUCCESS;
+}
+
+bool UpdateExecutor::Next(Row *&row) {
+  Row *child_row = nullptr;
+  while (child_->Next(child_row)) {
+    RowId old_row_id = child_row->GetRowId();
+    if (moved_.count(old_row_id.Get()) != 0) {
+      continue;
+    }
+    std::vector<Field> fields;
+    fields.reserve(value_of_column_.size());
+    for (size_t i = 0; i < value_of_column_.size(); i++) {
+      int value = value_of_column_[i];
+      fields.emplace_back(value < 0 ? *child_row->GetField(i) : values_[value]);
+    }
+    row_ = std::make_unique<Row>(fields);
+    // the row may be left deleted if it moved but fits no page, the rollback of the statement restores it
+    if (!table_info_->GetTableHeap()->UpdateTuple(*row_, old_row_id, txn_)) {
+      status_ = DB_FAILED;
+      return false;
+    }
+    RowId new_row_id = row_->GetRowId();
+    if (!(new_row_id == old_row_id)) {
+      moved_.insert(new_row_id.Get());
+      for (auto index_info : indexes_) {
+        Row key = index_info->GetIndexKey(*row_);
+        index_info->GetIndex()->RemoveEntry(key, old_row_id, txn_);
+        index_info->GetIndex()->InsertEntry(key, new_row_id, txn_);
+      }
+    }
+    row = row_.get();
+    return true;
+  }
+  return false;
+}
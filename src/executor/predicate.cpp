@@ -0,0 +1,62 @@
+#include "executor/predicate.h"
+
+bool ComparePredicate::Evaluate(const Row &row) const {
+  return Matches(*row.GetField(column_index_));
+}
+
+bool ComparePredicate::EvaluateTuple(char *tuple, Schema *schema) const {
+  // the field only points into the tuple
+  return Matches(Row::ReadField(tuple, schema, column_index_));
+}
+
+bool ComparePredicate::Matches(const Field &field) const {
+  switch (compare_type_) {
+    case CompareType::kIsNull:
+      return field.IsNull();
+    case CompareType::kIsNotNull:
+      return !field.IsNull();
+    default:
+      break;
+  }
+  if (field.IsNull() || value_.IsNull()) {
+    return false;
+  }
+  CmpBool result = CmpBool::kFalse;
+  switch (compare_type_) {
+    case CompareType::kEqual:
+      result = field.CompareEquals(value_);
+      break;
+    case CompareType::kNotEqual:
+      result = field.CompareNotEquals(value_);
+      break;
+    case CompareType::kLessThan:
+      result = field.CompareLessThan(value_);
+      break;
+    case CompareType::kLessThanOrEqual:
+      result = field.CompareLessThanEquals(value_);
+      break;
+    case CompareType::kGreaterThan:
+      result = field.CompareGreaterThan(value_);
+      break;
+    case CompareType::kGreaterThanOrEqual:
+      result = field.CompareGreaterThanEquals(value_);
+      break;
+    default:
+      break;
+  }
+  return result == CmpBool::kTrue;
+}
+
+bool LogicalPredicate::Evaluate(const Row &row) const {
+  if (is_and_) {
+    return left_->Evaluate(row) && right_->Evaluate(row);
+  }
+  return left_->Evaluate(row) || right_->Evaluate(row);
+}
+
+bool LogicalPredicate::EvaluateTuple(char *tuple, Schema *schema) const {
+  if (is_and_) {
+    return left_->EvaluateTuple(tuple, schema) && right_->EvaluateTuple(tuple, schema);
+  }
+  return left_->EvaluateTuple(tuple, schema) || right_->EvaluateTuple(tuple, schema);
+}
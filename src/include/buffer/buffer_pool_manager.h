@@ -1,61 +1,136 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
-#include <list>
-#include <mutex>
-#include <unordered_map>
+#include <chrono>
+#include <functional>
+#include <utility>
+#include <vector>
 
-#include "buffer/lru_replacer.h"
 #include "page/page.h"
-#include "page/disk_file_meta_page.h"
 #include "storage/disk_manager.h"
+#include "storage/page_run_allocator.h"
+#include "transaction/log_manager.h"
 
 using namespace std;
 
+/**
+ * Settings of the background flusher, which writes dirty unpinned pages ahead of eviction so that
+ * victims are clean and the eviction path does not wait for a write.
+ *
+ * The flusher starts writing when fewer than low_watermark of the frames are free or clean and unpinned,
+ * and keeps writing in the following rounds until high_watermark of the frames are.
+ */
+struct FlusherOptions {
+  double low_watermark{0.1};
+  double high_watermark{0.2};
+  /** at most this many pages are written in one round */
+  size_t max_pages_per_round{64};
+  /** time between two rounds */
+  std::chrono::milliseconds interval{10};
+};
+
+/**
+ * Outcome of BufferPoolManager::PrefetchPage
+ */
+enum class PrefetchResult {
+  kResident,    // the page is in the buffer pool
+  kLoading,     // the page is being read by an earlier prefetch
+  kStarted,     // a read of the page into a free frame was started
+  kFailed       // every frame is pinned or loading
+};
+
+/**
+ * BufferPoolManager is the interface of the buffer pools, through which the pages of the database file are
+ * read and written: a single BufferPoolManagerInstance, or a ParallelBufferPoolManager sharding the pages
+ * onto several instances.
+ */
 class BufferPoolManager {
 public:
-  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
+  virtual ~BufferPoolManager() = default;
+
+  virtual Page *FetchPage(page_id_t page_id) = 0;
+
+  virtual bool UnpinPage(page_id_t page_id, bool is_dirty) = 0;
+
+  virtual bool FlushPage(page_id_t page_id) = 0;
 
-  ~BufferPoolManager();
+  inline Page *NewPage(page_id_t &page_id) { return NewPageFrom(page_id, nullptr); }
 
-  Page *FetchPage(page_id_t page_id);
+  /**
+   * Like NewPage, with the page taken from the runs reserved by allocator, e.g. to keep the pages
+   * of a table contiguous on disk. A null allocator allocates any free page.
+   */
+  virtual Page *NewPageFrom(page_id_t &page_id, PageRunAllocator *allocator) = 0;
+
+  virtual bool DeletePage(page_id_t page_id) = 0;
+
+  /**
+   * Write every dirty page, except the pages held by a PageLogScope. With a log manager the pages are synced
+   * and a pages flushed record tells recovery that no change before it needs to be redone.
+   */
+  virtual void FlushAllPages() = 0;
 
-  bool UnpinPage(page_id_t page_id, bool is_dirty);
+  /**
+   * Write the dirty unpinned pages whose recovery LSN is before lsn, without holding the latch while writing
+   */
+  virtual void FlushPagesBefore(lsn_t lsn) = 0;
 
-  bool FlushPage(page_id_t page_id);
+  /**
+   * The dirty page table: every page which may differ from disk, with its recovery LSN. Pinned pages are
+   * included, they may have been changed without being unpinned yet.
+   */
+  virtual void GetDirtyPageTable(std::vector<std::pair<page_id_t, lsn_t>> &dirty_pages) = 0;
 
-  Page *NewPage(page_id_t &page_id);
+  virtual bool IsPageFree(page_id_t page_id) = 0;
 
-  bool DeletePage(page_id_t page_id);
+  virtual bool CheckAllUnpinned() = 0;
 
-  void FlushAllPages();
+  /** @return number of FetchPage calls which found the page in the buffer pool */
+  virtual size_t GetHitCount() = 0;
 
-  bool IsPageFree(page_id_t page_id);
+  /** @return number of FetchPage calls which read the page from disk */
+  virtual size_t GetMissCount() = 0;
 
-  bool CheckAllUnpinned();
+  /**
+   * Start the background flusher, does nothing if it is already running
+   */
+  virtual void StartFlusher(const FlusherOptions &options = FlusherOptions()) = 0;
 
-  inline DiskManager *GetDiskManager() const { return disk_manager_; }
+  /**
+   * Stop the background flusher and wait for its last round
+   */
+  virtual void StopFlusher() = 0;
 
-private:
   /**
-   * Allocate new page (operations like create index/table) For now just keep an increasing counter
+   * Start reading a page into a frame in the background, without pinning it. The frame can be evicted
+   * once the read has completed; a FetchPage of the page meanwhile waits for the read.
    */
-  page_id_t AllocatePage();
+  virtual PrefetchResult PrefetchPage(page_id_t page_id) = 0;
 
   /**
-   * Deallocate page (operations like drop index/table) Need bitmap in header page for tracking pages
+   * Call reader on a page if it is in the buffer pool and not being read, without pinning the page or
+   * counting an access. The page may be modified concurrently, so only hints should be taken from it.
+   * @return false if reader was not called
    */
-  void DeallocatePage(page_id_t page_id);
+  virtual bool PeekPage(page_id_t page_id, const std::function<void(Page *)> &reader) = 0;
+
+  /** @return number of reads started by PrefetchPage */
+  virtual size_t GetPrefetchCount() = 0;
+
+  /** Maximum window of the read-ahead of sequential scans, 0 disables read-ahead */
+  virtual void SetReadAheadWindow(size_t window) = 0;
+
+  virtual size_t GetReadAheadWindow() const = 0;
+
+  /** @return number of dirty victims written back on the eviction path */
+  virtual size_t GetForegroundWriteCount() = 0;
+
+  /** @return number of pages written by the background flusher */
+  virtual size_t GetBackgroundWriteCount() = 0;
 
+  virtual DiskManager *GetDiskManager() const = 0;
 
-private:
-  size_t pool_size_;                                        // number of pages in buffer pool
-  Page *pages_;                                             // array of pages
-  DiskManager *disk_manager_;                               // pointer to the disk manager.
-  std::unordered_map<page_id_t, frame_id_t> page_table_;    // to keep track of pages
-  Replacer *replacer_;                                      // to find an unpinned page for replacement
-  std::list<frame_id_t> free_list_;                         // to find a free page for replacement
-  recursive_mutex latch_;                                   // to protect shared data structure
+  virtual LogManager *GetLogManager() const = 0;
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
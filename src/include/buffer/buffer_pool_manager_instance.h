@@ -0,0 +1,235 @@
+#ifndef MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
+#define MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
+
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/replacer.h"
+#include "page/disk_file_meta_page.h"
+
+/**
+ * BufferPoolManagerInstance caches the pages of the database file in a fixed number of frames.
+ *
+ * With a log manager, the buffer pool also keeps what recovery needs to know about the frames: the
+ * LSN from which on the log may hold changes of a page which are not on disk (its recovery LSN), for
+ * the dirty page table of a checkpoint, and for pages logged by a PageLogScope, their copy as of the last
+ * page write and the LSN of that write. The allocation and deallocation of pages is logged as well.
+ */
+class BufferPoolManagerInstance : public BufferPoolManager {
+  friend class ParallelBufferPoolManager;
+  friend class PageLogScope;
+
+public:
+  /**
+   * @param log_manager if not null, a page is only written once the log is on disk up to the LSN of the page
+   */
+  explicit BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
+                                     ReplacerType replacer_type = ReplacerType::kLRU,
+                                     LogManager *log_manager = nullptr);
+
+  ~BufferPoolManagerInstance() override;
+
+  Page *FetchPage(page_id_t page_id) override;
+
+  bool UnpinPage(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPage(page_id_t page_id) override;
+
+  Page *NewPageFrom(page_id_t &page_id, PageRunAllocator *allocator) override;
+
+  bool DeletePage(page_id_t page_id) override;
+
+  void FlushAllPages() override;
+
+  void FlushPagesBefore(lsn_t lsn) override;
+
+  void GetDirtyPageTable(std::vector<std::pair<page_id_t, lsn_t>> &dirty_pages) override;
+
+  bool IsPageFree(page_id_t page_id) override;
+
+  bool CheckAllUnpinned() override;
+
+  size_t GetHitCount() override;
+
+  size_t GetMissCount() override;
+
+  void StartFlusher(const FlusherOptions &options = FlusherOptions()) override;
+
+  void StopFlusher() override;
+
+  PrefetchResult PrefetchPage(page_id_t page_id) override;
+
+  bool PeekPage(page_id_t page_id, const std::function<void(Page *)> &reader) override;
+
+  size_t GetPrefetchCount() override;
+
+  inline void SetReadAheadWindow(size_t window) override { read_ahead_window_ = window; }
+
+  inline size_t GetReadAheadWindow() const override { return read_ahead_window_; }
+
+  size_t GetForegroundWriteCount() override;
+
+  size_t GetBackgroundWriteCount() override;
+
+  inline DiskManager *GetDiskManager() const override { return disk_manager_; }
+
+  inline LogManager *GetLogManager() const override { return log_manager_; }
+
+private:
+  /**
+   * Append a pages flushed record, after the pages and the page allocations are on disk
+   * @param redo_lsn no change before this LSN needs to be redone
+   */
+  void LogPagesFlushed(lsn_t redo_lsn);
+
+  /**
+   * Allocate new page (operations like create index/table) For now just keep an increasing counter
+   */
+  page_id_t AllocatePage();
+
+  /**
+   * Deallocate page (operations like drop index/table) Need bitmap in header page for tracking pages
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /**
+   * Log the allocation or deallocation of a page
+   */
+  void LogPageAllocation(LogRecordType type, page_id_t page_id);
+
+  /**
+   * Bookkeeping of a frame just pinned: its recovery LSN, and the PageLogScope of the thread if any
+   */
+  void TrackPin(frame_id_t frame_id);
+
+  /**
+   * Forget a frame whose page left the buffer pool
+   */
+  void ResetFrame(frame_id_t frame_id);
+
+  /**
+   * A frame was written with the content it had when the next LSN was next_lsn
+   */
+  void TrackWrite(frame_id_t frame_id, lsn_t next_lsn);
+
+  /**
+   * @return the LSN up to which the log must be on disk before the page in a frame is written
+   */
+  lsn_t GetFrameLSN(frame_id_t frame_id);
+
+  /**
+   * @return the LSN the next log record will get, INVALID_LSN without logging
+   */
+  lsn_t GetNextLSN() const;
+
+  /**
+   * Write every dirty page not held by a page log scope, the latch is held throughout
+   * @return the smallest recovery LSN of a frame which may still differ from disk, INT32_MAX if none may
+   */
+  lsn_t WriteAllPages();
+
+  /**
+   * Write the pages of batch, copied under the latch and written without it
+   * @param batch page id and frame of the pages, sorted by page id
+   */
+  void WriteBatch(const std::vector<std::pair<page_id_t, frame_id_t>> &batch, std::vector<char> &buffer,
+                  std::unique_lock<std::recursive_mutex> &lock);
+
+  /**
+   * Append the changed ranges of a frame held by a page log scope to page write data
+   * @return false if the page did not change or was deleted within the scope
+   */
+  bool DiffScopeFrame(frame_id_t frame_id, std::vector<char> &data);
+
+  /**
+   * Release the pin of a page log scope on a frame
+   * @param lsn LSN of the page write of the scope
+   */
+  void ReleaseScopeFrame(frame_id_t frame_id, lsn_t lsn);
+
+  /**
+   * Bring a page already allocated on disk into this buffer pool as a new, zeroed page
+   */
+  Page *NewPageWithId(page_id_t page_id);
+
+  /**
+   * Take a frame from the free list, or evict one chosen by the replacer
+   * @return false if all frames are pinned
+   */
+  bool FindFreeFrame(frame_id_t *frame_id);
+
+  /**
+   * Make a page just allocated on disk a new, zeroed and pinned page of the buffer pool
+   * @param frame_id a frame taken by FindFreeFrame, given back if the page keeps a frame it still has
+   */
+  Page *InitNewPage(page_id_t page_id, frame_id_t frame_id, std::unique_lock<std::recursive_mutex> &lock);
+
+  /**
+   * Wait until the running flusher round has written its pages
+   * @return false if no round was running
+   */
+  bool WaitForFlusher(std::unique_lock<std::recursive_mutex> &lock);
+
+  /**
+   * Make frames whose prefetch has completed ordinary frames
+   */
+  void ReapLoads();
+
+  /**
+   * Wait for the prefetch of a frame and make it an ordinary frame, the latch is released meanwhile
+   */
+  void FinishLoad(frame_id_t frame_id, std::unique_lock<std::recursive_mutex> &lock);
+
+  /**
+   * Wait for the oldest prefetch in flight, unless a prefetch has completed already
+   * @return false if no prefetch was in flight
+   */
+  bool WaitForLoad(std::unique_lock<std::recursive_mutex> &lock);
+
+  /**
+   * Body of the flusher thread
+   */
+  void RunFlusher();
+
+  /**
+   * Write-ahead logging, wait until the log is on disk up to lsn before a page with this LSN is written
+   */
+  void FlushLog(lsn_t lsn);
+
+private:
+  size_t pool_size_;                                        // number of pages in buffer pool
+  Page *pages_;                                             // array of pages
+  DiskManager *disk_manager_;                               // pointer to the disk manager.
+  LogManager *log_manager_{nullptr};                        // pointer to the log manager, null without logging
+  std::unordered_map<page_id_t, frame_id_t> page_table_;    // to keep track of pages
+  Replacer *replacer_;                                      // to find an unpinned page for replacement
+  std::list<frame_id_t> free_list_;                         // to find a free page for replacement
+  recursive_mutex latch_;                                   // to protect shared data structure
+  size_t hit_count_{0};                                     // number of fetches served from the buffer pool
+  size_t miss_count_{0};                                    // number of fetches served from the disk
+  std::vector<bool> flushing_;                              // frames whose page is being written by the flusher
+  size_t num_flushing_{0};                                  // number of pages in the running flusher round
+  std::condition_variable_any flush_cv_;                    // notified when a flusher round ends or on stop
+  std::thread flusher_;                                     // the background flusher
+  bool stop_flusher_{false};
+  FlusherOptions flusher_options_;
+  size_t foreground_write_count_{0};                        // dirty victims written on the eviction path
+  size_t background_write_count_{0};                        // pages written by the flusher
+  std::vector<AsyncIOHandlePtr> loading_;                   // read of every frame filled by PrefetchPage
+  std::vector<frame_id_t> loading_frames_;                  // frames being filled by PrefetchPage
+  size_t prefetch_count_{0};                                // number of reads started by PrefetchPage
+  size_t read_ahead_window_{DEFAULT_READ_AHEAD_WINDOW};
+  // recovery, with a log manager only
+  std::vector<lsn_t> rec_lsns_;                             // recovery LSN of every frame, INVALID_LSN if clean
+  std::vector<std::unique_ptr<char[]>> log_copies_;         // copy of the pages logged by a page log scope
+  std::vector<lsn_t> write_lsns_;                           // LSN of the last page write of those pages
+  std::vector<bool> scope_pinned_;                          // frames held by the page log scope of a thread
+};
+
+#endif  // MINISQL_BUFFER_POOL_MANAGER_INSTANCE_H
@@ -0,0 +1,45 @@
+#ifndef MINISQL_CLOCK_REPLACER_H
+#define MINISQL_CLOCK_REPLACER_H
+
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+/**
+ * ClockReplacer implements the CLOCK replacement policy, which approximates LRU with one reference bit per frame.
+ *
+ * The hand sweeps over the frames in the replacer, clearing reference bits, and evicts the first frame
+ * whose bit is already clear.
+ */
+class ClockReplacer : public Replacer {
+public:
+  /**
+   * Create a new ClockReplacer.
+   * @param num_pages the maximum number of pages the ClockReplacer will be required to store
+   */
+  explicit ClockReplacer(size_t num_pages);
+
+  ~ClockReplacer() override = default;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  bool VictimIf(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &predicate) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+private:
+  size_t num_pages_;
+  /** whether the frame can be victimized */
+  std::vector<bool> in_replacer_;
+  /** reference bit, set when the frame is unpinned */
+  std::vector<bool> referenced_;
+  size_t hand_{0};
+  size_t size_{0};
+};
+
+#endif  // MINISQL_CLOCK_REPLACER_H
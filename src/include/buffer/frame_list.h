@@ -0,0 +1,62 @@
+#ifndef MINISQL_FRAME_LIST_H
+#define MINISQL_FRAME_LIST_H
+
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * Intrusive doubly linked list of frame ids used by the replacers.
+ *
+ * Links of all frames are preallocated, so that adding or removing a frame never allocates.
+ * Index num_frames is the sentinel: its next link is the head and its prev link is the tail.
+ */
+class FrameList {
+public:
+  explicit FrameList(size_t num_frames)
+          : sentinel_(static_cast<frame_id_t>(num_frames)),
+            prev_(num_frames + 1, sentinel_),
+            next_(num_frames + 1, sentinel_),
+            contains_(num_frames, false) {}
+
+  inline bool Contains(frame_id_t frame_id) const { return contains_[frame_id]; }
+
+  inline bool Empty() const { return size_ == 0; }
+
+  inline size_t Size() const { return size_; }
+
+  /** @return the least recently added frame, the list must not be empty */
+  inline frame_id_t Back() const { return prev_[sentinel_]; }
+
+  /** @return the frame added right after frame_id, End() after the most recently added one */
+  inline frame_id_t Prev(frame_id_t frame_id) const { return prev_[frame_id]; }
+
+  /** @return the sentinel, which ends a walk from Back() through Prev() */
+  inline frame_id_t End() const { return sentinel_; }
+
+  inline void PushFront(frame_id_t frame_id) {
+    frame_id_t head = next_[sentinel_];
+    prev_[frame_id] = sentinel_;
+    next_[frame_id] = head;
+    prev_[head] = frame_id;
+    next_[sentinel_] = frame_id;
+    contains_[frame_id] = true;
+    size_++;
+  }
+
+  inline void Remove(frame_id_t frame_id) {
+    next_[prev_[frame_id]] = next_[frame_id];
+    prev_[next_[frame_id]] = prev_[frame_id];
+    contains_[frame_id] = false;
+    size_--;
+  }
+
+private:
+  frame_id_t sentinel_;
+  std::vector<frame_id_t> prev_;
+  std::vector<frame_id_t> next_;
+  std::vector<bool> contains_;
+  size_t size_{0};
+};
+
+#endif  // MINISQL_FRAME_LIST_H
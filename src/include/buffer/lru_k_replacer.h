@@ -0,0 +1,75 @@
+#ifndef MINISQL_LRU_K_REPLACER_H
+#define MINISQL_LRU_K_REPLACER_H
+
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The backward K-distance of a frame is the time since its K-th most recent reference. Frames with fewer
+ * than K references have an infinite distance and are evicted first, least recently referenced first;
+ * otherwise the frame with the largest K-distance is evicted. A page read once by a scan therefore never
+ * pushes out pages which are referenced repeatedly.
+ *
+ * Consecutive accesses to the same frame are correlated (e.g. reading several tuples of one table page)
+ * and count as a single reference.
+ *
+ * The history of an evicted page is retained in a direct-mapped table of 2 * num_pages slots keyed by page id,
+ * and restored when the page is loaded again. Without it a page read back in always starts with an infinite
+ * distance, and is evicted again before its second reference whenever the other frames hold pages with K
+ * references, however old. The history of a removed (deleted) page is dropped.
+ */
+class LRUKReplacer : public Replacer {
+public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k number of references tracked per frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = 2);
+
+  ~LRUKReplacer() override = default;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  bool VictimIf(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &predicate) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  void Load(frame_id_t frame_id, page_id_t page_id) override;
+
+  size_t Size() override;
+
+private:
+  void ResetHistory(frame_id_t frame_id);
+
+  void RetainHistory(frame_id_t frame_id);
+
+private:
+  size_t num_pages_;
+  size_t k_;
+  /** the K most recent reference timestamps of every frame, most recent first */
+  std::vector<uint64_t> history_;
+  /** number of references recorded in history_, at most K */
+  std::vector<size_t> ref_counts_;
+  /** whether the frame can be victimized */
+  std::vector<bool> evictable_;
+  /** page held by every frame, as reported by Load */
+  std::vector<page_id_t> page_ids_;
+  /** retained history of evicted pages, laid out like history_, ref_counts_ and page_ids_ */
+  std::vector<uint64_t> retained_history_;
+  std::vector<size_t> retained_ref_counts_;
+  std::vector<page_id_t> retained_page_ids_;
+  size_t size_{0};
+  uint64_t current_timestamp_{0};
+  frame_id_t last_accessed_frame_{INVALID_FRAME_ID};
+};
+
+#endif  // MINISQL_LRU_K_REPLACER_H
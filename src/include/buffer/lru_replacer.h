@@ -1,13 +1,7 @@
 #ifndef MINISQL_LRU_REPLACER_H
 #define MINISQL_LRU_REPLACER_H
 
-#include <list>
-#include <mutex>
-#include <unordered_set>
-/**增加unordered_map对应库*/
-#include <unordered_map>
-#include <vector>
-
+#include "buffer/frame_list.h"
 #include "buffer/replacer.h"
 #include "common/config.h"
 
@@ -31,6 +25,8 @@ public:
 
   bool Victim(frame_id_t *frame_id) override;
 
+  bool VictimIf(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &predicate) override;
+
   void Pin(frame_id_t frame_id) override;
 
   void Unpin(frame_id_t frame_id) override;
@@ -38,16 +34,10 @@ public:
   size_t Size() override;
 
 private:
-//  // add your own private member variables here
- using ListIterator = typename std::list<frame_id_t>::const_iterator;
  /** number of pages in buffer pool */
  size_t _num_pages;
- /** lrulist */
- std::list<frame_id_t> lrulist;
- /** lrumap */
- //std::unordered_map<frame_id_t, std::list<frame_id_t>::iterator> lrumap;
- std::unordered_map<frame_id_t,ListIterator> lrumap;
-
+ /** lrulist, most recently unpinned frame at the front */
+ FrameList lrulist;
 };
 
 #endif  // MINISQL_LRU_REPLACER_H
@@ -0,0 +1,82 @@
+#ifndef MINISQL_PAGE_LOG_SCOPE_H
+#define MINISQL_PAGE_LOG_SCOPE_H
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "transaction/log_manager.h"
+
+class BufferPoolManagerInstance;
+
+/**
+ * Physical logging of the pages changed by one operation, e.g. an insert into a b+ tree.
+ *
+ * Only table pages have log records of their own. The pages of indexes and free space maps are logged
+ * as the bytes which an operation changed: while a scope is active on a thread, the buffer pool keeps
+ * every page it hands out to the thread pinned until the scope ends, together with a copy of the page as of
+ * its last page write. At the end of the scope the changed ranges of all the pages are logged in one
+ * page write record, so that a structure modification such as a split is redone entirely or not at all.
+ *
+ * Scopes are serialized by a latch of the log manager, so the pages are not changed by another scope
+ * meanwhile. A scope within a scope of the same thread does nothing. Pages deleted within a scope are
+ * deallocated after the page write is logged, so that no page on disk can refer to a free page.
+ *
+ * Page write data:
+ * | PageCount (4) | then per page: | PageId (4) | RangeCount (4) | then per range: | Offset (2) | Length (2) | Bytes |
+ */
+class PageLogScope {
+public:
+  /**
+   * A page of a page write record
+   */
+  struct PageWrite {
+    page_id_t page_id_{INVALID_PAGE_ID};
+    uint32_t range_count_{0};
+    const char *ranges_{nullptr};
+  };
+
+  /**
+   * Start a scope on this thread, does nothing without a log manager or within another scope
+   */
+  explicit PageLogScope(LogManager *log_manager);
+
+  /**
+   * Log the pages changed within the scope and unpin them
+   */
+  ~PageLogScope();
+
+  DISALLOW_COPY(PageLogScope)
+
+  /** @return the scope active on this thread for the pages logged by log_manager, null if there is none */
+  static PageLogScope *Current(LogManager *log_manager);
+
+  /** Keep a frame pinned by buffer_pool_manager until the end of the scope */
+  void AddFrame(BufferPoolManagerInstance *buffer_pool_manager, frame_id_t frame_id);
+
+  /** Deallocate a page deleted within the scope at its end */
+  void AddDeletedPage(BufferPoolManagerInstance *buffer_pool_manager, page_id_t page_id);
+
+  /**
+   * Append the changed ranges of a page to page write data
+   * @return number of ranges appended, the page is not appended if there is none
+   */
+  static uint32_t DiffPage(page_id_t page_id, const char *old_data, const char *new_data, std::vector<char> &data);
+
+  /** Split the data of a page write record into its pages */
+  static std::vector<PageWrite> ParsePageWrite(const char *data, uint32_t size);
+
+  /** Write the ranges of a page write into the page */
+  static void ApplyPageWrite(const PageWrite &page_write, char *page_data);
+
+private:
+  LogManager *log_manager_{nullptr};
+  std::unique_lock<std::mutex> lock_;
+  std::vector<std::pair<BufferPoolManagerInstance *, frame_id_t>> frames_;
+  std::vector<std::pair<BufferPoolManagerInstance *, page_id_t>> deleted_pages_;
+  static thread_local PageLogScope *current_;
+};
+
+#endif  // MINISQL_PAGE_LOG_SCOPE_H
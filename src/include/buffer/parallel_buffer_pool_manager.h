@@ -0,0 +1,97 @@
+#ifndef MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+#define MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+/**
+ * ParallelBufferPoolManager shards pages onto several BufferPoolManager instances by page_id % num_instances.
+ * Every instance has its own latch, page table, free list and replacer, so accesses to pages of different
+ * instances do not contend with each other.
+ *
+ * Page ids are allocated by the disk manager, or from the runs of a PageRunAllocator, before a frame is taken
+ * from the instance owning the id, so the instance can not be chosen first. Since consecutive ids are handed out,
+ * new pages go to the instances round robin. If the instance owning an id has all its frames pinned, the
+ * following ids are tried, so a new page fails only once every instance is full; the ids skipped are given back
+ * and their deallocation is logged.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+public:
+  /**
+   * @param num_instances number of buffer pool instances
+   * @param pool_size number of pages in each instance
+   * @param replacer_type replacement policy of each instance
+   * @param log_manager log manager of every instance, see BufferPoolManager
+   */
+  explicit ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                     ReplacerType replacer_type = ReplacerType::kLRU,
+                                     LogManager *log_manager = nullptr);
+
+  ~ParallelBufferPoolManager() override;
+
+  Page *FetchPage(page_id_t page_id) override;
+
+  bool UnpinPage(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPage(page_id_t page_id) override;
+
+  Page *NewPageFrom(page_id_t &page_id, PageRunAllocator *allocator) override;
+
+  bool DeletePage(page_id_t page_id) override;
+
+  void FlushAllPages() override;
+
+  void FlushPagesBefore(lsn_t lsn) override;
+
+  void GetDirtyPageTable(std::vector<std::pair<page_id_t, lsn_t>> &dirty_pages) override;
+
+  bool IsPageFree(page_id_t page_id) override;
+
+  bool CheckAllUnpinned() override;
+
+  size_t GetHitCount() override;
+
+  size_t GetMissCount() override;
+
+  PrefetchResult PrefetchPage(page_id_t page_id) override;
+
+  bool PeekPage(page_id_t page_id, const std::function<void(Page *)> &reader) override;
+
+  size_t GetPrefetchCount() override;
+
+  /** every instance runs its own flusher */
+  void StartFlusher(const FlusherOptions &options = FlusherOptions()) override;
+
+  void StopFlusher() override;
+
+  size_t GetForegroundWriteCount() override;
+
+  size_t GetBackgroundWriteCount() override;
+
+  inline void SetReadAheadWindow(size_t window) override { read_ahead_window_ = window; }
+
+  inline size_t GetReadAheadWindow() const override { return read_ahead_window_; }
+
+  inline DiskManager *GetDiskManager() const override { return disk_manager_; }
+
+  inline LogManager *GetLogManager() const override { return log_manager_; }
+
+  inline size_t GetNumInstances() const { return instances_.size(); }
+
+  inline size_t GetPoolSize() const { return instances_.size() * pool_size_per_instance_; }
+
+private:
+  inline BufferPoolManagerInstance *GetInstance(page_id_t page_id) const {
+    return instances_[static_cast<size_t>(page_id) % instances_.size()];
+  }
+
+private:
+  DiskManager *disk_manager_;
+  LogManager *log_manager_;
+  size_t pool_size_per_instance_;
+  size_t read_ahead_window_{DEFAULT_READ_AHEAD_WINDOW};
+  std::vector<BufferPoolManagerInstance *> instances_;
+};
+
+#endif  // MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
@@ -0,0 +1,58 @@
+#ifndef MINISQL_READ_AHEAD_H
+#define MINISQL_READ_AHEAD_H
+
+#include <deque>
+#include <functional>
+
+#include "buffer/buffer_pool_manager.h"
+
+/**
+ * ScanReadAhead prefetches the pages of a chain ahead of a sequential scan, e.g. the pages of a table heap
+ * or the leaves of a B+ tree. The scan calls Advance with the page it is on; the next page ids are taken
+ * from the pages already in the buffer pool, so the chain is followed as fast as the reads complete.
+ *
+ * The window starts small and adapts to the consumer: it doubles whenever the consumer reaches a page
+ * which is still being read, and halves when a page read ahead was evicted before the consumer got to it.
+ */
+class ScanReadAhead {
+public:
+  using NextPageFunc = std::function<page_id_t(Page *)>;
+
+  /**
+   * @param next_page_id returns the id of the page following a page of the chain
+   * @param max_window maximum number of pages read ahead, the buffer pool setting by default
+   */
+  ScanReadAhead(BufferPoolManager *buffer_pool_manager, NextPageFunc next_page_id, size_t max_window);
+
+  ScanReadAhead(BufferPoolManager *buffer_pool_manager, NextPageFunc next_page_id)
+          : ScanReadAhead(buffer_pool_manager, std::move(next_page_id), buffer_pool_manager->GetReadAheadWindow()) {}
+
+  /**
+   * Called by the scan on every step, with the page it is about to read
+   */
+  void Advance(page_id_t page_id);
+
+  inline size_t GetWindow() const { return window_; }
+
+  /** Initial window of a scan */
+  static constexpr size_t MIN_WINDOW = 4;
+
+private:
+  /**
+   * Follow the chain from the last page read ahead until the window is full or a page is still being read
+   */
+  void Fill();
+
+private:
+  BufferPoolManager *buffer_pool_manager_;
+  NextPageFunc next_page_id_;
+  size_t max_window_;
+  size_t window_;
+  page_id_t current_page_id_{INVALID_PAGE_ID};
+  /** pages read ahead which the scan has not reached yet, in chain order */
+  std::deque<page_id_t> ahead_;
+  /** the end of the chain has been read ahead */
+  bool end_reached_{false};
+};
+
+#endif  // MINISQL_READ_AHEAD_H
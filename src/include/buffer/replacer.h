@@ -2,10 +2,24 @@
 #define MINISQL_REPLACER_H
 
 #include <cstdio>
+#include <functional>
+
 #include "common/config.h"
 
+/**
+ * Replacement policies a buffer pool can be created with.
+ */
+enum class ReplacerType {
+  kLRU,
+  kClock,
+  kLRUK,
+  k2Q
+};
+
 /**
  * Replacer is an abstract class that tracks page usage.
+ *
+ * Pin is called on every access of a frame, so policies which keep an access history record it there.
  */
 class Replacer {
 public:
@@ -20,6 +34,15 @@ public:
    */
   virtual bool Victim(frame_id_t *frame_id) = 0;
 
+  /**
+   * Remove the victim frame as defined by the replacement policy among the frames satisfying the predicate.
+   * Frames failing the predicate are left in the replacer as they are.
+   * @param[out] frame_id id of frame that was removed
+   * @param predicate whether a frame may be victimized
+   * @return true if a victim frame was found, false otherwise
+   */
+  virtual bool VictimIf(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &predicate) = 0;
+
   /**
    * Pins a frame, indicating that it should not be victimized until it is unpinned.
    * @param frame_id the id of the frame to pin
@@ -32,8 +55,29 @@ public:
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Forget a frame whose page was deleted. The frame is not tracked until it is unpinned again,
+   * and the next page loaded into it starts with an empty access history.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Called before the first Pin after page_id is placed in a frame. Policies which retain the history of
+   * evicted pages use it to recognize a page coming back; the default ignores it.
+   * @param frame_id the id of the frame
+   * @param page_id the id of the page now held by the frame
+   */
+  virtual void Load(frame_id_t /*frame_id*/, page_id_t /*page_id*/) {}
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
+
+  /**
+   * Create a replacer of the given policy.
+   * @param num_pages the maximum number of pages the replacer will be required to store
+   */
+  static Replacer *Create(ReplacerType type, size_t num_pages);
 };
 
 #endif  // MINISQL_REPLACER_H
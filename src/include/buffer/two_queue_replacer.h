@@ -0,0 +1,59 @@
+#ifndef MINISQL_TWO_QUEUE_REPLACER_H
+#define MINISQL_TWO_QUEUE_REPLACER_H
+
+#include <vector>
+
+#include "buffer/frame_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+/**
+ * TwoQueueReplacer implements the simplified 2Q replacement policy.
+ *
+ * A frame referenced once since its page was loaded belongs to the FIFO queue A1, a frame referenced
+ * again is promoted to the LRU queue Am. Victims are taken from A1 while it holds more than a quarter
+ * of the buffer pool, so pages read once by a scan are recycled through A1 and do not flush Am.
+ *
+ * The replacer only sees frame ids, so there is no queue of evicted pages (A1out of full 2Q).
+ * Consecutive accesses to the same frame are correlated and count as a single reference.
+ */
+class TwoQueueReplacer : public Replacer {
+public:
+  /**
+   * Create a new TwoQueueReplacer.
+   * @param num_pages the maximum number of pages the TwoQueueReplacer will be required to store
+   */
+  explicit TwoQueueReplacer(size_t num_pages);
+
+  ~TwoQueueReplacer() override = default;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  bool VictimIf(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &predicate) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+private:
+  enum class Queue : uint8_t { kNone, kA1, kAm };
+
+  void Reset(frame_id_t frame_id);
+
+private:
+  /** target number of frames in A1 */
+  size_t a1_max_size_;
+  /** evictable frames of A1 and Am, most recent at the front */
+  FrameList a1_;
+  FrameList am_;
+  /** queue every frame belongs to, pinned or not */
+  std::vector<Queue> queues_;
+  size_t a1_count_{0};
+  frame_id_t last_accessed_frame_{INVALID_FRAME_ID};
+};
+
+#endif  // MINISQL_TWO_QUEUE_REPLACER_H
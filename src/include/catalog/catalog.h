@@ -1,6 +1,7 @@
 #ifndef MINISQL_CATALOG_H
 #define MINISQL_CATALOG_H
 
+#include <ostream>
 #include <string>
 #include <map>
 #include <unordered_map>
@@ -13,6 +14,7 @@
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 #include "transaction/transaction.h"
+#include "transaction/version_manager.h"
 
 class CatalogMeta {
   friend class CatalogManager;
@@ -68,8 +70,11 @@ private:
  */
 class CatalogManager {
 public:
+  /**
+   * @param version_manager keeps the older versions of the rows of the tables, null to read the latest rows only
+   */
   explicit CatalogManager(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager,
-                          LogManager *log_manager, bool init);
+                          LogManager *log_manager, bool init, VersionManager *version_manager = nullptr);
 
   ~CatalogManager();
 
@@ -79,20 +84,38 @@ public:
 
   dberr_t GetTables(std::vector<TableInfo *> &tables) const;
 
+  /**
+   * Create an index on the rows already in the table
+   * @param unique whether two rows may have the same key, the index is not created if they do
+   * @param index_type the structure the index is built on
+   * @return DB_INDEX_KEY_TOO_LONG if a key, with the row id of a non-unique B+ tree index, may exceed
+   * GENERIC_KEY_MAX_SIZE
+   */
   dberr_t CreateIndex(const std::string &table_name, const std::string &index_name,
                       const std::vector<std::string> &index_keys, Transaction *txn,
-                      IndexInfo *&index_info);
+                      IndexInfo *&index_info, bool unique = true, IndexType index_type = IndexType::kBPlusTree);
 
   dberr_t GetIndex(const std::string &table_name, const std::string &index_name, IndexInfo *&index_info) const;
 
+  dberr_t GetIndex(index_id_t index_id, IndexInfo *&index_info) const;
+
   dberr_t GetTableIndexes(const std::string &table_name, std::vector<IndexInfo *> &indexes) const;
 
   dberr_t DropTable(const std::string &table_name);
 
   dberr_t DropIndex(const std::string &index_name);
 
+  /**
+   * Fragmentation report: the pages, the runs of contiguous pages and the average run length
+   * of the page chain of every table and every index, in the order a scan reads them.
+   */
+  dberr_t ReportFragmentation(std::ostream &os) const;
+
 private:
-  dberr_t FlushCatalogMetaPage() const;
+  /**
+   * Make the catalog durable after a DDL statement: the pages are flushed, then the catalog file is replaced
+   */
+  dberr_t FlushCatalogMetaPage();
 
   dberr_t LoadTable(const table_id_t table_id, const page_id_t page_id,  TableMetadata *table_meta);
 
@@ -108,6 +131,7 @@ private:
   [[maybe_unused]] BufferPoolManager *buffer_pool_manager_; //1
   [[maybe_unused]] LockManager *lock_manager_; //1
   [[maybe_unused]] LogManager *log_manager_; //1
+  VersionManager *version_manager_;
   [[maybe_unused]] CatalogMeta *catalog_meta_;
   [[maybe_unused]] std::atomic<index_id_t> next_table_id_; //1
   [[maybe_unused]] std::atomic<index_id_t> next_index_id_; //1
@@ -6,6 +6,7 @@
 #include "catalog/table.h"
 #include "index/generic_key.h"
 #include "index/b_plus_tree_index.h"
+#include "index/extendible_hash_index.h"
 #include "record/schema.h"
 
 class IndexMetadata {
@@ -14,7 +15,7 @@ class IndexMetadata {
 public:
   static IndexMetadata *Create(const index_id_t index_id, const std::string &index_name,
                                const table_id_t table_id, const std::vector<uint32_t> &key_map,
-                               MemHeap *heap);
+                               MemHeap *heap, bool unique = true, IndexType index_type = IndexType::kBPlusTree);
 
   uint32_t SerializeTo(char *buf) const;
 
@@ -32,19 +33,36 @@ public:
 
   inline index_id_t GetIndexId() const { return index_id_; }
 
+  inline uint32_t GetKeyFormatVersion() const { return key_format_version_; }
+
+  inline bool IsUnique() const { return unique_; }
+
+  inline IndexType GetIndexType() const { return index_type_; }
+
 private:
   IndexMetadata() = delete;
 
   explicit IndexMetadata(const index_id_t index_id, const std::string &index_name,
-                         const table_id_t table_id, const std::vector<uint32_t> &key_map):
-                          index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map){}
+                         const table_id_t table_id, const std::vector<uint32_t> &key_map, bool unique,
+                         IndexType index_type, const uint32_t key_format_version = GENERIC_KEY_FORMAT_VERSION):
+                          index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map),
+                          unique_(unique), index_type_(index_type), key_format_version_(key_format_version){}
 
 private:
-  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344528;
+  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344531;
+  /** metadata written before indexes had a type, the index is a B+ tree */
+  static constexpr uint32_t B_PLUS_TREE_INDEX_METADATA_MAGIC_NUM = 344530;
+  /** metadata written before indexes could be non-unique, the index is unique */
+  static constexpr uint32_t UNIQUE_INDEX_METADATA_MAGIC_NUM = 344529;
+  /** metadata written before key formats were versioned, keys are in format version 1 */
+  static constexpr uint32_t LEGACY_INDEX_METADATA_MAGIC_NUM = 344528;
   index_id_t index_id_;
   std::string index_name_;
   table_id_t table_id_;
   std::vector<uint32_t> key_map_;  /** The mapping of index key to tuple key */
+  bool unique_;  /** Whether two rows may have the same key, the keys of a non-unique B+ tree end with the row id */
+  IndexType index_type_;  /** The structure the index is built on */
+  uint32_t key_format_version_;  /** The format version of keys stored in the index */
 };
 
 /**
@@ -58,6 +76,7 @@ public:
   }
 
   ~IndexInfo() {
+    delete index_;
     delete heap_;
   }
 
@@ -70,7 +89,19 @@ public:
                                             table_info->GetMemHeap());
     // Step3: call CreateIndex to create the index
     index_ = CreateIndex(buffer_pool_manager);
+    if (index_ == nullptr) {
+      LOG(FATAL) << "Keys of index " << meta_data_->index_name_ << " may take "
+                 << GetKeyMaxSize(key_schema_, meta_data_->unique_, meta_data_->index_type_)
+                 << " bytes, more than the " << GENERIC_KEY_MAX_SIZE << " an index supports." << std::endl;
+    }
     //ASSERT(false, "Not Implemented yet.");
+    // Step4: keys written in an older format can not be compared with the current one
+    if (meta_data_->key_format_version_ != GENERIC_KEY_FORMAT_VERSION) {
+      LOG(WARNING) << "Index " << meta_data_->index_name_ << " uses key format version "
+                   << meta_data_->key_format_version_ << ", rebuilding it." << std::endl;
+      RebuildIndex();
+      meta_data_->key_format_version_ = GENERIC_KEY_FORMAT_VERSION;
+    }
   }
 
   inline Index *GetIndex() { return index_; }
@@ -81,47 +112,87 @@ public:
 
   inline MemHeap *GetMemHeap() const { return heap_; }
 
+  /**
+   * @return upper bound of the size of a key of an index on key_schema, with the row id behind the fields of a
+   * non-unique B+ tree. An index whose keys exceed GENERIC_KEY_MAX_SIZE can not be built.
+   */
+  static uint32_t GetKeyMaxSize(Schema *key_schema, bool unique, IndexType index_type) {
+    bool with_row_id = !unique && index_type == IndexType::kBPlusTree;
+    return GetGenericKeyMaxSize(key_schema) + (with_row_id ? GENERIC_KEY_ROW_ID_SIZE : 0);
+  }
+
   inline TableInfo *GetTableInfo() const { return table_info_; }
 
   inline IndexMetadata *GetIndexMeta() const {return meta_data_;}
+
+  /**
+   * @return the key of a row of the table in this index
+   */
+  Row GetIndexKey(const Row &row) const {
+    std::vector<Field> fields;
+    for (auto column_index : meta_data_->key_map_) {
+      fields.emplace_back(*row.GetField(column_index));
+    }
+    return Row(fields);
+  }
 private:
   explicit IndexInfo() : meta_data_{nullptr}, index_{nullptr}, table_info_{nullptr},
                          key_schema_{nullptr}, heap_(new SimpleMemHeap()) {}
 
-  Index *CreateIndex(BufferPoolManager *buffer_pool_manager) {
+  void RebuildIndex() {
+    index_->Destroy();
+    index_->BulkLoad(table_info_->GetTableHeap(), meta_data_->GetKeyMapping(), nullptr);
+  }
 
-//   Row *row;
-   uint32_t size = 0;
-   Schema* schema = table_info_->GetSchema();
-   for(uint32_t i = 0; i < schema->GetColumnCount(); i++){
-     TypeId type_id = schema->GetColumns()[i]->GetType();
-     if(type_id == kTypeChar){
-       size += schema->GetColumns()[i]->GetLength();
-     }
-     else{
-       size += Type::GetTypeSize(type_id);
-     }
-   }
+  /**
+   * @return nullptr if the keys of the index do not fit in the largest generic key
+   */
+  Index *CreateIndex(BufferPoolManager *buffer_pool_manager) {
+   bool unique = meta_data_->unique_;
+   if (meta_data_->index_type_ == IndexType::kHash)
+     return CreateHashIndex(buffer_pool_manager);
+   uint32_t size = GetKeyMaxSize(key_schema_, unique, meta_data_->index_type_);
    Index *b_plustree_index = nullptr;
-//   row = table_info_->GetTableHeap()->Begin(nullptr).operator->();
-//   size = row->GetSerializedSize(key_schema_);
-   if(0<size&&size<4) b_plustree_index = new BPlusTreeIndex<GenericKey<4>,RowId,GenericComparator<4>>
-         (meta_data_->index_id_,key_schema_,buffer_pool_manager);
-   else if (size<8)  b_plustree_index = new BPlusTreeIndex<GenericKey<8>,RowId,GenericComparator<8>>
-         (meta_data_->index_id_,key_schema_,buffer_pool_manager);
-   else if (size<16) b_plustree_index = new BPlusTreeIndex<GenericKey<16>,RowId,GenericComparator<16>>
-         (meta_data_->index_id_,key_schema_,buffer_pool_manager);
-   else if (size<32) b_plustree_index = new BPlusTreeIndex<GenericKey<32>,RowId,GenericComparator<32>>
-         (meta_data_->index_id_,key_schema_,buffer_pool_manager);
-   else b_plustree_index = new BPlusTreeIndex<GenericKey<64>,RowId,GenericComparator<64>>
-         (meta_data_->index_id_,key_schema_,buffer_pool_manager);
-
-//   for(auto it = table_info_->GetTableHeap()->Begin(nullptr);it != table_info_->GetTableHeap()->End(); it++){
-//     b_plustree_index->InsertEntry(*it, it->GetRowId(), nullptr);
-//   }
+   if(size<=4) b_plustree_index = new BPlusTreeIndex<GenericKey<4>,RowId,GenericComparator<4>>
+         (meta_data_->index_id_,key_schema_,buffer_pool_manager,unique);
+   else if (size<=8)  b_plustree_index = new BPlusTreeIndex<GenericKey<8>,RowId,GenericComparator<8>>
+         (meta_data_->index_id_,key_schema_,buffer_pool_manager,unique);
+   else if (size<=16) b_plustree_index = new BPlusTreeIndex<GenericKey<16>,RowId,GenericComparator<16>>
+         (meta_data_->index_id_,key_schema_,buffer_pool_manager,unique);
+   else if (size<=32) b_plustree_index = new BPlusTreeIndex<GenericKey<32>,RowId,GenericComparator<32>>
+         (meta_data_->index_id_,key_schema_,buffer_pool_manager,unique);
+   else if (size<=GENERIC_KEY_MAX_SIZE)
+     b_plustree_index = new BPlusTreeIndex<GenericKey<64>,RowId,GenericComparator<64>>
+         (meta_data_->index_id_,key_schema_,buffer_pool_manager,unique);
+
     return b_plustree_index;
   }
 
+  /**
+   * The values of a hash index are kept next to their keys, so its keys never end with the row id
+   */
+  Index *CreateHashIndex(BufferPoolManager *buffer_pool_manager) {
+    bool unique = meta_data_->unique_;
+    uint32_t size = GetKeyMaxSize(key_schema_, unique, IndexType::kHash);
+    index_id_t index_id = meta_data_->index_id_;
+    if (size <= 4)
+      return new ExtendibleHashIndex<GenericKey<4>, RowId, GenericComparator<4>>(index_id, key_schema_,
+                                                                                 buffer_pool_manager, unique);
+    if (size <= 8)
+      return new ExtendibleHashIndex<GenericKey<8>, RowId, GenericComparator<8>>(index_id, key_schema_,
+                                                                                 buffer_pool_manager, unique);
+    if (size <= 16)
+      return new ExtendibleHashIndex<GenericKey<16>, RowId, GenericComparator<16>>(index_id, key_schema_,
+                                                                                   buffer_pool_manager, unique);
+    if (size <= 32)
+      return new ExtendibleHashIndex<GenericKey<32>, RowId, GenericComparator<32>>(index_id, key_schema_,
+                                                                                   buffer_pool_manager, unique);
+    if (size <= GENERIC_KEY_MAX_SIZE)
+      return new ExtendibleHashIndex<GenericKey<64>, RowId, GenericComparator<64>>(index_id, key_schema_,
+                                                                                   buffer_pool_manager, unique);
+    return nullptr;
+  }
+
 private:
   IndexMetadata *meta_data_;
   Index *index_;
@@ -17,8 +17,8 @@ public:
 
   static uint32_t DeserializeFrom(char *buf, TableMetadata *&table_meta, MemHeap *heap);
 
-  static TableMetadata *Create(table_id_t table_id, std::string table_name,
-                               page_id_t root_page_id, TableSchema *schema, MemHeap *heap);
+  static TableMetadata *Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
+                               page_id_t free_space_map_page_id, TableSchema *schema, MemHeap *heap);
 
   inline table_id_t GetTableId() const { return table_id_; }
 
@@ -26,20 +26,30 @@ public:
 
   inline uint32_t GetFirstPageId() const { return root_page_id_; }
 
+  inline page_id_t GetFreeSpaceMapPageId() const { return free_space_map_page_id_; }
+
   inline Schema *GetSchema() const { return schema_; }
 
+  inline uint32_t GetRowFormatVersion() const { return row_format_version_; }
 
 private:
   TableMetadata() = delete;
 
-  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema);
+  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id,
+                page_id_t free_space_map_page_id, TableSchema *schema,
+                uint32_t row_format_version = ROW_FORMAT_VERSION);
 
 private:
-  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
+  /** layout with the free space map page id and the row format version */
+  static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344529;
+  /** layout of metadata written before tables had a free space map, rows are in format version 1 */
+  static constexpr uint32_t LEGACY_TABLE_METADATA_MAGIC_NUM = 344528;
   table_id_t table_id_;
   std::string table_name_;
   page_id_t root_page_id_;
+  page_id_t free_space_map_page_id_;
   Schema *schema_;
+  uint32_t row_format_version_;  /** The format version of rows stored in the table heap */
 };
 
 /**
@@ -15,6 +15,14 @@ static constexpr int INDEX_ROOTS_PAGE_ID = 1;        // logical page id of the i
 
 static constexpr int PAGE_SIZE = 4096;               // size of a data page in byte
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 1024;// default size of buffer pool
+static constexpr int DEFAULT_BUFFER_POOL_INSTANCES = 1;// default number of buffer pool instances
+static constexpr int DEFAULT_READ_AHEAD_WINDOW = 32; // max pages read ahead of a sequential scan, 0 disables
+static constexpr int DEFAULT_PAGE_RUN_SIZE = 64;     // contiguous pages reserved at once for a table heap or index
+static constexpr double DEFAULT_FILL_FACTOR = 1.0;   // share of a b+ tree page filled by a bulk load
+static constexpr size_t DEFAULT_SORT_BUFFER_SIZE = 64 << 20;  // memory of an external sort before it spills a run
+static constexpr size_t DEFAULT_LOG_BUFFER_SIZE = 32 * PAGE_SIZE;  // size of each of the two log buffers
+static constexpr size_t DEFAULT_LOCK_SHARDS = 64;   // number of independently latched parts of the lock table
+static constexpr size_t DEFAULT_VERSION_SHARDS = 64;  // number of independently latched parts of the version store
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;    // max length of varchar
@@ -28,5 +36,6 @@ using lsn_t = int32_t;
 using column_id_t = uint32_t;
 using index_id_t = uint32_t;
 using table_id_t = uint32_t;
+using timestamp_t = uint64_t;
 
 #endif  // MINISQL_CONFIG_H
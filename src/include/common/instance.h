@@ -1,19 +1,30 @@
 #ifndef MINISQL_INSTANCE_H
 #define MINISQL_INSTANCE_H
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <thread>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "catalog/catalog.h"
 #include "common/config.h"
 #include "common/dberr.h"
 #include "storage/disk_manager.h"
+#include "transaction/checkpoint_manager.h"
+#include "transaction/lock_manager.h"
+#include "transaction/log_manager.h"
+#include "transaction/recovery_manager.h"
+#include "transaction/transaction_manager.h"
+#include "transaction/version_manager.h"
 
 class DBStorageEngine {
 public:
   explicit DBStorageEngine(std::string db_name, bool init = true,
-                           uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE)
+                           uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           uint32_t buffer_pool_instances = DEFAULT_BUFFER_POOL_INSTANCES,
+                           ReplacerType replacer_type = ReplacerType::kLRU)
           : db_file_name_(std::move(db_name)), init_(init) {
     // Init database file if needed
     if (init_) {
@@ -21,8 +32,32 @@ public:
     }
     // Initialize components
     disk_mgr_ = new DiskManager(db_file_name_);
-    bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
-    catalog_mgr_ = new CatalogManager(bpm_, nullptr, nullptr, init);
+    if (init_) {
+      remove(disk_mgr_->GetLogFileName().c_str());
+    }
+    log_mgr_ = new LogManager(disk_mgr_);
+    if (buffer_pool_instances > 1) {
+      // buffer_pool_size is split among the instances
+      uint32_t instance_pool_size = (buffer_pool_size + buffer_pool_instances - 1) / buffer_pool_instances;
+      bpm_ = new ParallelBufferPoolManager(buffer_pool_instances, instance_pool_size, disk_mgr_, replacer_type,
+                                           log_mgr_);
+    } else {
+      bpm_ = new BufferPoolManagerInstance(buffer_pool_size, disk_mgr_, replacer_type, log_mgr_);
+    }
+    // the tables and indexes are brought back to their state at the crash before the catalog reads them
+    // a redo worker pins a page at a time, at most half of the frames of an instance are pinned by them
+    size_t redo_workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                           std::max(1u, buffer_pool_size / buffer_pool_instances / 2));
+    RecoveryManager recovery_mgr(disk_mgr_, bpm_, log_mgr_, redo_workers);
+    if (!init_) {
+      recovery_mgr.Redo();
+    }
+    bpm_->StartFlusher();
+    lock_mgr_ = new LockManager();
+    version_mgr_ = new VersionManager();
+    catalog_mgr_ = new CatalogManager(bpm_, lock_mgr_, log_mgr_, init, version_mgr_);
+    txn_mgr_ = new TransactionManager(catalog_mgr_, bpm_, log_mgr_, lock_mgr_, version_mgr_);
+    checkpoint_mgr_ = new CheckpointManager(disk_mgr_, bpm_, log_mgr_, txn_mgr_);
     // Allocate static page for db storage engine
     if (init) {//起来看这块的代码，关闭一个db然后新建一个db，load内容该如何读取？DPM的作用是？（ispagefree/...)的作用？
       page_id_t id;
@@ -35,19 +70,36 @@ public:
     } else {
       ASSERT(!bpm_->IsPageFree(CATALOG_META_PAGE_ID), "Invalid catalog meta page.");
       ASSERT(!bpm_->IsPageFree(INDEX_ROOTS_PAGE_ID), "Invalid header page.");
+      recovery_mgr.Undo(txn_mgr_, checkpoint_mgr_);
     }
+    checkpoint_mgr_->Start();
+    version_mgr_->Start();
   }
 
   ~DBStorageEngine() {
+    delete checkpoint_mgr_;
+    // the rows deleted are removed by a last garbage collection, while their tables are still there
+    version_mgr_->Stop();
+    delete txn_mgr_;
+    delete version_mgr_;
     delete catalog_mgr_;
+    delete lock_mgr_;
+    // the pages written by the buffer pool wait for the log, recovery reads no further back than this
+    bpm_->FlushAllPages();
     delete bpm_;
+    delete log_mgr_;
     delete disk_mgr_;
   }
 
 public:
   DiskManager *disk_mgr_;
+  LogManager *log_mgr_;
   BufferPoolManager *bpm_;
+  LockManager *lock_mgr_;
+  VersionManager *version_mgr_;
   CatalogManager *catalog_mgr_;
+  TransactionManager *txn_mgr_;
+  CheckpointManager *checkpoint_mgr_;
   std::string db_file_name_;
   bool init_;
 };
@@ -1,10 +1,13 @@
 #ifndef MINISQL_EXECUTE_ENGINE_H
 #define MINISQL_EXECUTE_ENGINE_H
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include "common/dberr.h"
 #include "common/instance.h"
+#include "executor/executors/abstract_executor.h"
 #include "transaction/transaction.h"
 
 extern "C" {
@@ -19,6 +22,7 @@ extern "C" {
  */
 struct ExecuteContext {
   bool flag_quit_{false};
+  // the transaction begun by BEGIN, until its COMMIT or ROLLBACK
   Transaction *txn_{nullptr};
 };
 
@@ -79,6 +83,29 @@ private:
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  /**
+   * Build the operators producing the rows of a table which satisfy a where clause: an index scan if the
+   * clause requires an indexed column to equal a constant, an index range scan if it bounds an indexed
+   * column, a sequential scan otherwise, and a filter
+   * @param conditions the where clause, nullptr for all rows
+   * @param read_only whether the rows produced are left unmodified, else a range scan collects the row ids first
+   * @param columns the columns of the rows produced, nullptr for all columns of the table
+   */
+  dberr_t BuildScan(TableInfo *table_info, pSyntaxNode conditions, ExecuteContext *context,
+                    std::unique_ptr<AbstractExecutor> &executor, bool read_only = false,
+                    const std::vector<uint32_t> *columns = nullptr);
+
+  /**
+   * Run a statement on a table in the transaction begun by BEGIN, or else in a transaction of its own, committed
+   * if the statement succeeds and rolled back otherwise, which makes the statement atomic and durable. The table
+   * is locked in mode first. A transaction denied a lock to prevent a deadlock, or which changes a row changed
+   * since its snapshot, or whose statement fails, is rolled back as a whole.
+   * @param read_only true if the statement changes nothing, a transaction of its own then only reads a snapshot
+   * without locks
+   */
+  dberr_t RunInTransaction(ExecuteContext *context, TableInfo *table_info, LockMode mode,
+                           const std::function<dberr_t()> &statement, bool read_only = false);
+
 private:
   [[maybe_unused]] std::unordered_map<std::string, DBStorageEngine *> dbs_;  /** all opened databases */
   [[maybe_unused]] std::string current_db_;  /** current database name */
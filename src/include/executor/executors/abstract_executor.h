@@ -0,0 +1,38 @@
+#ifndef MINISQL_ABSTRACT_EXECUTOR_H
+#define MINISQL_ABSTRACT_EXECUTOR_H
+
+#include "common/dberr.h"
+#include "record/row.h"
+
+/**
+ * AbstractExecutor is the interface of the physical operators a statement is executed with.
+ * The operators form a tree, and rows are pulled from the root one at a time: every call to Next
+ * pulls as many rows from the children as it needs to produce one row, so no operator holds more
+ * than the row it is working on.
+ */
+class AbstractExecutor {
+public:
+  virtual ~AbstractExecutor() = default;
+
+  /**
+   * Prepare the executor, and its children, to produce rows from the start
+   */
+  virtual void Init() = 0;
+
+  /**
+   * Produce the next row
+   * @param[out] row the next row, owned by the executor and valid until the next call to Next
+   * @return false if there are no more rows, or if the executor failed
+   */
+  virtual bool Next(Row *&row) = 0;
+
+  /**
+   * @return DB_SUCCESS unless the executor stopped on a failure, the statement is then rolled back
+   */
+  inline dberr_t GetStatus() const { return status_; }
+
+protected:
+  dberr_t status_{DB_SUCCESS};
+};
+
+#endif  // MINISQL_ABSTRACT_EXECUTOR_H
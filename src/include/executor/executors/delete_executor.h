@@ -0,0 +1,31 @@
+#ifndef MINISQL_DELETE_EXECUTOR_H
+#define MINISQL_DELETE_EXECUTOR_H
+
+#include <memory>
+#include <vector>
+
+#include "catalog/indexes.h"
+#include "executor/executors/abstract_executor.h"
+
+/**
+ * Deletes the rows of the child from a table and its indexes, and produces the deleted rows.
+ * A row which can not be deleted stops the delete with a failed status.
+ */
+class DeleteExecutor : public AbstractExecutor {
+public:
+  DeleteExecutor(TableInfo *table_info, std::vector<IndexInfo *> indexes, std::unique_ptr<AbstractExecutor> child,
+                 Transaction *txn)
+          : table_info_(table_info), indexes_(std::move(indexes)), child_(std::move(child)), txn_(txn) {}
+
+  void Init() override;
+
+  bool Next(Row *&row) override;
+
+private:
+  TableInfo *table_info_;
+  std::vector<IndexInfo *> indexes_;
+  std::unique_ptr<AbstractExecutor> child_;
+  Transaction *txn_;
+};
+
+#endif  // MINISQL_DELETE_EXECUTOR_H
@@ -0,0 +1,26 @@
+#ifndef MINISQL_FILTER_EXECUTOR_H
+#define MINISQL_FILTER_EXECUTOR_H
+
+#include <memory>
+
+#include "executor/executors/abstract_executor.h"
+#include "executor/predicate.h"
+
+/**
+ * Produces the rows of the child which satisfy a predicate
+ */
+class FilterExecutor : public AbstractExecutor {
+public:
+  FilterExecutor(std::unique_ptr<AbstractExecutor> child, std::unique_ptr<Predicate> predicate)
+          : child_(std::move(child)), predicate_(std::move(predicate)) {}
+
+  void Init() override;
+
+  bool Next(Row *&row) override;
+
+private:
+  std::unique_ptr<AbstractExecutor> child_;
+  std::unique_ptr<Predicate> predicate_;
+};
+
+#endif  // MINISQL_FILTER_EXECUTOR_H
@@ -0,0 +1,49 @@
+#ifndef MINISQL_INDEX_RANGE_SCAN_EXECUTOR_H
+#define MINISQL_INDEX_RANGE_SCAN_EXECUTOR_H
+
+#include <memory>
+#include <vector>
+
+#include "catalog/indexes.h"
+#include "executor/executors/abstract_executor.h"
+
+/**
+ * Produces the rows of a table whose key in a single column index lies between two bounds, in key order.
+ * The index is walked while rows are produced, so the table must not be modified through the scan, unless
+ * the row ids are collected first.
+ */
+class IndexRangeScanExecutor : public AbstractExecutor {
+public:
+  /**
+   * @param lo lower bound of the key, nullptr if there is none
+   * @param hi upper bound of the key, nullptr if there is none
+   * @param collect whether the row ids of the range are collected at Init, for a delete or update through the scan
+   */
+  IndexRangeScanExecutor(TableInfo *table_info, IndexInfo *index_info, const Field *lo, bool lo_inclusive,
+                         const Field *hi, bool hi_inclusive, Transaction *txn, bool collect = false);
+
+  void Init() override;
+
+  bool Next(Row *&row) override;
+
+private:
+  /** @return false once the range is exhausted */
+  bool NextRowId(RowId &row_id);
+
+  TableInfo *table_info_;
+  IndexInfo *index_info_;
+  std::unique_ptr<Row> lo_;
+  bool lo_inclusive_;
+  std::unique_ptr<Row> hi_;
+  bool hi_inclusive_;
+  Transaction *txn_;
+  bool collect_;
+  std::unique_ptr<IndexRangeIterator> iterator_;
+  // the row ids collected, and the next to be read
+  std::vector<RowId> row_ids_;
+  size_t next_{0};
+  // reused for every row read, only valid until the next call to Next
+  Row row_{INVALID_ROWID};
+};
+
+#endif  // MINISQL_INDEX_RANGE_SCAN_EXECUTOR_H
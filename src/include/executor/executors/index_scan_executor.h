@@ -0,0 +1,33 @@
+#ifndef MINISQL_INDEX_SCAN_EXECUTOR_H
+#define MINISQL_INDEX_SCAN_EXECUTOR_H
+
+#include <vector>
+
+#include "catalog/indexes.h"
+#include "executor/executors/abstract_executor.h"
+
+/**
+ * Produces the rows of a table whose key in an index equals the given key
+ */
+class IndexScanExecutor : public AbstractExecutor {
+public:
+  IndexScanExecutor(TableInfo *table_info, IndexInfo *index_info, std::vector<Field> &key_fields, Transaction *txn)
+          : table_info_(table_info), index_info_(index_info), key_(key_fields), txn_(txn) {}
+
+  void Init() override;
+
+  bool Next(Row *&row) override;
+
+private:
+  TableInfo *table_info_;
+  IndexInfo *index_info_;
+  Row key_;
+  Transaction *txn_;
+  // row ids found in the index, a unique index has at most one per key
+  std::vector<RowId> row_ids_;
+  size_t next_{0};
+  // reused for every row read, only valid until the next call to Next
+  Row row_{INVALID_ROWID};
+};
+
+#endif  // MINISQL_INDEX_SCAN_EXECUTOR_H
@@ -0,0 +1,32 @@
+#ifndef MINISQL_INSERT_EXECUTOR_H
+#define MINISQL_INSERT_EXECUTOR_H
+
+#include <vector>
+
+#include "catalog/indexes.h"
+#include "executor/executors/abstract_executor.h"
+
+/**
+ * Inserts a row into a table and its indexes, and produces the inserted row.
+ * If a key is rejected by an index, e.g. a duplicate of a unique key, the insert is undone and
+ * no row is produced.
+ */
+class InsertExecutor : public AbstractExecutor {
+public:
+  InsertExecutor(TableInfo *table_info, std::vector<IndexInfo *> indexes, std::vector<Field> &values,
+                 Transaction *txn)
+          : table_info_(table_info), indexes_(std::move(indexes)), row_(values), txn_(txn) {}
+
+  void Init() override;
+
+  bool Next(Row *&row) override;
+
+private:
+  TableInfo *table_info_;
+  std::vector<IndexInfo *> indexes_;
+  Row row_;
+  Transaction *txn_;
+  bool inserted_{false};
+};
+
+#endif  // MINISQL_INSERT_EXECUTOR_H
@@ -0,0 +1,27 @@
+#ifndef MINISQL_PROJECTION_EXECUTOR_H
+#define MINISQL_PROJECTION_EXECUTOR_H
+
+#include <memory>
+#include <vector>
+
+#include "executor/executors/abstract_executor.h"
+
+/**
+ * Produces the given columns of the rows of the child, in the given order
+ */
+class ProjectionExecutor : public AbstractExecutor {
+public:
+  ProjectionExecutor(std::unique_ptr<AbstractExecutor> child, std::vector<uint32_t> column_indexes)
+          : child_(std::move(child)), column_indexes_(std::move(column_indexes)) {}
+
+  void Init() override;
+
+  bool Next(Row *&row) override;
+
+private:
+  std::unique_ptr<AbstractExecutor> child_;
+  std::vector<uint32_t> column_indexes_;
+  std::unique_ptr<Row> row_;
+};
+
+#endif  // MINISQL_PROJECTION_EXECUTOR_H
@@ -0,0 +1,42 @@
+#ifndef MINISQL_SEQ_SCAN_EXECUTOR_H
+#define MINISQL_SEQ_SCAN_EXECUTOR_H
+
+#include <memory>
+#include <vector>
+
+#include "catalog/table.h"
+#include "executor/executors/abstract_executor.h"
+#include "executor/predicate.h"
+
+/**
+ * Produces the rows of a table in the order of the table heap. A predicate and a projection are pushed down
+ * into the scan: the predicate is evaluated on the tuples in the pages, and only the rows satisfying it are
+ * deserialized, of which only the projected columns.
+ */
+class SeqScanExecutor : public AbstractExecutor {
+public:
+  /**
+   * @param predicate the condition on the rows produced, nullptr for all rows
+   * @param columns the columns of the rows produced, in this order, empty for all columns
+   */
+  SeqScanExecutor(TableInfo *table_info, Transaction *txn, std::unique_ptr<Predicate> predicate = nullptr,
+                  std::vector<uint32_t> columns = {})
+          : table_info_(table_info), txn_(txn), predicate_(std::move(predicate)), columns_(std::move(columns)) {}
+
+  void Init() override;
+
+  bool Next(Row *&row) override;
+
+private:
+  TableInfo *table_info_;
+  Transaction *txn_;
+  std::unique_ptr<Predicate> predicate_;
+  std::vector<uint32_t> columns_;
+  TableIterator iter_;
+  TableIterator end_;
+  // the iterator still points to the row returned by the last call to Next, which the parent may have
+  // deleted or updated since; it is only moved on when the next row is pulled
+  bool advance_{false};
+};
+
+#endif  // MINISQL_SEQ_SCAN_EXECUTOR_H
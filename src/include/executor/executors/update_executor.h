@@ -0,0 +1,43 @@
+#ifndef MINISQL_UPDATE_EXECUTOR_H
+#define MINISQL_UPDATE_EXECUTOR_H
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "catalog/indexes.h"
+#include "executor/executors/abstract_executor.h"
+
+/**
+ * Sets columns of the rows of the child to constants, and produces the updated rows.
+ * The updated columns must not be part of an index key; a row which no longer fits into its page
+ * moves to a new row id, which its index entries are updated to. A row which can not be updated stops the
+ * update with a failed status.
+ */
+class UpdateExecutor : public AbstractExecutor {
+public:
+  /**
+   * @param column_indexes the updated columns
+   * @param values the new values of the updated columns, in the same order
+   */
+  UpdateExecutor(TableInfo *table_info, std::vector<IndexInfo *> indexes, std::unique_ptr<AbstractExecutor> child,
+                 const std::vector<uint32_t> &column_indexes, std::vector<Field> &values, Transaction *txn);
+
+  void Init() override;
+
+  bool Next(Row *&row) override;
+
+private:
+  TableInfo *table_info_;
+  std::vector<IndexInfo *> indexes_;
+  std::unique_ptr<AbstractExecutor> child_;
+  // for every column of the table, the index of its new value in values_, -1 if it is not updated
+  std::vector<int> value_of_column_;
+  std::vector<Field> values_;
+  Transaction *txn_;
+  std::unique_ptr<Row> row_;
+  // rows which were moved by this update, a scan of the table may come across them again
+  std::unordered_set<int64_t> moved_;
+};
+
+#endif  // MINISQL_UPDATE_EXECUTOR_H
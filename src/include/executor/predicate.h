@@ -0,0 +1,88 @@
+#ifndef MINISQL_PREDICATE_H
+#define MINISQL_PREDICATE_H
+
+#include <memory>
+
+#include "record/field.h"
+#include "record/row.h"
+
+enum class CompareType {
+  kEqual,
+  kNotEqual,
+  kLessThan,
+  kLessThanOrEqual,
+  kGreaterThan,
+  kGreaterThanOrEqual,
+  kIsNull,
+  kIsNotNull
+};
+
+/**
+ * Condition of a where clause, evaluated on the rows of a table
+ */
+class Predicate {
+public:
+  virtual ~Predicate() = default;
+
+  /**
+   * @return true iff the row satisfies the condition, comparisons with null are never satisfied
+   */
+  virtual bool Evaluate(const Row &row) const = 0;
+
+  /**
+   * Evaluate the condition on a serialized row of a table, see Row, without deserializing it
+   */
+  virtual bool EvaluateTuple(char *tuple, Schema *schema) const = 0;
+};
+
+/**
+ * Comparison of a column with a constant, e.g. id < 10
+ */
+class ComparePredicate : public Predicate {
+public:
+  ComparePredicate(uint32_t column_index, CompareType compare_type, const Field &value)
+          : column_index_(column_index), compare_type_(compare_type), value_(value) {}
+
+  bool Evaluate(const Row &row) const override;
+
+  bool EvaluateTuple(char *tuple, Schema *schema) const override;
+
+  inline uint32_t GetColumnIndex() const { return column_index_; }
+
+  inline CompareType GetCompareType() const { return compare_type_; }
+
+  inline const Field &GetValue() const { return value_; }
+
+private:
+  bool Matches(const Field &field) const;
+
+  uint32_t column_index_;
+  CompareType compare_type_;
+  Field value_;
+};
+
+/**
+ * Conjunction or disjunction of two conditions
+ */
+class LogicalPredicate : public Predicate {
+public:
+  LogicalPredicate(bool is_and, std::unique_ptr<Predicate> left, std::unique_ptr<Predicate> right)
+          : is_and_(is_and), left_(std::move(left)), right_(std::move(right)) {}
+
+  bool Evaluate(const Row &row) const override;
+
+  bool EvaluateTuple(char *tuple, Schema *schema) const override;
+
+  inline bool IsAnd() const { return is_and_; }
+
+  inline const Predicate *GetLeft() const { return left_.get(); }
+
+  inline const Predicate *GetRight() const { return right_.get(); }
+
+private:
+  bool is_and_;
+  std::unique_ptr<Predicate> left_;
+  std::unique_ptr<Predicate> right_;
+};
+
+#endif  // MINISQL_PREDICATE_H
@@ -1,15 +1,19 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <functional>
 #include <queue>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "page/b_plus_tree_internal_page.h"
 #include "page/b_plus_tree_leaf_page.h"
 #include "page/b_plus_tree_page.h"
+#include "common/rwlatch.h"
 #include "transaction/transaction.h"
 #include "index/index_iterator.h"
+#include "storage/page_run_allocator.h"
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
@@ -22,11 +26,20 @@
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ * (5) GetValue, Insert and Remove may be called from many threads at once:
+ *     readers crab down with read latches, writers crab down with read
+ *     latches and write latch the leaf, and only when the leaf would split or
+ *     merge start over, crabbing down with write latches. Iterators read
+ *     latch the leaf they are in and crab to the next one, see IndexIterator.
+ *     BulkLoad and Destroy pin pages without latching them, and must not run
+ *     alongside writers.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
   using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  // finds the leaf after the last key it read again
+  friend class IndexIterator<KeyType, ValueType, KeyComparator>;
 
 public:
   explicit BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
@@ -44,13 +57,17 @@ public:
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction = nullptr);
 
+  // Build this empty B+ tree bottom-up out of size pairs in ascending key order.
+  bool BulkLoad(size_t size, const std::function<bool(MappingType &)> &next,
+                double fill_factor = DEFAULT_FILL_FACTOR);
+
   INDEXITERATOR_TYPE Begin();
 
   INDEXITERATOR_TYPE Begin(const KeyType &key);
 
   INDEXITERATOR_TYPE End();
 
-  // expose for test purpose
+  // expose for test purpose, the leaf is pinned but not latched
   Page *FindLeafPage(const KeyType &key, bool leftMost = false);
 
   Page *FindLeafPage(bool leftMost);
@@ -58,6 +75,9 @@ public:
   // used to check whether all pages are unpinned
   bool Check();
 
+  // how contiguous the leaves are on disk, in key order
+  PageRunStats GetLeafPageRunStats();
+
   // destroy the b plus tree
   void Destroy();
 
@@ -73,9 +93,34 @@ public:
   }
 
 private:
+  // what a page is latched for on the way down to a leaf
+  enum class Operation { kRead, kInsert, kRemove };
+
+  // the page of a level of a tree being bulk loaded which takes the next entries, and what is left of the level
+  struct BulkLoadLevel {
+    size_t entries;
+    size_t pages;
+    size_t page_index{0};
+    size_t remaining{0};
+    Page *page{nullptr};
+  };
+
+  void BulkLoadNewPage(std::vector<BulkLoadLevel> &levels, size_t level, const KeyType &key);
+
   void StartNewTree(const KeyType &key, const ValueType &value);
 
-  bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+  Page *FindLeafPageRead(const KeyType &key, bool left_most);
+
+  Page *FindLeafPageOptimistic(const KeyType &key);
+
+  Page *FindLeafPagePessimistic(const KeyType &key, Operation op, std::vector<Page *> &path, bool &root_latched);
+
+  bool IsSafe(BPlusTreePage *node, Operation op) const;
+
+  void ReleasePath(std::vector<Page *> &path, bool &root_latched, size_t keep);
+
+  bool InsertIntoLeaf(Page *leaf_page, const KeyType &key, const ValueType &value,
+                      Transaction *transaction = nullptr);
 
   void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
                         Transaction *transaction = nullptr);
@@ -84,11 +129,11 @@ private:
   N *Split(N *node);
 
   template<typename N>
-  bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr);
+  bool CoalesceOrRedistribute(N *node, std::vector<page_id_t> &deleted, Transaction *transaction = nullptr);
 
   template<typename N>
   bool Coalesce(N **neighbor_node, N **node, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent,
-                int index, Transaction *transaction = nullptr);
+                int index, std::vector<page_id_t> &deleted, Transaction *transaction = nullptr);
 
   template<typename N>
   void Redistribute(N *neighbor_node, N *node, int index);
@@ -97,6 +142,8 @@ private:
 
   void UpdateRootPageId(int insert_record = 0);
 
+  void DestroyPage(page_id_t page_id);
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
@@ -105,10 +152,14 @@ private:
   // member variable
   index_id_t index_id_;
   page_id_t root_page_id_;
+  // guards root_page_id_, held from reading it until the root page is latched
+  mutable ReaderWriterLatch root_latch_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  // leaves come from runs of contiguous pages, so that range scans read the file sequentially
+  PageRunAllocator leaf_allocator_;
 };
 
 #endif  // MINISQL_B_PLUS_TREE_H
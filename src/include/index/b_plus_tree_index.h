@@ -6,10 +6,40 @@
 
 #define BPLUSTREE_INDEX_TYPE BPlusTreeIndex<KeyType, ValueType, KeyComparator>
 
+/**
+ * Walks the leaves of a B+ tree from the first key of a range until a key is beyond its upper bound
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeRangeIterator : public IndexRangeIterator {
+public:
+  BPlusTreeRangeIterator(INDEXITERATOR_TYPE begin, const KeyType *lo, bool lo_inclusive, const KeyType *hi,
+                         bool hi_inclusive, const KeyComparator &comparator);
+
+  bool Next(RowId &row_id) override;
+
+private:
+  INDEXITERATOR_TYPE iter_;
+  KeyType lo_;
+  KeyType hi_;
+  bool has_lo_;
+  bool lo_inclusive_;
+  bool has_hi_;
+  bool hi_inclusive_;
+  KeyComparator comparator_;
+};
+
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
 public:
-  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager);
+  /**
+   * @param unique whether two entries may have the same key. The keys of a non-unique index end with
+   * the row id of their entry, which keeps the keys of the B+ tree unique.
+   * @param fill_factor share of each page a bulk load fills
+   * @param sort_buffer_size memory a bulk load sorts the entries in, before it spills them to disk
+   */
+  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                 bool unique = true, double fill_factor = DEFAULT_FILL_FACTOR,
+                 size_t sort_buffer_size = DEFAULT_SORT_BUFFER_SIZE);
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
@@ -17,8 +47,15 @@ public:
 
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) override;
 
+  dberr_t ScanRange(const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive,
+                    std::unique_ptr<IndexRangeIterator> &iterator, Transaction *txn) override;
+
+  dberr_t BulkLoad(TableHeap *table_heap, const std::vector<uint32_t> &key_map, Transaction *txn) override;
+
   dberr_t Destroy() override;
 
+  PageRunStats GetPageRunStats() override;
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
@@ -26,10 +63,23 @@ public:
   INDEXITERATOR_TYPE GetEndIterator();
 
 protected:
+  /**
+   * @return the key of the entry of a row in the B+ tree
+   */
+  KeyType MakeKey(const Row &key, RowId row_id) const;
+
+  /**
+   * @return the key all entries with the fields of key in the B+ tree are larger (or smaller) than
+   */
+  KeyType MakeBound(const Row &key, bool largest) const;
+
   // comparator for key
   KeyComparator comparator_;
   // container
   BPLUSTREE_TYPE container_;
+  bool unique_;
+  double fill_factor_;
+  size_t sort_buffer_size_;
 };
 
 #endif //MINISQL_B_PLUS_TREE_INDEX_H
@@ -0,0 +1,37 @@
+#ifndef MINISQL_EXTENDIBLE_HASH_INDEX_H
+#define MINISQL_EXTENDIBLE_HASH_INDEX_H
+
+#include "index/extendible_hash_table.h"
+#include "index/index.h"
+
+#define HASH_INDEX_TYPE ExtendibleHashIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * Index over an extendible hash table, for lookups of whole keys. Its keys are not kept in order,
+ * so it does not support range scans.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class ExtendibleHashIndex : public Index {
+public:
+  /**
+   * @param unique whether two entries may have the same key
+   */
+  ExtendibleHashIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                      bool unique = true);
+
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) override;
+
+  dberr_t Destroy() override;
+
+protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  HASH_TABLE_TYPE container_;
+};
+
+#endif  // MINISQL_EXTENDIBLE_HASH_INDEX_H
@@ -0,0 +1,81 @@
+#ifndef MINISQL_EXTENDIBLE_HASH_TABLE_H
+#define MINISQL_EXTENDIBLE_HASH_TABLE_H
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "page/hash_table_bucket_page.h"
+#include "page/hash_table_directory_page.h"
+#include "transaction/transaction.h"
+
+#define HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Disk based extendible hash table, made of a directory and bucket pages of
+ * the buffer pool. A full bucket is split in two and the directory doubled
+ * when it has no slot left to tell them apart; an emptied bucket is merged
+ * back into its split image. The directory does not shrink.
+ *
+ * Keys are hashed over their bytes, so equal keys must be equal byte by byte,
+ * which holds for the zero padded GenericKey. A key may have several values,
+ * unless the table is unique; a key & value pair is only stored once.
+ * Lookups share a latch on the table, inserts and removes hold it exclusively.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class ExtendibleHashTable {
+  using BucketPage = HashTableBucketPage<KeyType, ValueType, KeyComparator>;
+
+public:
+  explicit ExtendibleHashTable(index_id_t index_id, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, bool unique = false);
+
+  // Insert a key-value pair, false if it is there already, or the table is unique and has the key
+  bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // Remove a key-value pair, false if it is not there
+  bool Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // add the values of a key to result, false if there are none
+  bool GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction = nullptr);
+
+  uint32_t GetGlobalDepth();
+
+  // used to check whether all pages are unpinned
+  bool Check();
+
+  // destroy the hash table
+  void Destroy();
+
+  static uint32_t Hash(const KeyType &key);
+
+private:
+  void CreateDirectory();
+
+  page_id_t GetBucketPageId(HashTableDirectoryPage *directory, uint32_t slot);
+
+  void SetBucketPageId(HashTableDirectoryPage *directory, uint32_t slot, page_id_t bucket_page_id);
+
+  bool InsertIntoBucket(page_id_t bucket_page_id, const KeyType &key, const ValueType &value, bool overflow,
+                        bool &duplicate);
+
+  void AddToBucket(BucketPage *bucket, const KeyType &key, const ValueType &value);
+
+  bool SplitBucket(HashTableDirectoryPage *directory, uint32_t hash);
+
+  void GrowDirectory(HashTableDirectoryPage *directory);
+
+  void MergeBucket(HashTableDirectoryPage *directory, uint32_t slot);
+
+  void UpdateRootPageId(int insert_record = 0);
+
+  // member variable
+  index_id_t index_id_;
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  bool unique_;
+  ReaderWriterLatch table_latch_;
+};
+
+#endif  // MINISQL_EXTENDIBLE_HASH_TABLE_H
@@ -6,22 +6,89 @@
 #include "record/row.h"
 #include "record/field.h"
 
+/**
+ * Version of the on-disk key format, bumped whenever the encoding of GenericKey changes.
+ *  version 1: fields serialized as in a row, compared by deserializing both keys
+ *  version 2: fields serialized in a memcomparable format, compared by memcmp
+ */
+static constexpr uint32_t GENERIC_KEY_FORMAT_VERSION = 2;
+
+/** bytes at the end of a key of a non-unique index which hold the row id of the entry */
+static constexpr uint32_t GENERIC_KEY_ROW_ID_SIZE = 8;
+
+/** size of the largest generic key an index is built with, an index with longer keys is refused */
+static constexpr uint32_t GENERIC_KEY_MAX_SIZE = 64;
+
+/**
+ * @return upper bound of the encoded size of a key, assuming char fields do not contain 0x00 bytes
+ */
+inline uint32_t GetGenericKeyMaxSize(Schema *key_schema) {
+  uint32_t size = 0;
+  for (auto column : key_schema->GetColumns()) {
+    // null flag
+    size += 1;
+    if (column->GetType() == TypeId::kTypeChar) {
+      // data and terminator
+      size += column->GetLength() + 2;
+    } else {
+      size += Type::GetTypeSize(column->GetType());
+    }
+  }
+  return size;
+}
+
+/**
+ * Key of the generic index. Fields are encoded in a memcomparable format (see Type::SerializeToKey)
+ * and the rest of the key is zero padded, so two keys of the same schema compare as their bytes.
+ */
 template<size_t KeySize>
 class GenericKey {
 public:
-  inline void SerializeFromKey(const Row &key, Schema *schema) {
-    // initialize to 0
-    uint32_t size = key.GetSerializedSize(schema);
+  /**
+   * @param with_row_id whether a row id is put into the key afterwards, the fields must then leave
+   * GENERIC_KEY_ROW_ID_SIZE bytes free
+   */
+  inline void SerializeFromKey(const Row &key, Schema *schema, bool with_row_id = false) {
     ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+      size += key.GetField(i)->GetKeySerializedSize();
+    }
     ASSERT(size <= KeySize, "Index key size exceed max key size.");
+    ASSERT(!with_row_id || size + GENERIC_KEY_ROW_ID_SIZE <= KeySize, "Index key leaves no room for the row id.");
+    // initialize to 0
     memset(data, 0, KeySize);
-    key.SerializeTo(data, schema);
+    char *buf = data;
+    for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+      buf += key.GetField(i)->SerializeToKey(buf);
+    }
+  }
+
+  /**
+   * Put a row id into the last GENERIC_KEY_ROW_ID_SIZE bytes of the key, which the fields must leave
+   * free. Keys of a non-unique index end with the row id of their entry, so that they are unique and
+   * ordered by (fields, row id). The row id is encoded big endian, with the sign of the page id flipped.
+   */
+  inline void SetRowId(RowId row_id) {
+    SetRowIdBytes((static_cast<uint64_t>(static_cast<uint32_t>(row_id.GetPageId()) ^ 0x80000000u) << 32) |
+                  row_id.GetSlotNum());
   }
 
+  /**
+   * Put the smallest or the largest encoding of a row id into the key, which bound the entries with
+   * the same fields in a non-unique index
+   */
+  inline void SetRowIdBound(bool largest) { SetRowIdBytes(largest ? UINT64_MAX : 0); }
+
   inline void DeserializeToKey(Row &key, Schema *schema) const {
-    uint32_t ofs = key.DeserializeFrom(const_cast<char *>(data), schema);
-    ASSERT(ofs <= KeySize, "Index key size exceed max key size.");
-    return;
+    MemHeap *heap = key.GetMemHeap();
+    const char *buf = data;
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      Field *field = nullptr;
+      buf += Field::DeserializeFromKey(buf, schema->GetColumn(i)->GetType(), &field, heap);
+      key.GetFields().push_back(field);
+    }
+    ASSERT(static_cast<size_t>(buf - data) <= KeySize, "Index key size exceed max key size.");
   }
 
   // compare
@@ -44,34 +111,28 @@ public:
 
   // actual location of data, extends past the end.
   char data[KeySize];
+
+private:
+  inline void SetRowIdBytes(uint64_t value) {
+    if constexpr (KeySize >= GENERIC_KEY_ROW_ID_SIZE) {
+      for (uint32_t i = 0; i < GENERIC_KEY_ROW_ID_SIZE; i++) {
+        data[KeySize - 1 - i] = static_cast<char>(value >> (8 * i));
+      }
+    } else {
+      ASSERT(false, "Index key size too small for a row id.");
+    }
+  }
 };
 
 /**
- * Function object returns true if lhs < rhs, used for trees
+ * Function object returns the order of lhs and rhs, used for trees
  */
 template<size_t KeySize>
 class GenericComparator {
 public:
   inline int operator()(const GenericKey<KeySize> &lhs,
                         const GenericKey<KeySize> &rhs) const {
-    int column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    lhs.DeserializeToKey(lhs_key, key_schema_);
-    rhs.DeserializeToKey(rhs_key, key_schema_);
-
-    for (int i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue)
-        return -1;
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue)
-        return 1;
-    }
-    // equals
-    return 0;
+    return memcmp(lhs.data, rhs.data, KeySize);
   }
 
   GenericComparator(const GenericComparator &other) {
@@ -82,7 +143,7 @@ public:
   GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
 
 private:
-  Schema *key_schema_;
+  [[maybe_unused]] Schema *key_schema_;
 };
 
 #endif  // MINISQL_GENERIC_KEY_H
@@ -2,15 +2,45 @@
 #define MINISQL_INDEX_H
 
 #include <memory>
+#include <vector>
 
 #include "common/dberr.h"
 #include "record/row.h"
+#include "storage/page_run_allocator.h"
+#include "storage/table_heap.h"
+#include "transaction/log_manager.h"
 #include "transaction/transaction.h"
 
+/**
+ * Cursor over the entries of a range of keys of an index, in key order
+ */
+class IndexRangeIterator {
+public:
+  virtual ~IndexRangeIterator() = default;
+
+  /**
+   * @param[out] row_id row id of the next entry in the range
+   * @return false once the range is exhausted
+   */
+  virtual bool Next(RowId &row_id) = 0;
+};
+
+/**
+ * The structures an index can be built on
+ */
+enum class IndexType : uint32_t {
+  kBPlusTree = 0,  /** keys in order, for lookups and range scans */
+  kHash,           /** keys hashed, for lookups of whole keys only */
+};
+
+/**
+ * With a log manager, the pages of an index are logged as page writes, see PageLogScope, and an entry
+ * inserted or removed by a transaction is logged once more as the key and the row id, for its rollback.
+ */
 class Index {
 public:
-  explicit Index(index_id_t index_id, IndexSchema *key_schema)
-          : index_id_(index_id), key_schema_(key_schema) {}
+  explicit Index(index_id_t index_id, IndexSchema *key_schema, LogManager *log_manager = nullptr)
+          : index_id_(index_id), key_schema_(key_schema), log_manager_(log_manager) {}
 
   virtual ~Index() {}
 
@@ -20,11 +50,66 @@ public:
 
   virtual dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) = 0;
 
+  /**
+   * Scan the entries whose keys lie between two bounds
+   * @param lo lower bound of the keys, nullptr if there is none
+   * @param hi upper bound of the keys, nullptr if there is none
+   * @param[out] iterator cursor over the entries in the range
+   * @return DB_FAILED if the index does not keep its keys in order
+   */
+  virtual dberr_t ScanRange(const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive,
+                            std::unique_ptr<IndexRangeIterator> &iterator, Transaction *txn) {
+    return DB_FAILED;
+  }
+
+  /**
+   * Fill an empty index with the entries of all the rows of a table
+   * @param key_map columns of the table the key is made of
+   */
+  virtual dberr_t BulkLoad(TableHeap *table_heap, const std::vector<uint32_t> &key_map, Transaction *txn) {
+    for (auto it = table_heap->Begin(txn); it != table_heap->End(); ++it) {
+      std::vector<Field> fields;
+      for (auto column_index : key_map) {
+        fields.emplace_back(*it->GetField(column_index));
+      }
+      Row key(fields);
+      dberr_t ret = InsertEntry(key, it->GetRowId(), txn);
+      if (ret != DB_SUCCESS) {
+        return ret;
+      }
+    }
+    return DB_SUCCESS;
+  }
+
   virtual dberr_t Destroy() = 0;
 
+  /**
+   * @return how contiguous the pages an index scan reads are on disk, empty if the index has no such chain
+   */
+  virtual PageRunStats GetPageRunStats() { return PageRunStats(); }
+
+protected:
+  /**
+   * Log an entry inserted or removed by txn, within the page log scope of the change and once it succeeded
+   * @param type kIndexInsert or kIndexDelete
+   */
+  void LogEntry(LogRecordType type, const Row &key, RowId row_id, Transaction *txn) {
+    if (log_manager_ == nullptr || txn == nullptr) {
+      return;
+    }
+    std::vector<char> buf(key.GetSerializedSize(key_schema_));
+    key.SerializeTo(buf.data(), key_schema_);
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), type, index_id_, row_id, buf.data(),
+                         static_cast<uint32_t>(buf.size()));
+    size_t offset;
+    lsn_t lsn = log_manager_->AppendLogRecord(&log_record, &offset);
+    txn->AddLogRecord(lsn, offset);
+  }
+
 protected:
   index_id_t index_id_;
   IndexSchema *key_schema_;
+  LogManager *log_manager_;
 };
 
 #endif //MINISQL_INDEX_H
@@ -1,16 +1,38 @@
 #ifndef MINISQL_INDEX_ITERATOR_H
 #define MINISQL_INDEX_ITERATOR_H
 
+#include <memory>
+
+#include "buffer/read_ahead.h"
 #include "page/b_plus_tree_leaf_page.h"
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
+/**
+ * Walks the leaves of a B+ tree in key order. The current leaf is pinned and read latched, so writers wait for
+ * the iterator to leave it; the latch of the next leaf is taken before the one of the current leaf is released.
+ * A writer merging the next leaf waits for the current one while holding the next, so the iterator does not wait
+ * for the next leaf: it lets go of the current one instead and finds the leaf after the last key read again.
+ * A thread must not change the tree, or wait for a lock, while its iterators are in a leaf.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
 public:
   // you may define your own constructor based on your member variables
   explicit IndexIterator();
-  IndexIterator(B_PLUS_TREE_LEAF_PAGE_TYPE* leaf_, int index_, BufferPoolManager* buffer_pool_manager_);
+  /**
+   * @param page the leaf to start at, pinned and read latched, which the iterator takes over; nullptr for the end
+   * @param index the entry to start at, one past the last one of the leaf to start at the next leaf
+   */
+  IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, Page *page, int index,
+                BufferPoolManager *buffer_pool_manager);
+  // the latch of a leaf is not taken twice by a thread, a writer waiting in between would block it
+  IndexIterator(const IndexIterator &other) = delete;
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator &operator=(IndexIterator other);
   ~IndexIterator();
 
   /** Return the key/value pair this iterator is currently pointing at. */
@@ -26,10 +48,24 @@ public:
   bool operator!=(const IndexIterator &itr) const;
 
 private:
+  /**
+   * Move to the first entry from index on, in the following leaves if index is past the end of the leaf
+   */
+  void SkipToEntry();
+
+  /**
+   * Unlatch and unpin the current leaf
+   */
+  void Release();
+
   // add your own private member variables here
  int index = 0;
  B_PLUS_TREE_LEAF_PAGE_TYPE* leaf = nullptr;
+ Page *page = nullptr;
+ BPlusTree<KeyType, ValueType, KeyComparator> *tree = nullptr;
  BufferPoolManager *buffer_pool_manager = nullptr;
+ // prefetches the following leaves
+ std::shared_ptr<ScanReadAhead> read_ahead;
 };
 
 
@@ -0,0 +1,124 @@
+#ifndef MINISQL_KEY_SEARCH_H
+#define MINISQL_KEY_SEARCH_H
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#include <immintrin.h>
+#define MINISQL_KEY_SEARCH_AVX512
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define MINISQL_KEY_SEARCH_AVX2
+#endif
+
+#include "index/generic_key.h"
+
+/**
+ * Search in the sorted key & value pairs of a B+ tree page. The implementation is chosen at compile time
+ * from the key and comparator types:
+ *  - any key: branch free binary search, the comparison result selects the next base without a jump
+ *  - GenericKey<8>, e.g. a single INT column: the memcomparable key is compared as a big endian
+ *    64 bit integer. The binary search stops at a window of WINDOW pairs, whose keys are compared
+ *    with SIMD instructions, 8 keys at once with AVX-512 and 4 with AVX2.
+ */
+template<typename KeyType, typename KeyComparator>
+class KeySearch {
+public:
+  /**
+   * @return the first index i so that array[i].first >= key, size if there is none
+   */
+  template<typename MappingType>
+  static inline int LowerBound(const MappingType *array, int size, const KeyType &key,
+                               const KeyComparator &comparator) {
+    if (size == 0) {
+      return 0;
+    }
+    // the result lies in [base, base + size]
+    const MappingType *base = array;
+    while (size > 1) {
+      int half = size / 2;
+      base = comparator(base[half].first, key) < 0 ? base + half : base;
+      size -= half;
+    }
+    return static_cast<int>(base - array) + (comparator(base->first, key) < 0);
+  }
+};
+
+template<>
+class KeySearch<GenericKey<8>, GenericComparator<8>> {
+public:
+  template<typename MappingType>
+  static inline int LowerBound(const MappingType *array, int size, const GenericKey<8> &key,
+                               const GenericComparator<8> & /* comparator */) {
+    const uint64_t target = Load(key);
+    const MappingType *base = array;
+    while (size > WINDOW) {
+      int half = size / 2;
+      base = Load(base[half].first) < target ? base + half : base;
+      size -= half;
+    }
+    return static_cast<int>(base - array) + CountLess(base, size, target);
+  }
+
+  /** Pairs left to the SIMD comparison after the binary search */
+  static constexpr int WINDOW = 16;
+
+private:
+  /** @return the key as an integer which orders like the bytes of the key */
+  static inline uint64_t Load(const GenericKey<8> &key) {
+    uint64_t value;
+    memcpy(&value, key.data, sizeof(value));
+    return __builtin_bswap64(value);
+  }
+
+  /**
+   * @return number of the first size keys of array which are less than target
+   */
+  template<typename MappingType>
+  static inline int CountLess(const MappingType *array, int size, uint64_t target) {
+    int count = 0;
+    int i = 0;
+#if defined(MINISQL_KEY_SEARCH_AVX512) || defined(MINISQL_KEY_SEARCH_AVX2)
+    // the keys of 16 byte pairs are every other 64 bit word
+    if constexpr (sizeof(MappingType) == 16) {
+      const auto *words = reinterpret_cast<const int64_t *>(array);
+#ifdef MINISQL_KEY_SEARCH_AVX512
+      const __m512i even = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+      const __m512i byte_swap = _mm512_set4_epi32(0x08090a0b, 0x0c0d0e0f, 0x00010203, 0x04050607);
+      const __m512i target_keys = _mm512_set1_epi64(static_cast<int64_t>(target));
+      for (; i < size; i += 8) {
+        // masked loads do not touch the pairs beyond size
+        __mmask8 pairs = size - i >= 8 ? 0xFF : static_cast<__mmask8>((1u << (size - i)) - 1);
+        __mmask8 low = pairs & 0x0F, high = pairs >> 4;
+        __mmask8 low_words = static_cast<__mmask8>((low & 1) | (low & 2) << 1 | (low & 4) << 2 | (low & 8) << 3);
+        __mmask8 high_words = static_cast<__mmask8>((high & 1) | (high & 2) << 1 | (high & 4) << 2 | (high & 8) << 3);
+        __m512i first = _mm512_maskz_loadu_epi64(low_words, words + 2 * i);
+        __m512i second = _mm512_maskz_loadu_epi64(high_words, words + 2 * i + 8);
+        __m512i keys = _mm512_shuffle_epi8(_mm512_permutex2var_epi64(first, even, second), byte_swap);
+        count += __builtin_popcount(_mm512_mask_cmplt_epu64_mask(pairs, keys, target_keys));
+      }
+      return count;
+#else
+      const __m256i byte_swap = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+                                                8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+      // AVX2 compares signed integers, flipping the sign bit keeps the unsigned order
+      const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+      const __m256i target_keys = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(target)), sign);
+      for (; i + 4 <= size; i += 4) {
+        __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + 2 * i));
+        __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + 2 * i + 4));
+        __m256i keys = _mm256_xor_si256(_mm256_shuffle_epi8(_mm256_unpacklo_epi64(first, second), byte_swap), sign);
+        count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(target_keys, keys))));
+      }
+#endif
+    }
+#endif
+    for (; i < size; i++) {
+      count += Load(array[i].first) < target;
+    }
+    return count;
+  }
+};
+
+#endif  // MINISQL_KEY_SEARCH_H
@@ -55,11 +55,12 @@ public:
   void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                          BufferPoolManager *buffer_pool_manager);
 
+  // append a child, which must be larger than all the others, without adopting it
+  void CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
+
 private:
   void CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
 
-  void CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
-
   void CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
 
   MappingType array_[INTERNAL_PAGE_SIZE];
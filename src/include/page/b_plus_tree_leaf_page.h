@@ -66,11 +66,12 @@ public:
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient, const KeyType &middle_key,
                          BufferPoolManager *buffer_pool_manager);
 
+  // append an item, which must be larger than all the others
+  void CopyLastFrom(const MappingType &item);
+
 private:
   void CopyNFrom(MappingType *items, int size);
 
-  void CopyLastFrom(const MappingType &item);
-
   void CopyFirstFrom(const MappingType &item);
 
   page_id_t next_page_id_;
@@ -20,6 +20,19 @@ public:
    */
   bool AllocatePage(uint32_t &page_offset);
 
+  /**
+   * Allocate num_pages consecutive pages, the first free run from next_free_page_ on.
+   * @param page_offset Index in extent of the first page allocated.
+   * @return true if a free run was found.
+   */
+  bool AllocatePages(uint32_t num_pages, uint32_t &page_offset);
+
+  /**
+   * Allocate the page at page_offset, e.g. to redo an allocation.
+   * @return false if the page is allocated already.
+   */
+  bool AllocatePageAt(uint32_t page_offset);
+
   /**
    * @return true if successfully de-allocate a page.
    */
@@ -5,7 +5,7 @@
 
 #include "page/bitmap_page.h"
 
-static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 8) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 16) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
 class DiskFileMetaPage {
 public:
@@ -27,7 +27,11 @@ public:
 public:
   uint32_t num_allocated_pages_{0};
   uint32_t num_extents_ = {0};   // each extent consists with a bit map and BIT_MAP_SIZE pages
-  uint32_t extent_used_page_[(PAGE_SIZE - 8)/4];
+  // log offset of the begin record of the last complete checkpoint, where recovery starts reading the log
+  uint64_t checkpoint_offset_{0};
+  uint32_t extent_used_page_[(PAGE_SIZE - 16)/4];
 };
 
+static_assert(sizeof(DiskFileMetaPage) == PAGE_SIZE, "The disk file meta page must fill a page.");
+
 #endif //MINISQL_DISK_FILE_META_PAGE_H
@@ -0,0 +1,82 @@
+#ifndef MINISQL_FREE_SPACE_MAP_PAGE_H
+#define MINISQL_FREE_SPACE_MAP_PAGE_H
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * Free space map page records a coarse free space category for the table pages of a table heap,
+ * so that inserting a tuple does not need to walk through the whole page chain.
+ *
+ * Format (size in byte):
+ *  -----------------------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | NextPageId (4) | EntryCount (4) | TablePage_1 id (4) | ... |
+ *  -----------------------------------------------------------------------------------
+ *  ----------------------------------------------------------
+ * | ... | TablePage_1 category (4 bit) | TablePage_2 category (4 bit) | ... |
+ *  ----------------------------------------------------------
+ *
+ * Category c means that the table page has at least c * CATEGORY_UNIT bytes of free space.
+ */
+class FreeSpaceMapPage {
+public:
+  void Init(page_id_t page_id) {
+    page_id_ = page_id;
+    lsn_ = INVALID_LSN;
+    next_page_id_ = INVALID_PAGE_ID;
+    entry_count_ = 0;
+  }
+
+  inline page_id_t GetPageId() const { return page_id_; }
+
+  inline page_id_t GetNextPageId() const { return next_page_id_; }
+
+  inline void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  inline uint32_t GetEntryCount() const { return entry_count_; }
+
+  inline bool IsFull() const { return entry_count_ == MAX_ENTRIES; }
+
+  /**
+   * Append a table page to the end of this page.
+   * @param slot Index in this page of the appended entry.
+   * @return false if the page is full.
+   */
+  bool Append(page_id_t table_page_id, uint8_t category, uint32_t &slot);
+
+  page_id_t GetTablePageId(uint32_t slot) const;
+
+  uint8_t GetCategory(uint32_t slot) const;
+
+  void SetCategory(uint32_t slot, uint8_t category);
+
+  /**
+   * @return the category of a page with free_space bytes of free space (rounded down).
+   */
+  static uint8_t ToCategory(uint32_t free_space);
+
+  /**
+   * @return the minimal category a page must have to hold size bytes (rounded up),
+   * MAX_CATEGORY + 1 if no category can guarantee that much free space.
+   */
+  static uint8_t RequiredCategory(uint32_t size);
+
+public:
+  static constexpr uint8_t MAX_CATEGORY = 15;
+  static constexpr uint32_t CATEGORY_UNIT = PAGE_SIZE / (MAX_CATEGORY + 1);
+  static constexpr uint32_t SIZE_FSM_PAGE_HEADER = 16;
+  /** every entry takes 4 bytes for the page id and half a byte for the category */
+  static constexpr uint32_t MAX_ENTRIES = (PAGE_SIZE - SIZE_FSM_PAGE_HEADER) * 2 / 9;
+
+private:
+  page_id_t page_id_;
+  [[maybe_unused]] lsn_t lsn_;
+  page_id_t next_page_id_;
+  uint32_t entry_count_;
+  page_id_t table_page_ids_[MAX_ENTRIES];
+  uint8_t categories_[(MAX_ENTRIES + 1) / 2];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) <= PAGE_SIZE, "Free space map page exceeds page size.");
+
+#endif //MINISQL_FREE_SPACE_MAP_PAGE_H
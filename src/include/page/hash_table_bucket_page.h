@@ -0,0 +1,79 @@
+#ifndef MINISQL_HASH_TABLE_BUCKET_PAGE_H
+#define MINISQL_HASH_TABLE_BUCKET_PAGE_H
+
+/**
+ * hash_table_bucket_page.h
+ *
+ * Bucket of an extendible hash table, holding the key & value pairs whose
+ * keys hash to it, in key order, so that a probe is a binary search. A key
+ * may appear with several values. A bucket which is full and can not be split any further goes on in
+ * overflow pages of the same format, linked by NextPageId, each of them in
+ * key order; LocalDepth is only kept in the first page.
+ *
+ * Bucket page format (size in byte):
+ *  ------------------------------------------------------------------------
+ * | PageId (4) | LocalDepth (4) | CurrentSize (4) | NextPageId (4) |
+ *  ------------------------------------------------------------------------
+ *  ------------------------------------------------------------------------
+ * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ------------------------------------------------------------------------
+ */
+#include <utility>
+#include <vector>
+
+#include "page/b_plus_tree_page.h"
+
+#define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
+#define BUCKET_PAGE_HEADER_SIZE 16
+#define BUCKET_ARRAY_SIZE static_cast<int>((PAGE_SIZE - BUCKET_PAGE_HEADER_SIZE) / sizeof(MappingType))
+
+INDEX_TEMPLATE_ARGUMENTS
+class HashTableBucketPage {
+public:
+  // After creating a new bucket page from buffer pool, must call initialize
+  // method to set default values
+  void Init(page_id_t page_id, uint32_t local_depth);
+
+  page_id_t GetPageId() const { return page_id_; }
+
+  uint32_t GetLocalDepth() const { return local_depth_; }
+
+  void SetLocalDepth(uint32_t local_depth) { local_depth_ = local_depth; }
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  int GetSize() const { return size_; }
+
+  bool IsFull() const { return size_ == BUCKET_ARRAY_SIZE; }
+
+  const MappingType &GetItem(int index) const { return array_[index]; }
+
+  // insert a pair into a page which is not full, after the pairs with the same key
+  void Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  // add the values of key to result, false if there are none
+  bool GetValue(const KeyType &key, const KeyComparator &comparator, std::vector<ValueType> &result) const;
+
+  // whether a pair has key, or key and value if match_value
+  bool Contains(const KeyType &key, const ValueType &value, bool match_value, const KeyComparator &comparator) const;
+
+  // remove the pair of key and value, false if there is none
+  bool Remove(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  // remove all pairs
+  void Clear() { size_ = 0; }
+
+private:
+  // index of the first pair whose key is not smaller than key
+  int LowerBound(const KeyType &key, const KeyComparator &comparator) const;
+
+  page_id_t page_id_;
+  uint32_t local_depth_;
+  int size_;
+  page_id_t next_page_id_;
+  MappingType array_[0];
+};
+
+#endif  // MINISQL_HASH_TABLE_BUCKET_PAGE_H
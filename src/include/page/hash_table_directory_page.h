@@ -0,0 +1,72 @@
+#ifndef MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+#define MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+
+#include "common/config.h"
+
+/**
+ * hash_table_directory_page.h
+ *
+ * Directory of an extendible hash table. The directory has 2^GlobalDepth
+ * slots, slot i holds the bucket of the keys whose hash ends with the
+ * GlobalDepth low bits of i. The slots are kept in segment pages of
+ * DIRECTORY_SEGMENT_SIZE slots each, the directory page keeps the ids of the
+ * segment pages, so that the directory grows beyond a single page.
+ *
+ * Directory page format (size in byte):
+ *  --------------------------------------------------------------------
+ * | PageId (4) | GlobalDepth (4) | Segment_1 id (4) | Segment_2 id (4) | ...
+ *  --------------------------------------------------------------------
+ *
+ * Segment page format (size in byte):
+ *  --------------------------------------------------------------------
+ * | Bucket of slot 1 (4) | Bucket of slot 2 (4) | ...
+ *  --------------------------------------------------------------------
+ */
+#define DIRECTORY_SEGMENT_SIZE static_cast<uint32_t>(PAGE_SIZE / sizeof(page_id_t))
+#define DIRECTORY_MAX_SEGMENTS 512u
+#define DIRECTORY_MAX_DEPTH 19u
+
+class HashTableDirectoryPage {
+public:
+  // After creating a new directory page from buffer pool, must call initialize
+  // method to set default values
+  void Init(page_id_t page_id, page_id_t segment_page_id);
+
+  page_id_t GetPageId() const { return page_id_; }
+
+  uint32_t GetGlobalDepth() const { return global_depth_; }
+
+  void IncrGlobalDepth();
+
+  // number of slots of the directory
+  uint32_t Size() const { return 1u << global_depth_; }
+
+  // the slot of a hash
+  uint32_t SlotOf(uint32_t hash) const { return hash & (Size() - 1); }
+
+  // number of segment pages the slots are kept in
+  uint32_t NumSegments() const;
+
+  page_id_t GetSegmentPageId(uint32_t segment) const;
+
+  void SetSegmentPageId(uint32_t segment, page_id_t segment_page_id);
+
+private:
+  page_id_t page_id_;
+  uint32_t global_depth_;
+  page_id_t segments_[DIRECTORY_MAX_SEGMENTS];
+};
+
+class HashTableSegmentPage {
+public:
+  page_id_t GetBucketPageId(uint32_t slot) const { return buckets_[slot % DIRECTORY_SEGMENT_SIZE]; }
+
+  void SetBucketPageId(uint32_t slot, page_id_t bucket_page_id) {
+    buckets_[slot % DIRECTORY_SEGMENT_SIZE] = bucket_page_id;
+  }
+
+private:
+  page_id_t buckets_[PAGE_SIZE / sizeof(page_id_t)];
+};
+
+#endif  // MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
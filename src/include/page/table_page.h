@@ -18,6 +18,8 @@
  **/
 
 #include <cstring>
+#include <functional>
+#include <vector>
 #include "common/macros.h"
 #include "common/rowid.h"
 #include "page/page.h"
@@ -26,6 +28,11 @@
 #include "transaction/log_manager.h"
 #include "transaction/transaction.h"
 
+/**
+ * Decides on a row of a table from its serialized tuple, see Row for the format, without deserializing it
+ */
+using TupleFilter = std::function<bool(char *tuple)>;
+
 class TablePage : public Page {
 public:
   void Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Transaction *txn);
@@ -46,20 +53,59 @@ public:
 
   bool InsertTuple(Row &row, Schema *schema, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
+  /**
+   * Insert a serialized tuple without logging, to redo an insert. The tuple goes to the slot InsertTuple would
+   * have chosen, so the page is the same as after the insert which is redone.
+   * @param rid set to the row id of the tuple
+   */
+  bool InsertTuple(const char *tuple, uint32_t tuple_size, RowId *rid);
+
   bool MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
   bool UpdateTuple(const Row &new_row, Row *old_row, Schema *schema,
                    Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
+  /**
+   * Replace the tuple at rid by a serialized tuple without logging, to redo an update or to undo one
+   */
+  bool UpdateTuple(const RowId &rid, const char *tuple, uint32_t tuple_size);
+
   void ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
 
   void RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
 
-  bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager);
-
-  bool GetFirstTupleRid(RowId *first_rid);
+  /**
+   * @param copy_data false to let the char fields of the row point into this page, which then has to stay
+   * pinned and unchanged as long as the row is used
+   */
+  bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager, bool copy_data = true);
+
+  /**
+   * Same as GetTuple, but the row is only deserialized if its tuple passes filter, and only the given columns
+   * @param filter nullptr to read every row
+   * @param columns the columns the row is made of, in this order, nullptr for all columns of the schema
+   * @return false if the row does not exist or fails the filter
+   */
+  bool GetTuple(Row *row, Schema *schema, const TupleFilter &filter, const std::vector<uint32_t> *columns,
+                Transaction *txn, LockManager *lock_manager, bool copy_data = true);
+
+  /**
+   * @param tuple_size set to the size of the tuple at rid
+   * @param deleted set to whether the tuple is marked deleted
+   * @return the serialized tuple at rid, also if it is marked deleted, nullptr if there is none
+   */
+  char *GetTupleData(const RowId &rid, uint32_t *tuple_size, bool *deleted);
+
+  /**
+   * @param with_deleted true to also find the tuples marked deleted, which an older snapshot may still see
+   */
+  bool GetFirstTupleRid(RowId *first_rid, bool with_deleted = false);
+
+  bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid, bool with_deleted = false);
 
-  bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
 
 private:
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
@@ -72,10 +118,6 @@ private:
 
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
   }
@@ -98,11 +140,26 @@ private:
 
   static uint32_t UnsetDeletedFlag(uint32_t tuple_size) { return static_cast<uint32_t>(tuple_size & (~DELETE_MASK)); }
 
+  /**
+   * Claim the space of a new tuple of tuple_size bytes at the free space pointer, in a free slot or a new one
+   */
+  bool ReserveTuple(uint32_t tuple_size, uint32_t *slot_num);
+
+  /**
+   * Move the tuples so that the tuple in slot_num has tuple_size bytes
+   * @return where the tuple starts now, its content is undefined
+   */
+  char *ResizeTuple(uint32_t slot_num, uint32_t tuple_size);
+
+  /**
+   * Append the log record of a change of this page, stamp its LSN into the page and chain it to txn
+   */
+  void AppendLog(LogRecord &log_record, Transaction *txn, LogManager *log_manager);
+
 private:
   static_assert(sizeof(page_id_t) == 4);
   static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
   static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
-  static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
   static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
@@ -111,6 +168,7 @@ private:
   static constexpr size_t OFFSET_TUPLE_SIZE = 28;
 
 public:
+  static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t SIZE_MAX_ROW = PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE;
 };
 
@@ -60,13 +60,14 @@ public:
     }
   }
 
-  // copy constructor
+  // copy constructor, the copy of a char field owns its data, since the data of the other field may
+  // belong to the heap of a row or to a page and go away before the copy
   explicit Field(const Field &other) {
     type_id_ = other.type_id_;
     len_ = other.len_;
     is_null_ = other.is_null_;
-    manage_data_ = other.manage_data_;
-    if (type_id_ == TypeId::kTypeChar && !is_null_ && manage_data_) {
+    manage_data_ = type_id_ == TypeId::kTypeChar && !is_null_;
+    if (manage_data_) {
       value_.chars_ = new char[len_];
       memcpy(value_.chars_, other.value_.chars_, len_);
     } else {
@@ -96,14 +97,27 @@ public:
     return Type::GetInstance(type_id_)->SerializeTo(*this, buf);
   }
 
-  inline static uint32_t DeserializeFrom(char *buf, const TypeId type_id, Field **field, bool is_null, MemHeap *heap) {
-    return Type::GetInstance(type_id)->DeserializeFrom(buf, field, is_null, heap);
+  inline static uint32_t DeserializeFrom(char *buf, const TypeId type_id, Field **field, bool is_null, MemHeap *heap,
+                                         bool copy_data = true) {
+    return Type::GetInstance(type_id)->DeserializeFrom(buf, field, is_null, heap, copy_data);
   }
 
   inline uint32_t GetSerializedSize() const {
     return Type::GetInstance(type_id_)->GetSerializedSize(*this, is_null_);
   }
 
+  inline uint32_t SerializeToKey(char *buf) const {
+    return Type::GetInstance(type_id_)->SerializeToKey(*this, buf);
+  }
+
+  inline static uint32_t DeserializeFromKey(const char *buf, const TypeId type_id, Field **field, MemHeap *heap) {
+    return Type::GetInstance(type_id)->DeserializeFromKey(buf, field, heap);
+  }
+
+  inline uint32_t GetKeySerializedSize() const {
+    return Type::GetInstance(type_id_)->GetKeySerializedSize(*this);
+  }
+
   inline bool CheckComparable(const Field &o) const {
     return type_id_ == o.type_id_;
   }
@@ -9,29 +9,38 @@
 #include "record/schema.h"
 #include "utils/mem_heap.h"
 
+/**
+ * Version of the on-disk row format, bumped whenever the layout of a serialized row changes.
+ *  version 1: fields serialized one after another, nulls not recorded
+ *  version 2: null bitmap, fixed size fields at fixed offsets, char offset table and char data
+ */
+static constexpr uint32_t ROW_FORMAT_VERSION = 2;
+
 /**
  *  Row format:
- * -------------------------------------------
- * | Header | Field-1 | ... | Field-N |
- * -------------------------------------------
- *  Header format:
- * --------------------------------------------
- * | Field Nums | Null bitmap |
- * -------------------------------------------
- *  
- *
+ * -----------------------------------------------------------------------------
+ * | Null bitmap | Fixed size fields | Char offset table | Char-1 | ... | Char-M |
+ * -----------------------------------------------------------------------------
+ *  The null bitmap has a bit per column of the schema, set if the field is null. Ints and floats are
+ *  stored at offsets computed once per schema, a null one is zeroed. The offset table has an entry per
+ *  char column, the offset from the start of the row where the data of the column ends, which starts
+ *  where the data of the char column before it ends. So any field can be read without decoding the
+ *  others, see DeserializeField.
  */
 class Row {
 public:
+  /** size of an entry of the char offset table */
+  static constexpr uint32_t VAR_OFFSET_SIZE = sizeof(uint16_t);
+
   /**
    * Row used for insert
    * Field integrity should check by upper level
    */
-  explicit Row(std::vector<Field> &fields) : heap_(new SimpleMemHeap) {
+  explicit Row(std::vector<Field> &fields) : heap_(&arena_) {
     // deep copy
+    fields_.reserve(fields.size());
     for (auto &field : fields) {
-      void *buf = heap_->Allocate(sizeof(Field));
-      fields_.push_back(new(buf)Field(field));
+      fields_.push_back(ALLOC_P(heap_, Field)(field));
     }
   }
 
@@ -43,27 +52,36 @@ public:
   /**
    * Row used for deserialize and update
    */
-  Row(RowId rid) : rid_(rid), heap_(new SimpleMemHeap) {}
+  Row(RowId rid) : rid_(rid), heap_(&arena_) {}
 
   /**
    * Row copy function
    */
-  Row(const Row &other) : heap_(new SimpleMemHeap) {
-    if (!fields_.empty()) {
-      for (auto &field : fields_) {
-        heap_->Free(field);
-      }
-      fields_.clear();
-    }
-    rid_ = other.rid_;
+  Row(const Row &other) : rid_(other.rid_), heap_(&arena_) {
+    fields_.reserve(other.fields_.size());
     for (auto &field : other.fields_) {
-      void *buf = heap_->Allocate(sizeof(Field));
-      fields_.push_back(new(buf)Field(*field));
+      fields_.push_back(ALLOC_P(heap_, Field)(*field));
     }
   }
 
   virtual ~Row() {
-    delete heap_;
+    // the arena only releases the memory of the fields, the data a char field owns is freed by its destructor
+    for (auto &field : fields_) {
+      field->~Field();
+    }
+  }
+
+  /**
+   * Drop the fields and move the row to another row id, e.g. to deserialize the next row of a scan into it
+   * without allocating it anew. The arena of the row is reset, so that it reuses its memory.
+   */
+  void Clear(RowId rid) {
+    for (auto &field : fields_) {
+      field->~Field();
+    }
+    fields_.clear();
+    arena_.Reset();
+    rid_ = rid;
   }
 
   /**
@@ -71,15 +89,46 @@ public:
    */
   uint32_t SerializeTo(char *buf, Schema *schema) const;
 
-  uint32_t DeserializeFrom(char *buf, Schema *schema);
+  /**
+   * @param copy_data whether char fields copy their data into the heap of the row, or point into buf, which
+   * then has to stay unchanged as long as the row is used
+   */
+  uint32_t DeserializeFrom(char *buf, Schema *schema, bool copy_data = true);
+
+  /**
+   * Deserialize only the given columns, the fields of the row are the fields of these columns in this order
+   */
+  uint32_t DeserializeFrom(char *buf, Schema *schema, const std::vector<uint32_t> &columns, bool copy_data = true);
 
   /**
    * For empty row, return 0
-   * For non-empty row with null fields, eg: |null|null|null|, return header size only
+   * For non-empty row, return the fixed length of the schema plus the length of the non-null char fields
    * @return
    */
   uint32_t GetSerializedSize(Schema *schema) const;
 
+  /**
+   * Read a single field of a serialized row, e.g. straight from a page, without decoding the others
+   * @param copy_data same as for DeserializeFrom
+   * @return the field, allocated from heap
+   */
+  static Field *DeserializeField(char *buf, Schema *schema, uint32_t column_index, MemHeap *heap,
+                                 bool copy_data = true);
+
+  /**
+   * Read a single field of a serialized row without allocating, a char field points into buf
+   */
+  static Field ReadField(char *buf, Schema *schema, uint32_t column_index);
+
+  static inline bool IsFieldNull(const char *buf, uint32_t column_index) {
+    return (buf[column_index / 8] >> (column_index % 8)) & 1;
+  }
+
+  /**
+   * @return the size of a serialized row, read from its offset table
+   */
+  static uint32_t GetSerializedSize(const char *buf, Schema *schema);
+
   inline const RowId GetRowId() const { return rid_; }
 
   inline void SetRowId(RowId rid) { rid_ = rid; }
@@ -93,12 +142,16 @@ public:
 
   inline size_t GetFieldCount() const { return fields_.size(); }
 
+  inline MemHeap *GetMemHeap() const { return heap_; }
+
 private:
   Row &operator=(const Row &other) = delete;
 
 private:
   RowId rid_{};
   std::vector<Field *> fields_;   /** Make sure that all fields are created by mem heap */
+  // the fields and the data of deserialized char fields
+  ArenaMemHeap arena_;
   MemHeap *heap_{nullptr};
 };
 
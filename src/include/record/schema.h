@@ -10,7 +10,7 @@
 
 class Schema {
 public:
-  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) {}
+  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) { InitRowLayout(); }
 
   inline const std::vector<Column *> &GetColumns() const { return columns_; }
 
@@ -28,6 +28,22 @@ public:
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /**
+   * The layout of a serialized row of this schema, see Row. The offset of a fixed size column is where its
+   * value is, the offset of a char column where the end offset of its data is in the offset table.
+   */
+  inline uint32_t GetColumnOffset(const uint32_t column_index) const { return column_offsets_[column_index]; }
+
+  /**
+   * @return the offset of the offset table of the char columns in a serialized row
+   */
+  inline uint32_t GetVarOffsetsBegin() const { return var_offsets_begin_; }
+
+  /**
+   * @return the size of a serialized row up to the data of its char columns
+   */
+  inline uint32_t GetFixedLength() const { return fixed_length_; }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -73,8 +89,13 @@ public:
   static uint32_t DeserializeFrom(char *buf, Schema *&schema, MemHeap *heap);
 
 private:
+  void InitRowLayout();
+
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;   /** don't need to delete pointer to column */
+  std::vector<uint32_t> column_offsets_;
+  uint32_t var_offsets_begin_{0};
+  uint32_t fixed_length_{0};
 };
 
 using IndexSchema = Schema;
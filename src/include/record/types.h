@@ -49,12 +49,23 @@ public:
   // Serialize this field into the given storage space.
   virtual uint32_t SerializeTo(const Field &field, char *buf) const;
 
-  // Deserialize a field of the given type from the given storage space.
-  virtual uint32_t DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap) const;
+  // Deserialize a field of the given type from the given storage space. The field and its data are
+  // allocated from heap, unless copy_data is false and the field may point into storage.
+  virtual uint32_t DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap, bool copy_data) const;
 
   // Get serialize size of a field
   virtual uint32_t GetSerializedSize(const Field &field, bool is_null) const;
 
+  // Serialize this field into a memcomparable format, so that the order of two encoded
+  // fields of the same type is the order of their bytes. Used for index keys.
+  virtual uint32_t SerializeToKey(const Field &field, char *buf) const;
+
+  // Deserialize a field of the given type from the memcomparable format.
+  virtual uint32_t DeserializeFromKey(const char *storage, Field **field, MemHeap *heap) const;
+
+  // Get memcomparable serialize size of a field
+  virtual uint32_t GetKeySerializedSize(const Field &field) const;
+
   // Access the raw variable length data
   virtual const char *GetData(const Field &val) const;
 
@@ -73,6 +84,11 @@ public:
 
   virtual CmpBool CompareGreaterThanEquals(const Field &left, const Field &right) const;
 
+public:
+  /** first byte of every encoded key field, nulls are ordered before all other values */
+  static constexpr char KEY_NULL = 0x00;
+  static constexpr char KEY_NOT_NULL = 0x01;
+
 protected:
   TypeId type_id_{TypeId::kTypeInvalid};
   static Type *type_singletons_[TypeId::KMaxTypeId + 1];
@@ -84,10 +100,17 @@ public:
 
   virtual uint32_t SerializeTo(const Field &field, char *buf) const override;
 
-  virtual uint32_t DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap) const override;
+  virtual uint32_t DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap,
+                                   bool copy_data) const override;
 
   virtual uint32_t GetSerializedSize(const Field &field, bool is_null) const override;
 
+  virtual uint32_t SerializeToKey(const Field &field, char *buf) const override;
+
+  virtual uint32_t DeserializeFromKey(const char *storage, Field **field, MemHeap *heap) const override;
+
+  virtual uint32_t GetKeySerializedSize(const Field &field) const override;
+
   virtual CmpBool CompareEquals(const Field &left, const Field &right) const override;
 
   virtual CmpBool CompareNotEquals(const Field &left, const Field &right) const override;
@@ -107,10 +130,17 @@ public:
 
   virtual uint32_t SerializeTo(const Field &field, char *buf) const override;
 
-  virtual uint32_t DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap) const override;
+  virtual uint32_t DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap,
+                                   bool copy_data) const override;
 
   virtual uint32_t GetSerializedSize(const Field &field, bool is_null) const override;
 
+  virtual uint32_t SerializeToKey(const Field &field, char *buf) const override;
+
+  virtual uint32_t DeserializeFromKey(const char *storage, Field **field, MemHeap *heap) const override;
+
+  virtual uint32_t GetKeySerializedSize(const Field &field) const override;
+
   virtual const char *GetData(const Field &val) const override;
 
   virtual uint32_t GetLength(const Field &val) const override;
@@ -134,10 +164,17 @@ public:
 
   virtual uint32_t SerializeTo(const Field &field, char *buf) const override;
 
-  virtual uint32_t DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap) const override;
+  virtual uint32_t DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap,
+                                   bool copy_data) const override;
 
   virtual uint32_t GetSerializedSize(const Field &field, bool is_null) const override;
 
+  virtual uint32_t SerializeToKey(const Field &field, char *buf) const override;
+
+  virtual uint32_t DeserializeFromKey(const char *storage, Field **field, MemHeap *heap) const override;
+
+  virtual uint32_t GetKeySerializedSize(const Field &field) const override;
+
   virtual CmpBool CompareEquals(const Field &left, const Field &right) const override;
 
   virtual CmpBool CompareNotEquals(const Field &left, const Field &right) const override;
@@ -0,0 +1,96 @@
+#ifndef MINISQL_ASYNC_IO_H
+#define MINISQL_ASYNC_IO_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * Implementations of asynchronous I/O a DiskManager can use.
+ * kAuto takes io_uring when the kernel supports it and falls back to the thread pool otherwise.
+ */
+enum class AsyncIOEngineType {
+  kAuto,
+  kIOUring,
+  kThreadPool
+};
+
+/**
+ * Completion handle of an asynchronous read or write. It may cover several system level operations,
+ * e.g. a run of pages split at an extent boundary, and completes when all of them have finished.
+ */
+class AsyncIOHandle {
+public:
+  explicit AsyncIOHandle(size_t pending = 0) : pending_(pending) {}
+
+  /**
+   * Block until the I/O has completed
+   * @return true if every operation succeeded
+   */
+  bool Wait();
+
+  /** @return whether the I/O has completed */
+  bool IsDone();
+
+  /** Add an operation the handle waits for, before it is submitted */
+  void AddPending();
+
+  /** Called by the engine when one operation has finished */
+  void Complete(bool success);
+
+private:
+  std::mutex latch_;
+  std::condition_variable cv_;
+  size_t pending_;
+  bool success_{true};
+};
+
+using AsyncIOHandlePtr = std::shared_ptr<AsyncIOHandle>;
+
+/**
+ * A single positioned read or write on a file descriptor.
+ * A read ending beyond the end of the file is filled up with zeros, like DiskManager::ReadPage.
+ */
+struct AsyncIOOp {
+  bool is_write{false};
+  int fd{-1};
+  size_t offset{0};
+  char *data{nullptr};
+  size_t size{0};
+  AsyncIOHandlePtr handle;
+};
+
+/**
+ * AsyncIOEngine keeps many positioned reads and writes in flight and completes their handles
+ * from a background thread.
+ */
+class AsyncIOEngine {
+public:
+  virtual ~AsyncIOEngine() = default;
+
+  /**
+   * Start the operations, without waiting for them to complete
+   */
+  virtual void Submit(std::vector<AsyncIOOp> &ops) = 0;
+
+  /** @return kIOUring or kThreadPool */
+  virtual AsyncIOEngineType GetType() const = 0;
+
+  /**
+   * Create an engine of the given type. kIOUring falls back to the thread pool if io_uring is not
+   * available, check GetType() for the engine actually created.
+   * @param queue_depth maximum number of operations in flight
+   */
+  static std::unique_ptr<AsyncIOEngine> Create(AsyncIOEngineType type, size_t queue_depth = 64);
+
+protected:
+  /**
+   * Finish an operation which transferred result bytes, or failed with -errno
+   */
+  static void FinishOp(AsyncIOOp &op, long result);
+};
+
+#endif  // MINISQL_ASYNC_IO_H
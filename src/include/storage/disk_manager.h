@@ -5,12 +5,39 @@
 #include <atomic>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <string>
+#include <vector>
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/async_io.h"
+
+/**
+ * How DiskManager accesses the database file.
+ *
+ * kFileDescriptor uses positioned pread/pwrite on a file descriptor and keeps the file size in memory,
+ * so page reads and writes do not share a cursor and run concurrently.
+ * kFstream seeks and reads a single std::fstream under db_io_latch_, one request at a time.
+ */
+enum class DiskIOBackend {
+  kFileDescriptor,
+  kFstream
+};
+
+/**
+ * An asynchronous read or write of num_pages pages with consecutive logical page ids.
+ * page_data must stay valid until the request has completed.
+ */
+struct PageIORequest {
+  bool is_write{false};
+  page_id_t logical_page_id{INVALID_PAGE_ID};
+  char *page_data{nullptr};
+  size_t num_pages{1};
+};
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
@@ -22,7 +49,8 @@
  */
 class DiskManager {
 public:
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, DiskIOBackend backend = DiskIOBackend::kFileDescriptor,
+                       AsyncIOEngineType async_io_type = AsyncIOEngineType::kAuto);
 
   ~DiskManager() {
     if (!closed) {
@@ -42,12 +70,48 @@ public:
    */
   void WritePage(page_id_t logical_page_id, const char *page_data);
 
+  /**
+   * Write num_pages pages with consecutive logical page ids starting at first_logical_page_id.
+   * Pages contiguous on disk are written and flushed together.
+   * @param page_data num_pages * PAGE_SIZE bytes of page content
+   */
+  void WritePages(page_id_t first_logical_page_id, const char *page_data, size_t num_pages);
+
+  /**
+   * Start reading a page, the returned handle completes when page_data is filled
+   */
+  AsyncIOHandlePtr ReadPageAsync(page_id_t logical_page_id, char *page_data);
+
+  /**
+   * Start writing a page, the returned handle completes when the page is written
+   */
+  AsyncIOHandlePtr WritePageAsync(page_id_t logical_page_id, const char *page_data);
+
+  /**
+   * Start all requests at once, with a single system call for io_uring
+   * @return a completion handle for every request
+   */
+  std::vector<AsyncIOHandlePtr> SubmitBatch(const std::vector<PageIORequest> &requests);
+
+  /**
+   * The engine is created by the first asynchronous request. With the fstream backend requests are
+   * executed synchronously and the type is only a preference.
+   * @return the engine type which serves asynchronous requests
+   */
+  AsyncIOEngineType GetAsyncIOEngineType();
+
   /**
    * Get next free page from disk
    * @return logical page id of allocated page
    */
   page_id_t AllocatePage();
 
+  /**
+   * Allocate a given page, e.g. to redo its allocation
+   * @return false if the page is allocated already
+   */
+  bool AllocatePageAt(page_id_t logical_page_id);
+
   /**
    * Free this page and reset bit map
    */
@@ -58,6 +122,64 @@ public:
    */
   bool IsPageFree(page_id_t logical_page_id);
 
+  /**
+   * Reserve num_pages pages with consecutive logical ids within one extent, so that they are contiguous on disk.
+   * Reserved pages are not handed out by AllocatePage; they become allocated one by one with
+   * AllocateReservedPage and are returned with ReleasePages. Reservations are not persisted.
+   * @return logical page id of the first page, INVALID_PAGE_ID if no extent has such a run
+   */
+  page_id_t ReservePages(size_t num_pages);
+
+  /**
+   * Allocate a page reserved by ReservePages
+   * @return false if the page is not reserved
+   */
+  bool AllocateReservedPage(page_id_t logical_page_id);
+
+  /**
+   * Free the pages of a reservation which are still reserved
+   */
+  void ReleasePages(page_id_t first_logical_page_id, size_t num_pages);
+
+  /**
+   * Write the bitmap pages and the meta page changed since the last call.
+   * Page allocation only updates them in memory, they are written here and when the disk manager is closed.
+   */
+  void FlushMetaData();
+
+  /**
+   * Wait until the pages written so far are on disk
+   */
+  void Sync();
+
+  /**
+   * Log offset of the begin record of the last complete checkpoint, kept in the meta page and persisted
+   * by FlushMetaData. 0 if no checkpoint was taken.
+   */
+  size_t GetCheckpointOffset();
+
+  void SetCheckpointOffset(size_t offset);
+
+  /**
+   * Append log data to the log file and sync it to disk.
+   * The log file is named after the database file with extension .log, it is opened on first use.
+   */
+  void WriteLog(const char *log_data, size_t size);
+
+  /**
+   * Read log data from offset on
+   * @return number of bytes read, less than size at the end of the log
+   */
+  size_t ReadLog(char *log_data, size_t size, size_t offset);
+
+  /** @return size of the log file in bytes */
+  size_t GetLogSize();
+
+  /**
+   * Cut the log file to size bytes, e.g. to drop a record torn by a crash before appending after it
+   */
+  void TruncateLog(size_t size);
+
   /**
    * Shut down the disk manager and close all the file resources.
    */
@@ -75,6 +197,10 @@ public:
 
   inline std::string GetFileName() const { return file_name_; }
 
+  inline std::string GetLogFileName() const { return log_name_; }
+
+  inline DiskIOBackend GetBackend() const { return backend_; }
+
 private:
   /**
    * Helper function to get disk file size
@@ -91,19 +217,77 @@ private:
    */
   void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
 
+  /**
+   * Write num_pages consecutive physical pages in disk
+   */
+  void WritePhysicalPages(page_id_t first_physical_page_id, const char *page_data, size_t num_pages);
+
+  /**
+   * Create the asynchronous I/O engine on first use
+   */
+  AsyncIOEngine *GetAsyncIOEngine();
+
+  /**
+   * Raise the cached file size after a write up to end
+   */
+  void GrowFileSize(size_t end);
+
+  /**
+   * Open the log file on first use, log_io_latch_ must be held
+   */
+  bool OpenLog();
+
+  /**
+   * Lock db_io_latch_ if page reads and writes share the stream cursor
+   */
+  std::unique_lock<std::recursive_mutex> LockIO();
+
   /**
    * Map logical page id to physical page id
    */
   page_id_t MapPageId(page_id_t logical_page_id);
 
+  /**
+   * @return the bitmap of an extent, read from disk on first use
+   */
+  BitmapPage<PAGE_SIZE> *GetBitmap(uint32_t extent_id);
+
+  /**
+   * Physical page id of the bitmap page of an extent
+   */
+  static inline page_id_t MapBitmapPageId(uint32_t extent_id) {
+    return static_cast<page_id_t>(extent_id * (BITMAP_SIZE + 1) + 1);
+  }
+
 private:
-  // stream to write db file
+  DiskIOBackend backend_;
+  // stream to write db file, kFstream only
   std::fstream db_io_;
+  // file descriptor of db file, kFileDescriptor only, and its size in bytes
+  int db_fd_{-1};
+  std::atomic<size_t> file_size_{0};
   std::string file_name_;
+  // log file, appended by WriteLog
+  std::string log_name_;
+  int log_fd_{-1};
+  size_t log_size_{0};
+  std::mutex log_io_latch_;
+  // asynchronous reads and writes, created on first use under async_io_latch_
+  AsyncIOEngineType async_io_type_;
+  std::unique_ptr<AsyncIOEngine> async_io_;
+  std::mutex async_io_latch_;
   // with multiple buffer pool instances, need to protect file access
   std::recursive_mutex db_io_latch_;
   bool closed{false};
   char meta_data_[PAGE_SIZE];
+  // bitmaps of the extents cached in memory, null until first used, and whether they differ from disk
+  std::vector<std::unique_ptr<BitmapPage<PAGE_SIZE>>> bitmaps_;
+  std::vector<bool> bitmap_dirty_;
+  bool meta_dirty_{false};
+  // every extent before it is full
+  uint32_t next_free_extent_{0};
+  // pages reserved but not allocated yet, they are allocated in the cached bitmaps and free on disk
+  std::set<page_id_t> reserved_;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#ifndef MINISQL_FREE_SPACE_MAP_H
+#define MINISQL_FREE_SPACE_MAP_H
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "page/free_space_map_page.h"
+
+/**
+ * Free space map of a table heap.
+ *
+ * The categories of all table pages are persisted in a chain of FreeSpaceMapPage, in the same order
+ * as the table pages are linked in the heap. An in-memory copy of the categories, together with the
+ * maximum category of every map page, is kept so that finding a page with enough room only touches
+ * the map pages which can possibly satisfy the request.
+ *
+ * Changes of the map pages are logged as page writes, see PageLogScope. A table page linked to the heap
+ * before a crash may be missing from the map, Load adds it.
+ *
+ * The map is shared by all the threads changing the heap, which hold the latches of different table pages,
+ * so the in-memory copy and the map pages are guarded by a latch of their own.
+ */
+class FreeSpaceMap {
+public:
+  explicit FreeSpaceMap(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {}
+
+  /**
+   * Create an empty free space map.
+   */
+  bool Init();
+
+  /**
+   * Load an existing free space map. If the heap was created without a free space map,
+   * i.e. first_page_id is INVALID_PAGE_ID, the map is rebuilt by walking the heap once.
+   */
+  void Load(page_id_t first_page_id, page_id_t heap_first_page_id);
+
+  /**
+   * @return a table page which has at least size bytes of free space, INVALID_PAGE_ID if none
+   */
+  page_id_t FindPage(uint32_t size) const;
+
+  /**
+   * Register a table page newly linked to the end of the heap.
+   */
+  bool AddPage(page_id_t table_page_id, uint32_t free_space);
+
+  /**
+   * Record the current free space of a table page.
+   */
+  void UpdatePage(page_id_t table_page_id, uint32_t free_space);
+
+  /**
+   * Release all map pages.
+   */
+  void Free();
+
+  inline page_id_t GetFirstPageId() const {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    return first_page_id_;
+  }
+
+  /**
+   * @return the last page of the heap
+   */
+  inline page_id_t GetLastTablePageId() const {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    return table_page_ids_.empty() ? INVALID_PAGE_ID : table_page_ids_.back();
+  }
+
+  inline size_t GetTablePageCount() const {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    return table_page_ids_.size();
+  }
+
+private:
+  void RecomputeMaxCategory(size_t map_index);
+
+private:
+  BufferPoolManager *buffer_pool_manager_;
+  // guards the members below and the map pages
+  mutable std::recursive_mutex latch_;
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+  /** ids of map pages in chain order */
+  std::vector<page_id_t> map_page_ids_;
+  /** maximum category of the entries held by each map page */
+  std::vector<uint8_t> max_categories_;
+  /** table page ids and their categories in heap order */
+  std::vector<page_id_t> table_page_ids_;
+  std::vector<uint8_t> categories_;
+  /** table page id -> index in table_page_ids_ */
+  std::unordered_map<page_id_t, uint32_t> positions_;
+};
+
+#endif //MINISQL_FREE_SPACE_MAP_H
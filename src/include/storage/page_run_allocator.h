@@ -0,0 +1,54 @@
+#ifndef MINISQL_PAGE_RUN_ALLOCATOR_H
+#define MINISQL_PAGE_RUN_ALLOCATOR_H
+
+#include <mutex>
+
+#include "common/config.h"
+#include "storage/disk_manager.h"
+
+/**
+ * PageRunAllocator hands out the pages of one object, e.g. a table heap or the leaves of an index,
+ * from runs of contiguous pages it reserves on the DiskManager. Pages allocated one after the other
+ * are then neighbours on disk, and a scan of the object reads the file sequentially.
+ */
+class PageRunAllocator {
+public:
+  explicit PageRunAllocator(DiskManager *disk_manager, size_t run_size = DEFAULT_PAGE_RUN_SIZE);
+
+  /**
+   * @return the next page of the current run, a page from a new run once it is used up
+   */
+  page_id_t AllocatePage();
+
+  /**
+   * Give the pages of the current run which were not allocated back to the disk manager
+   */
+  void Release();
+
+private:
+  DiskManager *disk_manager_;
+  size_t run_size_;
+  std::mutex latch_;
+  // pages [next_page_id_, end_page_id_) are reserved for this object
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  page_id_t end_page_id_{INVALID_PAGE_ID};
+};
+
+/**
+ * Contiguity of a chain of pages, e.g. the pages of a table heap or the leaves of an index.
+ * A run is a longest part of the chain whose pages follow each other in the file.
+ */
+struct PageRunStats {
+  size_t num_pages{0};
+  size_t num_runs{0};
+  page_id_t last_page_id{INVALID_PAGE_ID};
+
+  /** Add the next page of the chain */
+  void AddPage(page_id_t page_id);
+
+  inline double AverageRunLength() const {
+    return num_runs == 0 ? 0 : static_cast<double>(num_pages) / num_runs;
+  }
+};
+
+#endif  // MINISQL_PAGE_RUN_ALLOCATOR_H
@@ -1,32 +1,42 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <mutex>
+
 #include "buffer/buffer_pool_manager.h"
 #include "page/table_page.h"
+#include "storage/free_space_map.h"
+#include "storage/page_run_allocator.h"
 #include "storage/table_iterator.h"
 #include "transaction/log_manager.h"
 #include "transaction/lock_manager.h"
+#include "transaction/version_manager.h"
 
 class TableHeap {
   friend class TableIterator;
 
 public:
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap) {
+                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap,
+                           VersionManager *version_manager = nullptr) {
     void *buf = heap->Allocate(sizeof(TableHeap));
-    return new(buf) TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
+    return new(buf) TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager, version_manager);
   }
 
-  static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap) {
+  static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id,
+                           page_id_t free_space_map_page_id, Schema *schema,
+                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap,
+                           VersionManager *version_manager = nullptr) {
     void *buf = heap->Allocate(sizeof(TableHeap));
-    return new(buf) TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+    return new(buf) TableHeap(buffer_pool_manager, first_page_id, free_space_map_page_id, schema,
+                              log_manager, lock_manager, version_manager);
   }
 
   ~TableHeap() {}
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * The new row is locked exclusively for txn, the insert is left for its rollback if txn is denied the lock.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The transaction performing the insert
    * @return true iff the insert is successful
@@ -34,15 +44,19 @@ public:
   bool InsertTuple(Row &row, Transaction *txn);
 
   /**
-   * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
+   * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called, by the commit of txn if any,
+   * or once no snapshot sees the row any more.
+   * The row is locked exclusively for txn first, see LockManager.
    * @param[in] rid Resource id of the tuple of delete
    * @param[in] txn Transaction performing the delete
-   * @return true iff the delete is successful (i.e the tuple exists)
+   * @return true iff the delete is successful (i.e the tuple exists), txn is aborted if it reads a snapshot and
+   * the row was changed since, see VersionManager
    */
   bool MarkDelete(const RowId &rid, Transaction *txn);
 
   /**
    * if the new tuple is too large to fit in the old page, return false (will delete and insert)
+   * The row is locked exclusively for txn first, and fails as MarkDelete if it was changed since the snapshot of txn.
    * @param[in] row Tuple of new row
    * @param[in] rid Rid of the old tuple
    * @param[in] txn Transaction performing the update
@@ -65,10 +79,11 @@ public:
   void RollbackDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * Read a tuple from the table.
+   * Read a tuple from the table. The row is locked shared for txn first, unless it is found missing, or the version
+   * the snapshot of txn sees is read without a lock.
    * @param[in/out] row Output variable for the tuple, row id of the tuple is wrapped in row
    * @param[in] txn transaction performing the read
-   * @return true if the read was successful (i.e. the tuple exists)
+   * @return true if the read was successful (i.e. the tuple exists), false also if txn was denied the lock
    */
   bool GetTuple(Row *row, Transaction *txn);
 
@@ -82,6 +97,12 @@ public:
    */
   TableIterator Begin(Transaction *txn);
 
+  /**
+   * @return the begin iterator of a scan of the rows whose tuple passes filter, made of the given columns,
+   * see TableIterator
+   */
+  TableIterator Begin(Transaction *txn, TupleFilter filter, std::vector<uint32_t> columns);
+
   /**
    * @return the end iterator of this table
    */
@@ -92,41 +113,112 @@ public:
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return the id of the first page of the free space map of this table
+   */
+  inline page_id_t GetFreeSpaceMapPageId() const { return free_space_map_.GetFirstPageId(); }
+
+  /**
+   * @return how contiguous the pages of this table are on disk, in the order of the page chain
+   */
+  PageRunStats GetPageRunStats();
+
+private:
+  /**
+   * Try to insert the tuple into the given page and refresh its free space in the free space map.
+   */
+  bool InsertIntoPage(page_id_t page_id, Row &row, Transaction *txn);
+
+  /**
+   * Link a new page holding the tuple to the end of the heap, the append latch is held
+   * @param last_page_id the last page of the heap
+   */
+  bool AppendPage(page_id_t last_page_id, Row &row, Transaction *txn);
+
+  /**
+   * Lock the row txn inserted at rid exclusively, waiting only if it could not be locked under the latch of its page
+   * @return false if txn was denied the lock and is now aborted
+   */
+  bool LockInsertedRow(const RowId &rid, Transaction *txn);
+
+  /**
+   * Keep the version of the row at rid before txn changes it, the page is write latched
+   * @param exists whether the row exists after the change
+   * @return false if the row is missing, or if txn may not change it and is now aborted
+   */
+  bool RecordWrite(TablePage *page, const RowId &rid, Transaction *txn, bool exists);
+
+  /**
+   * Find the tuple of the row at rid of page which txn sees, the page is latched
+   * @param version holds the tuple if it is an older version of the row
+   * @return the tuple, nullptr if txn sees none
+   */
+  char *GetVisibleTuple(TablePage *page, const RowId &rid, Transaction *txn, std::vector<char> &version);
+
+  /** @return true if the rows accessed by txn are locked */
+  inline bool IsLocking(Transaction *txn) const { return txn != nullptr && lock_manager_ != nullptr; }
+
+  /** @return true if txn reads the versions of its snapshot, without locks */
+  inline bool ReadsSnapshot(Transaction *txn) const {
+    return txn != nullptr && version_manager_ != nullptr && txn->GetIsolationLevel() == IsolationLevel::kSnapshot;
+  }
+
+  /**
+   * @param columns nullptr for all columns
+   */
+  TableIterator BeginScan(Transaction *txn, TupleFilter filter, std::shared_ptr<const std::vector<uint32_t>> columns);
+
 private:
   /**
    * create table heap and initialize first page
    */
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                     LogManager *log_manager, LockManager *lock_manager) :
+                     LogManager *log_manager, LockManager *lock_manager, VersionManager *version_manager) :
           buffer_pool_manager_(buffer_pool_manager),
+          page_allocator_(buffer_pool_manager->GetDiskManager()),
+          free_space_map_(buffer_pool_manager),
           schema_(schema),
           log_manager_(log_manager),
-          lock_manager_(lock_manager) {
-      TablePage *first_page = (TablePage *)buffer_pool_manager_->NewPage(first_page_id_);
+          lock_manager_(lock_manager),
+          version_manager_(version_manager) {
+      TablePage *first_page = (TablePage *)buffer_pool_manager_->NewPageFrom(first_page_id_, &page_allocator_);
       first_page->Init(first_page_id_,INVALID_PAGE_ID,log_manager, txn);
-//      buffer_pool_manager_->UnpinPage(first_page_id_, true);
+      free_space_map_.Init();
+      free_space_map_.AddPage(first_page_id_, first_page->GetFreeSpaceRemaining());
+      buffer_pool_manager_->UnpinPage(first_page_id_, true);
   };
 
   /**
    * load existing table heap by first_page_id
    */
-  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id,
+                     page_id_t free_space_map_page_id, Schema *schema,
+                     LogManager *log_manager, LockManager *lock_manager, VersionManager *version_manager)
           : buffer_pool_manager_(buffer_pool_manager),
             first_page_id_(first_page_id),
+            page_allocator_(buffer_pool_manager->GetDiskManager()),
+            free_space_map_(buffer_pool_manager),
             schema_(schema),
             log_manager_(log_manager),
-            lock_manager_(lock_manager) {
-//    TablePage *first_page = (TablePage *)buffer_pool_manager_->FetchPage(first_page_id_);
-//    first_page->Init(first_page_id_,INVALID_PAGE_ID,log_manager, nullptr);
+            lock_manager_(lock_manager),
+            version_manager_(version_manager) {
+    free_space_map_.Load(free_space_map_page_id, first_page_id_);
   }
 
 private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
+  // new pages of the heap, contiguous with the pages allocated before them
+  PageRunAllocator page_allocator_;
+  FreeSpaceMap free_space_map_;
+  // held while a page is linked to the end of the heap, so that two new pages are never linked to the same one
+  std::mutex append_latch_;
   Schema *schema_;
   [[maybe_unused]] LogManager *log_manager_;
-  [[maybe_unused]] LockManager *lock_manager_;
+  // locks the rows accessed by a transaction, null to run without locking
+  LockManager *lock_manager_;
+  // keeps the older versions of the rows changed, null to read the latest rows only
+  VersionManager *version_manager_;
 };
 
 #endif  // MINISQL_TABLE_HEAP_H
@@ -1,7 +1,11 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include <memory>
+
+#include "buffer/read_ahead.h"
 #include "common/rowid.h"
+#include "page/table_page.h"
 #include "record/row.h"
 #include "transaction/transaction.h"
 
@@ -16,7 +20,14 @@ public:
 
   TableIterator(const TableIterator &other);
 
-  TableIterator(TableHeap *table_heap, RowId rid);
+  /**
+   * @param filter the rows whose tuple fails it are skipped without being deserialized, nullptr for none
+   * @param columns the columns the rows are made of, nullptr for all
+   * @param txn the rows are locked shared for it before they are read. If it is denied a lock, the scan ends there
+   * and txn is aborted. If it reads a snapshot, the versions of the rows it sees are read without locks instead.
+   */
+  TableIterator(TableHeap *table_heap, RowId rid, TupleFilter filter = nullptr,
+                std::shared_ptr<const std::vector<uint32_t>> columns = nullptr, Transaction *txn = nullptr);
 
   virtual ~TableIterator();
 
@@ -35,9 +46,32 @@ public:
   TableIterator operator++(int);
 
 private:
+  /**
+   * Read the row at rid of page, which stays pinned, into the row of the iterator
+   * @return false if the row fails the filter or is not in the snapshot read, true also if the scan ended on a
+   * lock denied
+   */
+  bool ReadRow(TablePage *page, RowId rid);
+
+  /**
+   * Move to the next row of the table, or to the end
+   * @return false if the row moved to fails the filter
+   */
+  bool Advance();
+
   // add your own private member variables here
   TableHeap *table_heap_;
+  // one row is reused for every row read, copied from its page under the read latch of the page, which is kept
+  // pinned until the iterator moves on
   Row *row_;
+  TablePage *page_{nullptr};
+  // prefetches the following pages of the heap, shared by copies of the iterator
+  std::shared_ptr<ScanReadAhead> read_ahead_;
+  TupleFilter filter_;
+  std::shared_ptr<const std::vector<uint32_t>> columns_;
+  Transaction *txn_{nullptr};
+  // the older version of the row read from a snapshot
+  std::vector<char> version_;
 };
 
 #endif //MINISQL_TABLE_ITERATOR_H
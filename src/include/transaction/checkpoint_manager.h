@@ -0,0 +1,102 @@
+#ifndef MINISQL_CHECKPOINT_MANAGER_H
+#define MINISQL_CHECKPOINT_MANAGER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk_manager.h"
+#include "transaction/log_manager.h"
+#include "transaction/transaction_manager.h"
+
+/**
+ * Content of a checkpoint end record.
+ *
+ * Format (size in bytes):
+ * | RedoLSN (4) | RedoOffset (8) | UndoOffset (8) | NextTxnId (4) | TxnCount (4) |
+ * then per active transaction: | TxnId (4) | LastLSN (4) | BeginOffset (8) |
+ * then: | PageCount (4) | then per dirty page: | PageId (4) | RecLSN (4) |
+ */
+struct CheckpointData {
+  // no change before redo_lsn_ needs to be redone, the record at redo_offset_ is not after it
+  lsn_t redo_lsn_{0};
+  size_t redo_offset_{0};
+  // no record of an active transaction is before undo_offset_
+  size_t undo_offset_{0};
+  txn_id_t next_txn_id_{0};
+  std::vector<ActiveTransaction> active_txns_;
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_pages_;
+
+  void SerializeTo(std::vector<char> &data) const;
+
+  /** @return false if data is not a complete checkpoint */
+  static bool DeserializeFrom(const char *data, uint32_t size, CheckpointData *checkpoint);
+};
+
+/**
+ * CheckpointManager takes fuzzy checkpoints, which bound the part of the log read by recovery.
+ *
+ * A checkpoint logs a begin record, then an end record with the active transactions and the dirty page
+ * table, and only then records the offset of the begin record in the meta page of the database file.
+ * Transactions and writes of pages go on meanwhile. Before logging its begin record, a checkpoint writes
+ * the pages which are dirty since before the previous checkpoint, so that recovery never reads the log
+ * further back than about two checkpoint intervals, except for the records of long transactions.
+ */
+class CheckpointManager {
+public:
+  CheckpointManager(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, LogManager *log_manager,
+                    TransactionManager *txn_manager);
+
+  /**
+   * Stop the background checkpoints, no checkpoint is taken
+   */
+  ~CheckpointManager();
+
+  DISALLOW_COPY(CheckpointManager)
+
+  /**
+   * Take a checkpoint, returns once it is on disk
+   */
+  void Checkpoint();
+
+  /**
+   * Take a checkpoint in the background every interval, does nothing if already started
+   */
+  void Start(std::chrono::milliseconds interval = DEFAULT_CHECKPOINT_INTERVAL);
+
+  /**
+   * Stop the background checkpoints and wait for the one being taken
+   */
+  void Stop();
+
+  /** @return number of checkpoints taken */
+  size_t GetCheckpointCount();
+
+  static constexpr std::chrono::milliseconds DEFAULT_CHECKPOINT_INTERVAL{30000};
+
+private:
+  void RunCheckpointThread(std::chrono::milliseconds interval);
+
+private:
+  DiskManager *disk_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+  LogManager *log_manager_;
+  TransactionManager *txn_manager_;
+  // a checkpoint at a time
+  std::mutex checkpoint_latch_;
+  lsn_t prev_begin_lsn_{0};
+  size_t checkpoint_count_{0};
+  // background checkpoints
+  std::mutex latch_;
+  std::condition_variable stop_cv_;
+  bool stop_{false};
+  std::thread checkpoint_thread_;
+};
+
+#endif  // MINISQL_CHECKPOINT_MANAGER_H
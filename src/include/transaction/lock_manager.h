@@ -1,13 +1,118 @@
 #ifndef MINISQL_LOCK_MANAGER_H
 #define MINISQL_LOCK_MANAGER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "transaction/transaction.h"
+
 /**
  * LockManager handles transactions asking for locks on records.
  *
- * Implemented by student self.
+ * Rows are locked shared or exclusive, tables in any mode, intention modes announcing the row locks taken in
+ * them. Locks are held until the transaction ends (strict two-phase locking), TransactionManager releases them
+ * after its commit or rollback. The lock table is split in shards by key, each with its own latch, so that
+ * transactions locking different rows rarely meet on a latch.
+ *
+ * Deadlocks are prevented by wait-die, the id of a transaction being its age: a transaction waits for a
+ * conflicting lock only if it is older than every transaction holding or awaiting it. A younger transaction
+ * is denied the lock at once and marked aborted; it must then be rolled back by its caller, and may be retried
+ * under a new id. A transaction only ever waits for younger ones, so no cycle of waits can form.
  */
 class LockManager {
+public:
+  explicit LockManager(size_t shard_count = DEFAULT_LOCK_SHARDS);
+
+  DISALLOW_COPY(LockManager)
+
+  /**
+   * Lock the row at rid in shared mode, or keep a stronger lock txn already holds on it
+   * @return false if txn was denied the lock and is now aborted
+   */
+  bool LockShared(Transaction *txn, const RowId &rid);
+
+  /**
+   * Lock the row at rid in exclusive mode, upgrading a shared lock txn holds on it
+   * @param wait false to return false at once, leaving txn active, if the lock can not be granted right away
+   * @return false if txn was denied the lock and is now aborted
+   */
+  bool LockExclusive(Transaction *txn, const RowId &rid, bool wait = true);
+
+  /**
+   * Lock a table, a lock txn holds on it is upgraded to the weakest mode covering both
+   * @return false if txn was denied the lock and is now aborted
+   */
+  bool LockTable(Transaction *txn, table_id_t table_id, LockMode mode);
+
+  /** @return true if txn holds a lock on the row at rid */
+  inline bool HoldsLock(Transaction *txn, const RowId &rid) const { return txn->GetLocks().count(RowKey(rid)) != 0; }
+
+  /**
+   * Release the lock of txn on the row at rid before the transaction ends, if it holds one. Only for a row
+   * which no longer exists, e.g. one which was read missing or whose insert is rolled back.
+   */
+  void Unlock(Transaction *txn, const RowId &rid);
+
+  /**
+   * Release every lock held by txn, at its end
+   */
+  void ReleaseAll(Transaction *txn);
+
+  /** @return number of requests which waited for a conflicting lock */
+  inline size_t GetWaitCount() const { return wait_count_.load(); }
+
+  /** @return number of requests denied by wait-die */
+  inline size_t GetDieCount() const { return die_count_.load(); }
+
+  /** @return true if a lock in mode a may be held along with a lock in mode b by another transaction */
+  static bool Compatible(LockMode a, LockMode b);
+
+  /** @return the weakest mode at least as strong as both a and b */
+  static LockMode Supremum(LockMode a, LockMode b);
+
+private:
+  struct LockRequest {
+    txn_id_t txn_id_;
+    LockMode mode_;
+    bool granted_;
+  };
+
+  /**
+   * The requests on a key, granted or waiting in their order of arrival
+   */
+  struct LockQueue {
+    std::list<LockRequest> requests_;
+    std::condition_variable cv_;
+  };
+
+  struct Shard {
+    std::mutex latch_;
+    std::unordered_map<uint64_t, LockQueue> queues_;
+  };
+
+  static inline uint64_t RowKey(const RowId &rid) { return static_cast<uint64_t>(rid.Get()); }
+
+  // the page id of a row is not negative, so the keys of tables never meet those of rows
+  static inline uint64_t TableKey(table_id_t table_id) { return (1ULL << 63) | table_id; }
+
+  inline Shard &GetShard(uint64_t key) { return shards_[(key ^ (key >> 32)) % shard_count_]; }
+
+  bool Lock(Transaction *txn, uint64_t key, LockMode mode, bool wait);
+
+  void Unlock(Transaction *txn, uint64_t key);
 
+private:
+  size_t shard_count_;
+  std::unique_ptr<Shard[]> shards_;
+  std::atomic<size_t> wait_count_{0};
+  std::atomic<size_t> die_count_{0};
 };
 
-#endif //MINISQL_LOCK_MANAGER_H
+#endif  // MINISQL_LOCK_MANAGER_H
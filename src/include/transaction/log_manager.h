@@ -1,15 +1,128 @@
 #ifndef MINISQL_LOG_MANAGER_H
 #define MINISQL_LOG_MANAGER_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk_manager.h"
+#include "transaction/log_record.h"
+
 /**
  * LogManager maintains a separate thread that is awakened whenever the
  * log buffer is full or whenever a timeout happens.
  * When the thread is awakened, the log buffer's content is written into the disk log file.
  *
- * Implemented by student self
+ * Records are appended to one of two buffers while the thread writes and syncs the other one. A caller
+ * which needs its records on disk, e.g. to commit, waits in Flush. All the callers waiting while the
+ * thread writes are served by its next write, so concurrent commits share a single sync of the log.
+ *
+ * Write-ahead logging: every change of a page is logged and the LSN of its record is stamped into the page.
+ * The buffer pool makes sure the log is on disk up to the LSN of a page before it writes the page.
+ *
+ * LSNs are consecutive. The log manager also knows the file offset of every record it appends, and keeps
+ * the offset of every LSN_INDEX_STRIDE-th record, so that a checkpoint can tell recovery where in the
+ * file to start reading for a given LSN.
  */
 class LogManager {
+  friend class PageLogScope;
+
+public:
+  /**
+   * Start the flush thread
+   * @param buffer_size size of each log buffer, no record may be larger
+   */
+  explicit LogManager(DiskManager *disk_manager, size_t buffer_size = DEFAULT_LOG_BUFFER_SIZE);
+
+  /**
+   * Write the records left in the buffer and stop the flush thread
+   */
+  ~LogManager();
+
+  DISALLOW_COPY(LogManager)
+
+  /**
+   * Give the record the next LSN and append it to the log buffer, waits for the flush thread if the buffer is full
+   * @param offset if not null, set to the offset of the record in the log file
+   * @return LSN of the record
+   */
+  lsn_t AppendLogRecord(LogRecord *log_record, size_t *offset = nullptr);
+
+  /**
+   * Wait until the log is on disk up to lsn, or up to the last record appended if lsn is beyond it
+   */
+  void Flush(lsn_t lsn);
+
+  /** @return LSN the next record will get */
+  inline lsn_t GetNextLSN() const { return next_lsn_.load(); }
+
+  /**
+   * @return offset in the log file of a record with an LSN not greater than lsn, where a scan for lsn can start
+   */
+  size_t GetOffsetBefore(lsn_t lsn);
+
+  /**
+   * Read the record at offset from the log on disk, the record must have been flushed
+   * @param buffer holds the record, which points into it
+   * @return false if there is no complete record at offset
+   */
+  bool ReadLogRecord(size_t offset, std::vector<char> &buffer, LogRecord *log_record);
+
+  /**
+   * Continue an existing log after recovery has read it, no record may have been appended yet
+   * @param next_lsn LSN after the last record in the log
+   * @param offset end of the last record in the log
+   */
+  void Restart(lsn_t next_lsn, size_t offset);
+
+  /** @return LSN of the last record on disk, INVALID_LSN if there is none */
+  lsn_t GetPersistentLSN();
+
+  /** @return number of writes of the log to disk, each followed by a sync */
+  size_t GetFlushCount();
+
+  /** the flush thread writes the buffer at least this often */
+  static constexpr std::chrono::milliseconds LOG_TIMEOUT{10};
+
+  /** the offset of every record whose LSN is a multiple of this is kept */
+  static constexpr lsn_t LSN_INDEX_STRIDE = 64;
+
+private:
+  /**
+   * Body of the flush thread
+   */
+  void RunFlushThread();
 
+private:
+  DiskManager *disk_manager_;
+  size_t buffer_size_;
+  // records are appended to log_buffer_ while flush_buffer_ is written
+  std::unique_ptr<char[]> log_buffer_;
+  std::unique_ptr<char[]> flush_buffer_;
+  size_t log_buffer_offset_{0};
+  // written under latch_, read without it by the buffer pool to date the first change of a page
+  std::atomic<lsn_t> next_lsn_{0};
+  // offset in the log file of the next record, and of every LSN_INDEX_STRIDE-th record in LSN order
+  size_t next_offset_{0};
+  std::vector<std::pair<lsn_t, size_t>> lsn_offsets_;
+  lsn_t persistent_lsn_{INVALID_LSN};
+  size_t flush_count_{0};
+  // a caller waits for the buffer to be written
+  bool flush_requested_{false};
+  bool stop_{false};
+  std::mutex latch_;
+  std::condition_variable flush_cv_;    // wakes the flush thread
+  std::condition_variable flushed_cv_;  // notified when the buffers are swapped and when a write has completed
+  std::thread flush_thread_;
+  // serializes the page log scopes, see PageLogScope
+  std::mutex page_log_latch_;
 };
 
 #endif //MINISQL_LOG_MANAGER_H
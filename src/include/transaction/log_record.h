@@ -0,0 +1,194 @@
+#ifndef MINISQL_LOG_RECORD_H
+#define MINISQL_LOG_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/config.h"
+#include "common/rowid.h"
+
+enum class LogRecordType {
+  kInvalid = 0,
+  kInsert,
+  kMarkDelete,
+  kApplyDelete,
+  kRollbackDelete,
+  kUpdate,
+  kBegin,
+  kCommit,
+  kAbort,
+  kNewPage,
+  kAllocatePage,
+  kDeallocatePage,
+  kPageWrite,
+  kIndexInsert,
+  kIndexDelete,
+  kCLR,
+  kCheckpointBegin,
+  kCheckpointEnd,
+  kPagesFlushed
+};
+
+/**
+ * A record of the write-ahead log, for a change of a table page or for the begin or end of a transaction.
+ * Pages of other kinds, e.g. index pages, are logged as the bytes which changed (page write), and
+ * changes of an index made by a transaction are logged a second time as the key inserted or deleted,
+ * so that the transaction can be rolled back.
+ *
+ * Header format (size in bytes):
+ * -------------------------------------------------------------------------
+ * | Size (4) | LSN (4) | TransactionId (4) | PrevLSN (4) | LogRecordType (4) |
+ * -------------------------------------------------------------------------
+ * followed by, depending on the type:
+ *  insert, mark delete, apply delete, rollback delete: | RowId (8) | TupleSize (4) | Tuple |
+ *  update: | RowId (8) | OldTupleSize (4) | OldTuple | NewTupleSize (4) | NewTuple |
+ *  new page: | PrevPageId (4) | PageId (4) |
+ *  allocate page, deallocate page: | PageId (4) |
+ *  index insert, index delete: | IndexId (4) | RowId (8) | KeySize (4) | Key |
+ *  compensation (CLR): | UndoNextLSN (4) | UndoneType (4) | RowId (8) | TupleSize (4) | Tuple |
+ *  page write, checkpoint end, pages flushed: | Data |, see PageLogScope and CheckpointManager
+ *  begin, commit, abort, checkpoint begin: nothing
+ *
+ * A compensation record is written for every change undone by a rollback. It redoes the undo: an apply delete
+ * of an insert, a rollback delete of a mark delete, or an update back to the old tuple; an undone index change
+ * has nothing to redo, its pages are logged by page writes. UndoNextLSN is the PrevLSN of the undone record,
+ * where an interrupted rollback continues.
+ *
+ * Tuples are kept as serialized rows, see Row. A record does not own them, they must stay valid until
+ * the record is serialized, or as long as the buffer a record was deserialized from.
+ */
+class LogRecord {
+public:
+  LogRecord() = default;
+
+  /** begin, commit or abort */
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType type)
+          : size_(HEADER_SIZE), txn_id_(txn_id), prev_lsn_(prev_lsn), type_(type) {}
+
+  /** insert, mark delete, apply delete or rollback delete of the tuple at rid */
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType type, const RowId &rid, const char *tuple,
+            uint32_t tuple_size)
+          : size_(HEADER_SIZE + sizeof(int64_t) + sizeof(uint32_t) + tuple_size), txn_id_(txn_id),
+            prev_lsn_(prev_lsn), type_(type), rid_(rid), tuple_(tuple), tuple_size_(tuple_size) {}
+
+  /** update of the tuple at rid */
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, const RowId &rid, const char *old_tuple, uint32_t old_tuple_size,
+            const char *new_tuple, uint32_t new_tuple_size)
+          : size_(HEADER_SIZE + sizeof(int64_t) + 2 * sizeof(uint32_t) + old_tuple_size + new_tuple_size),
+            txn_id_(txn_id), prev_lsn_(prev_lsn), type_(LogRecordType::kUpdate), rid_(rid), tuple_(old_tuple),
+            tuple_size_(old_tuple_size), new_tuple_(new_tuple), new_tuple_size_(new_tuple_size) {}
+
+  /** a new table page linked after prev_page_id */
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, page_id_t prev_page_id, page_id_t page_id)
+          : size_(HEADER_SIZE + 2 * sizeof(page_id_t)), txn_id_(txn_id), prev_lsn_(prev_lsn),
+            type_(LogRecordType::kNewPage), prev_page_id_(prev_page_id), page_id_(page_id) {}
+
+  /** allocation or deallocation of a page */
+  LogRecord(LogRecordType type, page_id_t page_id)
+          : size_(HEADER_SIZE + sizeof(page_id_t)), type_(type), page_id_(page_id) {}
+
+  /** insert or delete of key with rid in an index */
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType type, index_id_t index_id, const RowId &rid,
+            const char *key, uint32_t key_size)
+          : size_(HEADER_SIZE + sizeof(index_id_t) + sizeof(int64_t) + sizeof(uint32_t) + key_size),
+            txn_id_(txn_id), prev_lsn_(prev_lsn), type_(type), rid_(rid), tuple_(key), tuple_size_(key_size),
+            index_id_(index_id) {}
+
+  /** compensation of a record of type undone_type, with the tuple which the undo wrote if any */
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, lsn_t undo_next_lsn, LogRecordType undone_type, const RowId &rid,
+            const char *tuple, uint32_t tuple_size)
+          : size_(HEADER_SIZE + sizeof(lsn_t) + sizeof(uint32_t) + sizeof(int64_t) + sizeof(uint32_t) + tuple_size),
+            txn_id_(txn_id), prev_lsn_(prev_lsn), type_(LogRecordType::kCLR), rid_(rid), tuple_(tuple),
+            tuple_size_(tuple_size), undo_next_lsn_(undo_next_lsn), undone_type_(undone_type) {}
+
+  /** page write, checkpoint end or pages flushed, whose content is laid out by the writer */
+  LogRecord(LogRecordType type, const char *data, uint32_t data_size)
+          : size_(HEADER_SIZE + data_size), type_(type), tuple_(data), tuple_size_(data_size) {}
+
+  /**
+   * @return number of bytes written, GetSize()
+   */
+  uint32_t SerializeTo(char *buf) const;
+
+  /**
+   * Read the record at the beginning of buf
+   * @param size number of bytes available in buf
+   * @return number of bytes read, 0 if buf does not start with a complete record, e.g. at the end of the log
+   */
+  static uint32_t DeserializeFrom(const char *buf, size_t size, LogRecord *log_record);
+
+  inline uint32_t GetSize() const { return size_; }
+
+  inline lsn_t GetLSN() const { return lsn_; }
+
+  inline void SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+  inline txn_id_t GetTxnId() const { return txn_id_; }
+
+  inline lsn_t GetPrevLSN() const { return prev_lsn_; }
+
+  inline LogRecordType GetType() const { return type_; }
+
+  inline const RowId &GetRowId() const { return rid_; }
+
+  /** @return the tuple of the change, the old tuple of an update */
+  inline const char *GetTuple() const { return tuple_; }
+
+  inline uint32_t GetTupleSize() const { return tuple_size_; }
+
+  inline const char *GetNewTuple() const { return new_tuple_; }
+
+  inline uint32_t GetNewTupleSize() const { return new_tuple_size_; }
+
+  inline page_id_t GetPrevPageId() const { return prev_page_id_; }
+
+  inline page_id_t GetPageId() const { return page_id_; }
+
+  inline index_id_t GetIndexId() const { return index_id_; }
+
+  /** @return the key of an index change */
+  inline const char *GetKey() const { return tuple_; }
+
+  inline uint32_t GetKeySize() const { return tuple_size_; }
+
+  inline lsn_t GetUndoNextLSN() const { return undo_next_lsn_; }
+
+  inline LogRecordType GetUndoneType() const { return undone_type_; }
+
+  /** @return the content of a page write, checkpoint end or pages flushed record */
+  inline const char *GetData() const { return tuple_; }
+
+  inline uint32_t GetDataSize() const { return tuple_size_; }
+
+  /** @return whether a rollback has to undo the record */
+  inline bool IsUndoable() const {
+    return type_ == LogRecordType::kInsert || type_ == LogRecordType::kMarkDelete ||
+           type_ == LogRecordType::kUpdate || type_ == LogRecordType::kIndexInsert ||
+           type_ == LogRecordType::kIndexDelete;
+  }
+
+  static constexpr uint32_t HEADER_SIZE = 20;
+
+private:
+  uint32_t size_{0};
+  lsn_t lsn_{INVALID_LSN};
+  txn_id_t txn_id_{INVALID_TXN_ID};
+  lsn_t prev_lsn_{INVALID_LSN};
+  LogRecordType type_{LogRecordType::kInvalid};
+  // tuple changes, the key of index changes and the data of records laid out by the writer
+  RowId rid_;
+  const char *tuple_{nullptr};
+  uint32_t tuple_size_{0};
+  const char *new_tuple_{nullptr};
+  uint32_t new_tuple_size_{0};
+  // new page
+  page_id_t prev_page_id_{INVALID_PAGE_ID};
+  page_id_t page_id_{INVALID_PAGE_ID};
+  // index changes
+  index_id_t index_id_{0};
+  // compensation
+  lsn_t undo_next_lsn_{INVALID_LSN};
+  LogRecordType undone_type_{LogRecordType::kInvalid};
+};
+
+#endif //MINISQL_LOG_RECORD_H
@@ -0,0 +1,165 @@
+#ifndef MINISQL_RECOVERY_MANAGER_H
+#define MINISQL_RECOVERY_MANAGER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk_manager.h"
+#include "transaction/checkpoint_manager.h"
+#include "transaction/log_manager.h"
+#include "transaction/transaction_manager.h"
+
+class TablePage;
+
+/**
+ * RecoveryManager brings a database back to its last committed state after a crash, ARIES style.
+ *
+ * Redo runs before the catalog is loaded, so that it reads the tables and indexes as they were at the crash:
+ *  - analysis reads the log from the begin record of the last checkpoint to its end, and rebuilds the
+ *    dirty page table and the transactions active at the crash (the losers). A torn record at the end
+ *    of the log is cut off, and the log manager goes on after the last complete record.
+ *  - redo reads the log from the recovery LSN of the dirty page table, or from the begin of the first loser
+ *    if it is earlier, and repeats history: a record of a table page is redone if the page is older
+ *    than the record, page writes and page allocations are redone if the page may be older than the record.
+ *    The log is read in batches, whose changes are split by page id across worker threads: each worker
+ *    redoes the changes of its pages in LSN order, while the next batch is read and its pages prefetched.
+ *    The page bitmaps are redone in log order as the records are read.
+ *
+ * Undo runs once the catalog is loaded: the losers are rolled back by the transaction manager, the latest
+ * change first across all of them, and a checkpoint is taken.
+ */
+class RecoveryManager {
+public:
+  /**
+   * @param redo_workers threads redoing the pages, one per core if 0
+   */
+  RecoveryManager(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, LogManager *log_manager,
+                  size_t redo_workers = 0);
+
+  ~RecoveryManager();
+
+  DISALLOW_COPY(RecoveryManager)
+
+  /**
+   * Analysis and redo, no record may have been appended to the log yet
+   */
+  void Redo();
+
+  /**
+   * Roll back the transactions active at the crash, write every page and take a checkpoint
+   */
+  void Undo(TransactionManager *txn_manager, CheckpointManager *checkpoint_manager);
+
+  /** @return number of log records read by redo */
+  inline size_t GetRedoRecordCount() const { return redo_record_count_; }
+
+  /** @return number of changes redone */
+  inline size_t GetRedoneCount() const { return redone_count_.load(); }
+
+  inline size_t GetRedoWorkers() const { return redo_workers_; }
+
+  /** the log is read in chunks of this size */
+  static constexpr size_t SCAN_BUFFER_SIZE = 1 << 20;
+
+  /** records are handed to the redo workers in batches of about this size */
+  static constexpr size_t REDO_BATCH_SIZE = 256 << 10;
+
+private:
+  /**
+   * A transaction active at the crash
+   */
+  struct Loser {
+    size_t begin_offset_{0};
+    // LSN and offset of its records, collected by redo
+    std::vector<std::pair<lsn_t, size_t>> records_;
+  };
+
+  /**
+   * Records read by redo, and the changes of pages in them split across the workers
+   */
+  struct RedoBatch {
+    // the records as read from the log, records_ points into it
+    std::vector<char> data_;
+    std::vector<LogRecord> records_;
+    // per worker, the record and page of every change it redoes, in LSN order
+    std::vector<std::vector<std::pair<const LogRecord *, page_id_t>>> changes_;
+  };
+
+  /**
+   * Call callback on every complete record of the log from offset on, in order, until it returns false.
+   * The callback gets the record, its serialized form and its offset.
+   * @return offset after the last record read
+   */
+  size_t ScanLog(size_t offset, const std::function<bool(const LogRecord &, const char *, size_t)> &callback);
+
+  /**
+   * Add the record to the dirty page table and the active transactions
+   */
+  void Analyze(const LogRecord &log_record, size_t offset);
+
+  /**
+   * Split the changes of the batch across the workers and prefetch their pages, then wait for the batch
+   * before it and start the workers on this one
+   */
+  void DispatchBatch(std::unique_ptr<RedoBatch> batch);
+
+  /**
+   * Wait for the workers on the batch being redone
+   */
+  void WaitBatch();
+
+  /**
+   * Redo the change of a page made by a record, the page may be older than the record
+   */
+  void RedoPage(const LogRecord &log_record, page_id_t page_id);
+
+  /**
+   * Redo a change of a table page if the page is older than the record
+   */
+  void RedoTablePage(page_id_t page_id, const LogRecord &log_record,
+                     const std::function<void(TablePage *)> &redo);
+
+  /** @return whether the page on disk may be older than the record */
+  bool MayNeedRedo(page_id_t page_id, lsn_t lsn) const;
+
+  /**
+   * Add the pages whose content the record changes to pages
+   */
+  static void GetChangedPages(const LogRecord &log_record, std::vector<page_id_t> &pages);
+
+  void AddDirtyPage(page_id_t page_id, lsn_t lsn);
+
+private:
+  DiskManager *disk_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+  LogManager *log_manager_;
+  // analysis
+  std::unordered_map<page_id_t, lsn_t> dirty_pages_;
+  std::unordered_map<txn_id_t, Loser> losers_;
+  // transactions which ended after the checkpoint began, they are not active even if its end record says so
+  std::unordered_set<txn_id_t> ended_txns_;
+  bool checkpoint_read_{false};
+  lsn_t redo_lsn_{INVALID_LSN};
+  size_t redo_offset_{0};
+  // no change before redo_floor_ needs to be redone, as told by the last pages flushed record
+  lsn_t redo_floor_{INVALID_LSN};
+  size_t redo_floor_offset_{0};
+  txn_id_t next_txn_id_{0};
+  size_t redo_record_count_{0};
+  std::atomic<size_t> redone_count_{0};
+  // redo workers
+  size_t redo_workers_;
+  std::unique_ptr<RedoBatch> running_batch_;
+  std::vector<std::thread> workers_;
+};
+
+#endif  // MINISQL_RECOVERY_MANAGER_H
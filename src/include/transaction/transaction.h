@@ -1,13 +1,115 @@
 #ifndef MINISQL_TRANSACTION_H
 #define MINISQL_TRANSACTION_H
 
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rowid.h"
+
+class TableHeap;
+
+/**
+ * A transaction is aborted when it is denied a lock to prevent a deadlock, or when it would change a row changed
+ * since its snapshot, it then has to be rolled back
+ */
+enum class TransactionState { kActive, kAborted };
+
+/**
+ * How a transaction reads: from a snapshot of the rows committed when it began, without locks, or the latest rows
+ * under shared locks held until its end
+ */
+enum class IsolationLevel { kSnapshot, kRepeatableRead };
+
+/**
+ * Modes of a lock, intention modes are only taken on tables
+ */
+enum class LockMode { kIntentionShared, kIntentionExclusive, kShared, kSharedIntentionExclusive, kExclusive };
+
 /**
  * Transaction tracks information related to a transaction.
  *
  * Implemented by student self
 */
 class Transaction {
+public:
+  explicit Transaction(txn_id_t txn_id = INVALID_TXN_ID) : txn_id_(txn_id) {}
+
+  inline txn_id_t GetTransactionId() const { return txn_id_; }
+
+  inline TransactionState GetState() const { return state_; }
+
+  inline void SetState(TransactionState state) { state_ = state; }
+
+  inline IsolationLevel GetIsolationLevel() const { return isolation_level_; }
+
+  inline void SetIsolationLevel(IsolationLevel isolation_level) { isolation_level_ = isolation_level; }
+
+  /** @return true if the transaction only reads, it is then neither logged nor locks */
+  inline bool IsReadOnly() const { return read_only_; }
+
+  inline void SetReadOnly(bool read_only) { read_only_ = read_only; }
+
+  /** @return the timestamp of the snapshot read, the changes committed up to it are seen */
+  inline timestamp_t GetReadTs() const { return read_ts_; }
+
+  inline void SetReadTs(timestamp_t read_ts) { read_ts_ = read_ts; }
+
+  /** @return the timestamp the changes of the transaction are seen from, once committed */
+  inline timestamp_t GetCommitTs() const { return commit_ts_; }
+
+  inline void SetCommitTs(timestamp_t commit_ts) { commit_ts_ = commit_ts; }
+
+  /** @return LSN of the last log record of this transaction, INVALID_LSN if it has none */
+  inline lsn_t GetPrevLSN() const { return prev_lsn_; }
+
+  inline void SetPrevLSN(lsn_t prev_lsn) { prev_lsn_ = prev_lsn; }
+
+  /**
+   * A log record of a change made by this transaction was appended, it is undone by a rollback
+   * @param offset offset of the record in the log file
+   */
+  inline void AddLogRecord(lsn_t lsn, size_t offset) {
+    prev_lsn_ = lsn;
+    log_records_.emplace_back(lsn, offset);
+  }
+
+  /** @return LSN and log offset of the records of the changes made by this transaction, in LSN order */
+  inline const std::vector<std::pair<lsn_t, size_t>> &GetLogRecords() const { return log_records_; }
+
+  /**
+   * A row marked deleted by this transaction, it is only removed from its table once the transaction commits
+   */
+  inline void AddDeletedRow(TableHeap *table_heap, const RowId &rid) { deleted_rows_.emplace_back(table_heap, rid); }
+
+  inline const std::vector<std::pair<TableHeap *, RowId>> &GetDeletedRows() const { return deleted_rows_; }
+
+  /**
+   * A row the transaction wrote a new version of, the previous version is kept by the version manager
+   */
+  inline void AddWrittenRow(const RowId &rid) { written_rows_.push_back(rid); }
+
+  inline const std::vector<RowId> &GetWrittenRows() const { return written_rows_; }
+
+  /** @return the locks held, by the key of their row or table in the lock manager */
+  inline std::unordered_map<uint64_t, LockMode> &GetLocks() { return locks_; }
 
+private:
+  txn_id_t txn_id_;
+  TransactionState state_{TransactionState::kActive};
+  IsolationLevel isolation_level_{IsolationLevel::kSnapshot};
+  bool read_only_{false};
+  timestamp_t read_ts_{0};
+  timestamp_t commit_ts_{0};
+  // the log records of a transaction are chained backwards through their PrevLSN
+  lsn_t prev_lsn_{INVALID_LSN};
+  std::vector<std::pair<lsn_t, size_t>> log_records_;
+  std::vector<std::pair<TableHeap *, RowId>> deleted_rows_;
+  std::vector<RowId> written_rows_;
+  std::unordered_map<uint64_t, LockMode> locks_;
 };
 
 #endif  // MINISQL_TRANSACTION_H
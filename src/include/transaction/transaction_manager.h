@@ -0,0 +1,130 @@
+#ifndef MINISQL_TRANSACTION_MANAGER_H
+#define MINISQL_TRANSACTION_MANAGER_H
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "transaction/lock_manager.h"
+#include "transaction/log_manager.h"
+#include "transaction/transaction.h"
+#include "transaction/version_manager.h"
+
+class CatalogManager;
+
+/**
+ * An active transaction as recorded by a checkpoint
+ */
+struct ActiveTransaction {
+  txn_id_t txn_id_{INVALID_TXN_ID};
+  lsn_t last_lsn_{INVALID_LSN};
+  // offset in the log file of the begin record, where recovery starts reading to find every record of it
+  size_t begin_offset_{0};
+};
+
+/**
+ * TransactionManager begins, commits and rolls back transactions.
+ *
+ * A commit is durable once its commit record is on disk; rows the transaction deleted are only marked
+ * deleted until then and removed afterwards. A rollback reads the records of the changes of the transaction
+ * back from the log, the latest first, and undoes them logically: a tuple is put back the way it was at its
+ * row id, an index entry is inserted or removed again. A compensation record is logged for every undone change,
+ * so that a rollback interrupted by a crash is neither repeated nor lost.
+ *
+ * The locks of a transaction are released once its commit is on disk, or once it is rolled back.
+ *
+ * With a version manager, a transaction reads the snapshot of the rows committed when it began, see VersionManager.
+ * A read only transaction is neither logged nor listed as active, it only holds its snapshot.
+ */
+class TransactionManager {
+public:
+  /**
+   * @param catalog finds the index of an index change to roll back
+   * @param log_manager null to run without logging, rollbacks then do nothing
+   * @param lock_manager holds the locks of the transactions, null to run without locking
+   * @param version_manager keeps the older versions of the rows, null to read the latest rows only
+   */
+  TransactionManager(CatalogManager *catalog, BufferPoolManager *buffer_pool_manager, LogManager *log_manager,
+                     LockManager *lock_manager = nullptr, VersionManager *version_manager = nullptr);
+
+  /**
+   * Transactions still active are forgotten, as in a crash
+   */
+  ~TransactionManager();
+
+  DISALLOW_COPY(TransactionManager)
+
+  /**
+   * @param isolation_level how the transaction reads, a snapshot is only read with a version manager
+   * @param read_only true if the transaction changes nothing, it is then not logged
+   */
+  Transaction *Begin(IsolationLevel isolation_level = IsolationLevel::kSnapshot, bool read_only = false);
+
+  /**
+   * Log the commit, wait until it is on disk, release the locks of txn and remove the rows it deleted, once no
+   * snapshot sees them. txn is deleted.
+   */
+  void Commit(Transaction *txn);
+
+  /**
+   * Roll back txn, log its end and release its locks. txn is deleted.
+   */
+  void Abort(Transaction *txn);
+
+  /**
+   * Roll back several transactions, the latest change first across all of them, e.g. those active at a crash.
+   * The transactions are deleted.
+   */
+  void AbortAll(const std::vector<Transaction *> &txns);
+
+  /**
+   * Register a transaction which was active at a crash, for recovery to roll it back. Its log records are added
+   * to it by recovery, it must not log a begin record again.
+   */
+  Transaction *Resume(txn_id_t txn_id, size_t begin_offset);
+
+  /**
+   * The transactions begun after this one get greater ids, used by recovery
+   */
+  void SetNextTransactionId(txn_id_t txn_id);
+
+  inline txn_id_t GetNextTransactionId() const { return next_txn_id_.load(); }
+
+  /**
+   * @return the active transactions, for a checkpoint: those with a begin record logged and no end record yet
+   */
+  std::vector<ActiveTransaction> GetActiveTransactions();
+
+private:
+  /**
+   * Undo one change of txn and log its compensation
+   */
+  void Undo(const LogRecord &log_record, Transaction *txn);
+
+  /**
+   * End the snapshot of a read only txn, which has nothing to log or to undo
+   */
+  void EndReadOnly(Transaction *txn);
+
+  /**
+   * Log the end of txn and forget it
+   */
+  void End(Transaction *txn, LogRecordType type);
+
+private:
+  CatalogManager *catalog_;
+  BufferPoolManager *buffer_pool_manager_;
+  LogManager *log_manager_;
+  LockManager *lock_manager_;
+  VersionManager *version_manager_;
+  std::atomic<txn_id_t> next_txn_id_{0};
+  std::mutex latch_;
+  std::unordered_map<txn_id_t, Transaction *> txn_map_;
+  std::unordered_map<txn_id_t, size_t> begin_offsets_;
+};
+
+#endif  // MINISQL_TRANSACTION_MANAGER_H
@@ -0,0 +1,222 @@
+#ifndef MINISQL_VERSION_MANAGER_H
+#define MINISQL_VERSION_MANAGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/rwlatch.h"
+#include "common/rowid.h"
+#include "transaction/transaction.h"
+
+class TableHeap;
+
+/**
+ * Which version of a row a snapshot sees
+ */
+enum class Visibility {
+  kCurrent,  // the tuple in the table page, if it is not marked deleted
+  kOlder,    // an older version kept by the version manager
+  kNone      // none, the row did not exist yet for the snapshot
+};
+
+/**
+ * VersionManager keeps the older versions of the rows changed recently, for multi-version concurrency control.
+ *
+ * The table pages hold the latest version of every row. When a transaction first changes a row, the version
+ * before the change is kept here in the version chain of the row, with the commit timestamp it was written with.
+ * The latest version is stamped with the commit timestamp of its writer when the writer commits. A transaction
+ * reading a snapshot sees the versions committed up to the timestamp it began at, and its own changes, without
+ * taking locks. Writers still lock the rows exclusively; a transaction reading a snapshot which writes a row
+ * changed by a transaction committed after it began is aborted (the first writer wins).
+ *
+ * A row deleted by a transaction stays marked deleted in its page as long as a snapshot may see it. The versions
+ * which no snapshot sees any more, those older than the oldest active snapshot, are reclaimed at commit when no
+ * older snapshot is active, or else by a garbage collection in the background.
+ *
+ * The versions only matter to the transactions running, so they are not logged: after a restart the table
+ * pages hold the only version of every row.
+ */
+class VersionManager {
+public:
+  explicit VersionManager(size_t shard_count = DEFAULT_VERSION_SHARDS);
+
+  /**
+   * Stop the background garbage collection
+   */
+  ~VersionManager();
+
+  DISALLOW_COPY(VersionManager)
+
+  /**
+   * Take the snapshot txn reads, of the changes committed so far
+   */
+  void BeginSnapshot(Transaction *txn);
+
+  /**
+   * Keep the version of the row at rid before txn changes it. The page of the row is write latched.
+   * @param tuple the serialized tuple of the row before the change, nullptr if the row is inserted
+   * @param exists whether the row exists after the change
+   * @return false if txn reads a snapshot and the row was changed by a transaction it does not see, txn is
+   * then aborted and the row must be left unchanged
+   */
+  bool RecordWrite(TableHeap *table, const RowId &rid, Transaction *txn, const char *tuple, uint32_t tuple_size,
+                   bool exists);
+
+  /**
+   * Find the version of the row at rid the snapshot of txn sees. The page of the row is latched.
+   * @param tuple set to the serialized tuple of an older version
+   */
+  Visibility GetVisibleVersion(const RowId &rid, Transaction *txn, std::vector<char> *tuple);
+
+  /**
+   * Stamp the versions written by txn with a new commit timestamp, once its commit is durable. Its snapshot ends.
+   */
+  void Commit(Transaction *txn);
+
+  /**
+   * Remove the rows deleted by the committed txn from their tables if no snapshot sees them any more,
+   * the garbage collection removes the others later
+   */
+  void ApplyDeletes(Transaction *txn);
+
+  /**
+   * Drop the version txn wrote of the row at rid, whose change is undone. The page of the row is write latched.
+   */
+  void Rollback(Transaction *txn, const RowId &rid);
+
+  /**
+   * Drop the versions written by txn once it is rolled back. Its snapshot ends.
+   */
+  void Abort(Transaction *txn);
+
+  /**
+   * End the snapshot of a transaction which wrote nothing
+   */
+  void EndSnapshot(Transaction *txn);
+
+  /**
+   * The index entries of a deleted row are removed with it, so an index may miss rows a snapshot still sees
+   * @return true if rows of table were deleted by other transactions which txn does not see committed
+   */
+  bool HasDeletesAfter(TableHeap *table, Transaction *txn);
+
+  /**
+   * Forget the versions of the rows of a dropped table, waits for the deletes being applied to its rows
+   */
+  void Forget(TableHeap *table);
+
+  /**
+   * Reclaim the versions older than the oldest active snapshot, and remove the rows whose delete every
+   * snapshot sees from their tables
+   */
+  void CollectGarbage();
+
+  /**
+   * Collect garbage in the background every interval, does nothing if already started
+   */
+  void Start(std::chrono::milliseconds interval = DEFAULT_GC_INTERVAL);
+
+  /**
+   * Stop the background garbage collection, after a last one
+   */
+  void Stop();
+
+  /** @return number of older versions kept */
+  inline size_t GetVersionCount() const { return version_count_.load(); }
+
+  /** @return number of older versions reclaimed */
+  inline size_t GetReclaimedCount() const { return reclaimed_count_.load(); }
+
+  /** @return the timestamp of the oldest active snapshot, or of the latest commit if none is active */
+  timestamp_t GetOldestSnapshot();
+
+  static constexpr std::chrono::milliseconds DEFAULT_GC_INTERVAL{1000};
+
+private:
+  struct Version {
+    timestamp_t begin_ts_;
+    bool exists_;
+    std::vector<char> tuple_;
+  };
+
+  /**
+   * The versions of a row, the latest is in its table page
+   */
+  struct VersionChain {
+    TableHeap *table_{nullptr};
+    // the uncommitted writer of the latest version, INVALID_TXN_ID once it is stamped with begin_ts_
+    txn_id_t writer_{INVALID_TXN_ID};
+    timestamp_t begin_ts_{0};
+    bool exists_{true};
+    // the older versions, the latest first
+    std::deque<Version> older_;
+  };
+
+  struct Shard {
+    std::mutex latch_;
+    std::unordered_map<int64_t, VersionChain> chains_;
+  };
+
+  /**
+   * The transactions which deleted rows of a table
+   */
+  struct TableDeletes {
+    std::unordered_set<txn_id_t> deleters_;
+    timestamp_t last_commit_ts_{0};
+  };
+
+  inline Shard &GetShard(const RowId &rid) {
+    auto key = static_cast<uint64_t>(rid.Get());
+    return shards_[(key ^ (key >> 32)) % shard_count_];
+  }
+
+  /** @return the oldest snapshot, latch_ is held */
+  timestamp_t OldestSnapshot() const;
+
+  /** End the snapshot of txn, latch_ is held */
+  void RemoveSnapshot(Transaction *txn);
+
+  /** Drop the chain of a row whose latest version every snapshot sees, the shard latch is held */
+  std::unordered_map<int64_t, VersionChain>::iterator EraseChain(
+          Shard &shard, std::unordered_map<int64_t, VersionChain>::iterator chain);
+
+  void RunGarbageCollectionThread(std::chrono::milliseconds interval);
+
+private:
+  size_t shard_count_;
+  std::unique_ptr<Shard[]> shards_;
+  // the chains are looked up only while there are some
+  std::atomic<size_t> chain_count_{0};
+  std::atomic<size_t> version_count_{0};
+  std::atomic<size_t> reclaimed_count_{0};
+  // the timestamps, taken after the shard latches
+  std::mutex latch_;
+  timestamp_t clock_{0};
+  // the read timestamps of the active snapshots, and the number of snapshots at each
+  std::map<timestamp_t, size_t> snapshots_;
+  std::unordered_map<txn_id_t, timestamp_t> snapshot_txns_;
+  // the commit timestamps of the transactions whose versions are being stamped
+  std::unordered_map<txn_id_t, timestamp_t> committing_;
+  std::unordered_map<TableHeap *, TableDeletes> table_deletes_;
+  // held shared from taking the deleted rows out of their chains until they are removed from their tables,
+  // and exclusively by Forget, so that no table is written after it is dropped
+  ReaderWriterLatch apply_latch_;
+  // background garbage collection
+  std::mutex gc_latch_;
+  std::condition_variable stop_cv_;
+  bool stop_{false};
+  std::thread gc_thread_;
+};
+
+#endif  // MINISQL_VERSION_MANAGER_H
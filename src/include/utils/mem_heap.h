@@ -1,9 +1,12 @@
 #ifndef MINISQL_MEM_HEAP_H
 #define MINISQL_MEM_HEAP_H
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <unordered_set>
+#include <vector>
 #include "common/macros.h"
 
 class MemHeap {
@@ -47,6 +50,7 @@ public:
     auto iter = allocated_.find(ptr);
     if (iter != allocated_.end()) {
       allocated_.erase(iter);
+      free(ptr);
     }
   }
 
@@ -54,4 +58,72 @@ private:
   std::unordered_set<void *> allocated_;
 };
 
+/**
+ * Hands out memory by bumping a pointer through blocks malloc'ed from the system, whose sizes double from
+ * the initial block size up to ARENA_MAX_BLOCK_SIZE. Free does nothing, all memory goes back at once
+ * by Reset, which keeps the last and largest block for reuse, or by the destructor. No block is allocated
+ * before the first Allocate, so an unused arena costs nothing.
+ */
+class ArenaMemHeap : public MemHeap {
+public:
+  static constexpr size_t ARENA_MAX_BLOCK_SIZE = 64 * 1024;
+
+  explicit ArenaMemHeap(size_t block_size = 256) : block_size_(block_size) {}
+
+  ~ArenaMemHeap() {
+    for (auto block : blocks_) {
+      free(block);
+    }
+  }
+
+  ArenaMemHeap(const ArenaMemHeap &) = delete;
+
+  ArenaMemHeap &operator=(const ArenaMemHeap &) = delete;
+
+  void *Allocate(size_t size) {
+    size = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    if (size > static_cast<size_t>(end_ - pos_)) {
+      NewBlock(size);
+    }
+    void *buf = pos_;
+    pos_ += size;
+    return buf;
+  }
+
+  void Free(void *) {}
+
+  /**
+   * Gives back all memory handed out so far, the pointers returned by Allocate are no longer valid
+   */
+  void Reset() {
+    if (blocks_.size() > 1) {
+      for (size_t i = 0; i + 1 < blocks_.size(); i++) {
+        free(blocks_[i]);
+      }
+      blocks_.erase(blocks_.begin(), blocks_.end() - 1);
+    }
+    if (!blocks_.empty()) {
+      pos_ = blocks_.back();
+    }
+  }
+
+private:
+  void NewBlock(size_t size) {
+    if (!blocks_.empty() && block_size_ < ARENA_MAX_BLOCK_SIZE) {
+      block_size_ *= 2;
+    }
+    size_t block_size = std::max(block_size_, size);
+    char *block = static_cast<char *>(malloc(block_size));
+    ASSERT(block != nullptr, "Out of memory exception");
+    blocks_.push_back(block);
+    pos_ = block;
+    end_ = block + block_size;
+  }
+
+  size_t block_size_;
+  std::vector<char *> blocks_;
+  char *pos_{nullptr};
+  char *end_{nullptr};
+};
+
 #endif //MINISQL_MEM_HEAP_H
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <string>
 #include "glog/logging.h"
 #include "index/b_plus_tree.h"
@@ -13,18 +14,51 @@ BPLUSTREE_TYPE::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_ma
           buffer_pool_manager_(buffer_pool_manager),
           comparator_(comparator),
           leaf_max_size_(leaf_max_size),
-          internal_max_size_(internal_max_size) {
-
+          internal_max_size_(internal_max_size),
+          leaf_allocator_(buffer_pool_manager->GetDiskManager()) {
+  // load the root of an existing index
+  auto *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  if (page != nullptr) {
+    auto *roots_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
+    if (!roots_page->GetRootId(index_id_, &root_page_id_)) {
+      root_page_id_ = INVALID_PAGE_ID;
+    }
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Destroy() {
-  while(!IsEmpty()){
-    Page* page = FindLeafPage(true);
-    auto leaf = reinterpret_cast<LeafPage*>(page);
-    Remove(leaf->KeyAt(0));
-    buffer_pool_manager_->DeletePage(page->GetPageId());
+  leaf_allocator_.Release();
+  if (!IsEmpty()) {
+    DestroyPage(root_page_id_);
+    root_page_id_ = INVALID_PAGE_ID;
+  }
+  auto *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  if (page == nullptr)
+    ASSERT(false, "fail to fetch page");
+  auto *roots_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
+  roots_page->Delete(index_id_);
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+}
+
+/*
+ * Release a page and all pages below it
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DestroyPage(page_id_t page_id) {
+  auto *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr)
+    ASSERT(false, "fail to fetch page");
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      DestroyPage(internal->ValueAt(i));
+    }
   }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  buffer_pool_manager_->DeletePage(page_id);
 }
 
 /*
@@ -32,7 +66,10 @@ void BPLUSTREE_TYPE::Destroy() {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::IsEmpty() const {
-  return root_page_id_ == INVALID_PAGE_ID;
+  root_latch_.RLock();
+  bool empty = root_page_id_ == INVALID_PAGE_ID;
+  root_latch_.RUnlock();
+  return empty;
 }
 
 /*****************************************************************************
@@ -45,21 +82,175 @@ bool BPLUSTREE_TYPE::IsEmpty() const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction) {
-  auto leaf_page = FindLeafPage(key, false);
+  auto leaf_page = FindLeafPageRead(key, false);
+  if(leaf_page == nullptr)
+    return false;
   auto node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
 
   bool flag = false;
-  if(node != nullptr){
-    ValueType value;
-    if(node->Lookup(key, value, comparator_)){
-      result.push_back(value);
-      flag = true;
-    }
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  ValueType value;
+  if(node->Lookup(key, value, comparator_)){
+    result.push_back(value);
+    flag = true;
   }
+  leaf_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
   return flag;
 }
 
+/*****************************************************************************
+ * LATCH CRABBING
+ *****************************************************************************/
+/*
+ * Find the leaf page containing key, or the left most one, crabbing down with
+ * read latches: the latch of a child is taken before the one of its parent
+ * is released.
+ * @return: the leaf page pinned and read latched, nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageRead(const KeyType &key, bool left_most) {
+  root_latch_.RLock();
+  if(root_page_id_ == INVALID_PAGE_ID){
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  auto *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  if(page == nullptr)
+    ASSERT(false, "fail to fetch root page");
+  page->RLatch();
+  root_latch_.RUnlock();
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while(!node->IsLeafPage()){
+    auto *in_node = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_page_id = left_most ? in_node->ValueAt(0) : in_node->Lookup(key, comparator_);
+    auto *child = buffer_pool_manager_->FetchPage(child_page_id);
+    if(child == nullptr)
+      ASSERT(false, "fail to fetch child page");
+    child->RLatch();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+/*
+ * Find the leaf page containing key for a writer which hopes the leaf does not
+ * split or merge: crab down with read latches and write latch the leaf only.
+ * The read latch of a leaf is traded for the write latch while its parent, or
+ * the root latch, is still read latched, so no split or merge can happen in
+ * between and it is still the leaf of key afterwards.
+ * @return: the leaf page pinned and write latched, nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageOptimistic(const KeyType &key) {
+  root_latch_.RLock();
+  if(root_page_id_ == INVALID_PAGE_ID){
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  auto *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  if(page == nullptr)
+    ASSERT(false, "fail to fetch root page");
+  page->RLatch();
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if(node->IsLeafPage()){
+    page->RUnlatch();
+    page->WLatch();
+    root_latch_.RUnlock();
+    return page;
+  }
+  root_latch_.RUnlock();
+  while(true){
+    auto *in_node = reinterpret_cast<InternalPage *>(node);
+    auto *child = buffer_pool_manager_->FetchPage(in_node->Lookup(key, comparator_));
+    if(child == nullptr)
+      ASSERT(false, "fail to fetch child page");
+    child->RLatch();
+    auto *child_node = reinterpret_cast<BPlusTreePage *>(child->GetData());
+    bool is_leaf = child_node->IsLeafPage();
+    if(is_leaf){
+      child->RUnlatch();
+      child->WLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child;
+    node = child_node;
+    if(is_leaf)
+      return page;
+  }
+}
+
+/*
+ * Find the leaf page containing key, crabbing down with write latches. The
+ * pages which may change by op stay latched in path, from the top most one
+ * down to the leaf: once a page is safe, the latches of its ancestors, and of
+ * the root if root_latched, are released.
+ * @return: the leaf page, nullptr if the tree is empty, in which case the
+ * root latch is held
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPagePessimistic(const KeyType &key, Operation op, std::vector<Page *> &path,
+                                              bool &root_latched) {
+  root_latch_.WLock();
+  root_latched = true;
+  if(root_page_id_ == INVALID_PAGE_ID)
+    return nullptr;
+  auto *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  if(page == nullptr)
+    ASSERT(false, "fail to fetch root page");
+  while(true){
+    page->WLatch();
+    path.push_back(page);
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if(IsSafe(node, op))
+      ReleasePath(path, root_latched, 1);
+    if(node->IsLeafPage())
+      return page;
+    page = buffer_pool_manager_->FetchPage(reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_));
+    if(page == nullptr)
+      ASSERT(false, "fail to fetch child page");
+  }
+}
+
+/*
+ * Whether op on the subtree of node changes node only, and none of its
+ * ancestors: an insert does not split it, a remove does not merge it or
+ * take an entry away from its siblings.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsSafe(BPlusTreePage *node, Operation op) const {
+  if(op == Operation::kRead)
+    return true;
+  if(op == Operation::kInsert)
+    return node->GetSize() < node->GetMaxSize();
+  if(node->IsRootPage())
+    return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+  return node->GetSize() > node->GetMinSize();
+}
+
+/*
+ * Unlatch and unpin the pages of path but the last keep ones, and release the
+ * root latch if it is still held
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleasePath(std::vector<Page *> &path, bool &root_latched, size_t keep) {
+  if(root_latched){
+    root_latch_.WUnlock();
+    root_latched = false;
+  }
+  if(path.size() <= keep)
+    return;
+  size_t release = path.size() - keep;
+  for(size_t i = 0; i < release; i++){
+    path[i]->WUnlatch();
+    buffer_pool_manager_->UnpinPage(path[i]->GetPageId(), true);
+  }
+  path.erase(path.begin(), path.begin() + release);
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -67,16 +258,41 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
+ * The leaf is first found with FindLeafPageOptimistic, and the entry inserted
+ * there if the leaf does not split; otherwise the insert starts over with the
+ * pages which split write latched by FindLeafPagePessimistic.
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  if(IsEmpty()){
+  auto *leaf_page = FindLeafPageOptimistic(key);
+  if(leaf_page != nullptr){
+    auto *leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+    ValueType temp;
+    bool duplicate = leaf->Lookup(key, temp, comparator_);
+    bool safe = IsSafe(leaf, Operation::kInsert);
+    if(!duplicate && safe)
+      leaf->Insert(key, value, comparator_);
+    leaf_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), !duplicate && safe);
+    if(duplicate)
+      return false;
+    if(safe)
+      return true;
+  }
+
+  std::vector<Page *> path;
+  bool root_latched;
+  leaf_page = FindLeafPagePessimistic(key, Operation::kInsert, path, root_latched);
+  if(leaf_page == nullptr){
     StartNewTree(key, value);
+    root_latch_.WUnlock();
     return true;
   }
-  return InsertIntoLeaf(key, value, transaction);
+  bool inserted = InsertIntoLeaf(leaf_page, key, value, transaction);
+  ReleasePath(path, root_latched, 0);
+  return inserted;
 }
 /*
  * Insert constant key & value pair into an empty tree
@@ -86,7 +302,7 @@ bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
-  auto *page = buffer_pool_manager_->NewPage(root_page_id_);
+  auto *page = buffer_pool_manager_->NewPageFrom(root_page_id_, &leaf_allocator_);
   if (page == nullptr) {
     ASSERT(false, "fail to fetch page");
   }
@@ -99,21 +315,19 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
 
 /*
  * Insert constant key & value pair into leaf page
- * User needs to first find the right leaf page as insertion target, then look
- * through leaf page to see whether insert key exist or not. If exist, return
- * immediately, otherwise insert entry. Remember to deal with split if necessary.
+ * The leaf page and every page which splits along with it are write latched
+ * by the caller, who also unlatches and unpins them. Look through leaf page to
+ * see whether insert key exist or not. If exist, return immediately, otherwise
+ * insert entry. Remember to deal with split if necessary.
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-    auto* leaf_page = FindLeafPage(key, false);
-    if(leaf_page == nullptr)
-      ASSERT(false, "fail to fetch page");
+bool BPLUSTREE_TYPE::InsertIntoLeaf(Page *leaf_page, const KeyType &key, const ValueType &value,
+                                    Transaction *transaction) {
     auto* leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
     ValueType temp;
     if(leaf->Lookup(key, temp, comparator_)){
-      buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
       return false;
     }
     else{
@@ -125,7 +339,6 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
         InsertIntoParent(leaf, new_leaf->KeyAt(0), new_leaf, transaction);
         buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
       }
-      buffer_pool_manager_->UnpinPage((leaf_page->GetPageId()), true);
       return true;
     }
 }
@@ -141,7 +354,9 @@ INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
 N *BPLUSTREE_TYPE::Split(N *node) {
   page_id_t new_page_id;
-  auto* new_page = buffer_pool_manager_->NewPage(new_page_id);
+  // internal pages are allocated anywhere, so that they do not interrupt the runs of leaves
+  auto* new_page = std::is_same<N, LeafPage>::value ? buffer_pool_manager_->NewPageFrom(new_page_id, &leaf_allocator_)
+                                                    : buffer_pool_manager_->NewPage(new_page_id);
   if(new_page == nullptr)
     ASSERT(false, "fail to new a page when split");
   auto *new_node = reinterpret_cast<N*>(new_page->GetData());
@@ -205,6 +420,114 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
   }
 }
 
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Number of pages a level of size entries is spread over evenly, so that
+ * every page holds about fill_factor of max_size entries, but at least the
+ * minimum a page keeps after a remove, unless it is the only one
+ */
+static size_t BulkLoadPages(size_t entries, int max_size, double fill_factor) {
+  const size_t min_size = (max_size + 1) / 2;
+  const size_t fill = std::clamp(static_cast<size_t>(max_size * fill_factor), min_size, static_cast<size_t>(max_size));
+  size_t pages = (entries + fill - 1) / fill;
+  while (pages > 1 && entries / pages < min_size)
+    pages--;
+  return std::max<size_t>(pages, 1);
+}
+
+/*
+ * Build an empty tree out of size pairs, which next hands out in ascending
+ * key order. The shape of every level is known from size up front, so the
+ * pages are written left to right and each of them once: a page is created
+ * when its first entry arrives, after its parent, and it is done with once
+ * the next page of its level is created. The leaves come from the runs of
+ * leaf_allocator_, which makes the writes of the leaf level sequential.
+ * @return: false if two keys are equal or not in order, or there are fewer
+ * than size pairs, and the tree is left empty.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(size_t size, const std::function<bool(MappingType &)> &next, double fill_factor) {
+  ASSERT(IsEmpty(), "bulk load into a tree which is not empty");
+  if (size == 0)
+    return true;
+  std::vector<BulkLoadLevel> levels;
+  levels.push_back({size, BulkLoadPages(size, leaf_max_size_, fill_factor)});
+  while (levels.back().pages > 1) {
+    size_t children = levels.back().pages;
+    levels.push_back({children, BulkLoadPages(children, internal_max_size_, fill_factor)});
+  }
+
+  bool in_order = true;
+  MappingType item;
+  KeyType last_key;
+  for (size_t i = 0; i < size; i++) {
+    if (!next(item) || (i > 0 && comparator_(last_key, item.first) >= 0)) {
+      in_order = false;
+      break;
+    }
+    if (levels[0].remaining == 0)
+      BulkLoadNewPage(levels, 0, item.first);
+    reinterpret_cast<LeafPage *>(levels[0].page->GetData())->CopyLastFrom(item);
+    levels[0].remaining--;
+    last_key = item.first;
+  }
+  for (auto &level : levels) {
+    if (level.page != nullptr)
+      buffer_pool_manager_->UnpinPage(level.page->GetPageId(), true);
+  }
+  if (levels.back().page != nullptr) {
+    root_page_id_ = levels.back().page->GetPageId();
+    UpdateRootPageId(1);
+  }
+  if (!in_order) {
+    Destroy();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Create the next page of a level, and the next page of its parent level
+ * first if the current one is full. The previous page of the level is
+ * unpinned, and a previous leaf linked to the new one.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoadNewPage(std::vector<BulkLoadLevel> &levels, size_t level, const KeyType &key) {
+  page_id_t parent_page_id = INVALID_PAGE_ID;
+  if (level + 1 < levels.size()) {
+    if (levels[level + 1].remaining == 0)
+      BulkLoadNewPage(levels, level + 1, key);
+    parent_page_id = levels[level + 1].page->GetPageId();
+  }
+  BulkLoadLevel &current = levels[level];
+  page_id_t page_id;
+  Page *page = level == 0 ? buffer_pool_manager_->NewPageFrom(page_id, &leaf_allocator_)
+                          : buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr)
+    ASSERT(false, "fail to new a page when bulk load");
+  if (level == 0) {
+    reinterpret_cast<LeafPage *>(page->GetData())->Init(page_id, parent_page_id, leaf_max_size_);
+    if (current.page != nullptr)
+      reinterpret_cast<LeafPage *>(current.page->GetData())->SetNextPageId(page_id);
+  } else {
+    reinterpret_cast<InternalPage *>(page->GetData())->Init(page_id, parent_page_id, internal_max_size_);
+  }
+  if (current.page != nullptr)
+    buffer_pool_manager_->UnpinPage(current.page->GetPageId(), true);
+  current.page = page;
+  // entries [entries * i / pages, entries * (i + 1) / pages) go to page i
+  current.remaining = current.entries * (current.page_index + 1) / current.pages -
+                      current.entries * current.page_index / current.pages;
+  current.page_index++;
+  if (parent_page_id != INVALID_PAGE_ID) {
+    auto *parent = reinterpret_cast<InternalPage *>(levels[level + 1].page->GetData());
+    parent->CopyLastFrom({key, page_id}, buffer_pool_manager_);
+    levels[level + 1].remaining--;
+  }
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -214,39 +537,44 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  * If not, User needs to first find the right leaf page as deletion target, then
  * delete entry from leaf page. Remember to deal with redistribute or merge if
  * necessary.
+ * As Insert, the remove is first tried with only the leaf write latched, and
+ * starts over with write latch crabbing when the leaf would underflow. The
+ * separators in the parents are left alone: a key removed from the front of a
+ * leaf still separates it from its left sibling. Pages emptied by a merge are
+ * deleted once no latch and pin is held on them any more.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
-  if(IsEmpty()) return;
-  auto* leaf_page = reinterpret_cast<LeafPage*>(FindLeafPage(key, false));
-
-  int cur_size = leaf_page->RemoveAndDeleteRecord(key, comparator_);
-  if(leaf_page->IsRootPage()){
-    leaf_page->RemoveAndDeleteRecord(key, comparator_);
-    if(leaf_page->GetSize() == 0){
-      root_page_id_ = -1;
-    }
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
+  auto* leaf_page = FindLeafPageOptimistic(key);
+  if(leaf_page == nullptr)
+    return;
+  auto* leaf = reinterpret_cast<LeafPage*>(leaf_page->GetData());
+  ValueType temp;
+  bool found = leaf->Lookup(key, temp, comparator_);
+  bool safe = IsSafe(leaf, Operation::kRemove);
+  if(found && safe)
+    leaf->RemoveAndDeleteRecord(key, comparator_);
+  leaf_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), found && safe);
+  if(!found || safe)
     return;
-  }
-  auto* parent_page = buffer_pool_manager_->FetchPage(leaf_page->GetParentPageId());
-  if(parent_page == nullptr)
-    ASSERT(false, "fail to fetch parent page");
-  auto* parent_node = reinterpret_cast<InternalPage *>(parent_page->GetData());
-  parent_node->SetKeyAt(parent_node->ValueIndex(leaf_page->GetPageId()), leaf_page->KeyAt(0));
-  while(!parent_node->IsRootPage()){
-    auto* cur_node = parent_node;
-    parent_page = buffer_pool_manager_->FetchPage(parent_node->GetParentPageId());
-    parent_node = reinterpret_cast<InternalPage *>(parent_page->GetData());
-    parent_node->SetKeyAt(parent_node->ValueIndex(cur_node->GetPageId()), cur_node->KeyAt(0));
-    buffer_pool_manager_->UnpinPage(cur_node->GetPageId(), true);
-  }
-  buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
-
-  if(cur_size < leaf_page->GetMinSize())
-    CoalesceOrRedistribute(leaf_page, transaction);
 
-  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
+  std::vector<Page *> path;
+  bool root_latched;
+  leaf_page = FindLeafPagePessimistic(key, Operation::kRemove, path, root_latched);
+  if(leaf_page == nullptr){
+    root_latch_.WUnlock();
+    return;
+  }
+  leaf = reinterpret_cast<LeafPage*>(leaf_page->GetData());
+  std::vector<page_id_t> deleted;
+  int old_size = leaf->GetSize();
+  int cur_size = leaf->RemoveAndDeleteRecord(key, comparator_);
+  if(cur_size < old_size && (leaf->IsRootPage() ? cur_size == 0 : cur_size < leaf->GetMinSize()))
+    CoalesceOrRedistribute(leaf, deleted, transaction);
+  ReleasePath(path, root_latched, 0);
+  for(auto page_id : deleted)
+    buffer_pool_manager_->DeletePage(page_id);
 }
 
 /*
@@ -258,9 +586,16 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
-bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
+bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, std::vector<page_id_t> &deleted, Transaction *transaction) {
   if(node->IsRootPage()){
-    return AdjustRoot(node);
+    // the root may hold fewer than min size entries, it only goes away once it is empty or has one child
+    if((node->IsLeafPage() && node->GetSize() == 0) || (!node->IsLeafPage() && node->GetSize() == 1)){
+      if(AdjustRoot(node)){
+        deleted.push_back(node->GetPageId());
+        return true;
+      }
+    }
+    return false;
   }
   auto* parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
   auto* parent_node = reinterpret_cast<InternalPage*>(parent_page->GetData());
@@ -269,7 +604,9 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
   int sibling = index - 1;
   if(index == 0)
     sibling = 1;
+  // the parent is write latched by this thread, so no one else latches two siblings at once
   auto* sibling_page = buffer_pool_manager_->FetchPage(parent_node->ValueAt(sibling));
+  sibling_page->WLatch();
   auto* sibling_node = reinterpret_cast<N*>(sibling_page->GetData());
 
   if(node->GetSize() + sibling_node->GetSize() <= node->GetMaxSize()){
@@ -279,21 +616,22 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
       sibling_node = temp;
     }
     index = parent_node->ValueIndex(node->GetPageId());
-    Coalesce(&sibling_node, &node, &parent_node, index, transaction);
+    Coalesce(&sibling_node, &node, &parent_node, index, deleted, transaction);
   }
   else{
     Redistribute(sibling_node, node, index);
   }
 
   buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
+  sibling_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(sibling_page->GetPageId(), true);
 
   return false;
 }
 
 /*
- * Move all the key & value pairs from one page to its sibling page, and notify
- * buffer pool manager to delete this page. Parent page must be adjusted to
+ * Move all the key & value pairs from one page to its sibling page, and add
+ * this page to deleted, to be deleted by the caller once it is unpinned. Parent page must be adjusted to
  * take info of deletion into account. Remember to deal with coalesce or
  * redistribute recursively if necessary.
  * Using template N to represent either internal page or leaf page.
@@ -306,13 +644,13 @@ INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
 bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
                               BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent, int index,
-                              Transaction *transaction) {
+                              std::vector<page_id_t> &deleted, Transaction *transaction) {
     assert((*neighbor_node)->GetSize() + (*node)->GetSize() <= (*node)->GetMaxSize());
     (*node)->MoveAllTo(*neighbor_node, (*parent)->KeyAt(index), buffer_pool_manager_);
     (*parent)->Remove(index);
-    buffer_pool_manager_->DeletePage((*node)->GetPageId());
+    deleted.push_back((*node)->GetPageId());
     if((*parent)->GetSize() < (*parent)->GetMinSize()){
-      return CoalesceOrRedistribute<InternalPage>(*parent, transaction);
+      return CoalesceOrRedistribute<InternalPage>(*parent, deleted, transaction);
     }
 
     return false;
@@ -401,51 +739,39 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
  *****************************************************************************/
 /*
  * Input parameter is void, find the left most leaf page first, then construct
- * index iterator
+ * index iterator, which holds the leaf read latched
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
-  auto* leaf = reinterpret_cast<LeafPage *>(FindLeafPage(true));
-  return INDEXITERATOR_TYPE(leaf, 0, buffer_pool_manager_);
+  auto* page = FindLeafPageRead(KeyType{}, true);
+  if(page == nullptr)
+    return End();
+  return INDEXITERATOR_TYPE(this, page, 0, buffer_pool_manager_);
 }
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
- * first, then construct index iterator
+ * first, then construct index iterator, which holds the leaf read latched
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
-  auto* leaf_node = reinterpret_cast<LeafPage*>(FindLeafPage(key, false));
-  if(leaf_node == nullptr)
-    return INDEXITERATOR_TYPE(leaf_node, 0, buffer_pool_manager_);
-  else
-    return INDEXITERATOR_TYPE(leaf_node, leaf_node->KeyIndex(key, comparator_), buffer_pool_manager_);
+  auto* page = FindLeafPageRead(key, false);
+  if(page == nullptr)
+    return End();
+  auto* leaf_node = reinterpret_cast<LeafPage*>(page->GetData());
+  return INDEXITERATOR_TYPE(this, page, leaf_node->KeyIndex(key, comparator_), buffer_pool_manager_);
 }
 
 /*
  * Input parameter is void, construct an index iterator representing the end
- * of the key/value pair in the leaf node
+ * of the key/value pair in the leaf node, i.e. one past the last pair
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
-  assert(root_page_id_ != INVALID_PAGE_ID);
-  auto *page = buffer_pool_manager_->FetchPage(root_page_id_);
-  auto *node = reinterpret_cast<BPlusTreePage*>(page->GetData());
-
-  while(!node->IsLeafPage()){
-    auto  *in_node = reinterpret_cast<InternalPage *>(node);
-    page_id_t child_page_id;
-    child_page_id = in_node->ValueAt(in_node->GetSize()-1);
-    assert(child_page_id > 0);
-    buffer_pool_manager_->UnpinPage((page->GetPageId()), false);
-    page = buffer_pool_manager_->FetchPage(child_page_id);
-    node = reinterpret_cast<BPlusTreePage*>(page->GetData());
-  }
-  auto *leaf = reinterpret_cast<LeafPage*>(page->GetData());
-  return INDEXITERATOR_TYPE(leaf, leaf->GetSize()-1, buffer_pool_manager_);
+  return INDEXITERATOR_TYPE(this, nullptr, 0, buffer_pool_manager_);
 }
 
 /*****************************************************************************
@@ -454,52 +780,40 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
  * the left most leaf page
- * Note: the leaf page is pinned, you need to unpin it after use.
+ * Note: the leaf page is pinned, you need to unpin it after use. It is not
+ * latched; nullptr is returned if the tree is empty.
  */
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
-    assert(root_page_id_ != INVALID_PAGE_ID);
-    auto *page = buffer_pool_manager_->FetchPage(root_page_id_);
-    auto *node = reinterpret_cast<BPlusTreePage*>(page->GetData());
-
-    while(!node->IsLeafPage()){
-      auto  *in_node = reinterpret_cast<InternalPage *>(node);
-      page_id_t child_page_id;
-      if(leftMost){
-        child_page_id = in_node->ValueAt(0);
-      }else{
-        child_page_id = in_node->Lookup(key, comparator_);
-      }
-      assert(child_page_id > 0);
-      buffer_pool_manager_->UnpinPage((page->GetPageId()), false);
-      page = buffer_pool_manager_->FetchPage(child_page_id);
-      node = reinterpret_cast<BPlusTreePage*>(page->GetData());
-    }
-    return page;
+  auto *page = FindLeafPageRead(key, leftMost);
+  if(page != nullptr)
+    page->RUnlatch();
+  return page;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(bool leftMost) {
-  assert(root_page_id_ != INVALID_PAGE_ID);
-  auto *page = buffer_pool_manager_->FetchPage(root_page_id_);
-  auto *node = reinterpret_cast<BPlusTreePage*>(page->GetData());
+  return FindLeafPage(KeyType{}, leftMost);
+}
 
-  while(!node->IsLeafPage()){
-    auto  *in_node = reinterpret_cast<InternalPage *>(node);
-    page_id_t child_page_id;
-    child_page_id = in_node->ValueAt(0);
-    assert(child_page_id > 0);
-    buffer_pool_manager_->UnpinPage((page->GetPageId()), false);
-    page = buffer_pool_manager_->FetchPage(child_page_id);
-    node = reinterpret_cast<BPlusTreePage*>(page->GetData());
+INDEX_TEMPLATE_ARGUMENTS
+PageRunStats BPLUSTREE_TYPE::GetLeafPageRunStats() {
+  PageRunStats stats;
+  auto *page = FindLeafPage(true);
+  while (page != nullptr) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    stats.AddPage(page->GetPageId());
+    page_id_t next_page_id = leaf->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = next_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(next_page_id);
   }
-  return page;
+  return stats;
 }
 
 
 /*
- * Update/Insert root page id in header page(where page_id = 0, header_page is
- * defined under include/page/header_page.h)
+ * Update/Insert root page id in index roots page(where page_id = INDEX_ROOTS_PAGE_ID,
+ * index_roots_page is defined under include/page/index_roots_page.h)
  * Call this method everytime root page id is changejd.
  * @parameter: insert_record      default value is false. When set to true,
  * insert a record <index_name, root_page_id> into header page instead of
@@ -507,17 +821,23 @@ Page *BPLUSTREE_TYPE::FindLeafPage(bool leftMost) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
-  auto* page = buffer_pool_manager_->FetchPage(0);
+  auto* page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
   if(page == nullptr)
     ASSERT(false, "fail to fetch page");
+  // the roots page is shared by all indexes
+  page->WLatch();
   auto* root_page_ = reinterpret_cast<IndexRootsPage*>(page->GetData());
+  // a tree emptied and grown again already has its record
   if(insert_record){
-    root_page_->Insert(index_id_, root_page_id_);
+    if(!root_page_->Insert(index_id_, root_page_id_))
+      root_page_->Update(index_id_, root_page_id_);
   }
   else{
-    root_page_->Update(index_id_, root_page_id_);
+    if(!root_page_->Update(index_id_, root_page_id_))
+      root_page_->Insert(index_id_, root_page_id_);
   }
-  buffer_pool_manager_->UnpinPage(0, true);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
 }
 
 /**
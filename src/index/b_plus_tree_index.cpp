@@ -1,46 +1,231 @@
 #include "index/b_plus_tree_index.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <queue>
+
+#include "buffer/page_log_scope.h"
 #include "index/generic_key.h"
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema,
-                                     BufferPoolManager *buffer_pool_manager)
-        : Index(index_id, key_schema),
+                                     BufferPoolManager *buffer_pool_manager, bool unique, double fill_factor,
+                                     size_t sort_buffer_size)
+        : Index(index_id, key_schema, buffer_pool_manager->GetLogManager()),
           comparator_(key_schema_),
-          container_(index_id, buffer_pool_manager, comparator_) {
+          container_(index_id, buffer_pool_manager, comparator_),
+          unique_(unique),
+          fill_factor_(fill_factor),
+          sort_buffer_size_(sort_buffer_size) {
+
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType BPLUSTREE_INDEX_TYPE::MakeKey(const Row &key, RowId row_id) const {
+  KeyType index_key;
+  index_key.SerializeFromKey(key, key_schema_, !unique_);
+  if (!unique_) {
+    index_key.SetRowId(row_id);
+  }
+  return index_key;
+}
 
+INDEX_TEMPLATE_ARGUMENTS
+KeyType BPLUSTREE_INDEX_TYPE::MakeBound(const Row &key, bool largest) const {
+  KeyType index_key;
+  index_key.SerializeFromKey(key, key_schema_, !unique_);
+  if (!unique_) {
+    index_key.SetRowIdBound(largest);
+  }
+  return index_key;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
   ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
-  KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  KeyType index_key = MakeKey(key, row_id);
+  PageLogScope scope(log_manager_);
 
   bool status = container_.Insert(index_key, row_id, txn);
 
   if (!status) {
     return DB_FAILED;
   }
+  LogEntry(LogRecordType::kIndexInsert, key, row_id, txn);
   return DB_SUCCESS;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
-  KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  KeyType index_key = MakeKey(key, row_id);
+  PageLogScope scope(log_manager_);
 
   container_.Remove(index_key, txn);
+  LogEntry(LogRecordType::kIndexDelete, key, row_id, txn);
   return DB_SUCCESS;
 }
 
+/**
+ * A unique index looks the key up, a non-unique one walks the leaves over all the entries with its fields
+ */
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::ScanKey(const Row &key, vector<RowId> &result, Transaction *txn) {
-  KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
-  if (container_.GetValue(index_key, result, txn)) {
-    return DB_SUCCESS;
+  if (unique_) {
+    KeyType index_key;
+    index_key.SerializeFromKey(key, key_schema_);
+    if (container_.GetValue(index_key, result, txn)) {
+      return DB_SUCCESS;
+    }
+    return DB_KEY_NOT_FOUND;
+  }
+  std::unique_ptr<IndexRangeIterator> iterator;
+  ScanRange(&key, true, &key, true, iterator, txn);
+  size_t size = result.size();
+  RowId row_id;
+  while (iterator->Next(row_id)) {
+    result.push_back(row_id);
+  }
+  return result.size() > size ? DB_SUCCESS : DB_KEY_NOT_FOUND;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::ScanRange(const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive,
+                                        std::unique_ptr<IndexRangeIterator> &iterator, Transaction *txn) {
+  // in a non-unique index, an inclusive lower bound starts before the entries with the same fields and an
+  // exclusive one after them, and the other way round for the upper bound
+  KeyType lo_key, hi_key;
+  if (lo != nullptr) {
+    lo_key = MakeBound(*lo, !lo_inclusive);
+  }
+  if (hi != nullptr) {
+    hi_key = MakeBound(*hi, hi_inclusive);
+  }
+  iterator = std::make_unique<BPlusTreeRangeIterator<KeyType, ValueType, KeyComparator>>(
+          lo == nullptr ? container_.Begin() : container_.Begin(lo_key), lo == nullptr ? nullptr : &lo_key,
+          lo_inclusive, hi == nullptr ? nullptr : &hi_key, hi_inclusive, comparator_);
+  return DB_SUCCESS;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+BPlusTreeRangeIterator<KeyType, ValueType, KeyComparator>::BPlusTreeRangeIterator(
+        INDEXITERATOR_TYPE begin, const KeyType *lo, bool lo_inclusive, const KeyType *hi, bool hi_inclusive,
+        const KeyComparator &comparator)
+        : iter_(std::move(begin)), has_lo_(lo != nullptr), lo_inclusive_(lo_inclusive), has_hi_(hi != nullptr),
+          hi_inclusive_(hi_inclusive), comparator_(comparator) {
+  if (has_lo_) {
+    lo_ = *lo;
+  }
+  if (has_hi_) {
+    hi_ = *hi;
   }
-  return DB_KEY_NOT_FOUND;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPlusTreeRangeIterator<KeyType, ValueType, KeyComparator>::Next(RowId &row_id) {
+  const INDEXITERATOR_TYPE end;
+  while (iter_ != end) {
+    const MappingType &entry = *iter_;
+    if (has_lo_ && !lo_inclusive_ && comparator_(entry.first, lo_) == 0) {
+      ++iter_;
+      continue;
+    }
+    if (has_hi_) {
+      int cmp = comparator_(entry.first, hi_);
+      if (cmp > 0 || (cmp == 0 && !hi_inclusive_)) {
+        // past the range, the leaf is no longer needed
+        iter_ = INDEXITERATOR_TYPE();
+        return false;
+      }
+    }
+    row_id = entry.second;
+    ++iter_;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Write sorted entries to a temporary file, a run of an external sort
+ */
+template<typename T>
+static FILE *SpillRun(const std::vector<T> &items) {
+  FILE *file = std::tmpfile();
+  if (file == nullptr || fwrite(items.data(), sizeof(T), items.size(), file) != items.size()) {
+    ASSERT(false, "fail to write a run of an external sort");
+  }
+  rewind(file);
+  return file;
+}
+
+/**
+ * The entries are sorted in memory while they fit into sort_buffer_size_, otherwise in runs of that size
+ * written to temporary files and merged. The sorted entries are then handed to the B+ tree, which builds
+ * its pages bottom-up.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::BulkLoad(TableHeap *table_heap, const std::vector<uint32_t> &key_map,
+                                       Transaction *txn) {
+  auto less = [this](const MappingType &a, const MappingType &b) { return comparator_(a.first, b.first) < 0; };
+  const size_t run_capacity = std::max<size_t>(sort_buffer_size_ / sizeof(MappingType), 1);
+  std::vector<MappingType> buffer;
+  std::vector<FILE *> runs;
+  size_t size = 0;
+  for (auto it = table_heap->Begin(txn); it != table_heap->End(); ++it) {
+    std::vector<Field> fields;
+    for (auto column_index : key_map) {
+      fields.emplace_back(*it->GetField(column_index));
+    }
+    Row key(fields);
+    buffer.emplace_back(MakeKey(key, it->GetRowId()), it->GetRowId());
+    size++;
+    if (buffer.size() == run_capacity) {
+      std::sort(buffer.begin(), buffer.end(), less);
+      runs.push_back(SpillRun(buffer));
+      buffer.clear();
+    }
+  }
+  std::sort(buffer.begin(), buffer.end(), less);
+
+  bool loaded;
+  if (runs.empty()) {
+    size_t next = 0;
+    loaded = container_.BulkLoad(size, [&](MappingType &item) {
+      item = buffer[next++];
+      return true;
+    }, fill_factor_);
+  } else {
+    if (!buffer.empty()) {
+      runs.push_back(SpillRun(buffer));
+    }
+    std::vector<MappingType>().swap(buffer);
+    // the smallest entry not merged yet of every run
+    using Head = std::pair<MappingType, size_t>;
+    auto greater = [&less](const Head &a, const Head &b) { return less(b.first, a.first); };
+    std::priority_queue<Head, std::vector<Head>, decltype(greater)> heads(greater);
+    for (size_t i = 0; i < runs.size(); i++) {
+      Head head;
+      if (fread(&head.first, sizeof(MappingType), 1, runs[i]) == 1) {
+        head.second = i;
+        heads.push(head);
+      }
+    }
+    loaded = container_.BulkLoad(size, [&](MappingType &item) {
+      if (heads.empty()) {
+        return false;
+      }
+      Head head = heads.top();
+      heads.pop();
+      item = head.first;
+      if (fread(&head.first, sizeof(MappingType), 1, runs[head.second]) == 1) {
+        heads.push(head);
+      }
+      return true;
+    }, fill_factor_);
+    for (auto run : runs) {
+      fclose(run);
+    }
+  }
+  return loaded ? DB_SUCCESS : DB_FAILED;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -49,6 +234,11 @@ dberr_t BPLUSTREE_INDEX_TYPE::Destroy() {
   return DB_SUCCESS;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+PageRunStats BPLUSTREE_INDEX_TYPE::GetPageRunStats() {
+  return container_.GetLeafPageRunStats();
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() {
   return container_.Begin();
@@ -65,6 +255,21 @@ INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() {
   return container_.End();
 }
 
+template
+class BPlusTreeRangeIterator<GenericKey<4>, RowId, GenericComparator<4>>;
+
+template
+class BPlusTreeRangeIterator<GenericKey<8>, RowId, GenericComparator<8>>;
+
+template
+class BPlusTreeRangeIterator<GenericKey<16>, RowId, GenericComparator<16>>;
+
+template
+class BPlusTreeRangeIterator<GenericKey<32>, RowId, GenericComparator<32>>;
+
+template
+class BPlusTreeRangeIterator<GenericKey<64>, RowId, GenericComparator<64>>;
+
 template
 class BPlusTreeIndex<GenericKey<4>, RowId, GenericComparator<4>>;
 
@@ -0,0 +1,67 @@
+#include "index/extendible_hash_index.h"
+
+#include "buffer/page_log_scope.h"
+#include "index/generic_key.h"
+
+INDEX_TEMPLATE_ARGUMENTS
+HASH_INDEX_TYPE::ExtendibleHashIndex(index_id_t index_id, IndexSchema *key_schema,
+                                     BufferPoolManager *buffer_pool_manager, bool unique)
+        : Index(index_id, key_schema, buffer_pool_manager->GetLogManager()),
+          comparator_(key_schema_),
+          container_(index_id, buffer_pool_manager, comparator_, unique) {
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t HASH_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
+  ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
+  KeyType index_key;
+  index_key.SerializeFromKey(key, key_schema_);
+  PageLogScope scope(log_manager_);
+  if (!container_.Insert(index_key, row_id, txn)) {
+    return DB_FAILED;
+  }
+  LogEntry(LogRecordType::kIndexInsert, key, row_id, txn);
+  return DB_SUCCESS;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t HASH_INDEX_TYPE::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
+  KeyType index_key;
+  index_key.SerializeFromKey(key, key_schema_);
+  PageLogScope scope(log_manager_);
+  if (container_.Remove(index_key, row_id, txn)) {
+    LogEntry(LogRecordType::kIndexDelete, key, row_id, txn);
+  }
+  return DB_SUCCESS;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t HASH_INDEX_TYPE::ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) {
+  KeyType index_key;
+  index_key.SerializeFromKey(key, key_schema_);
+  if (container_.GetValue(index_key, result, txn)) {
+    return DB_SUCCESS;
+  }
+  return DB_KEY_NOT_FOUND;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t HASH_INDEX_TYPE::Destroy() {
+  container_.Destroy();
+  return DB_SUCCESS;
+}
+
+template
+class ExtendibleHashIndex<GenericKey<4>, RowId, GenericComparator<4>>;
+
+template
+class ExtendibleHashIndex<GenericKey<8>, RowId, GenericComparator<8>>;
+
+template
+class ExtendibleHashIndex<GenericKey<16>, RowId, GenericComparator<16>>;
+
+template
+class ExtendibleHashIndex<GenericKey<32>, RowId, GenericComparator<32>>;
+
+template
+class ExtendibleHashIndex<GenericKey<64>, RowId, GenericComparator<64>>;
@@ -0,0 +1,488 @@
+#include "index/extendible_hash_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "glog/logging.h"
+#include "index/basic_comparator.h"
+#include "index/generic_key.h"
+#include "page/index_roots_page.h"
+
+INDEX_TEMPLATE_ARGUMENTS
+HASH_TABLE_TYPE::ExtendibleHashTable(index_id_t index_id, BufferPoolManager *buffer_pool_manager,
+                                     const KeyComparator &comparator, bool unique)
+        : index_id_(index_id),
+          directory_page_id_(INVALID_PAGE_ID),
+          buffer_pool_manager_(buffer_pool_manager),
+          comparator_(comparator),
+          unique_(unique) {
+  // load the directory of an existing index
+  auto *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  if (page != nullptr) {
+    auto *roots_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
+    if (!roots_page->GetRootId(index_id_, &directory_page_id_)) {
+      directory_page_id_ = INVALID_PAGE_ID;
+    }
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  }
+}
+
+/*
+ * Hash the bytes of a key, 8 at a time, and mix the result, so that the low
+ * bits the directory uses depend on all of them
+ */
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t HASH_TABLE_TYPE::Hash(const KeyType &key) {
+  const auto *bytes = reinterpret_cast<const char *>(&key);
+  uint64_t hash = sizeof(KeyType);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= sizeof(KeyType); i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(word));
+    hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+    hash ^= hash >> 32;
+  }
+  if (i < sizeof(KeyType)) {
+    uint64_t word = 0;
+    memcpy(&word, bytes + i, sizeof(KeyType) - i);
+    hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return static_cast<uint32_t>(hash);
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction) {
+  table_latch_.RLock();
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    table_latch_.RUnlock();
+    return false;
+  }
+  auto *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  auto *directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  page_id_t page_id = GetBucketPageId(directory, directory->SlotOf(Hash(key)));
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  bool found = false;
+  while (page_id != INVALID_PAGE_ID) {
+    auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    found = bucket->GetValue(key, comparator_, result) || found;
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Insert into the bucket of the key, splitting it as long as it is full.
+ * A bucket whose pairs the directory can not tell apart any more gets an
+ * overflow page instead.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  table_latch_.WLock();
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    CreateDirectory();
+  }
+  auto *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  auto *directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  const uint32_t hash = Hash(key);
+  bool duplicate = false;
+  bool inserted = false;
+  while (!inserted && !duplicate) {
+    page_id_t bucket_page_id = GetBucketPageId(directory, directory->SlotOf(hash));
+    inserted = InsertIntoBucket(bucket_page_id, key, value, false, duplicate);
+    if (!inserted && !duplicate && !SplitBucket(directory, hash)) {
+      inserted = InsertIntoBucket(bucket_page_id, key, value, true, duplicate);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  table_latch_.WUnlock();
+  return inserted;
+}
+
+/*
+ * Create the directory of an empty table, with a single bucket
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_TYPE::CreateDirectory() {
+  page_id_t directory_page_id, segment_page_id, bucket_page_id;
+  auto *directory_page = buffer_pool_manager_->NewPage(directory_page_id);
+  auto *segment_page = buffer_pool_manager_->NewPage(segment_page_id);
+  auto *bucket_page = buffer_pool_manager_->NewPage(bucket_page_id);
+  if (directory_page == nullptr || segment_page == nullptr || bucket_page == nullptr)
+    ASSERT(false, "fail to new a page when create hash table directory");
+  reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData())->Init(directory_page_id, segment_page_id);
+  reinterpret_cast<HashTableSegmentPage *>(segment_page->GetData())->SetBucketPageId(0, bucket_page_id);
+  reinterpret_cast<BucketPage *>(bucket_page->GetData())->Init(bucket_page_id, 0);
+  buffer_pool_manager_->UnpinPage(directory_page_id, true);
+  buffer_pool_manager_->UnpinPage(segment_page_id, true);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  directory_page_id_ = directory_page_id;
+  UpdateRootPageId(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t HASH_TABLE_TYPE::GetBucketPageId(HashTableDirectoryPage *directory, uint32_t slot) {
+  page_id_t segment_page_id = directory->GetSegmentPageId(slot / DIRECTORY_SEGMENT_SIZE);
+  auto *segment_page = buffer_pool_manager_->FetchPage(segment_page_id);
+  auto *segment = reinterpret_cast<HashTableSegmentPage *>(segment_page->GetData());
+  page_id_t bucket_page_id = segment->GetBucketPageId(slot);
+  buffer_pool_manager_->UnpinPage(segment_page_id, false);
+  return bucket_page_id;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_TYPE::SetBucketPageId(HashTableDirectoryPage *directory, uint32_t slot, page_id_t bucket_page_id) {
+  page_id_t segment_page_id = directory->GetSegmentPageId(slot / DIRECTORY_SEGMENT_SIZE);
+  auto *segment_page = buffer_pool_manager_->FetchPage(segment_page_id);
+  auto *segment = reinterpret_cast<HashTableSegmentPage *>(segment_page->GetData());
+  segment->SetBucketPageId(slot, bucket_page_id);
+  buffer_pool_manager_->UnpinPage(segment_page_id, true);
+}
+
+/*
+ * Insert a pair into a bucket if one of its pages has room, or into a new
+ * overflow page if overflow is set
+ * @return: false if the pair is not inserted, duplicate tells whether that is
+ * because it, or its key in a unique table, is there already
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_TYPE::InsertIntoBucket(page_id_t bucket_page_id, const KeyType &key, const ValueType &value,
+                                       bool overflow, bool &duplicate) {
+  bool has_room = false;
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID;) {
+    auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    duplicate = bucket->Contains(key, value, !unique_, comparator_);
+    has_room = has_room || !bucket->IsFull();
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (duplicate)
+      return false;
+    page_id = next_page_id;
+  }
+  if (!has_room && !overflow)
+    return false;
+  auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(bucket_page_id)->GetData());
+  AddToBucket(bucket, key, value);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  return true;
+}
+
+/*
+ * Insert a pair into the first page of a bucket with room, adding an overflow
+ * page at the end if all are full. The first page is pinned by the caller.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_TYPE::AddToBucket(BucketPage *bucket, const KeyType &key, const ValueType &value) {
+  BucketPage *current = bucket;
+  while (current->IsFull()) {
+    page_id_t next_page_id = current->GetNextPageId();
+    Page *page;
+    if (next_page_id == INVALID_PAGE_ID) {
+      page = buffer_pool_manager_->NewPage(next_page_id);
+      if (page == nullptr)
+        ASSERT(false, "fail to new an overflow page");
+      reinterpret_cast<BucketPage *>(page->GetData())->Init(next_page_id, 0);
+      current->SetNextPageId(next_page_id);
+    } else {
+      page = buffer_pool_manager_->FetchPage(next_page_id);
+    }
+    if (current != bucket)
+      buffer_pool_manager_->UnpinPage(current->GetPageId(), true);
+    current = reinterpret_cast<BucketPage *>(page->GetData());
+  }
+  current->Insert(key, value, comparator_);
+  if (current != bucket)
+    buffer_pool_manager_->UnpinPage(current->GetPageId(), true);
+}
+
+/*
+ * Split the bucket of hash into two buckets one bit of local depth deeper,
+ * doubling the directory first if the bucket is as deep as the directory
+ * @return: false if the bucket can not be split any further, or none of its
+ * pairs would move apart from hash
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_TYPE::SplitBucket(HashTableDirectoryPage *directory, uint32_t hash) {
+  const uint32_t slot = directory->SlotOf(hash);
+  const page_id_t bucket_page_id = GetBucketPageId(directory, slot);
+  auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(bucket_page_id)->GetData());
+  const uint32_t local_depth = bucket->GetLocalDepth();
+  const uint32_t max_mask = (1u << DIRECTORY_MAX_DEPTH) - 1;
+  bool separable = false;
+  for (int i = 0; i < bucket->GetSize() && !separable; i++) {
+    separable = ((Hash(bucket->GetItem(i).first) ^ hash) & max_mask) != 0;
+  }
+  if (local_depth == DIRECTORY_MAX_DEPTH || !separable) {
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    return false;
+  }
+  if (local_depth == directory->GetGlobalDepth()) {
+    GrowDirectory(directory);
+  }
+
+  page_id_t image_page_id;
+  auto *image_page = buffer_pool_manager_->NewPage(image_page_id);
+  if (image_page == nullptr)
+    ASSERT(false, "fail to new a page when split bucket");
+  auto *image = reinterpret_cast<BucketPage *>(image_page->GetData());
+  image->Init(image_page_id, local_depth + 1);
+  bucket->SetLocalDepth(local_depth + 1);
+  // of the slots of the bucket, those with the new bit set go to the image
+  const uint32_t stride = 1u << local_depth;
+  for (uint32_t i = (slot & (stride - 1)) | stride; i < directory->Size(); i += 2 * stride) {
+    SetBucketPageId(directory, i, image_page_id);
+  }
+
+  // take all pairs out of the bucket and its overflow pages, and deal them out again
+  std::vector<MappingType> items;
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID;) {
+    auto *current = page_id == bucket_page_id
+                    ? bucket : reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    for (int i = 0; i < current->GetSize(); i++) {
+      items.push_back(current->GetItem(i));
+    }
+    page_id_t next_page_id = current->GetNextPageId();
+    if (page_id != bucket_page_id) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    page_id = next_page_id;
+  }
+  bucket->Clear();
+  bucket->SetNextPageId(INVALID_PAGE_ID);
+  // in key order, every pair goes to the end of its page
+  std::stable_sort(items.begin(), items.end(), [this](const MappingType &a, const MappingType &b) {
+    return comparator_(a.first, b.first) < 0;
+  });
+  for (const auto &item : items) {
+    AddToBucket((Hash(item.first) & stride) != 0 ? image : bucket, item.first, item.second);
+  }
+  buffer_pool_manager_->UnpinPage(image_page_id, true);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  return true;
+}
+
+/*
+ * Double the directory, the new upper half of the slots pointing to the same
+ * buckets as the lower half
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_TYPE::GrowDirectory(HashTableDirectoryPage *directory) {
+  const uint32_t size = directory->Size();
+  if (size < DIRECTORY_SEGMENT_SIZE) {
+    page_id_t segment_page_id = directory->GetSegmentPageId(0);
+    auto *segment_page = buffer_pool_manager_->FetchPage(segment_page_id);
+  auto *segment = reinterpret_cast<HashTableSegmentPage *>(segment_page->GetData());
+    for (uint32_t i = 0; i < size; i++) {
+      segment->SetBucketPageId(size + i, segment->GetBucketPageId(i));
+    }
+    buffer_pool_manager_->UnpinPage(segment_page_id, true);
+  } else {
+    const uint32_t segments = directory->NumSegments();
+    for (uint32_t i = 0; i < segments; i++) {
+      page_id_t new_page_id;
+      auto *new_page = buffer_pool_manager_->NewPage(new_page_id);
+      if (new_page == nullptr)
+        ASSERT(false, "fail to new a page when grow directory");
+      page_id_t segment_page_id = directory->GetSegmentPageId(i);
+      memcpy(new_page->GetData(), buffer_pool_manager_->FetchPage(segment_page_id)->GetData(), PAGE_SIZE);
+      buffer_pool_manager_->UnpinPage(segment_page_id, false);
+      buffer_pool_manager_->UnpinPage(new_page_id, true);
+      directory->SetSegmentPageId(segments + i, new_page_id);
+    }
+  }
+  directory->IncrGlobalDepth();
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Remove a pair from the bucket of its key. An overflow page it leaves empty
+ * is unlinked and deleted, an empty bucket is merged into its split image.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  table_latch_.WLock();
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    table_latch_.WUnlock();
+    return false;
+  }
+  auto *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  auto *directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  const uint32_t slot = directory->SlotOf(Hash(key));
+  bool removed = false;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  for (page_id_t page_id = GetBucketPageId(directory, slot); page_id != INVALID_PAGE_ID && !removed;) {
+    auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    removed = bucket->Remove(key, value, comparator_);
+    const bool empty = bucket->GetSize() == 0;
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, removed);
+    if (removed && empty && prev_page_id != INVALID_PAGE_ID) {
+      auto *prev = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(prev_page_id)->GetData());
+      prev->SetNextPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    prev_page_id = page_id;
+    page_id = next_page_id;
+  }
+  if (removed) {
+    MergeBucket(directory, slot);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, removed);
+  table_latch_.WUnlock();
+  return removed;
+}
+
+/*
+ * Merge the bucket of a slot into its split image while it is empty, and the
+ * image is as deep as the bucket
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_TYPE::MergeBucket(HashTableDirectoryPage *directory, uint32_t slot) {
+  while (true) {
+    page_id_t bucket_page_id = GetBucketPageId(directory, slot);
+    auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(bucket_page_id)->GetData());
+    const uint32_t local_depth = bucket->GetLocalDepth();
+    const bool empty = bucket->GetSize() == 0 && bucket->GetNextPageId() == INVALID_PAGE_ID;
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    if (local_depth == 0 || !empty)
+      return;
+    const uint32_t stride = 1u << (local_depth - 1);
+    const uint32_t image_slot = slot ^ stride;
+    page_id_t image_page_id = GetBucketPageId(directory, image_slot);
+    auto *image = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(image_page_id)->GetData());
+    if (image->GetLocalDepth() != local_depth) {
+      buffer_pool_manager_->UnpinPage(image_page_id, false);
+      return;
+    }
+    image->SetLocalDepth(local_depth - 1);
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    for (uint32_t i = slot & (stride - 1); i < directory->Size(); i += stride) {
+      SetBucketPageId(directory, i, image_page_id);
+    }
+    buffer_pool_manager_->DeletePage(bucket_page_id);
+    slot = image_slot;
+  }
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t HASH_TABLE_TYPE::GetGlobalDepth() {
+  table_latch_.RLock();
+  uint32_t global_depth = 0;
+  if (directory_page_id_ != INVALID_PAGE_ID) {
+    auto *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+    global_depth = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData())->GetGlobalDepth();
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  }
+  table_latch_.RUnlock();
+  return global_depth;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_TYPE::Check() {
+  bool all_unpinned = buffer_pool_manager_->CheckAllUnpinned();
+  if (!all_unpinned) {
+    LOG(ERROR) << "problem in page unpin" << std::endl;
+  }
+  return all_unpinned;
+}
+
+/*
+ * Release the buckets, with their overflow pages, the segments and the
+ * directory, and forget the directory in the index roots page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_TYPE::Destroy() {
+  table_latch_.WLock();
+  if (directory_page_id_ != INVALID_PAGE_ID) {
+    auto *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+    auto *directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+    std::unordered_set<page_id_t> buckets;
+    for (uint32_t slot = 0; slot < directory->Size(); slot++) {
+      buckets.insert(GetBucketPageId(directory, slot));
+    }
+    for (page_id_t page_id : buckets) {
+      while (page_id != INVALID_PAGE_ID) {
+        auto *bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+        page_id_t next_page_id = bucket->GetNextPageId();
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        buffer_pool_manager_->DeletePage(page_id);
+        page_id = next_page_id;
+      }
+    }
+    for (uint32_t i = 0; i < directory->NumSegments(); i++) {
+      buffer_pool_manager_->DeletePage(directory->GetSegmentPageId(i));
+    }
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    buffer_pool_manager_->DeletePage(directory_page_id_);
+    directory_page_id_ = INVALID_PAGE_ID;
+  }
+  auto *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  if (page == nullptr)
+    ASSERT(false, "fail to fetch page");
+  page->WLatch();
+  reinterpret_cast<IndexRootsPage *>(page->GetData())->Delete(index_id_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  table_latch_.WUnlock();
+}
+
+/*
+ * Update/Insert the directory page id in index roots page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_TYPE::UpdateRootPageId(int insert_record) {
+  auto *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  if (page == nullptr)
+    ASSERT(false, "fail to fetch page");
+  // the roots page is shared by all indexes
+  page->WLatch();
+  auto *roots_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
+  if (insert_record) {
+    if (!roots_page->Insert(index_id_, directory_page_id_))
+      roots_page->Update(index_id_, directory_page_id_);
+  } else {
+    if (!roots_page->Update(index_id_, directory_page_id_))
+      roots_page->Insert(index_id_, directory_page_id_);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+}
+
+template
+class ExtendibleHashTable<int, int, BasicComparator<int>>;
+
+template
+class ExtendibleHashTable<GenericKey<4>, RowId, GenericComparator<4>>;
+
+template
+class ExtendibleHashTable<GenericKey<8>, RowId, GenericComparator<8>>;
+
+template
+class ExtendibleHashTable<GenericKey<16>, RowId, GenericComparator<16>>;
+
+template
+class ExtendibleHashTable<GenericKey<32>, RowId, GenericComparator<32>>;
+
+template
+class ExtendibleHashTable<GenericKey<64>, RowId, GenericComparator<64>>;
@@ -1,4 +1,7 @@
+#include <thread>
+
 #include "index/basic_comparator.h"
+#include "index/b_plus_tree.h"
 #include "index/generic_key.h"
 #include "index/index_iterator.h"
 
@@ -6,12 +9,35 @@ INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator() {
 
 }
 
-INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(B_PLUS_TREE_LEAF_PAGE_TYPE* leaf_, int index_, BufferPoolManager* buffer_pool_manager_)
-  :index(index_), leaf(leaf_), buffer_pool_manager(buffer_pool_manager_){}
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(BPLUSTREE_TYPE *tree_, Page *page_, int index_,
+                                                           BufferPoolManager* buffer_pool_manager_)
+  :index(index_), page(page_), tree(tree_), buffer_pool_manager(buffer_pool_manager_){
+  if(page != nullptr){
+    leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
+    // a key beyond the last one of its leaf starts at the next leaf
+    SkipToEntry();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+  :index(other.index), leaf(other.leaf), page(other.page), tree(other.tree),
+   buffer_pool_manager(other.buffer_pool_manager), read_ahead(std::move(other.read_ahead)){
+  other.leaf = nullptr;
+  other.page = nullptr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(IndexIterator other) {
+  std::swap(index, other.index);
+  std::swap(leaf, other.leaf);
+  std::swap(page, other.page);
+  std::swap(tree, other.tree);
+  std::swap(buffer_pool_manager, other.buffer_pool_manager);
+  std::swap(read_ahead, other.read_ahead);
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::~IndexIterator() {
-  if(leaf != nullptr)
-    buffer_pool_manager->UnpinPage(leaf->GetPageId(), false);
+  Release();
 }
 
 INDEX_TEMPLATE_ARGUMENTS const MappingType &INDEXITERATOR_TYPE::operator*() {
@@ -20,18 +46,61 @@ INDEX_TEMPLATE_ARGUMENTS const MappingType &INDEXITERATOR_TYPE::operator*() {
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
   index++;
-  if(index >= leaf->GetSize()){
-    page_id_t next_page_id = leaf->GetNextPageId();
+  SkipToEntry();
+  return *this;
+}
 
-    if(next_page_id == INVALID_PAGE_ID)
-      leaf = nullptr;
-    else{
-      Page* page = buffer_pool_manager->FetchPage(next_page_id);
+INDEX_TEMPLATE_ARGUMENTS void INDEXITERATOR_TYPE::SkipToEntry() {
+  if(index < leaf->GetSize())
+    return;
+  // the entries up to key were read, the leaf is never empty unless the tree is
+  bool has_key = leaf->GetSize() > 0;
+  KeyType key;
+  if(has_key)
+    key = leaf->KeyAt(leaf->GetSize() - 1);
+  while(leaf != nullptr && index >= leaf->GetSize()){
+    page_id_t next_page_id = leaf->GetNextPageId();
+    if(next_page_id == INVALID_PAGE_ID || !has_key){
+      Release();
+      return;
+    }
+    // short range scans stay within a leaf, so read-ahead starts at the first move to the next leaf
+    if(read_ahead == nullptr){
+      read_ahead = std::make_shared<ScanReadAhead>(buffer_pool_manager, [](Page *page) {
+        return reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData())->GetNextPageId();
+      });
+    }
+    read_ahead->Advance(next_page_id);
+    // the next leaf stays the one after the current leaf as long as the current leaf is latched
+    Page* next_page = buffer_pool_manager->FetchPage(next_page_id);
+    if(next_page->TryRLatch()){
+      Release();
+      page = next_page;
       leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
       index = 0;
+      continue;
     }
+    // a writer holds the next leaf and may wait for the current one, whose entries may then move
+    buffer_pool_manager->UnpinPage(next_page_id, false);
+    Release();
+    std::this_thread::yield();
+    page = tree->FindLeafPageRead(key, false);
+    if(page == nullptr)
+      return;
+    leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
+    index = leaf->KeyIndex(key, tree->comparator_);
+    if(index < leaf->GetSize() && tree->comparator_(leaf->KeyAt(index), key) == 0)
+      index++;
   }
-  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS void INDEXITERATOR_TYPE::Release() {
+  if(page == nullptr)
+    return;
+  page->RUnlatch();
+  buffer_pool_manager->UnpinPage(page->GetPageId(), false);
+  page = nullptr;
+  leaf = nullptr;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
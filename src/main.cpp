@@ -40,6 +40,8 @@ int main(int argc, char **argv) {
   // for print syntax tree
   TreeFileManagers syntax_tree_file_mgr("syntax_tree_");
   [[maybe_unused]] uint32_t syntax_tree_id = 0;
+  // lives across statements, for the transaction begun by BEGIN
+  ExecuteContext context;
 
   while (1) {
     // read from buffer
@@ -70,7 +72,6 @@ int main(int argc, char **argv) {
 #endif
     }
 
-    ExecuteContext context;
     clock_t begin, end;
     begin = clock();
     engine.Execute(MinisqlGetParserRootNode(), &context);
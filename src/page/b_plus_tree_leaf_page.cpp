@@ -1,6 +1,7 @@
 #include <algorithm>
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/key_search.h"
 #include "page/b_plus_tree_leaf_page.h"
 
 /*****************************************************************************
@@ -37,15 +38,11 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
 
 /**
  * Helper method to find the first index i so that array_[i].first >= key
- * NOTE: This method is only used when generating index iterator
+ * Used by Insert, Lookup and RemoveAndDeleteRecord, see index/key_search.h
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
-  for(int i = 0; i < GetSize(); i++){
-    if(comparator(array_[i].first, key) >= 0)
-      return i;
-  }
-  return GetSize();
+  return KeySearch<KeyType, KeyComparator>::LowerBound(array_, GetSize(), key, comparator);
 }
 
 /*
@@ -120,16 +117,11 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const {
-  if(comparator(key, KeyAt(0))<0 || comparator(key, KeyAt(GetSize()-1)) > 0){
+  int index = KeyIndex(key, comparator);
+  if(index == GetSize() || comparator(array_[index].first, key) != 0)
     return false;
-  }
-  for(int i = 0; i < GetSize(); i++){
-    if(comparator(key, array_[i].first) == 0){
-      value = array_[i].second;
-      return true;
-    }
-  }
-  return false;
+  value = array_[index].second;
+  return true;
 }
 
 /*****************************************************************************
@@ -144,7 +136,7 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, co
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
   int index = KeyIndex(key, comparator);
-  if(index == GetSize())
+  if(index == GetSize() || comparator(array_[index].first, key) != 0)
     return GetSize();
   for(int i = index; i < GetSize()-1; i++)
     array_[i] = array_[i+1];
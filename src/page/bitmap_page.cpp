@@ -11,6 +11,10 @@ bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
       next_free_page_ = MAX_CHARS*8;
       return true;
     }
+    // pages before next_free_page_ are all allocated, so full bytes are skipped at once
+    while(bytes[next_free_page_/8] == 0xFF){
+      next_free_page_ = (next_free_page_/8 + 1)*8;
+    }
     while(!IsPageFree(next_free_page_)){
       next_free_page_++;
     }
@@ -18,6 +22,52 @@ bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
   }
 }
 
+template<size_t PageSize>
+bool BitmapPage<PageSize>::AllocatePages(uint32_t num_pages, uint32_t &page_offset) {
+  if(num_pages == 0 || page_allocated_ + num_pages > MAX_CHARS*8) return false;
+  uint32_t run = 0;
+  for(uint32_t i = next_free_page_; i < MAX_CHARS*8; i++){
+    if(run == 0 && i%8 == 0 && bytes[i/8] == 0xFF){
+      i += 7;
+      continue;
+    }
+    if(!IsPageFree(i)){
+      run = 0;
+      continue;
+    }
+    if(++run < num_pages) continue;
+    page_offset = i + 1 - num_pages;
+    for(uint32_t j = page_offset; j <= i; j++){
+      bytes[j/8] |= 0x01<<(j%8);
+    }
+    page_allocated_ += num_pages;
+    if(page_allocated_ == MAX_CHARS*8){
+      next_free_page_ = MAX_CHARS*8;
+      return true;
+    }
+    while(!IsPageFree(next_free_page_)){
+      next_free_page_++;
+    }
+    return true;
+  }
+  return false;
+}
+
+template<size_t PageSize>
+bool BitmapPage<PageSize>::AllocatePageAt(uint32_t page_offset) {
+  if(!IsPageFree(page_offset)) return false;
+  bytes[page_offset/8] |= 0x01<<(page_offset%8);
+  page_allocated_++;
+  if(page_allocated_ == MAX_CHARS*8){
+    next_free_page_ = MAX_CHARS*8;
+    return true;
+  }
+  while(!IsPageFree(next_free_page_)){
+    next_free_page_++;
+  }
+  return true;
+}
+
 template<size_t PageSize>
 bool BitmapPage<PageSize>::DeAllocatePage(uint32_t page_offset) {
   if(IsPageFree((page_offset))) return false;
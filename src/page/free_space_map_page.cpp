@@ -0,0 +1,43 @@
+#include "page/free_space_map_page.h"
+
+bool FreeSpaceMapPage::Append(page_id_t table_page_id, uint8_t category, uint32_t &slot) {
+  if (IsFull()) {
+    return false;
+  }
+  slot = entry_count_++;
+  table_page_ids_[slot] = table_page_id;
+  SetCategory(slot, category);
+  return true;
+}
+
+page_id_t FreeSpaceMapPage::GetTablePageId(uint32_t slot) const {
+  ASSERT(slot < entry_count_, "Slot out of range.");
+  return table_page_ids_[slot];
+}
+
+uint8_t FreeSpaceMapPage::GetCategory(uint32_t slot) const {
+  ASSERT(slot < entry_count_, "Slot out of range.");
+  uint8_t byte = categories_[slot / 2];
+  return (slot % 2 == 0) ? (byte & 0x0f) : (byte >> 4);
+}
+
+void FreeSpaceMapPage::SetCategory(uint32_t slot, uint8_t category) {
+  ASSERT(slot < entry_count_, "Slot out of range.");
+  ASSERT(category <= MAX_CATEGORY, "Invalid category.");
+  uint8_t &byte = categories_[slot / 2];
+  if (slot % 2 == 0) {
+    byte = (byte & 0xf0) | category;
+  } else {
+    byte = (byte & 0x0f) | (category << 4);
+  }
+}
+
+uint8_t FreeSpaceMapPage::ToCategory(uint32_t free_space) {
+  uint32_t category = free_space / CATEGORY_UNIT;
+  return category > MAX_CATEGORY ? MAX_CATEGORY : static_cast<uint8_t>(category);
+}
+
+uint8_t FreeSpaceMapPage::RequiredCategory(uint32_t size) {
+  uint32_t category = (size + CATEGORY_UNIT - 1) / CATEGORY_UNIT;
+  return category > MAX_CATEGORY ? MAX_CATEGORY + 1 : static_cast<uint8_t>(category);
+}
@@ -0,0 +1,94 @@
+#include "page/hash_table_bucket_page.h"
+
+#include <cstring>
+
+#include "index/basic_comparator.h"
+#include "index/generic_key.h"
+
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_BUCKET_TYPE::Init(page_id_t page_id, uint32_t local_depth) {
+  page_id_ = page_id;
+  local_depth_ = local_depth;
+  size_ = 0;
+  next_page_id_ = INVALID_PAGE_ID;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int HASH_TABLE_BUCKET_TYPE::LowerBound(const KeyType &key, const KeyComparator &comparator) const {
+  int lo = 0, hi = size_;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (comparator(array_[mid].first, key) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_BUCKET_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
+  ASSERT(!IsFull(), "insert into a full bucket");
+  int index = LowerBound(key, comparator);
+  while (index < size_ && comparator(array_[index].first, key) == 0) {
+    index++;
+  }
+  memmove(static_cast<void *>(array_ + index + 1), static_cast<void *>(array_ + index),
+          (size_ - index) * sizeof(MappingType));
+  array_[index] = {key, value};
+  size_++;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_BUCKET_TYPE::GetValue(const KeyType &key, const KeyComparator &comparator,
+                                      std::vector<ValueType> &result) const {
+  bool found = false;
+  for (int i = LowerBound(key, comparator); i < size_ && comparator(array_[i].first, key) == 0; i++) {
+    result.push_back(array_[i].second);
+    found = true;
+  }
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_BUCKET_TYPE::Contains(const KeyType &key, const ValueType &value, bool match_value,
+                                      const KeyComparator &comparator) const {
+  for (int i = LowerBound(key, comparator); i < size_ && comparator(array_[i].first, key) == 0; i++) {
+    if (!match_value || array_[i].second == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_BUCKET_TYPE::Remove(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
+  for (int i = LowerBound(key, comparator); i < size_ && comparator(array_[i].first, key) == 0; i++) {
+    if (array_[i].second == value) {
+      memmove(static_cast<void *>(array_ + i), static_cast<void *>(array_ + i + 1),
+              (size_ - i - 1) * sizeof(MappingType));
+      size_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+template
+class HashTableBucketPage<int, int, BasicComparator<int>>;
+
+template
+class HashTableBucketPage<GenericKey<4>, RowId, GenericComparator<4>>;
+
+template
+class HashTableBucketPage<GenericKey<8>, RowId, GenericComparator<8>>;
+
+template
+class HashTableBucketPage<GenericKey<16>, RowId, GenericComparator<16>>;
+
+template
+class HashTableBucketPage<GenericKey<32>, RowId, GenericComparator<32>>;
+
+template
+class HashTableBucketPage<GenericKey<64>, RowId, GenericComparator<64>>;
@@ -0,0 +1,26 @@
+#include "page/hash_table_directory_page.h"
+
+#include "common/macros.h"
+
+void HashTableDirectoryPage::Init(page_id_t page_id, page_id_t segment_page_id) {
+  page_id_ = page_id;
+  global_depth_ = 0;
+  segments_[0] = segment_page_id;
+}
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  ASSERT(global_depth_ < DIRECTORY_MAX_DEPTH, "hash table directory is full");
+  global_depth_++;
+}
+
+uint32_t HashTableDirectoryPage::NumSegments() const {
+  return Size() <= DIRECTORY_SEGMENT_SIZE ? 1 : Size() / DIRECTORY_SEGMENT_SIZE;
+}
+
+page_id_t HashTableDirectoryPage::GetSegmentPageId(uint32_t segment) const {
+  return segments_[segment];
+}
+
+void HashTableDirectoryPage::SetSegmentPageId(uint32_t segment, page_id_t segment_page_id) {
+  segments_[segment] = segment_page_id;
+}
@@ -1,18 +1,60 @@
 #include "page/table_page.h"
 
+#include <vector>
+
+// changes made outside of a transaction are logged without a transaction id
+static inline txn_id_t TxnId(Transaction *txn) {
+  return txn == nullptr ? INVALID_TXN_ID : txn->GetTransactionId();
+}
+
+static inline lsn_t PrevLSN(Transaction *txn) {
+  return txn == nullptr ? INVALID_LSN : txn->GetPrevLSN();
+}
+
 void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Transaction *txn) {
   memcpy(GetData(), &page_id, sizeof(page_id));
   SetPrevPageId(prev_id);
   SetNextPageId(INVALID_PAGE_ID);
   SetFreeSpacePointer(PAGE_SIZE);
   SetTupleCount(0);
+  if (log_mgr != nullptr) {
+    LogRecord log_record(TxnId(txn), PrevLSN(txn), prev_id, page_id);
+    AppendLog(log_record, txn, log_mgr);
+  }
 }
 
 bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn,
                             LockManager *lock_manager, LogManager *log_manager) {
   uint32_t serialized_size = row.GetSerializedSize(schema);
   ASSERT(serialized_size > 0, "Can not have empty row.");
-  if (GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
+  uint32_t slot_num;
+  if (!ReserveTuple(serialized_size, &slot_num)) {
+    return false;
+  }
+  uint32_t __attribute__((unused)) write_bytes = row.SerializeTo(GetData() + GetFreeSpacePointer(), schema);
+  ASSERT(write_bytes == serialized_size, "Unexpected behavior in row serialize.");
+  // Set rid
+  row.SetRowId(RowId(GetTablePageId(), slot_num));
+  if (log_manager != nullptr) {
+    LogRecord log_record(TxnId(txn), PrevLSN(txn), LogRecordType::kInsert, row.GetRowId(),
+                         GetData() + GetFreeSpacePointer(), serialized_size);
+    AppendLog(log_record, txn, log_manager);
+  }
+  return true;
+}
+
+bool TablePage::InsertTuple(const char *tuple, uint32_t tuple_size, RowId *rid) {
+  uint32_t slot_num;
+  if (!ReserveTuple(tuple_size, &slot_num)) {
+    return false;
+  }
+  memcpy(GetData() + GetFreeSpacePointer(), tuple, tuple_size);
+  rid->Set(GetTablePageId(), slot_num);
+  return true;
+}
+
+bool TablePage::ReserveTuple(uint32_t tuple_size, uint32_t *slot_num) {
+  if (GetFreeSpaceRemaining() < tuple_size + SIZE_TUPLE) {
     return false;
   }
   // Try to find a free slot to reuse.
@@ -24,22 +66,15 @@ bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn,
       break;
     }
   }
-  if (i == GetTupleCount() && GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
-    return false;
-  }
   // Otherwise we claim available free space..
-  SetFreeSpacePointer(GetFreeSpacePointer() - serialized_size);
-  uint32_t __attribute__((unused)) write_bytes = row.SerializeTo(GetData() + GetFreeSpacePointer(), schema);
-  ASSERT(write_bytes == serialized_size, "Unexpected behavior in row serialize.");
-
+  SetFreeSpacePointer(GetFreeSpacePointer() - tuple_size);
   // Set the tuple.
   SetTupleOffsetAtSlot(i, GetFreeSpacePointer());
-  SetTupleSize(i, serialized_size);
-  // Set rid
-  row.SetRowId(RowId(GetTablePageId(), i));
+  SetTupleSize(i, tuple_size);
   if (i == GetTupleCount()) {
     SetTupleCount(GetTupleCount() + 1);
   }
+  *slot_num = i;
   return true;
 }
 
@@ -54,6 +89,11 @@ bool TablePage::MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock
   if (IsDeleted(tuple_size)) {
     return false;
   }
+  if (log_manager != nullptr) {
+    LogRecord log_record(TxnId(txn), PrevLSN(txn), LogRecordType::kMarkDelete, rid,
+                         GetData() + GetTupleOffsetAtSlot(slot_num), tuple_size);
+    AppendLog(log_record, txn, log_manager);
+  }
   // Mark the tuple as deleted.
   if (tuple_size > 0) {
     SetTupleSize(slot_num, SetDeletedFlag(tuple_size));
@@ -84,22 +124,52 @@ bool TablePage::UpdateTuple(const Row &new_row, Row *old_row, Schema *schema,
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(GetData() + tuple_offset, schema);
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
+  // the old tuple is overwritten below
+  std::vector<char> old_tuple;
+  if (log_manager != nullptr) {
+    old_tuple.assign(GetData() + tuple_offset, GetData() + tuple_offset + tuple_size);
+  }
+  char *new_tuple = ResizeTuple(slot_num, serialized_size);
+  new_row.SerializeTo(new_tuple, schema);
+  if (log_manager != nullptr) {
+    LogRecord log_record(TxnId(txn), PrevLSN(txn), old_row->GetRowId(), old_tuple.data(), tuple_size,
+                         new_tuple, serialized_size);
+    AppendLog(log_record, txn, log_manager);
+  }
+  return true;
+}
+
+bool TablePage::UpdateTuple(const RowId &rid, const char *tuple, uint32_t tuple_size) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t old_tuple_size = GetTupleSize(slot_num);
+  if (IsDeleted(old_tuple_size) || GetFreeSpaceRemaining() + old_tuple_size < tuple_size) {
+    return false;
+  }
+  memcpy(ResizeTuple(slot_num, tuple_size), tuple, tuple_size);
+  return true;
+}
+
+char *TablePage::ResizeTuple(uint32_t slot_num, uint32_t tuple_size) {
+  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
+  uint32_t old_tuple_size = GetTupleSize(slot_num);
   uint32_t free_space_pointer = GetFreeSpacePointer();
   ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
-  memmove(GetData() + free_space_pointer + tuple_size - serialized_size, GetData() + free_space_pointer,
+  memmove(GetData() + free_space_pointer + old_tuple_size - tuple_size, GetData() + free_space_pointer,
           tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size - serialized_size);
-  new_row.SerializeTo(GetData() + tuple_offset + tuple_size - serialized_size, schema);
-  SetTupleSize(slot_num, serialized_size);
+  SetFreeSpacePointer(free_space_pointer + old_tuple_size - tuple_size);
+  SetTupleSize(slot_num, tuple_size);
 
   // Update all tuple offsets.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
     uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_row.GetSerializedSize(schema));
+    if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + old_tuple_size) {
+      SetTupleOffsetAtSlot(i, tuple_offset_i + old_tuple_size - tuple_size);
     }
   }
-  return true;
+  return GetData() + tuple_offset + old_tuple_size - tuple_size;
 }
 
 void TablePage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
@@ -113,6 +183,12 @@ void TablePage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_
     tuple_size = UnsetDeletedFlag(tuple_size);
   }
 
+  if (log_manager != nullptr) {
+    LogRecord log_record(TxnId(txn), PrevLSN(txn), LogRecordType::kApplyDelete, rid, GetData() + tuple_offset,
+                         tuple_size);
+    AppendLog(log_record, txn, log_manager);
+  }
+
   uint32_t free_space_pointer = GetFreeSpacePointer();
   ASSERT(tuple_offset >= free_space_pointer, "Free space appears before tuples.");
 
@@ -140,9 +216,14 @@ void TablePage::RollbackDelete(const RowId &rid, Transaction *txn, LogManager *l
   if (IsDeleted(tuple_size)) {
     SetTupleSize(slot_num, UnsetDeletedFlag(tuple_size));
   }
+  if (log_manager != nullptr) {
+    LogRecord log_record(TxnId(txn), PrevLSN(txn), LogRecordType::kRollbackDelete, rid,
+                         GetData() + GetTupleOffsetAtSlot(slot_num), UnsetDeletedFlag(tuple_size));
+    AppendLog(log_record, txn, log_manager);
+  }
 }
 
-bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager) {
+bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager, bool copy_data) {
   ASSERT(row != nullptr && row->GetRowId().Get() != INVALID_ROWID.Get(), "Invalid row.");
   // Get the current slot number.
   uint32_t slot_num = row->GetRowId().GetSlotNum();
@@ -158,15 +239,53 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   }
   // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  uint32_t __attribute__((unused)) read_bytes = row->DeserializeFrom(GetData() + tuple_offset, schema);
+  uint32_t __attribute__((unused)) read_bytes = row->DeserializeFrom(GetData() + tuple_offset, schema, copy_data);
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
   return true;
 }
 
-bool TablePage::GetFirstTupleRid(RowId *first_rid) {
+bool TablePage::GetTuple(Row *row, Schema *schema, const TupleFilter &filter, const std::vector<uint32_t> *columns,
+                         Transaction *txn, LockManager *lock_manager, bool copy_data) {
+  ASSERT(row != nullptr && row->GetRowId().Get() != INVALID_ROWID.Get(), "Invalid row.");
+  uint32_t slot_num = row->GetRowId().GetSlotNum();
+  if (slot_num >= GetTupleCount() || IsDeleted(GetTupleSize(slot_num))) {
+    return false;
+  }
+  char *tuple = GetData() + GetTupleOffsetAtSlot(slot_num);
+  if (filter != nullptr && !filter(tuple)) {
+    return false;
+  }
+  if (columns == nullptr) {
+    row->DeserializeFrom(tuple, schema, copy_data);
+  } else {
+    row->DeserializeFrom(tuple, schema, *columns, copy_data);
+  }
+  return true;
+}
+
+void TablePage::AppendLog(LogRecord &log_record, Transaction *txn, LogManager *log_manager) {
+  size_t offset;
+  lsn_t lsn = log_manager->AppendLogRecord(&log_record, &offset);
+  SetLSN(lsn);
+  if (txn != nullptr) {
+    txn->AddLogRecord(lsn, offset);
+  }
+}
+
+char *TablePage::GetTupleData(const RowId &rid, uint32_t *tuple_size, bool *deleted) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || GetTupleSize(slot_num) == 0) {
+    return nullptr;
+  }
+  *deleted = IsDeleted(GetTupleSize(slot_num));
+  *tuple_size = UnsetDeletedFlag(GetTupleSize(slot_num));
+  return GetData() + GetTupleOffsetAtSlot(slot_num);
+}
+
+bool TablePage::GetFirstTupleRid(RowId *first_rid, bool with_deleted) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
+    if (with_deleted ? GetTupleSize(i) != 0 : !IsDeleted(GetTupleSize(i))) {
       first_rid->Set(GetTablePageId(), i);
       return true;
     }
@@ -175,11 +294,11 @@ bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   return false;
 }
 
-bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
+bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid, bool with_deleted) {
   ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
   // Find and return the first valid tuple after our current slot number.
   for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
+    if (with_deleted ? GetTupleSize(i) != 0 : !IsDeleted(GetTupleSize(i))) {
       next_rid->Set(GetTablePageId(), i);
       return true;
     }
@@ -1,43 +1,113 @@
 #include "record/row.h"
 
+static inline uint32_t ReadVarOffset(const char *buf) {
+  return MACH_READ_FROM(uint16_t, buf);
+}
+
 uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
-  // replace with your code here
-    char *newbuf = buf;
-    Field *field;
-    uint32_t bytes;
-    for (auto i : fields_) {
-        field = i;
-        bytes = field->SerializeTo(newbuf);
-        newbuf += bytes;
+  ASSERT(fields_.size() == schema->GetColumnCount(), "Fields do not match the schema.");
+  uint32_t var_offset = schema->GetFixedLength();
+  memset(buf, 0, var_offset);
+  for (uint32_t i = 0; i < fields_.size(); ++i) {
+    Field *field = fields_[i];
+    char *pos = buf + schema->GetColumnOffset(i);
+    if (field->IsNull()) {
+      buf[i / 8] |= static_cast<char>(1 << (i % 8));
     }
-    return newbuf - buf;
+    if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar) {
+      if (!field->IsNull()) {
+        uint32_t len = field->GetLength();
+        memcpy(buf + var_offset, field->GetData(), len);
+        var_offset += len;
+      }
+      MACH_WRITE_TO(uint16_t, pos, static_cast<uint16_t>(var_offset));
+    } else if (!field->IsNull()) {
+      field->SerializeTo(pos);
+    }
+  }
+  return var_offset;
 }
 
+uint32_t Row::DeserializeFrom(char *buf, Schema *schema, bool copy_data) {
+  fields_.reserve(fields_.size() + schema->GetColumnCount());
+  for (uint32_t i = 0; i < schema->GetColumnCount(); ++i) {
+    fields_.push_back(DeserializeField(buf, schema, i, heap_, copy_data));
+  }
+  return GetSerializedSize(buf, schema);
+}
 
-uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
-  // replace with your code here
-    char *newbuf = buf;
-    Field *field = nullptr;
-    uint32_t bytes;
-    for (int i = 0; i < int(schema->GetColumnCount()); ++i) {
-        bytes = Field::DeserializeFrom(newbuf, schema->GetColumn(i)->GetType(), &field, false, heap_);
-        fields_.push_back(field);
-        newbuf += bytes;
-    }
-    return newbuf - buf;
+uint32_t Row::DeserializeFrom(char *buf, Schema *schema, const std::vector<uint32_t> &columns, bool copy_data) {
+  fields_.reserve(fields_.size() + columns.size());
+  for (auto column_index : columns) {
+    fields_.push_back(DeserializeField(buf, schema, column_index, heap_, copy_data));
+  }
+  return GetSerializedSize(buf, schema);
 }
 
 uint32_t Row::GetSerializedSize(Schema *schema) const {
-  // replace with your code here
-    if (fields_.empty())
-        return 0;
-    Field *field;
-    uint32_t bytes = 0;
-    for (auto i : fields_) {
-        field = i;
-        if (field == nullptr)
-            continue;
-        bytes += field->GetSerializedSize();
-    }
-    return bytes;
+  if (fields_.empty())
+    return 0;
+  uint32_t bytes = schema->GetFixedLength();
+  for (uint32_t i = 0; i < fields_.size(); ++i) {
+    if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar && !fields_[i]->IsNull())
+      bytes += fields_[i]->GetLength();
+  }
+  return bytes;
+}
+
+/**
+ * @return the data of a char field of a serialized row, which starts where the data of the char column
+ * before it ends
+ */
+static inline char *ReadCharData(char *buf, Schema *schema, uint32_t column_index, uint32_t *len) {
+  uint32_t offset = schema->GetColumnOffset(column_index);
+  uint32_t begin = offset == schema->GetVarOffsetsBegin() ? schema->GetFixedLength()
+                                                          : ReadVarOffset(buf + offset - Row::VAR_OFFSET_SIZE);
+  *len = ReadVarOffset(buf + offset) - begin;
+  return buf + begin;
+}
+
+Field Row::ReadField(char *buf, Schema *schema, uint32_t column_index) {
+  TypeId type = schema->GetColumn(column_index)->GetType();
+  if (IsFieldNull(buf, column_index)) {
+    return Field(type);
+  }
+  char *pos = buf + schema->GetColumnOffset(column_index);
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, MACH_READ_FROM(int32_t, pos));
+    case TypeId::kTypeFloat:
+      return Field(type, MACH_READ_FROM(float, pos));
+    default:
+      uint32_t len;
+      char *data = ReadCharData(buf, schema, column_index, &len);
+      return Field(type, data, len, false);
+  }
+}
+
+Field *Row::DeserializeField(char *buf, Schema *schema, uint32_t column_index, MemHeap *heap, bool copy_data) {
+  TypeId type = schema->GetColumn(column_index)->GetType();
+  bool is_null = IsFieldNull(buf, column_index);
+  if (type != TypeId::kTypeChar) {
+    Field *field = nullptr;
+    Field::DeserializeFrom(buf + schema->GetColumnOffset(column_index), type, &field, is_null, heap);
+    return field;
+  }
+  if (is_null) {
+    return ALLOC_P(heap, Field)(TypeId::kTypeChar);
+  }
+  uint32_t len;
+  char *data = ReadCharData(buf, schema, column_index, &len);
+  if (copy_data && len > 0) {
+    data = static_cast<char *>(memcpy(heap->Allocate(len), data, len));
+  }
+  return ALLOC_P(heap, Field)(TypeId::kTypeChar, data, len, false);
+}
+
+uint32_t Row::GetSerializedSize(const char *buf, Schema *schema) {
+  uint32_t fixed_length = schema->GetFixedLength();
+  if (fixed_length == schema->GetVarOffsetsBegin()) {
+    return fixed_length;
+  }
+  return ReadVarOffset(buf + fixed_length - VAR_OFFSET_SIZE);
 }
@@ -1,4 +1,24 @@
 #include "record/schema.h"
+#include "record/row.h"
+
+void Schema::InitRowLayout() {
+    column_offsets_.resize(columns_.size());
+    uint32_t offset = (GetColumnCount() + 7) / 8;
+    for (uint32_t i = 0; i < columns_.size(); i++) {
+        if (columns_[i]->GetType() != TypeId::kTypeChar) {
+            column_offsets_[i] = offset;
+            offset += Type::GetTypeSize(columns_[i]->GetType());
+        }
+    }
+    var_offsets_begin_ = offset;
+    for (uint32_t i = 0; i < columns_.size(); i++) {
+        if (columns_[i]->GetType() == TypeId::kTypeChar) {
+            column_offsets_[i] = offset;
+            offset += Row::VAR_OFFSET_SIZE;
+        }
+    }
+    fixed_length_ = offset;
+}
 
 uint32_t Schema::SerializeTo(char *buf) const {
   // replace with your code here
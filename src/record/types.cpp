@@ -1,3 +1,5 @@
+#include <string>
+
 #include "common/macros.h"
 #include "record/types.h"
 #include "record/field.h"
@@ -14,6 +16,22 @@ inline int CompareStrings(const char *str1, int len1, const char *str2, int len2
   return ret;
 }
 
+// write in big endian so that unsigned values compare the same as their bytes
+inline void WriteKeyUint32(char *buf, uint32_t val) {
+  for (int i = 3; i >= 0; i--) {
+    buf[i] = static_cast<char>(val & 0xff);
+    val >>= 8;
+  }
+}
+
+inline uint32_t ReadKeyUint32(const char *buf) {
+  uint32_t val = 0;
+  for (int i = 0; i < 4; i++) {
+    val = (val << 8) | static_cast<uint8_t>(buf[i]);
+  }
+  return val;
+}
+
 // ==============================Type=============================
 
 Type *Type::type_singletons_[] = {
@@ -28,7 +46,8 @@ uint32_t Type::SerializeTo(const Field &field, char *buf) const {
   return 0;
 }
 
-uint32_t Type::DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap) const {
+uint32_t Type::DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap,
+                               bool copy_data) const {
   ASSERT(false, "DeserializeFrom not implemented.");
   return 0;
 }
@@ -38,6 +57,21 @@ uint32_t Type::GetSerializedSize(const Field &field, bool is_null) const {
   return 0;
 }
 
+uint32_t Type::SerializeToKey(const Field &field, char *buf) const {
+  ASSERT(false, "SerializeToKey not implemented.");
+  return 0;
+}
+
+uint32_t Type::DeserializeFromKey(const char *storage, Field **field, MemHeap *heap) const {
+  ASSERT(false, "DeserializeFromKey not implemented.");
+  return 0;
+}
+
+uint32_t Type::GetKeySerializedSize(const Field &field) const {
+  ASSERT(false, "GetKeySerializedSize not implemented.");
+  return 0;
+}
+
 const char *Type::GetData(const Field &val) const {
   ASSERT(false, "GetData not implemented.");
   return nullptr;
@@ -88,7 +122,8 @@ uint32_t TypeInt::SerializeTo(const Field &field, char *buf) const {
   return 0;
 }
 
-uint32_t TypeInt::DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap) const {
+uint32_t TypeInt::DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap,
+                                  bool copy_data) const {
   if (is_null) {
     *field = ALLOC_P(heap, Field)(TypeId::kTypeInt);
     return 0;
@@ -105,6 +140,31 @@ uint32_t TypeInt::GetSerializedSize(const Field &field, bool is_null) const {
   return GetTypeSize(type_id_);
 }
 
+// flip the sign bit so that negative values are ordered before positive ones
+uint32_t TypeInt::SerializeToKey(const Field &field, char *buf) const {
+  if (field.IsNull()) {
+    buf[0] = KEY_NULL;
+    return 1;
+  }
+  buf[0] = KEY_NOT_NULL;
+  WriteKeyUint32(buf + 1, static_cast<uint32_t>(field.value_.integer_) ^ 0x80000000u);
+  return 1 + GetTypeSize(type_id_);
+}
+
+uint32_t TypeInt::DeserializeFromKey(const char *storage, Field **field, MemHeap *heap) const {
+  if (storage[0] == KEY_NULL) {
+    *field = ALLOC_P(heap, Field)(TypeId::kTypeInt);
+    return 1;
+  }
+  int32_t val = static_cast<int32_t>(ReadKeyUint32(storage + 1) ^ 0x80000000u);
+  *field = ALLOC_P(heap, Field)(TypeId::kTypeInt, val);
+  return 1 + GetTypeSize(type_id_);
+}
+
+uint32_t TypeInt::GetKeySerializedSize(const Field &field) const {
+  return field.IsNull() ? 1 : 1 + GetTypeSize(type_id_);
+}
+
 CmpBool TypeInt::CompareEquals(const Field &left, const Field &right) const {
   ASSERT(left.CheckComparable(right), "Not comparable.");
   if (left.IsNull() || right.IsNull()) {
@@ -163,7 +223,8 @@ uint32_t TypeFloat::SerializeTo(const Field &field, char *buf) const {
   return 0;
 }
 
-uint32_t TypeFloat::DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap) const {
+uint32_t TypeFloat::DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap,
+                                    bool copy_data) const {
   if (is_null) {
     *field = ALLOC_P(heap, Field)(TypeId::kTypeFloat);
     return 0;
@@ -180,6 +241,40 @@ uint32_t TypeFloat::GetSerializedSize(const Field &field, bool is_null) const {
   return GetTypeSize(type_id_);
 }
 
+// positive values get the sign bit set and negative values get all bits flipped,
+// the bits of an IEEE 754 float then compare the same as the float itself
+uint32_t TypeFloat::SerializeToKey(const Field &field, char *buf) const {
+  if (field.IsNull()) {
+    buf[0] = KEY_NULL;
+    return 1;
+  }
+  buf[0] = KEY_NOT_NULL;
+  // -0.0 and 0.0 are equal and must be encoded the same
+  float_t val = field.value_.float_ == 0 ? 0 : field.value_.float_;
+  uint32_t bits;
+  memcpy(&bits, &val, sizeof(uint32_t));
+  bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  WriteKeyUint32(buf + 1, bits);
+  return 1 + GetTypeSize(type_id_);
+}
+
+uint32_t TypeFloat::DeserializeFromKey(const char *storage, Field **field, MemHeap *heap) const {
+  if (storage[0] == KEY_NULL) {
+    *field = ALLOC_P(heap, Field)(TypeId::kTypeFloat);
+    return 1;
+  }
+  uint32_t bits = ReadKeyUint32(storage + 1);
+  bits = (bits & 0x80000000u) ? (bits & ~0x80000000u) : ~bits;
+  float_t val;
+  memcpy(&val, &bits, sizeof(uint32_t));
+  *field = ALLOC_P(heap, Field)(TypeId::kTypeFloat, val);
+  return 1 + GetTypeSize(type_id_);
+}
+
+uint32_t TypeFloat::GetKeySerializedSize(const Field &field) const {
+  return field.IsNull() ? 1 : 1 + GetTypeSize(type_id_);
+}
+
 CmpBool TypeFloat::CompareEquals(const Field &left, const Field &right) const {
   ASSERT(left.CheckComparable(right), "Not comparable.");
   if (left.IsNull() || right.IsNull()) {
@@ -239,13 +334,19 @@ uint32_t TypeChar::SerializeTo(const Field &field, char *buf) const {
   return 0;
 }
 
-uint32_t TypeChar::DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap) const {
+uint32_t TypeChar::DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap,
+                                   bool copy_data) const {
   if (is_null) {
     *field = ALLOC_P(heap, Field)(TypeId::kTypeChar);
     return 0;
   }
   uint32_t len = MACH_READ_UINT32(storage);
-  *field = ALLOC_P(heap, Field)(TypeId::kTypeChar, storage + sizeof(uint32_t), len, true);
+  // the data lives as long as the heap of the field, so that the field does not allocate it on its own
+  char *data = storage + sizeof(uint32_t);
+  if (copy_data && len > 0) {
+    data = static_cast<char *>(memcpy(heap->Allocate(len), data, len));
+  }
+  *field = ALLOC_P(heap, Field)(TypeId::kTypeChar, data, len, false);
   return len + sizeof(uint32_t);
 }
 
@@ -257,6 +358,56 @@ uint32_t TypeChar::GetSerializedSize(const Field &field, bool is_null) const {
   return len + sizeof(uint32_t);
 }
 
+// every 0x00 byte is escaped as 0x00 0xff and the string is terminated by 0x00 0x00,
+// so a string is ordered before all strings it is a prefix of
+uint32_t TypeChar::SerializeToKey(const Field &field, char *buf) const {
+  if (field.IsNull()) {
+    buf[0] = KEY_NULL;
+    return 1;
+  }
+  char *newbuf = buf;
+  *newbuf++ = KEY_NOT_NULL;
+  const char *data = field.value_.chars_;
+  for (uint32_t i = 0; i < field.len_; i++) {
+    *newbuf++ = data[i];
+    if (data[i] == 0x00) {
+      *newbuf++ = static_cast<char>(0xff);
+    }
+  }
+  *newbuf++ = 0x00;
+  *newbuf++ = 0x00;
+  return newbuf - buf;
+}
+
+uint32_t TypeChar::DeserializeFromKey(const char *storage, Field **field, MemHeap *heap) const {
+  if (storage[0] == KEY_NULL) {
+    *field = ALLOC_P(heap, Field)(TypeId::kTypeChar);
+    return 1;
+  }
+  std::string data;
+  const char *pos = storage + 1;
+  while (pos[0] != 0x00 || pos[1] != 0x00) {
+    data.push_back(pos[0]);
+    pos += (pos[0] == 0x00) ? 2 : 1;
+  }
+  pos += 2;
+  *field = ALLOC_P(heap, Field)(TypeId::kTypeChar, data.data(), data.size(), true);
+  return pos - storage;
+}
+
+uint32_t TypeChar::GetKeySerializedSize(const Field &field) const {
+  if (field.IsNull()) {
+    return 1;
+  }
+  uint32_t size = 1 + field.len_ + 2;
+  for (uint32_t i = 0; i < field.len_; i++) {
+    if (field.value_.chars_[i] == 0x00) {
+      size++;
+    }
+  }
+  return size;
+}
+
 const char *TypeChar::GetData(const Field &val) const {
   return val.value_.chars_;
 }
@@ -0,0 +1,343 @@
+#include "storage/async_io.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <thread>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "glog/logging.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define MINISQL_HAS_IO_URING
+#endif
+
+bool AsyncIOHandle::Wait() {
+  std::unique_lock<std::mutex> lock(latch_);
+  cv_.wait(lock, [this]() { return pending_ == 0; });
+  return success_;
+}
+
+bool AsyncIOHandle::IsDone() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return pending_ == 0;
+}
+
+void AsyncIOHandle::AddPending() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  pending_++;
+}
+
+void AsyncIOHandle::Complete(bool success) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  success_ = success_ && success;
+  if (--pending_ == 0) {
+    cv_.notify_all();
+  }
+}
+
+void AsyncIOEngine::FinishOp(AsyncIOOp &op, long result) {
+  bool success = result >= 0;
+  if (!success) {
+    LOG(ERROR) << "I/O error while " << (op.is_write ? "writing: " : "reading: ") << strerror(-result);
+  } else if (static_cast<size_t>(result) < op.size) {
+    if (op.is_write) {
+      // regular files only write short on errors such as a full disk, retry the rest synchronously
+      size_t written = result;
+      while (success && written < op.size) {
+        ssize_t count = pwrite(op.fd, op.data + written, op.size - written, op.offset + written);
+        success = count > 0;
+        written += success ? count : 0;
+      }
+      if (!success) {
+        LOG(ERROR) << "I/O error while writing";
+      }
+    } else {
+      // the file ends before the page
+      memset(op.data + result, 0, op.size - result);
+    }
+  }
+  op.handle->Complete(success);
+}
+
+/**
+ * Runs blocking pread/pwrite calls on a fixed set of worker threads.
+ */
+class ThreadPoolAsyncIOEngine : public AsyncIOEngine {
+public:
+  explicit ThreadPoolAsyncIOEngine(size_t num_workers) {
+    for (size_t i = 0; i < num_workers; i++) {
+      workers_.emplace_back(&ThreadPoolAsyncIOEngine::RunWorker, this);
+    }
+  }
+
+  ~ThreadPoolAsyncIOEngine() override {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void Submit(std::vector<AsyncIOOp> &ops) override {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      for (auto &op : ops) {
+        queue_.push_back(op);
+      }
+    }
+    cv_.notify_all();
+  }
+
+  AsyncIOEngineType GetType() const override { return AsyncIOEngineType::kThreadPool; }
+
+private:
+  void RunWorker() {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (true) {
+      // the queue is drained before stopping, so no handle is left pending
+      cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      AsyncIOOp op = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+      ssize_t result = op.is_write ? pwrite(op.fd, op.data, op.size, op.offset)
+                                   : pread(op.fd, op.data, op.size, op.offset);
+      FinishOp(op, result < 0 ? -errno : result);
+      lock.lock();
+    }
+  }
+
+private:
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<AsyncIOOp> queue_;
+  std::vector<std::thread> workers_;
+  bool stop_{false};
+};
+
+#ifdef MINISQL_HAS_IO_URING
+/**
+ * Submits reads and writes to an io_uring through the raw system calls, one io_uring_enter per batch.
+ * A reaper thread waits for completions. Every operation in flight owns a slot whose index is the
+ * user_data of its submission, and the number of slots bounds the operations in flight, so the
+ * completion queue (twice the size of the submission queue) never overflows.
+ */
+class IOUringAsyncIOEngine : public AsyncIOEngine {
+public:
+  ~IOUringAsyncIOEngine() override {
+    if (reaper_.joinable()) {
+      std::unique_lock<std::mutex> lock(latch_);
+      slot_cv_.wait(lock, [this]() { return free_slots_.size() == slots_.size(); });
+      // a nop with the stop tag wakes up the reaper
+      io_uring_sqe *sqe = NextSqe();
+      sqe->opcode = IORING_OP_NOP;
+      sqe->user_data = kStopTag;
+      Enter(1, 0, 0);
+      lock.unlock();
+      reaper_.join();
+    }
+    if (sqes_ != nullptr) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != nullptr) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0) {
+      close(ring_fd_);
+    }
+  }
+
+  /**
+   * @return false if the kernel does not support io_uring reads and writes
+   */
+  bool Init(size_t queue_depth) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+    if (ring_fd_ < 0 || !SupportsReadWrite()) {
+      return false;
+    }
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = MapRing(sq_ring_size_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == nullptr) {
+      return false;
+    }
+    cq_ring_ = single_mmap ? sq_ring_ : MapRing(cq_ring_size_, IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe *>(MapRing(sqes_size_, IORING_OFF_SQES));
+    if (cq_ring_ == nullptr || sqes_ == nullptr) {
+      return false;
+    }
+    auto *sq = static_cast<char *>(sq_ring_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    auto *cq = static_cast<char *>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    slots_.resize(params.sq_entries);
+    for (size_t i = 0; i < slots_.size(); i++) {
+      free_slots_.push_back(static_cast<uint32_t>(slots_.size() - 1 - i));
+    }
+    reaper_ = std::thread(&IOUringAsyncIOEngine::RunReaper, this);
+    return true;
+  }
+
+  void Submit(std::vector<AsyncIOOp> &ops) override {
+    std::unique_lock<std::mutex> lock(latch_);
+    unsigned to_submit = 0;
+    for (auto &op : ops) {
+      if (free_slots_.empty()) {
+        // submit what is queued, so that completions can free slots
+        Enter(to_submit, 0, 0);
+        to_submit = 0;
+        slot_cv_.wait(lock, [this]() { return !free_slots_.empty(); });
+      }
+      uint32_t slot = free_slots_.back();
+      free_slots_.pop_back();
+      slots_[slot] = op;
+      io_uring_sqe *sqe = NextSqe();
+      sqe->opcode = op.is_write ? IORING_OP_WRITE : IORING_OP_READ;
+      sqe->fd = op.fd;
+      sqe->off = op.offset;
+      sqe->addr = reinterpret_cast<uint64_t>(op.data);
+      sqe->len = static_cast<uint32_t>(op.size);
+      sqe->user_data = slot;
+      to_submit++;
+    }
+    Enter(to_submit, 0, 0);
+  }
+
+  AsyncIOEngineType GetType() const override { return AsyncIOEngineType::kIOUring; }
+
+private:
+  static constexpr uint64_t kStopTag = UINT64_MAX;
+
+  bool SupportsReadWrite() {
+    constexpr unsigned num_ops = 256;
+    std::vector<char> buffer(sizeof(io_uring_probe) + num_ops * sizeof(io_uring_probe_op), 0);
+    auto *probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PROBE, probe, num_ops) < 0) {
+      return false;
+    }
+    auto supported = [probe](unsigned op) {
+      return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    };
+    return supported(IORING_OP_READ) && supported(IORING_OP_WRITE) && supported(IORING_OP_NOP);
+  }
+
+  void *MapRing(size_t size, off_t offset) {
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+  }
+
+  /**
+   * Claim the next submission queue entry, latch_ must be held. The kernel consumes all entries in
+   * io_uring_enter and slots bound the entries in flight, so the submission queue is never full.
+   */
+  io_uring_sqe *NextSqe() {
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & sq_mask_;
+    io_uring_sqe *sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+  }
+
+  int Enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    if (to_submit == 0 && min_complete == 0) {
+      return 0;
+    }
+    int ret;
+    do {
+      ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, nullptr, 0));
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+      LOG(ERROR) << "io_uring_enter failed: " << strerror(errno);
+    }
+    return ret;
+  }
+
+  void RunReaper() {
+    while (true) {
+      unsigned head = *cq_head_;
+      if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        Enter(0, 1, IORING_ENTER_GETEVENTS);
+        continue;
+      }
+      io_uring_cqe *cqe = &cqes_[head & cq_mask_];
+      uint64_t tag = cqe->user_data;
+      long result = cqe->res;
+      __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+      if (tag == kStopTag) {
+        return;
+      }
+      AsyncIOOp op;
+      {
+        std::scoped_lock<std::mutex> lock(latch_);
+        op = std::move(slots_[tag]);
+        free_slots_.push_back(static_cast<uint32_t>(tag));
+      }
+      slot_cv_.notify_all();
+      FinishOp(op, result);
+    }
+  }
+
+private:
+  int ring_fd_{-1};
+  void *sq_ring_{nullptr};
+  void *cq_ring_{nullptr};
+  io_uring_sqe *sqes_{nullptr};
+  size_t sq_ring_size_{0};
+  size_t cq_ring_size_{0};
+  size_t sqes_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe *cqes_{nullptr};
+  /** protects the submission queue and the slots */
+  std::mutex latch_;
+  std::condition_variable slot_cv_;
+  std::vector<AsyncIOOp> slots_;
+  std::vector<uint32_t> free_slots_;
+  std::thread reaper_;
+};
+#endif
+
+std::unique_ptr<AsyncIOEngine> AsyncIOEngine::Create(AsyncIOEngineType type, size_t queue_depth) {
+#ifdef MINISQL_HAS_IO_URING
+  if (type != AsyncIOEngineType::kThreadPool) {
+    std::unique_ptr<IOUringAsyncIOEngine> engine(new IOUringAsyncIOEngine());
+    if (engine->Init(queue_depth)) {
+      return engine;
+    }
+  }
+#endif
+  // blocking calls, a few workers are enough to keep the device busy
+  return std::unique_ptr<AsyncIOEngine>(new ThreadPoolAsyncIOEngine(std::min<size_t>(queue_depth, 8)));
+}
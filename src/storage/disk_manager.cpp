@@ -1,12 +1,31 @@
+#include <algorithm>
 #include <stdexcept>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 #include "storage/disk_manager.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, DiskIOBackend backend, AsyncIOEngineType async_io_type)
+        : backend_(backend), file_name_(db_file), async_io_type_(async_io_type) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  size_t extension = db_file.find_last_of('.');
+  if (extension == std::string::npos || db_file.find('/', extension) != std::string::npos) {
+    extension = db_file.size();
+  }
+  log_name_ = db_file.substr(0, extension) + ".log";
+  if (backend_ == DiskIOBackend::kFileDescriptor) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat stat_buf;
+    if (db_fd_ < 0 || fstat(db_fd_, &stat_buf) != 0) {
+      throw std::exception();
+    }
+    file_size_ = stat_buf.st_size;
+    ReadPhysicalPage(META_PAGE_ID, meta_data_);
+    return;
+  }
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
   // directory or file does not exist
   if (!db_io_.is_open()) {
@@ -20,75 +39,422 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw std::exception();
     }
   }
+  file_size_ = std::max(GetFileSize(db_file), 0);
   ReadPhysicalPage(META_PAGE_ID, meta_data_);
 }
 
 void DiskManager::Close() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   if (!closed) {
-    db_io_.close();
+    {
+      // waits for the requests in flight
+      std::scoped_lock<std::mutex> async_io_lock(async_io_latch_);
+      async_io_.reset();
+    }
+    FlushMetaData();
+    if (backend_ == DiskIOBackend::kFileDescriptor) {
+      close(db_fd_);
+      db_fd_ = -1;
+    } else {
+      db_io_.close();
+    }
+    std::scoped_lock<std::mutex> log_lock(log_io_latch_);
+    if (log_fd_ >= 0) {
+      close(log_fd_);
+      log_fd_ = -1;
+    }
     closed = true;
   }
 }
 
 void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
+  auto lock = LockIO();
   ASSERT(logical_page_id >= 0, "Invalid page id.");
   ReadPhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
+  auto lock = LockIO();
   ASSERT(logical_page_id >= 0, "Invalid page id.");
   WritePhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
-page_id_t DiskManager::AllocatePage() {
-  DiskFileMetaPage *meta_data = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
-  uint32_t i = 0;
-  bool flag = true;
-  for(i = 0; i < meta_data->num_extents_; i++){
-    if(meta_data->extent_used_page_[i] < BITMAP_SIZE){
-      flag = false;
+void DiskManager::WritePages(page_id_t first_logical_page_id, const char *page_data, size_t num_pages) {
+  auto lock = LockIO();
+  ASSERT(first_logical_page_id >= 0, "Invalid page id.");
+  size_t written = 0;
+  while (written < num_pages) {
+    page_id_t logical_page_id = first_logical_page_id + static_cast<page_id_t>(written);
+    // pages of one extent are contiguous on disk, the bitmap page of the next extent lies in between
+    size_t run = std::min(num_pages - written, BITMAP_SIZE - logical_page_id % BITMAP_SIZE);
+    WritePhysicalPages(MapPageId(logical_page_id), page_data + written * PAGE_SIZE, run);
+    written += run;
+  }
+}
+
+AsyncIOHandlePtr DiskManager::ReadPageAsync(page_id_t logical_page_id, char *page_data) {
+  return SubmitBatch({PageIORequest{false, logical_page_id, page_data, 1}})[0];
+}
+
+AsyncIOHandlePtr DiskManager::WritePageAsync(page_id_t logical_page_id, const char *page_data) {
+  // the engine only reads from the buffer of a write
+  return SubmitBatch({PageIORequest{true, logical_page_id, const_cast<char *>(page_data), 1}})[0];
+}
+
+std::vector<AsyncIOHandlePtr> DiskManager::SubmitBatch(const std::vector<PageIORequest> &requests) {
+  std::vector<AsyncIOHandlePtr> handles;
+  handles.reserve(requests.size());
+  if (backend_ == DiskIOBackend::kFstream) {
+    // the stream has a single cursor, so requests are executed one by one
+    for (auto &request : requests) {
+      if (request.is_write) {
+        WritePages(request.logical_page_id, request.page_data, request.num_pages);
+      } else {
+        for (size_t i = 0; i < request.num_pages; i++) {
+          ReadPage(request.logical_page_id + static_cast<page_id_t>(i), request.page_data + i * PAGE_SIZE);
+        }
+      }
+      handles.push_back(std::make_shared<AsyncIOHandle>());
+    }
+    return handles;
+  }
+  AsyncIOEngine *engine = GetAsyncIOEngine();
+  std::vector<AsyncIOOp> ops;
+  for (auto &request : requests) {
+    ASSERT(request.logical_page_id >= 0, "Invalid page id.");
+    auto handle = std::make_shared<AsyncIOHandle>();
+    size_t done = 0;
+    while (done < request.num_pages) {
+      page_id_t logical_page_id = request.logical_page_id + static_cast<page_id_t>(done);
+      // runs are split at extent boundaries, like in WritePages
+      size_t run = std::min(request.num_pages - done, BITMAP_SIZE - logical_page_id % BITMAP_SIZE);
+      AsyncIOOp op;
+      op.is_write = request.is_write;
+      op.fd = db_fd_;
+      op.offset = static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE;
+      op.data = request.page_data + done * PAGE_SIZE;
+      op.size = run * PAGE_SIZE;
+      op.handle = handle;
+      done += run;
+      if (!op.is_write && op.offset >= file_size_) {
+        memset(op.data, 0, op.size);
+        continue;
+      }
+      if (op.is_write) {
+        GrowFileSize(op.offset + op.size);
+      }
+      handle->AddPending();
+      ops.push_back(std::move(op));
+    }
+    handles.push_back(std::move(handle));
+  }
+  engine->Submit(ops);
+  return handles;
+}
+
+AsyncIOEngineType DiskManager::GetAsyncIOEngineType() {
+  if (backend_ == DiskIOBackend::kFstream) {
+    return async_io_type_;
+  }
+  return GetAsyncIOEngine()->GetType();
+}
+
+AsyncIOEngine *DiskManager::GetAsyncIOEngine() {
+  std::scoped_lock<std::mutex> lock(async_io_latch_);
+  if (async_io_ == nullptr) {
+    async_io_ = AsyncIOEngine::Create(async_io_type_);
+  }
+  return async_io_.get();
+}
+
+void DiskManager::GrowFileSize(size_t end) {
+  // pages are written concurrently, so the size only grows
+  size_t file_size = file_size_.load();
+  while (file_size < end && !file_size_.compare_exchange_weak(file_size, end)) {
+  }
+}
+
+void DiskManager::WriteLog(const char *log_data, size_t size) {
+  std::scoped_lock<std::mutex> lock(log_io_latch_);
+  if (!OpenLog()) {
+    return;
+  }
+  size_t written = 0;
+  while (written < size) {
+    ssize_t count = pwrite(log_fd_, log_data + written, size - written, log_size_ + written);
+    if (count < 0) {
+      LOG(ERROR) << "I/O error while writing log";
+      return;
+    }
+    written += count;
+  }
+  log_size_ += size;
+  if (fdatasync(log_fd_) != 0) {
+    LOG(ERROR) << "I/O error while syncing log";
+  }
+}
+
+size_t DiskManager::GetLogSize() {
+  std::scoped_lock<std::mutex> lock(log_io_latch_);
+  return OpenLog() ? log_size_ : 0;
+}
+
+void DiskManager::TruncateLog(size_t size) {
+  std::scoped_lock<std::mutex> lock(log_io_latch_);
+  if (!OpenLog() || size >= log_size_) {
+    return;
+  }
+  if (ftruncate(log_fd_, size) != 0 || fdatasync(log_fd_) != 0) {
+    LOG(ERROR) << "I/O error while truncating log";
+    return;
+  }
+  log_size_ = size;
+}
+
+size_t DiskManager::ReadLog(char *log_data, size_t size, size_t offset) {
+  std::scoped_lock<std::mutex> lock(log_io_latch_);
+  if (!OpenLog()) {
+    return 0;
+  }
+  size_t read_count = 0;
+  while (read_count < size && offset + read_count < log_size_) {
+    ssize_t count = pread(log_fd_, log_data + read_count, size - read_count, offset + read_count);
+    if (count <= 0) {
+      if (count < 0) {
+        LOG(ERROR) << "I/O error while reading log";
+      }
       break;
     }
+    read_count += count;
   }
-  if(flag)
-    meta_data->num_extents_++;
-  uint32_t logical_page_id;
-  for(i = 0; i < meta_data->num_extents_; i++){
-    if(meta_data->extent_used_page_[i] < BITMAP_SIZE){
-      char bitmap_page_data[PAGE_SIZE];
-      ReadPhysicalPage(i * (BITMAP_SIZE+1) + 1, bitmap_page_data);
-      BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(bitmap_page_data);
-      bitmap_page->AllocatePage(logical_page_id);
-      meta_data->num_allocated_pages_++;
-      meta_data->extent_used_page_[i]++;
-      WritePhysicalPage(i * (BITMAP_SIZE+1) + 1,bitmap_page_data);
-      return i * BITMAP_SIZE + logical_page_id;
+  return read_count;
+}
+
+bool DiskManager::OpenLog() {
+  if (log_fd_ >= 0) {
+    return true;
+  }
+  log_fd_ = open(log_name_.c_str(), O_RDWR | O_CREAT, 0644);
+  struct stat stat_buf;
+  if (log_fd_ < 0 || fstat(log_fd_, &stat_buf) != 0) {
+    LOG(ERROR) << "Can not open log file " << log_name_;
+    return false;
+  }
+  log_size_ = stat_buf.st_size;
+  return true;
+}
+
+page_id_t DiskManager::AllocatePage() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  DiskFileMetaPage *meta_data = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t extent_id = next_free_extent_;
+  while (extent_id < meta_data->num_extents_ && meta_data->extent_used_page_[extent_id] >= BITMAP_SIZE) {
+    extent_id++;
+  }
+  next_free_extent_ = extent_id;
+  if (extent_id == meta_data->num_extents_) {
+    if (extent_id >= MAX_VALID_PAGE_ID / BITMAP_SIZE) {
+      return INVALID_PAGE_ID;
     }
+    meta_data->num_extents_++;
+  }
+  uint32_t page_offset;
+  if (!GetBitmap(extent_id)->AllocatePage(page_offset)) {
+    return INVALID_PAGE_ID;
+  }
+  bitmap_dirty_[extent_id] = true;
+  meta_data->num_allocated_pages_++;
+  meta_data->extent_used_page_[extent_id]++;
+  meta_dirty_ = true;
+  return static_cast<page_id_t>(extent_id * BITMAP_SIZE + page_offset);
+}
+
+bool DiskManager::AllocatePageAt(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  ASSERT(logical_page_id >= 0 && logical_page_id < MAX_VALID_PAGE_ID, "Invalid page id.");
+  DiskFileMetaPage *meta_data = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+  if (extent_id >= meta_data->num_extents_) {
+    // the extents in between are empty
+    meta_data->num_extents_ = extent_id + 1;
+    meta_dirty_ = true;
+  }
+  if (!GetBitmap(extent_id)->AllocatePageAt(logical_page_id % BITMAP_SIZE)) {
+    return false;
   }
-  return INVALID_PAGE_ID;
+  bitmap_dirty_[extent_id] = true;
+  meta_data->num_allocated_pages_++;
+  meta_data->extent_used_page_[extent_id]++;
+  meta_dirty_ = true;
+  return true;
 }
 
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
   DiskFileMetaPage *meta_data = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
-  char bitmap_page_data[PAGE_SIZE];
-  ReadPhysicalPage(logical_page_id + 1 + logical_page_id / BITMAP_SIZE - logical_page_id % BITMAP_SIZE,
-                   bitmap_page_data);
-  BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(bitmap_page_data);
-  uint32_t page = logical_page_id % BITMAP_SIZE;
-  bitmap_page->DeAllocatePage(page);
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+  // page already free
+  if (extent_id >= meta_data->num_extents_ || !GetBitmap(extent_id)->DeAllocatePage(logical_page_id % BITMAP_SIZE)) {
+    return;
+  }
+  bitmap_dirty_[extent_id] = true;
   meta_data->num_allocated_pages_--;
-  meta_data->extent_used_page_[logical_page_id/BITMAP_SIZE]--;
-  WritePhysicalPage(logical_page_id + 1 + logical_page_id / BITMAP_SIZE - logical_page_id % BITMAP_SIZE,
-                    bitmap_page_data);
+  meta_data->extent_used_page_[extent_id]--;
+  meta_dirty_ = true;
+  next_free_extent_ = std::min(next_free_extent_, extent_id);
 }
 
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
-  char bitmap_page_data[PAGE_SIZE];
-  ReadPhysicalPage(logical_page_id + 1 + logical_page_id/BITMAP_SIZE - logical_page_id%BITMAP_SIZE,
-                   bitmap_page_data);
-  BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(bitmap_page_data);
-  return bitmap_page->IsPageFree(logical_page_id%BITMAP_SIZE);
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  DiskFileMetaPage *meta_data = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+  if (extent_id >= meta_data->num_extents_) {
+    return true;
+  }
+  return GetBitmap(extent_id)->IsPageFree(logical_page_id % BITMAP_SIZE);
+}
+
+page_id_t DiskManager::ReservePages(size_t num_pages) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  ASSERT(num_pages > 0 && num_pages <= BITMAP_SIZE, "Invalid number of pages.");
+  DiskFileMetaPage *meta_data = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t page_offset;
+  uint32_t extent_id = next_free_extent_;
+  while (extent_id < meta_data->num_extents_) {
+    if (meta_data->extent_used_page_[extent_id] + num_pages <= BITMAP_SIZE &&
+        GetBitmap(extent_id)->AllocatePages(num_pages, page_offset)) {
+      break;
+    }
+    extent_id++;
+  }
+  if (extent_id == meta_data->num_extents_) {
+    if (extent_id >= MAX_VALID_PAGE_ID / BITMAP_SIZE || !GetBitmap(extent_id)->AllocatePages(num_pages, page_offset)) {
+      return INVALID_PAGE_ID;
+    }
+    meta_data->num_extents_++;
+  }
+  bitmap_dirty_[extent_id] = true;
+  meta_data->num_allocated_pages_ += num_pages;
+  meta_data->extent_used_page_[extent_id] += num_pages;
+  meta_dirty_ = true;
+  page_id_t first_page_id = static_cast<page_id_t>(extent_id * BITMAP_SIZE + page_offset);
+  for (size_t i = 0; i < num_pages; i++) {
+    reserved_.insert(first_page_id + static_cast<page_id_t>(i));
+  }
+  return first_page_id;
+}
+
+bool DiskManager::AllocateReservedPage(page_id_t logical_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (reserved_.erase(logical_page_id) == 0) {
+    return false;
+  }
+  // the page is written as allocated from now on
+  bitmap_dirty_[logical_page_id / BITMAP_SIZE] = true;
+  meta_dirty_ = true;
+  return true;
+}
+
+void DiskManager::ReleasePages(page_id_t first_logical_page_id, size_t num_pages) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  for (size_t i = 0; i < num_pages; i++) {
+    page_id_t logical_page_id = first_logical_page_id + static_cast<page_id_t>(i);
+    if (reserved_.erase(logical_page_id) != 0) {
+      DeAllocatePage(logical_page_id);
+    }
+  }
+}
+
+void DiskManager::FlushMetaData() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (closed) {
+    return;
+  }
+  for (uint32_t i = 0; i < bitmaps_.size(); i++) {
+    if (!bitmap_dirty_[i]) {
+      continue;
+    }
+    auto begin = reserved_.lower_bound(static_cast<page_id_t>(i * BITMAP_SIZE));
+    auto end = reserved_.lower_bound(static_cast<page_id_t>((i + 1) * BITMAP_SIZE));
+    if (begin == end) {
+      WritePhysicalPage(MapBitmapPageId(i), reinterpret_cast<const char *>(bitmaps_[i].get()));
+    } else {
+      // reserved pages are written as free
+      BitmapPage<PAGE_SIZE> bitmap = *bitmaps_[i];
+      for (auto iter = begin; iter != end; iter++) {
+        bitmap.DeAllocatePage(*iter % BITMAP_SIZE);
+      }
+      WritePhysicalPage(MapBitmapPageId(i), reinterpret_cast<const char *>(&bitmap));
+    }
+    bitmap_dirty_[i] = false;
+  }
+  if (meta_dirty_) {
+    char meta_data[PAGE_SIZE];
+    memcpy(meta_data, meta_data_, PAGE_SIZE);
+    DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data);
+    for (page_id_t reserved_page_id : reserved_) {
+      meta_page->num_allocated_pages_--;
+      meta_page->extent_used_page_[reserved_page_id / BITMAP_SIZE]--;
+    }
+    WritePhysicalPage(META_PAGE_ID, meta_data);
+    meta_dirty_ = false;
+  }
+}
+
+void DiskManager::Sync() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (closed) {
+    return;
+  }
+  if (backend_ == DiskIOBackend::kFileDescriptor) {
+    if (fdatasync(db_fd_) != 0) {
+      LOG(ERROR) << "I/O error while syncing";
+    }
+  } else {
+    // std::fstream does not expose its descriptor, the file is synced through one of its own
+    db_io_.flush();
+    int fd = open(file_name_.c_str(), O_RDONLY);
+    if (db_io_.fail() || fd < 0 || fdatasync(fd) != 0) {
+      LOG(ERROR) << "I/O error while syncing";
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+size_t DiskManager::GetCheckpointOffset() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  return reinterpret_cast<DiskFileMetaPage *>(meta_data_)->checkpoint_offset_;
+}
+
+void DiskManager::SetCheckpointOffset(size_t offset) {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  reinterpret_cast<DiskFileMetaPage *>(meta_data_)->checkpoint_offset_ = offset;
+  meta_dirty_ = true;
+}
+
+BitmapPage<PAGE_SIZE> *DiskManager::GetBitmap(uint32_t extent_id) {
+  static_assert(sizeof(BitmapPage<PAGE_SIZE>) == PAGE_SIZE, "A bitmap must fill a page.");
+  if (extent_id >= bitmaps_.size()) {
+    bitmaps_.resize(extent_id + 1);
+    bitmap_dirty_.resize(extent_id + 1, false);
+  }
+  if (bitmaps_[extent_id] == nullptr) {
+    bitmaps_[extent_id] = std::make_unique<BitmapPage<PAGE_SIZE>>();
+    ReadPhysicalPage(MapBitmapPageId(extent_id), reinterpret_cast<char *>(bitmaps_[extent_id].get()));
+  }
+  return bitmaps_[extent_id].get();
+}
+
+std::unique_lock<std::recursive_mutex> DiskManager::LockIO() {
+  // pread and pwrite take their own offsets, only the stream cursor needs the latch
+  if (backend_ == DiskIOBackend::kFileDescriptor) {
+    return std::unique_lock<std::recursive_mutex>(db_io_latch_, std::defer_lock);
+  }
+  return std::unique_lock<std::recursive_mutex>(db_io_latch_);
 }
 
 page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
@@ -102,9 +468,28 @@ int DiskManager::GetFileSize(const std::string &file_name) {
 }
 
 void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
-  // check if read beyond file length
-  if (offset >= GetFileSize(file_name_)) {
+  if (backend_ == DiskIOBackend::kFileDescriptor) {
+    size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+    ssize_t read_count = 0;
+    // check if read beyond file length
+    if (offset < file_size_) {
+      read_count = pread(db_fd_, page_data, PAGE_SIZE, offset);
+      if (read_count < 0) {
+        LOG(ERROR) << "I/O error while reading";
+        read_count = 0;
+      }
+    }
+    if (read_count < PAGE_SIZE) {
+#ifdef ENABLE_BPM_DEBUG
+      LOG(INFO) << "Read less than a page" << std::endl;
+#endif
+      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+    }
+    return;
+  }
+  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+  // check if read beyond file length, pages written to the stream may not have reached the file yet
+  if (offset >= file_size_) {
 #ifdef ENABLE_BPM_DEBUG
     LOG(INFO) << "Read less than a page" << std::endl;
 #endif
@@ -125,15 +510,33 @@ void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data)
 }
 
 void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+  WritePhysicalPages(physical_page_id, page_data, 1);
+}
+
+void DiskManager::WritePhysicalPages(page_id_t first_physical_page_id, const char *page_data, size_t num_pages) {
+  size_t offset = static_cast<size_t>(first_physical_page_id) * PAGE_SIZE;
+  if (backend_ == DiskIOBackend::kFileDescriptor) {
+    size_t size = num_pages * PAGE_SIZE;
+    size_t written = 0;
+    while (written < size) {
+      ssize_t count = pwrite(db_fd_, page_data + written, size - written, offset + written);
+      if (count < 0) {
+        LOG(ERROR) << "I/O error while writing";
+        return;
+      }
+      written += count;
+    }
+    GrowFileSize(offset + size);
+    return;
+  }
   // set write cursor to offset
   db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  db_io_.write(page_data, num_pages * PAGE_SIZE);
   // check for I/O error
   if (db_io_.bad()) {
     LOG(ERROR) << "I/O error while writing";
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  // the write stays in the stream buffer, durability comes from the log
+  GrowFileSize(offset + num_pages * PAGE_SIZE);
 }
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "storage/free_space_map.h"
+
+#include <algorithm>
+
+#include "buffer/page_log_scope.h"
+#include "glog/logging.h"
+#include "page/table_page.h"
+
+bool FreeSpaceMap::Init() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  PageLogScope scope(buffer_pool_manager_->GetLogManager());
+  auto page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->NewPage(first_page_id_));
+  if (page == nullptr) {
+    first_page_id_ = INVALID_PAGE_ID;
+    return false;
+  }
+  page->Init(first_page_id_);
+  buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  map_page_ids_.push_back(first_page_id_);
+  max_categories_.push_back(0);
+  return true;
+}
+
+void FreeSpaceMap::Load(page_id_t first_page_id, page_id_t heap_first_page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  if (first_page_id == INVALID_PAGE_ID) {
+    // heap created without a free space map, rebuild it from the page chain
+    if (!Init()) {
+      LOG(ERROR) << "Failed to allocate free space map page." << std::endl;
+      return;
+    }
+    page_id_t page_id = heap_first_page_id;
+    while (page_id != INVALID_PAGE_ID) {
+      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+      ASSERT(page != nullptr, "Can not fetch table page.");
+      AddPage(page_id, page->GetFreeSpaceRemaining());
+      page_id_t next_page_id = page->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    return;
+  }
+  first_page_id_ = first_page_id;
+  page_id_t page_id = first_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "Can not fetch free space map page.");
+    uint8_t max_category = 0;
+    for (uint32_t i = 0; i < page->GetEntryCount(); i++) {
+      uint8_t category = page->GetCategory(i);
+      positions_[page->GetTablePageId(i)] = table_page_ids_.size();
+      table_page_ids_.push_back(page->GetTablePageId(i));
+      categories_.push_back(category);
+      max_category = std::max(max_category, category);
+    }
+    map_page_ids_.push_back(page_id);
+    max_categories_.push_back(max_category);
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  // pages linked to the heap by a redone log record whose addition to the map was lost in a crash
+  page_id = GetLastTablePageId();
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "Can not fetch table page.");
+    if (positions_.find(page_id) == positions_.end()) {
+      AddPage(page_id, page->GetFreeSpaceRemaining());
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+page_id_t FreeSpaceMap::FindPage(uint32_t size) const {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  uint8_t required = FreeSpaceMapPage::RequiredCategory(size);
+  if (required > FreeSpaceMapPage::MAX_CATEGORY) {
+    return INVALID_PAGE_ID;
+  }
+  for (size_t i = 0; i < map_page_ids_.size(); i++) {
+    if (max_categories_[i] < required) {
+      continue;
+    }
+    size_t begin = i * FreeSpaceMapPage::MAX_ENTRIES;
+    size_t end = std::min(begin + FreeSpaceMapPage::MAX_ENTRIES, categories_.size());
+    for (size_t j = begin; j < end; j++) {
+      if (categories_[j] >= required) {
+        return table_page_ids_[j];
+      }
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+bool FreeSpaceMap::AddPage(page_id_t table_page_id, uint32_t free_space) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  ASSERT(!map_page_ids_.empty(), "Free space map is not initialized.");
+  PageLogScope scope(buffer_pool_manager_->GetLogManager());
+  uint8_t category = FreeSpaceMapPage::ToCategory(free_space);
+  page_id_t map_page_id = map_page_ids_.back();
+  auto page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(map_page_id));
+  if (page == nullptr) {
+    return false;
+  }
+  uint32_t slot;
+  if (page->IsFull()) {
+    // chain a new map page
+    page_id_t new_page_id;
+    auto new_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->NewPage(new_page_id));
+    if (new_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(map_page_id, false);
+      return false;
+    }
+    new_page->Init(new_page_id);
+    page->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(map_page_id, true);
+    map_page_ids_.push_back(new_page_id);
+    max_categories_.push_back(0);
+    map_page_id = new_page_id;
+    page = new_page;
+  }
+  page->Append(table_page_id, category, slot);
+  buffer_pool_manager_->UnpinPage(map_page_id, true);
+  positions_[table_page_id] = table_page_ids_.size();
+  table_page_ids_.push_back(table_page_id);
+  categories_.push_back(category);
+  max_categories_.back() = std::max(max_categories_.back(), category);
+  return true;
+}
+
+void FreeSpaceMap::UpdatePage(page_id_t table_page_id, uint32_t free_space) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  auto iter = positions_.find(table_page_id);
+  if (iter == positions_.end()) {
+    return;
+  }
+  uint32_t position = iter->second;
+  uint8_t category = FreeSpaceMapPage::ToCategory(free_space);
+  uint8_t old_category = categories_[position];
+  if (category == old_category) {
+    return;
+  }
+  size_t map_index = position / FreeSpaceMapPage::MAX_ENTRIES;
+  PageLogScope scope(buffer_pool_manager_->GetLogManager());
+  auto page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(map_page_ids_[map_index]));
+  if (page == nullptr) {
+    return;
+  }
+  page->SetCategory(position % FreeSpaceMapPage::MAX_ENTRIES, category);
+  buffer_pool_manager_->UnpinPage(map_page_ids_[map_index], true);
+  categories_[position] = category;
+  if (category > max_categories_[map_index]) {
+    max_categories_[map_index] = category;
+  } else if (old_category == max_categories_[map_index]) {
+    RecomputeMaxCategory(map_index);
+  }
+}
+
+void FreeSpaceMap::Free() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  for (auto page_id : map_page_ids_) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  first_page_id_ = INVALID_PAGE_ID;
+  map_page_ids_.clear();
+  max_categories_.clear();
+  table_page_ids_.clear();
+  categories_.clear();
+  positions_.clear();
+}
+
+void FreeSpaceMap::RecomputeMaxCategory(size_t map_index) {
+  size_t begin = map_index * FreeSpaceMapPage::MAX_ENTRIES;
+  size_t end = std::min(begin + FreeSpaceMapPage::MAX_ENTRIES, categories_.size());
+  uint8_t max_category = 0;
+  for (size_t i = begin; i < end; i++) {
+    max_category = std::max(max_category, categories_[i]);
+  }
+  max_categories_[map_index] = max_category;
+}
@@ -0,0 +1,42 @@
+#include "storage/page_run_allocator.h"
+
+#include <algorithm>
+
+PageRunAllocator::PageRunAllocator(DiskManager *disk_manager, size_t run_size)
+        : disk_manager_(disk_manager), run_size_(std::min(run_size, DiskManager::BITMAP_SIZE)) {}
+
+page_id_t PageRunAllocator::AllocatePage() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  while (true) {
+    if (next_page_id_ == end_page_id_) {
+      page_id_t first_page_id = run_size_ == 0 ? INVALID_PAGE_ID : disk_manager_->ReservePages(run_size_);
+      if (first_page_id == INVALID_PAGE_ID) {
+        // no extent has a free run left
+        return disk_manager_->AllocatePage();
+      }
+      next_page_id_ = first_page_id;
+      end_page_id_ = first_page_id + static_cast<page_id_t>(run_size_);
+    }
+    page_id_t page_id = next_page_id_++;
+    if (disk_manager_->AllocateReservedPage(page_id)) {
+      return page_id;
+    }
+  }
+}
+
+void PageRunAllocator::Release() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (next_page_id_ != end_page_id_) {
+    disk_manager_->ReleasePages(next_page_id_, end_page_id_ - next_page_id_);
+  }
+  next_page_id_ = end_page_id_ = INVALID_PAGE_ID;
+}
+
+void PageRunStats::AddPage(page_id_t page_id) {
+  // the bitmap page of the next extent lies between the last and the first page of two extents
+  if (last_page_id == INVALID_PAGE_ID || page_id != last_page_id + 1 || page_id % DiskManager::BITMAP_SIZE == 0) {
+    num_runs++;
+  }
+  num_pages++;
+  last_page_id = page_id;
+}
@@ -1,38 +1,89 @@
 #include "storage/table_heap.h"
 
 bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
-    if (row.GetSerializedSize(schema_) > TablePage::SIZE_MAX_ROW)
+    uint32_t serialized_size = row.GetSerializedSize(schema_);
+    if (serialized_size > TablePage::SIZE_MAX_ROW)
         return false;
-    page_id_t item_page_id = first_page_id_;
-    TablePage *item_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(item_page_id));
-//    buffer_pool_manager_->UnpinPage(item_page_id, false);
-    while (true) {
-        bool flag = item_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-        if(flag){
-//            buffer_pool_manager_->UnpinPage(item_page_id, true);
-            return true;
-        }
-        if (item_page->GetNextPageId() == INVALID_PAGE_ID)
-            break;
-        item_page_id = item_page->GetNextPageId();
-        item_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(item_page_id));
-//        buffer_pool_manager_->UnpinPage(item_page_id, false);
+    // 1. a page which is known to have enough room
+    page_id_t item_page_id = free_space_map_.FindPage(serialized_size + TablePage::SIZE_TUPLE);
+    if (item_page_id != INVALID_PAGE_ID && InsertIntoPage(item_page_id, row, txn))
+        return LockInsertedRow(row.GetRowId(), txn);
+    // 2. the last page, whose free space may be below the granularity of the map
+    page_id_t last_page_id = free_space_map_.GetLastTablePageId();
+    if (last_page_id != item_page_id && InsertIntoPage(last_page_id, row, txn))
+        return LockInsertedRow(row.GetRowId(), txn);
+    // 3. link a new page to the end of the heap, unless another thread has linked one meanwhile which has room
+    {
+        std::scoped_lock<std::mutex> append_lock(append_latch_);
+        page_id_t current_last_page_id = free_space_map_.GetLastTablePageId();
+        bool inserted = current_last_page_id != last_page_id && InsertIntoPage(current_last_page_id, row, txn);
+        if (!inserted && !AppendPage(current_last_page_id, row, txn))
+            return false;
     }
-//    buffer_pool_manager_->UnpinPage(item_page_id, true);
+    return LockInsertedRow(row.GetRowId(), txn);
+}
+
+bool TableHeap::AppendPage(page_id_t last_page_id, Row &row, Transaction *txn) {
     page_id_t new_page_id = INVALID_PAGE_ID;
-    TablePage *new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id));
-//    buffer_pool_manager_->UnpinPage(new_page_id,false);
+    TablePage *new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPageFrom(new_page_id, &page_allocator_));
     if (!new_page)
         return false;
-    new_page->Init(new_page_id, item_page_id, log_manager_, txn);
+    TablePage *last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
+    if (!last_page) {
+        buffer_pool_manager_->UnpinPage(new_page_id, false);
+        buffer_pool_manager_->DeletePage(new_page_id);
+        return false;
+    }
+    last_page->WLatch();
+    new_page->Init(new_page_id, last_page_id, log_manager_, txn);
+    last_page->SetNextPageId(new_page_id);
+    // the link is redone by the record of the new page
+    if (log_manager_ != nullptr)
+        last_page->SetLSN(new_page->GetLSN());
+    last_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(last_page_id, true);
+    new_page->WLatch();
     new_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-//    buffer_pool_manager_->UnpinPage(new_page_id,true);
-    item_page->SetNextPageId(new_page_id);
-//    buffer_pool_manager_->UnpinPage(item_page_id,true);
+    if (IsLocking(txn))
+        lock_manager_->LockExclusive(txn, row.GetRowId(), false);
+    if (txn != nullptr && version_manager_ != nullptr)
+        version_manager_->RecordWrite(this, row.GetRowId(), txn, nullptr, 0, true);
+    free_space_map_.AddPage(new_page_id, new_page->GetFreeSpaceRemaining());
+    new_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
     return true;
 }
 
+bool TableHeap::InsertIntoPage(page_id_t page_id, Row &row, Transaction *txn) {
+    TablePage *page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (!page)
+        return false;
+    page->WLatch();
+    bool flag = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+    // the new row is locked before anyone can see it, see LockInsertedRow
+    if (flag && IsLocking(txn))
+        lock_manager_->LockExclusive(txn, row.GetRowId(), false);
+    // no snapshot taken before sees the new row
+    if (flag && txn != nullptr && version_manager_ != nullptr)
+        version_manager_->RecordWrite(this, row.GetRowId(), txn, nullptr, 0, true);
+    free_space_map_.UpdatePage(page_id, page->GetFreeSpaceRemaining());
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, flag);
+    return flag;
+}
+
+bool TableHeap::LockInsertedRow(const RowId &rid, Transaction *txn) {
+    // granted already under the latch of the page, unless the slot is still locked by a transaction which
+    // waited for the row deleted from it and has yet to find it gone
+    return !IsLocking(txn) || lock_manager_->LockExclusive(txn, rid);
+}
+
 bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
+  // The row is locked before its page is latched, a transaction never waits for a lock holding a latch.
+  bool held = !IsLocking(txn) || lock_manager_->HoldsLock(txn, rid);
+  if (IsLocking(txn) && !lock_manager_->LockExclusive(txn, rid)) {
+    return false;
+  }
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
@@ -41,37 +92,57 @@ bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
   }
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  bool deleted = RecordWrite(page, rid, txn, false) && page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  if (deleted) {
+    if (txn != nullptr) {
+      txn->AddDeletedRow(this, rid);
+    }
+  } else if (!held) {
+    lock_manager_->Unlock(txn, rid);
+  }
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-  return true;
+  return deleted;
 }
 
 bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Transaction *txn) {
+    if (IsLocking(txn) && !lock_manager_->LockExclusive(txn, rid))
+        return false;
     TablePage *page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
     if(page == nullptr)
         return false;
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
     Row old_row(rid);
-    bool flag = page->UpdateTuple(row, &old_row, schema_, txn, lock_manager_, log_manager_);
-    if(flag){
-        buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-        return true;
+    page->WLatch();
+    if (!RecordWrite(page, rid, txn, true)) {
+        page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+        return false;
     }
-    else{
-        MarkDelete(rid, txn);
-        flag = InsertTuple(row, txn);
-        buffer_pool_manager_->UnpinPage(page->GetTablePageId(), flag);
-        return flag;
+    bool flag = page->UpdateTuple(row, &old_row, schema_, txn, lock_manager_, log_manager_);
+    if (flag) {
+        row.SetRowId(rid);
+        free_space_map_.UpdatePage(rid.GetPageId(), page->GetFreeSpaceRemaining());
     }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), flag);
+    if (flag)
+        return true;
+    // not enough space in the old page, update via delete followed by an insert
+    if (!MarkDelete(rid, txn))
+        return false;
+    return InsertTuple(row, txn);
 }
 
 void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
   // Step1: Find the page which contains the tuple.
   // Step2: Delete the tuple from the page.
     TablePage *page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+    assert(page != nullptr);
+    page->WLatch();
     page->ApplyDelete(rid, txn, log_manager_);
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(),true);
+    free_space_map_.UpdatePage(rid.GetPageId(), page->GetFreeSpaceRemaining());
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
 }
 
 void TableHeap::RollbackDelete(const RowId &rid, Transaction *txn) {
@@ -86,41 +157,120 @@ void TableHeap::RollbackDelete(const RowId &rid, Transaction *txn) {
 }
 
 void TableHeap::FreeHeap() {
-    TablePage *item_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-    page_id_t next_page_id = item_page->GetNextPageId();
-    buffer_pool_manager_->DeletePage(item_page->GetPageId());
-    while(next_page_id != INVALID_PAGE_ID){
-        item_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-        next_page_id = item_page->GetNextPageId();
-        buffer_pool_manager_->DeletePage(item_page->GetPageId());
+    page_allocator_.Release();
+    page_id_t page_id = first_page_id_;
+    while (page_id != INVALID_PAGE_ID) {
+        TablePage *item_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+        page_id_t next_page_id = item_page->GetNextPageId();
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        buffer_pool_manager_->DeletePage(page_id);
+        page_id = next_page_id;
+    }
+    free_space_map_.Free();
+}
+
+PageRunStats TableHeap::GetPageRunStats() {
+    PageRunStats stats;
+    page_id_t page_id = first_page_id_;
+    while (page_id != INVALID_PAGE_ID) {
+        TablePage *item_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+        if (!item_page)
+            break;
+        stats.AddPage(page_id);
+        page_id_t next_page_id = item_page->GetNextPageId();
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        page_id = next_page_id;
     }
-    return;
+    return stats;
 }
 
 bool TableHeap::GetTuple(Row *row, Transaction *txn) {
+    RowId rid = row->GetRowId();
+    bool snapshot = ReadsSnapshot(txn);
+    bool held = snapshot || !IsLocking(txn) || lock_manager_->HoldsLock(txn, rid);
+    if (!held && !lock_manager_->LockShared(txn, rid))
+        return false;
     TablePage *tpage = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(row->GetRowId().GetPageId()));
     if(!tpage)
         return false;
     else{
         bool flag;
-        flag = tpage->GetTuple(row,schema_,txn,lock_manager_);
+        tpage->RLatch();
+        if (snapshot) {
+            std::vector<char> version;
+            char *tuple = GetVisibleTuple(tpage, rid, txn, version);
+            flag = tuple != nullptr;
+            if (flag)
+                row->DeserializeFrom(tuple, schema_);
+        } else {
+            flag = tpage->GetTuple(row,schema_,txn,lock_manager_);
+        }
+        tpage->RUnlatch();
         buffer_pool_manager_->UnpinPage(tpage->GetTablePageId(), false);
+        // a row found missing is not kept locked
+        if (!flag && !held)
+            lock_manager_->Unlock(txn, rid);
         return flag;
     }
 }
 
+bool TableHeap::RecordWrite(TablePage *page, const RowId &rid, Transaction *txn, bool exists) {
+    if (txn == nullptr || version_manager_ == nullptr)
+        return true;
+    uint32_t tuple_size = 0;
+    bool deleted = false;
+    char *tuple = page->GetTupleData(rid, &tuple_size, &deleted);
+    if (tuple == nullptr || deleted) {
+        // a row the snapshot of txn still sees was deleted by a transaction committed since
+        std::vector<char> version;
+        if (ReadsSnapshot(txn) && version_manager_->GetVisibleVersion(rid, txn, &version) == Visibility::kOlder)
+            txn->SetState(TransactionState::kAborted);
+        return false;
+    }
+    return version_manager_->RecordWrite(this, rid, txn, tuple, tuple_size, exists);
+}
+
+char *TableHeap::GetVisibleTuple(TablePage *page, const RowId &rid, Transaction *txn, std::vector<char> &version) {
+    uint32_t tuple_size = 0;
+    bool deleted = false;
+    char *tuple = page->GetTupleData(rid, &tuple_size, &deleted);
+    if (tuple == nullptr)
+        return nullptr;
+    switch (version_manager_->GetVisibleVersion(rid, txn, &version)) {
+        case Visibility::kCurrent:
+            return deleted ? nullptr : tuple;
+        case Visibility::kOlder:
+            return version.data();
+        default:
+            return nullptr;
+    }
+}
+
 TableIterator TableHeap::Begin(Transaction *txn) {
+    return BeginScan(txn, nullptr, nullptr);
+}
+
+TableIterator TableHeap::Begin(Transaction *txn, TupleFilter filter, std::vector<uint32_t> columns) {
+    return BeginScan(txn, std::move(filter), std::make_shared<const std::vector<uint32_t>>(std::move(columns)));
+}
+
+TableIterator TableHeap::BeginScan(Transaction *txn, TupleFilter filter,
+                                   std::shared_ptr<const std::vector<uint32_t>> columns) {
     RowId rid;
     page_id_t page_id = first_page_id_;
     while(page_id != INVALID_PAGE_ID){
         TablePage * page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
-        bool flag = page->GetFirstTupleRid(&rid);
+        // the page may be evicted once unpinned, its link is read before
+        page->RLatch();
+        bool flag = page->GetFirstTupleRid(&rid, ReadsSnapshot(txn));
+        page_id_t next_page_id = page->GetNextPageId();
+        page->RUnlatch();
         buffer_pool_manager_->UnpinPage(page_id, false);
         if(flag)
             break;
-        page_id = page->GetNextPageId();
+        page_id = next_page_id;
     }
-    return TableIterator(this, rid);
+    return TableIterator(this, rid, std::move(filter), std::move(columns), txn);
 }
 
 TableIterator TableHeap::End() {
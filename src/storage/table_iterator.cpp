@@ -2,21 +2,35 @@
 #include "storage/table_iterator.h"
 #include "storage/table_heap.h"
 
-TableIterator::TableIterator() {
+TableIterator::TableIterator(): table_heap_(nullptr), row_(new Row(INVALID_ROWID)) {
 
 }
 
-TableIterator::TableIterator(const TableIterator &other): table_heap_(other.table_heap_), row_(new Row(*other.row_)){
+TableIterator::TableIterator(const TableIterator &other)
+        : table_heap_(other.table_heap_), row_(new Row(*other.row_)), read_ahead_(other.read_ahead_),
+          filter_(other.filter_), columns_(other.columns_), txn_(other.txn_) {
 
 }
 
-TableIterator::TableIterator(TableHeap *table_heap, RowId rid): table_heap_(table_heap), row_(new Row(rid)) {
-    if (rid.GetPageId() != INVALID_PAGE_ID)
-        table_heap_->GetTuple(row_, nullptr);
+TableIterator::TableIterator(TableHeap *table_heap, RowId rid, TupleFilter filter,
+                             std::shared_ptr<const std::vector<uint32_t>> columns, Transaction *txn)
+        : table_heap_(table_heap), row_(new Row(rid)), filter_(std::move(filter)), columns_(std::move(columns)),
+          txn_(txn) {
+    if (rid.GetPageId() != INVALID_PAGE_ID) {
+        read_ahead_ = std::make_shared<ScanReadAhead>(table_heap_->buffer_pool_manager_, [](Page *page) {
+            return reinterpret_cast<TablePage *>(page)->GetNextPageId();
+        });
+        read_ahead_->Advance(rid.GetPageId());
+        TablePage *page = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(rid.GetPageId()));
+        if (!ReadRow(page, rid))
+            ++(*this);
+    }
 }
 
 TableIterator::~TableIterator() {
     delete row_;
+    if (page_ != nullptr)
+        table_heap_->buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
 }
 
 bool TableIterator::operator==(const TableIterator &itr) const {
@@ -32,8 +46,19 @@ Row &TableIterator::operator*() {
 }
 
 TableIterator& TableIterator::operator=(const TableIterator &other){
-    table_heap_ = other.table_heap_;
-    row_ = other.row_;
+    if (this != &other) {
+        delete row_;
+        if (page_ != nullptr) {
+            table_heap_->buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
+            page_ = nullptr;
+        }
+        table_heap_ = other.table_heap_;
+        row_ = new Row(*other.row_);
+        read_ahead_ = other.read_ahead_;
+        filter_ = other.filter_;
+        columns_ = other.columns_;
+        txn_ = other.txn_;
+    }
     return *this;
 }
 
@@ -41,23 +66,80 @@ Row *TableIterator::operator->() {
     return row_;
 }
 
+bool TableIterator::ReadRow(TablePage *page, RowId rid) {
+    bool snapshot = table_heap_->ReadsSnapshot(txn_);
+    if (!snapshot && table_heap_->IsLocking(txn_) && !table_heap_->lock_manager_->LockShared(txn_, rid)) {
+        // txn_ has to be rolled back, the scan ends
+        table_heap_->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+        page_ = nullptr;
+        row_->Clear(INVALID_ROWID);
+        return true;
+    }
+    // the row is copied, its page may change once unlatched
+    row_->Clear(rid);
+    page_ = page;
+    page->RLatch();
+    bool found;
+    if (snapshot) {
+        char *tuple = table_heap_->GetVisibleTuple(page, rid, txn_, version_);
+        found = tuple != nullptr && (filter_ == nullptr || filter_(tuple));
+        if (found && columns_ == nullptr)
+            row_->DeserializeFrom(tuple, table_heap_->schema_);
+        else if (found)
+            row_->DeserializeFrom(tuple, table_heap_->schema_, *columns_);
+    } else {
+        // the row may have been deleted or moved since its slot was found, operator++ passes it over then
+        found = page->GetTuple(row_, table_heap_->schema_, filter_, columns_.get(), nullptr,
+                               table_heap_->lock_manager_);
+    }
+    page->RUnlatch();
+    return found;
+}
+
 TableIterator &TableIterator::operator++() {
+    // rows failing the filter are passed over
+    while (!Advance()) {
+    }
+    return *this;
+}
+
+bool TableIterator::Advance() {
     BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-    TablePage * item_page = (TablePage *)buffer_pool_manager->FetchPage(row_->GetRowId().GetPageId());
+    RowId row_id = row_->GetRowId();
+    if (read_ahead_ != nullptr)
+        read_ahead_->Advance(row_id.GetPageId());
+    // take over the pin of the page of the current row
+    TablePage * item_page = page_;
+    page_ = nullptr;
+    if (item_page == nullptr)
+        item_page = (TablePage *)buffer_pool_manager->FetchPage(row_id.GetPageId());
+    row_->Clear(INVALID_ROWID);
     RowId next_row_id;
-    if(!item_page->GetNextTupleRid(row_->GetRowId(),&next_row_id))
-        while(item_page->GetNextPageId() != INVALID_PAGE_ID){
-            TablePage * next_page=(TablePage *)buffer_pool_manager->FetchPage(item_page->GetNextPageId());
-            buffer_pool_manager->UnpinPage(item_page->GetTablePageId(),false);
-            item_page = next_page;
-            if(item_page->GetFirstTupleRid(&next_row_id))
-                break;
-        }
+    // a snapshot may still see the rows marked deleted
+    bool with_deleted = table_heap_->ReadsSnapshot(txn_);
+    // the slots and the link to the next page are changed by writers under the page latch
+    item_page->RLatch();
+    bool found = item_page->GetNextTupleRid(row_id, &next_row_id, with_deleted);
+    page_id_t next_page_id = item_page->GetNextPageId();
+    item_page->RUnlatch();
+    while (!found && next_page_id != INVALID_PAGE_ID) {
+        if (read_ahead_ != nullptr)
+            read_ahead_->Advance(next_page_id);
+        TablePage * next_page=(TablePage *)buffer_pool_manager->FetchPage(next_page_id);
+        buffer_pool_manager->UnpinPage(item_page->GetTablePageId(),false);
+        item_page = next_page;
+        item_page->RLatch();
+        found = item_page->GetFirstTupleRid(&next_row_id, with_deleted);
+        next_page_id = item_page->GetNextPageId();
+        item_page->RUnlatch();
+    }
+    if (next_row_id.GetPageId() != INVALID_PAGE_ID) {
+        // the pin of the page is handed over to the new row
+        return ReadRow(item_page, next_row_id);
+    }
     row_->SetRowId(next_row_id);
-    if (*this != table_heap_->End())
-        table_heap_->GetTuple(row_, nullptr);
     buffer_pool_manager->UnpinPage(item_page->GetTablePageId(), false);
-    return *this;
+    return true;
 }
 
 TableIterator TableIterator::operator++(int) {
@@ -0,0 +1,163 @@
+#include "transaction/checkpoint_manager.h"
+
+#include <algorithm>
+
+void CheckpointData::SerializeTo(std::vector<char> &data) const {
+  data.resize(sizeof(lsn_t) + 2 * sizeof(uint64_t) + sizeof(txn_id_t) + sizeof(uint32_t) +
+              active_txns_.size() * (sizeof(txn_id_t) + sizeof(lsn_t) + sizeof(uint64_t)) + sizeof(uint32_t) +
+              dirty_pages_.size() * (sizeof(page_id_t) + sizeof(lsn_t)));
+  char *buf = data.data();
+  MACH_WRITE_INT32(buf, redo_lsn_);
+  buf += sizeof(lsn_t);
+  MACH_WRITE_TO(uint64_t, buf, redo_offset_);
+  buf += sizeof(uint64_t);
+  MACH_WRITE_TO(uint64_t, buf, undo_offset_);
+  buf += sizeof(uint64_t);
+  MACH_WRITE_INT32(buf, next_txn_id_);
+  buf += sizeof(txn_id_t);
+  MACH_WRITE_UINT32(buf, active_txns_.size());
+  buf += sizeof(uint32_t);
+  for (auto &txn : active_txns_) {
+    MACH_WRITE_INT32(buf, txn.txn_id_);
+    buf += sizeof(txn_id_t);
+    MACH_WRITE_INT32(buf, txn.last_lsn_);
+    buf += sizeof(lsn_t);
+    MACH_WRITE_TO(uint64_t, buf, txn.begin_offset_);
+    buf += sizeof(uint64_t);
+  }
+  MACH_WRITE_UINT32(buf, dirty_pages_.size());
+  buf += sizeof(uint32_t);
+  for (auto &page : dirty_pages_) {
+    MACH_WRITE_INT32(buf, page.first);
+    buf += sizeof(page_id_t);
+    MACH_WRITE_INT32(buf, page.second);
+    buf += sizeof(lsn_t);
+  }
+}
+
+bool CheckpointData::DeserializeFrom(const char *data, uint32_t size, CheckpointData *checkpoint) {
+  const char *end = data + size;
+  const size_t fixed_size = sizeof(lsn_t) + 2 * sizeof(uint64_t) + sizeof(txn_id_t) + sizeof(uint32_t);
+  if (size < fixed_size) {
+    return false;
+  }
+  checkpoint->redo_lsn_ = MACH_READ_INT32(data);
+  data += sizeof(lsn_t);
+  checkpoint->redo_offset_ = MACH_READ_FROM(uint64_t, data);
+  data += sizeof(uint64_t);
+  checkpoint->undo_offset_ = MACH_READ_FROM(uint64_t, data);
+  data += sizeof(uint64_t);
+  checkpoint->next_txn_id_ = MACH_READ_INT32(data);
+  data += sizeof(txn_id_t);
+  uint32_t txn_count = MACH_READ_UINT32(data);
+  data += sizeof(uint32_t);
+  const size_t txn_size = sizeof(txn_id_t) + sizeof(lsn_t) + sizeof(uint64_t);
+  if (static_cast<size_t>(end - data) < txn_count * txn_size + sizeof(uint32_t)) {
+    return false;
+  }
+  checkpoint->active_txns_.resize(txn_count);
+  for (auto &txn : checkpoint->active_txns_) {
+    txn.txn_id_ = MACH_READ_INT32(data);
+    data += sizeof(txn_id_t);
+    txn.last_lsn_ = MACH_READ_INT32(data);
+    data += sizeof(lsn_t);
+    txn.begin_offset_ = MACH_READ_FROM(uint64_t, data);
+    data += sizeof(uint64_t);
+  }
+  uint32_t page_count = MACH_READ_UINT32(data);
+  data += sizeof(uint32_t);
+  if (static_cast<size_t>(end - data) != page_count * (sizeof(page_id_t) + sizeof(lsn_t))) {
+    return false;
+  }
+  checkpoint->dirty_pages_.resize(page_count);
+  for (auto &page : checkpoint->dirty_pages_) {
+    page.first = MACH_READ_INT32(data);
+    data += sizeof(page_id_t);
+    page.second = MACH_READ_INT32(data);
+    data += sizeof(lsn_t);
+  }
+  return true;
+}
+
+CheckpointManager::CheckpointManager(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager,
+                                     LogManager *log_manager, TransactionManager *txn_manager)
+        : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), log_manager_(log_manager),
+          txn_manager_(txn_manager) {}
+
+CheckpointManager::~CheckpointManager() {
+  Stop();
+}
+
+void CheckpointManager::Checkpoint() {
+  std::scoped_lock<std::mutex> lock(checkpoint_latch_);
+  // recovery would have to redo them from before the previous checkpoint otherwise
+  buffer_pool_manager_->FlushPagesBefore(prev_begin_lsn_);
+  size_t begin_offset;
+  LogRecord begin_record(INVALID_TXN_ID, INVALID_LSN, LogRecordType::kCheckpointBegin);
+  lsn_t begin_lsn = log_manager_->AppendLogRecord(&begin_record, &begin_offset);
+  // the page allocations are only redone from the log from here on, a deallocation must not reach the disk
+  // before the change which unlinked the page
+  log_manager_->Flush(begin_lsn);
+  disk_manager_->FlushMetaData();
+
+  CheckpointData checkpoint;
+  checkpoint.next_txn_id_ = txn_manager_->GetNextTransactionId();
+  checkpoint.active_txns_ = txn_manager_->GetActiveTransactions();
+  buffer_pool_manager_->GetDirtyPageTable(checkpoint.dirty_pages_);
+  // the pages written since the begin record are not in the dirty page table any more
+  disk_manager_->Sync();
+  checkpoint.redo_lsn_ = begin_lsn;
+  for (auto &page : checkpoint.dirty_pages_) {
+    checkpoint.redo_lsn_ = std::min(checkpoint.redo_lsn_, page.second);
+  }
+  checkpoint.redo_offset_ = log_manager_->GetOffsetBefore(checkpoint.redo_lsn_);
+  checkpoint.undo_offset_ = begin_offset;
+  for (auto &txn : checkpoint.active_txns_) {
+    checkpoint.undo_offset_ = std::min(checkpoint.undo_offset_, txn.begin_offset_);
+  }
+  std::vector<char> data;
+  checkpoint.SerializeTo(data);
+  LogRecord end_record(LogRecordType::kCheckpointEnd, data.data(), data.size());
+  log_manager_->Flush(log_manager_->AppendLogRecord(&end_record));
+
+  disk_manager_->SetCheckpointOffset(begin_offset);
+  disk_manager_->FlushMetaData();
+  disk_manager_->Sync();
+  prev_begin_lsn_ = begin_lsn;
+  checkpoint_count_++;
+}
+
+void CheckpointManager::Start(std::chrono::milliseconds interval) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (checkpoint_thread_.joinable()) {
+    return;
+  }
+  stop_ = false;
+  checkpoint_thread_ = std::thread(&CheckpointManager::RunCheckpointThread, this, interval);
+}
+
+void CheckpointManager::Stop() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (!checkpoint_thread_.joinable()) {
+      return;
+    }
+    stop_ = true;
+  }
+  stop_cv_.notify_one();
+  checkpoint_thread_.join();
+}
+
+size_t CheckpointManager::GetCheckpointCount() {
+  std::scoped_lock<std::mutex> lock(checkpoint_latch_);
+  return checkpoint_count_;
+}
+
+void CheckpointManager::RunCheckpointThread(std::chrono::milliseconds interval) {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (!stop_cv_.wait_for(lock, interval, [this]() { return stop_; })) {
+    lock.unlock();
+    Checkpoint();
+    lock.lock();
+  }
+}
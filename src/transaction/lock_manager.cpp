@@ -0,0 +1,156 @@
+#include "transaction/lock_manager.h"
+
+LockManager::LockManager(size_t shard_count)
+        : shard_count_(std::max<size_t>(1, shard_count)), shards_(new Shard[shard_count_]) {}
+
+bool LockManager::LockShared(Transaction *txn, const RowId &rid) {
+  return Lock(txn, RowKey(rid), LockMode::kShared, true);
+}
+
+bool LockManager::LockExclusive(Transaction *txn, const RowId &rid, bool wait) {
+  return Lock(txn, RowKey(rid), LockMode::kExclusive, wait);
+}
+
+bool LockManager::LockTable(Transaction *txn, table_id_t table_id, LockMode mode) {
+  return Lock(txn, TableKey(table_id), mode, true);
+}
+
+void LockManager::Unlock(Transaction *txn, const RowId &rid) {
+  Unlock(txn, RowKey(rid));
+}
+
+void LockManager::ReleaseAll(Transaction *txn) {
+  auto &locks = txn->GetLocks();
+  while (!locks.empty()) {
+    Unlock(txn, locks.begin()->first);
+  }
+}
+
+bool LockManager::Compatible(LockMode a, LockMode b) {
+  if (a == LockMode::kExclusive || b == LockMode::kExclusive) {
+    return false;
+  }
+  if (a == LockMode::kIntentionShared || b == LockMode::kIntentionShared) {
+    return true;
+  }
+  // left are IX, S and SIX, only IX with IX or S with S go together
+  return a == b && a != LockMode::kSharedIntentionExclusive;
+}
+
+LockMode LockManager::Supremum(LockMode a, LockMode b) {
+  if (a == b || b == LockMode::kIntentionShared) {
+    return a;
+  }
+  if (a == LockMode::kIntentionShared) {
+    return b;
+  }
+  if (a == LockMode::kExclusive || b == LockMode::kExclusive) {
+    return LockMode::kExclusive;
+  }
+  // two of IX, S and SIX which differ
+  return LockMode::kSharedIntentionExclusive;
+}
+
+bool LockManager::Lock(Transaction *txn, uint64_t key, LockMode mode, bool wait) {
+  if (txn->GetState() == TransactionState::kAborted) {
+    return false;
+  }
+  auto &locks = txn->GetLocks();
+  auto held = locks.find(key);
+  bool upgrade = held != locks.end();
+  // only txn changes its own locks, so the lock it holds is read without the latch
+  if (upgrade && Supremum(held->second, mode) == held->second) {
+    return true;
+  }
+  LockMode target = upgrade ? Supremum(held->second, mode) : mode;
+  txn_id_t txn_id = txn->GetTransactionId();
+  Shard &shard = GetShard(key);
+  std::unique_lock<std::mutex> latch(shard.latch_);
+  LockQueue &queue = shard.queues_[key];
+  auto request = queue.requests_.end();
+  if (upgrade) {
+    for (auto it = queue.requests_.begin(); it != queue.requests_.end(); ++it) {
+      if (it->txn_id_ == txn_id) {
+        request = it;
+        break;
+      }
+    }
+    ASSERT(request != queue.requests_.end(), "Lock held by a transaction is not in its queue.");
+  } else {
+    request = queue.requests_.insert(queue.requests_.end(), LockRequest{txn_id, target, false});
+  }
+  bool waited = false;
+  while (true) {
+    // a new request also waits behind the earlier waiting ones, an upgrade only for the granted ones
+    bool conflict = false;
+    bool die = false;
+    for (auto it = queue.requests_.begin(); it != queue.requests_.end(); ++it) {
+      if (it == request) {
+        if (!upgrade) {
+          break;
+        }
+        continue;
+      }
+      if ((it->granted_ || !upgrade) && !Compatible(it->mode_, target)) {
+        conflict = true;
+        if (it->txn_id_ < txn_id) {
+          die = true;
+          break;
+        }
+      }
+    }
+    if (!conflict) {
+      request->mode_ = target;
+      request->granted_ = true;
+      locks[key] = target;
+      return true;
+    }
+    if (die || !wait) {
+      if (!upgrade) {
+        queue.requests_.erase(request);
+        if (queue.requests_.empty()) {
+          shard.queues_.erase(key);
+        } else {
+          // the requests behind this one may be granted now
+          queue.cv_.notify_all();
+        }
+      }
+      if (wait) {
+        txn->SetState(TransactionState::kAborted);
+        die_count_++;
+      }
+      return false;
+    }
+    if (!waited) {
+      waited = true;
+      wait_count_++;
+    }
+    queue.cv_.wait(latch);
+  }
+}
+
+void LockManager::Unlock(Transaction *txn, uint64_t key) {
+  auto &locks = txn->GetLocks();
+  if (locks.erase(key) == 0) {
+    return;
+  }
+  txn_id_t txn_id = txn->GetTransactionId();
+  Shard &shard = GetShard(key);
+  std::scoped_lock<std::mutex> latch(shard.latch_);
+  auto queue = shard.queues_.find(key);
+  if (queue == shard.queues_.end()) {
+    return;
+  }
+  auto &requests = queue->second.requests_;
+  for (auto it = requests.begin(); it != requests.end(); ++it) {
+    if (it->txn_id_ == txn_id) {
+      requests.erase(it);
+      break;
+    }
+  }
+  if (requests.empty()) {
+    shard.queues_.erase(queue);
+  } else {
+    queue->second.cv_.notify_all();
+  }
+}
@@ -0,0 +1,122 @@
+#include "transaction/log_manager.h"
+
+#include <algorithm>
+
+LogManager::LogManager(DiskManager *disk_manager, size_t buffer_size)
+        : disk_manager_(disk_manager), buffer_size_(buffer_size), log_buffer_(new char[buffer_size]),
+          flush_buffer_(new char[buffer_size]) {
+  lsn_offsets_.emplace_back(0, 0);
+  flush_thread_ = std::thread(&LogManager::RunFlushThread, this);
+}
+
+LogManager::~LogManager() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stop_ = true;
+  }
+  flush_cv_.notify_one();
+  flush_thread_.join();
+}
+
+lsn_t LogManager::AppendLogRecord(LogRecord *log_record, size_t *offset) {
+  std::unique_lock<std::mutex> lock(latch_);
+  uint32_t size = log_record->GetSize();
+  ASSERT(size <= buffer_size_, "Log record larger than the log buffer.");
+  while (log_buffer_offset_ + size > buffer_size_) {
+    flush_requested_ = true;
+    flush_cv_.notify_one();
+    flushed_cv_.wait(lock);
+  }
+  lsn_t lsn = next_lsn_.load();
+  log_record->SetLSN(lsn);
+  log_record->SerializeTo(log_buffer_.get() + log_buffer_offset_);
+  log_buffer_offset_ += size;
+  if (lsn % LSN_INDEX_STRIDE == 0) {
+    lsn_offsets_.emplace_back(lsn, next_offset_);
+  }
+  if (offset != nullptr) {
+    *offset = next_offset_;
+  }
+  next_offset_ += size;
+  next_lsn_.store(lsn + 1);
+  return lsn;
+}
+
+void LogManager::Flush(lsn_t lsn) {
+  std::unique_lock<std::mutex> lock(latch_);
+  // nothing beyond the last record can be waited for, e.g. for a page which was never logged
+  lsn = std::min(lsn, next_lsn_ - 1);
+  while (persistent_lsn_ < lsn) {
+    flush_requested_ = true;
+    flush_cv_.notify_one();
+    flushed_cv_.wait(lock);
+  }
+}
+
+size_t LogManager::GetOffsetBefore(lsn_t lsn) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto iter = std::upper_bound(lsn_offsets_.begin(), lsn_offsets_.end(), std::make_pair(lsn, SIZE_MAX));
+  // the first entry is the start of the log, or of the part appended since Restart
+  return iter == lsn_offsets_.begin() ? iter->second : std::prev(iter)->second;
+}
+
+bool LogManager::ReadLogRecord(size_t offset, std::vector<char> &buffer, LogRecord *log_record) {
+  buffer.resize(LogRecord::HEADER_SIZE);
+  if (disk_manager_->ReadLog(buffer.data(), LogRecord::HEADER_SIZE, offset) < LogRecord::HEADER_SIZE) {
+    return false;
+  }
+  uint32_t size = MACH_READ_UINT32(buffer.data());
+  if (size < LogRecord::HEADER_SIZE || size > buffer_size_) {
+    return false;
+  }
+  buffer.resize(size);
+  if (disk_manager_->ReadLog(buffer.data(), size, offset) < size) {
+    return false;
+  }
+  return LogRecord::DeserializeFrom(buffer.data(), size, log_record) == size;
+}
+
+void LogManager::Restart(lsn_t next_lsn, size_t offset) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  ASSERT(log_buffer_offset_ == 0 && next_offset_ == 0, "Records appended before restart.");
+  next_lsn_.store(next_lsn);
+  next_offset_ = offset;
+  persistent_lsn_ = next_lsn - 1;
+  lsn_offsets_.assign(1, std::make_pair(next_lsn, offset));
+}
+
+lsn_t LogManager::GetPersistentLSN() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return persistent_lsn_;
+}
+
+size_t LogManager::GetFlushCount() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return flush_count_;
+}
+
+void LogManager::RunFlushThread() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    flush_cv_.wait_for(lock, LOG_TIMEOUT, [this]() { return flush_requested_ || stop_; });
+    flush_requested_ = false;
+    if (log_buffer_offset_ == 0) {
+      if (stop_) {
+        break;
+      }
+      continue;
+    }
+    // appends go on in the other buffer meanwhile, the callers of Flush arriving now are served by the next write
+    std::swap(log_buffer_, flush_buffer_);
+    size_t size = log_buffer_offset_;
+    lsn_t lsn = next_lsn_ - 1;
+    log_buffer_offset_ = 0;
+    flushed_cv_.notify_all();
+    lock.unlock();
+    disk_manager_->WriteLog(flush_buffer_.get(), size);
+    lock.lock();
+    persistent_lsn_ = lsn;
+    flush_count_++;
+    flushed_cv_.notify_all();
+  }
+}
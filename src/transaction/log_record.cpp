@@ -0,0 +1,162 @@
+#include "transaction/log_record.h"
+
+#include <cstring>
+
+#include "common/macros.h"
+
+uint32_t LogRecord::SerializeTo(char *buf) const {
+  char *start = buf;
+  MACH_WRITE_UINT32(buf, size_);
+  MACH_WRITE_INT32(buf + 4, lsn_);
+  MACH_WRITE_INT32(buf + 8, txn_id_);
+  MACH_WRITE_INT32(buf + 12, prev_lsn_);
+  MACH_WRITE_UINT32(buf + 16, static_cast<uint32_t>(type_));
+  buf += HEADER_SIZE;
+  switch (type_) {
+    case LogRecordType::kInsert:
+    case LogRecordType::kMarkDelete:
+    case LogRecordType::kApplyDelete:
+    case LogRecordType::kRollbackDelete:
+    case LogRecordType::kUpdate:
+      MACH_WRITE_TO(int64_t, buf, rid_.Get());
+      buf += sizeof(int64_t);
+      MACH_WRITE_UINT32(buf, tuple_size_);
+      memcpy(buf + 4, tuple_, tuple_size_);
+      buf += 4 + tuple_size_;
+      if (type_ == LogRecordType::kUpdate) {
+        MACH_WRITE_UINT32(buf, new_tuple_size_);
+        memcpy(buf + 4, new_tuple_, new_tuple_size_);
+        buf += 4 + new_tuple_size_;
+      }
+      break;
+    case LogRecordType::kNewPage:
+      MACH_WRITE_INT32(buf, prev_page_id_);
+      MACH_WRITE_INT32(buf + 4, page_id_);
+      buf += 2 * sizeof(page_id_t);
+      break;
+    case LogRecordType::kAllocatePage:
+    case LogRecordType::kDeallocatePage:
+      MACH_WRITE_INT32(buf, page_id_);
+      buf += sizeof(page_id_t);
+      break;
+    case LogRecordType::kIndexInsert:
+    case LogRecordType::kIndexDelete:
+      MACH_WRITE_UINT32(buf, index_id_);
+      MACH_WRITE_TO(int64_t, buf + 4, rid_.Get());
+      MACH_WRITE_UINT32(buf + 12, tuple_size_);
+      memcpy(buf + 16, tuple_, tuple_size_);
+      buf += 16 + tuple_size_;
+      break;
+    case LogRecordType::kCLR:
+      MACH_WRITE_INT32(buf, undo_next_lsn_);
+      MACH_WRITE_UINT32(buf + 4, static_cast<uint32_t>(undone_type_));
+      MACH_WRITE_TO(int64_t, buf + 8, rid_.Get());
+      MACH_WRITE_UINT32(buf + 16, tuple_size_);
+      memcpy(buf + 20, tuple_, tuple_size_);
+      buf += 20 + tuple_size_;
+      break;
+    case LogRecordType::kPageWrite:
+    case LogRecordType::kCheckpointEnd:
+    case LogRecordType::kPagesFlushed:
+      memcpy(buf, tuple_, tuple_size_);
+      buf += tuple_size_;
+      break;
+    default:
+      break;
+  }
+  ASSERT(static_cast<uint32_t>(buf - start) == size_, "Unexpected log record size.");
+  return buf - start;
+}
+
+uint32_t LogRecord::DeserializeFrom(const char *buf, size_t size, LogRecord *log_record) {
+  if (size < HEADER_SIZE) {
+    return 0;
+  }
+  uint32_t record_size = MACH_READ_UINT32(buf);
+  auto type = static_cast<LogRecordType>(MACH_READ_UINT32(buf + 16));
+  // the log ends with a torn or zeroed record
+  if (record_size < HEADER_SIZE || record_size > size || type == LogRecordType::kInvalid ||
+      type > LogRecordType::kPagesFlushed) {
+    return 0;
+  }
+  *log_record = LogRecord();
+  log_record->size_ = record_size;
+  log_record->lsn_ = MACH_READ_INT32(buf + 4);
+  log_record->txn_id_ = MACH_READ_INT32(buf + 8);
+  log_record->prev_lsn_ = MACH_READ_INT32(buf + 12);
+  log_record->type_ = type;
+  const char *end = buf + record_size;
+  buf += HEADER_SIZE;
+  switch (type) {
+    case LogRecordType::kInsert:
+    case LogRecordType::kMarkDelete:
+    case LogRecordType::kApplyDelete:
+    case LogRecordType::kRollbackDelete:
+    case LogRecordType::kUpdate:
+      if (end - buf < static_cast<ptrdiff_t>(sizeof(int64_t) + 4)) {
+        return 0;
+      }
+      log_record->rid_ = RowId(MACH_READ_FROM(int64_t, buf));
+      buf += sizeof(int64_t);
+      log_record->tuple_size_ = MACH_READ_UINT32(buf);
+      log_record->tuple_ = buf + 4;
+      buf += 4 + log_record->tuple_size_;
+      if (type == LogRecordType::kUpdate) {
+        if (end - buf < 4) {
+          return 0;
+        }
+        log_record->new_tuple_size_ = MACH_READ_UINT32(buf);
+        log_record->new_tuple_ = buf + 4;
+        buf += 4 + log_record->new_tuple_size_;
+      }
+      break;
+    case LogRecordType::kNewPage:
+      if (end - buf < static_cast<ptrdiff_t>(2 * sizeof(page_id_t))) {
+        return 0;
+      }
+      log_record->prev_page_id_ = MACH_READ_INT32(buf);
+      log_record->page_id_ = MACH_READ_INT32(buf + 4);
+      buf += 2 * sizeof(page_id_t);
+      break;
+    case LogRecordType::kAllocatePage:
+    case LogRecordType::kDeallocatePage:
+      if (end - buf < static_cast<ptrdiff_t>(sizeof(page_id_t))) {
+        return 0;
+      }
+      log_record->page_id_ = MACH_READ_INT32(buf);
+      buf += sizeof(page_id_t);
+      break;
+    case LogRecordType::kIndexInsert:
+    case LogRecordType::kIndexDelete:
+      if (end - buf < 16) {
+        return 0;
+      }
+      log_record->index_id_ = MACH_READ_UINT32(buf);
+      log_record->rid_ = RowId(MACH_READ_FROM(int64_t, buf + 4));
+      log_record->tuple_size_ = MACH_READ_UINT32(buf + 12);
+      log_record->tuple_ = buf + 16;
+      buf += 16 + log_record->tuple_size_;
+      break;
+    case LogRecordType::kCLR:
+      if (end - buf < 20) {
+        return 0;
+      }
+      log_record->undo_next_lsn_ = MACH_READ_INT32(buf);
+      log_record->undone_type_ = static_cast<LogRecordType>(MACH_READ_UINT32(buf + 4));
+      log_record->rid_ = RowId(MACH_READ_FROM(int64_t, buf + 8));
+      log_record->tuple_size_ = MACH_READ_UINT32(buf + 16);
+      log_record->tuple_ = buf + 20;
+      buf += 20 + log_record->tuple_size_;
+      break;
+    case LogRecordType::kPageWrite:
+    case LogRecordType::kCheckpointEnd:
+    case LogRecordType::kPagesFlushed:
+      log_record->tuple_size_ = record_size - HEADER_SIZE;
+      log_record->tuple_ = buf;
+      buf = end;
+      break;
+    default:
+      break;
+  }
+  return buf == end ? record_size : 0;
+}
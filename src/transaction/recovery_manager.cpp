@@ -0,0 +1,384 @@
+#include "transaction/recovery_manager.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "buffer/page_log_scope.h"
+#include "glog/logging.h"
+#include "page/table_page.h"
+
+RecoveryManager::RecoveryManager(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager,
+                                 LogManager *log_manager, size_t redo_workers)
+        : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), log_manager_(log_manager),
+          redo_workers_(redo_workers) {
+  if (redo_workers_ == 0) {
+    redo_workers_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+}
+
+RecoveryManager::~RecoveryManager() {
+  WaitBatch();
+}
+
+void RecoveryManager::Redo() {
+  // analysis
+  size_t checkpoint_offset = disk_manager_->GetCheckpointOffset();
+  redo_offset_ = checkpoint_offset;
+  lsn_t next_lsn = INVALID_LSN;
+  size_t end_offset = ScanLog(checkpoint_offset, [&](const LogRecord &log_record, const char *, size_t offset) {
+    // LSNs are consecutive, anything else is not part of the log
+    if (next_lsn != INVALID_LSN && log_record.GetLSN() != next_lsn) {
+      return false;
+    }
+    next_lsn = log_record.GetLSN() + 1;
+    Analyze(log_record, offset);
+    return true;
+  });
+  if (next_lsn == INVALID_LSN) {
+    ASSERT(checkpoint_offset == 0, "Checkpoint beyond the end of the log.");
+    next_lsn = 0;
+  }
+  if (end_offset < disk_manager_->GetLogSize()) {
+    LOG(WARNING) << "Cut off " << disk_manager_->GetLogSize() - end_offset << " bytes of a torn log record";
+    disk_manager_->TruncateLog(end_offset);
+  }
+  log_manager_->Restart(next_lsn, end_offset);
+
+  // redo, from where both the dirty pages and the records of the losers are read
+  if (redo_floor_ > redo_lsn_) {
+    redo_offset_ = redo_floor_offset_;
+  }
+  size_t offset = redo_offset_;
+  for (auto &loser : losers_) {
+    offset = std::min(offset, loser.second.begin_offset_);
+  }
+  auto batch = std::make_unique<RedoBatch>();
+  ScanLog(offset, [&](const LogRecord &log_record, const char *data, size_t record_offset) {
+    if (log_record.GetLSN() >= next_lsn) {
+      return false;
+    }
+    redo_record_count_++;
+    auto loser = losers_.find(log_record.GetTxnId());
+    if (loser != losers_.end()) {
+      loser->second.records_.emplace_back(log_record.GetLSN(), record_offset);
+    }
+    // the bitmaps are redone from wherever redo starts, replaying them in order gives their last state
+    if (log_record.GetType() == LogRecordType::kAllocatePage) {
+      disk_manager_->AllocatePageAt(log_record.GetPageId());
+    } else if (log_record.GetType() == LogRecordType::kDeallocatePage &&
+               !disk_manager_->IsPageFree(log_record.GetPageId())) {
+      disk_manager_->DeAllocatePage(log_record.GetPageId());
+    }
+    batch->data_.insert(batch->data_.end(), data, data + log_record.GetSize());
+    if (batch->data_.size() >= REDO_BATCH_SIZE) {
+      DispatchBatch(std::move(batch));
+      batch = std::make_unique<RedoBatch>();
+    }
+    return true;
+  });
+  DispatchBatch(std::move(batch));
+  WaitBatch();
+}
+
+void RecoveryManager::Undo(TransactionManager *txn_manager, CheckpointManager *checkpoint_manager) {
+  txn_manager->SetNextTransactionId(next_txn_id_);
+  std::vector<Transaction *> txns;
+  for (auto &loser : losers_) {
+    Transaction *txn = txn_manager->Resume(loser.first, loser.second.begin_offset_);
+    for (auto &record : loser.second.records_) {
+      txn->AddLogRecord(record.first, record.second);
+    }
+    txns.push_back(txn);
+  }
+  if (!txns.empty()) {
+    LOG(INFO) << "Rolling back " << txns.size() << " transactions active at the crash";
+  }
+  txn_manager->AbortAll(txns);
+  losers_.clear();
+  // the pages redone are written, so that the next recovery starts from here
+  buffer_pool_manager_->FlushAllPages();
+  checkpoint_manager->Checkpoint();
+}
+
+size_t RecoveryManager::ScanLog(size_t offset,
+                                const std::function<bool(const LogRecord &, const char *, size_t)> &callback) {
+  std::vector<char> buffer(SCAN_BUFFER_SIZE);
+  // offset in the log file of the first byte in buffer, and the bytes read and consumed from it
+  size_t buffer_offset = offset;
+  size_t size = 0;
+  size_t pos = 0;
+  LogRecord log_record;
+  while (true) {
+    uint32_t read_size = LogRecord::DeserializeFrom(buffer.data() + pos, size - pos, &log_record);
+    if (read_size > 0) {
+      if (!callback(log_record, buffer.data() + pos, buffer_offset + pos)) {
+        break;
+      }
+      pos += read_size;
+      continue;
+    }
+    // the next record is incomplete in the buffer, the rest of it is read behind the part left
+    size_t left = size - pos;
+    if (left >= sizeof(uint32_t)) {
+      uint32_t record_size = MACH_READ_UINT32(buffer.data() + pos);
+      if (record_size > buffer.size() && record_size <= std::max(SCAN_BUFFER_SIZE, DEFAULT_LOG_BUFFER_SIZE)) {
+        buffer.resize(record_size);
+      }
+    }
+    memmove(buffer.data(), buffer.data() + pos, left);
+    buffer_offset += pos;
+    pos = 0;
+    size_t read_count = disk_manager_->ReadLog(buffer.data() + left, buffer.size() - left, buffer_offset + left);
+    if (read_count == 0) {
+      // the end of the log, or a record which is not complete or not valid
+      size = left;
+      break;
+    }
+    size = left + read_count;
+  }
+  return buffer_offset + pos;
+}
+
+void RecoveryManager::Analyze(const LogRecord &log_record, size_t offset) {
+  txn_id_t txn_id = log_record.GetTxnId();
+  if (txn_id != INVALID_TXN_ID) {
+    next_txn_id_ = std::max(next_txn_id_, txn_id + 1);
+  }
+  lsn_t lsn = log_record.GetLSN();
+  switch (log_record.GetType()) {
+    case LogRecordType::kBegin:
+      losers_[txn_id].begin_offset_ = offset;
+      break;
+    case LogRecordType::kCommit:
+    case LogRecordType::kAbort:
+      losers_.erase(txn_id);
+      ended_txns_.insert(txn_id);
+      break;
+    case LogRecordType::kCheckpointEnd: {
+      CheckpointData checkpoint;
+      // a later checkpoint, which did not get to record its offset, tells nothing new
+      if (checkpoint_read_ ||
+          !CheckpointData::DeserializeFrom(log_record.GetData(), log_record.GetDataSize(), &checkpoint)) {
+        break;
+      }
+      checkpoint_read_ = true;
+      redo_lsn_ = checkpoint.redo_lsn_;
+      redo_offset_ = checkpoint.redo_offset_;
+      next_txn_id_ = std::max(next_txn_id_, checkpoint.next_txn_id_);
+      for (auto &txn : checkpoint.active_txns_) {
+        if (ended_txns_.count(txn.txn_id_) == 0 && losers_.count(txn.txn_id_) == 0) {
+          losers_[txn.txn_id_].begin_offset_ = txn.begin_offset_;
+        }
+      }
+      for (auto &page : checkpoint.dirty_pages_) {
+        AddDirtyPage(page.first, page.second);
+      }
+      break;
+    }
+    case LogRecordType::kPagesFlushed: {
+      lsn_t redo_lsn = MACH_READ_INT32(log_record.GetData());
+      if (redo_lsn > redo_floor_) {
+        redo_floor_ = redo_lsn;
+        redo_floor_offset_ = MACH_READ_FROM(uint64_t, log_record.GetData() + sizeof(lsn_t));
+      }
+      break;
+    }
+    default: {
+      std::vector<page_id_t> pages;
+      GetChangedPages(log_record, pages);
+      for (auto page_id : pages) {
+        AddDirtyPage(page_id, lsn);
+      }
+      break;
+    }
+  }
+}
+
+void RecoveryManager::DispatchBatch(std::unique_ptr<RedoBatch> batch) {
+  const char *data = batch->data_.data();
+  const char *end = data + batch->data_.size();
+  while (data < end) {
+    batch->records_.emplace_back();
+    data += LogRecord::DeserializeFrom(data, end - data, &batch->records_.back());
+  }
+  batch->changes_.resize(redo_workers_);
+  // the pages are prefetched in the order the workers get to them, as far as the read ahead window goes
+  std::unordered_set<page_id_t> prefetched;
+  std::vector<page_id_t> pages;
+  for (auto &log_record : batch->records_) {
+    pages.clear();
+    GetChangedPages(log_record, pages);
+    for (auto page_id : pages) {
+      if (!MayNeedRedo(page_id, log_record.GetLSN())) {
+        continue;
+      }
+      batch->changes_[page_id % redo_workers_].emplace_back(&log_record, page_id);
+      if (prefetched.size() < buffer_pool_manager_->GetReadAheadWindow() && prefetched.insert(page_id).second) {
+        buffer_pool_manager_->PrefetchPage(page_id);
+      }
+    }
+  }
+  WaitBatch();
+  running_batch_ = std::move(batch);
+  for (auto &changes : running_batch_->changes_) {
+    if (changes.empty()) {
+      continue;
+    }
+    workers_.emplace_back([this, &changes]() {
+      for (auto &change : changes) {
+        RedoPage(*change.first, change.second);
+      }
+    });
+  }
+}
+
+void RecoveryManager::WaitBatch() {
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  running_batch_.reset();
+}
+
+void RecoveryManager::RedoPage(const LogRecord &log_record, page_id_t page_id) {
+  const RowId &rid = log_record.GetRowId();
+  switch (log_record.GetType()) {
+    case LogRecordType::kAllocatePage: {
+      // the page may hold what was there before it was freed, the changes after the allocation are redone
+      Page *page = buffer_pool_manager_->FetchPage(page_id);
+      memset(page->GetData(), 0, PAGE_SIZE);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      redone_count_++;
+      break;
+    }
+    case LogRecordType::kPageWrite:
+      for (auto &page_write : PageLogScope::ParsePageWrite(log_record.GetData(), log_record.GetDataSize())) {
+        if (page_write.page_id_ != page_id) {
+          continue;
+        }
+        // the ranges are the content of the page as of the record, applying them again changes nothing
+        Page *page = buffer_pool_manager_->FetchPage(page_id);
+        PageLogScope::ApplyPageWrite(page_write, page->GetData());
+        buffer_pool_manager_->UnpinPage(page_id, true);
+        redone_count_++;
+      }
+      break;
+    case LogRecordType::kNewPage:
+      if (page_id == log_record.GetPageId()) {
+        RedoTablePage(page_id, log_record, [&](TablePage *page) {
+          page->Init(log_record.GetPageId(), log_record.GetPrevPageId(), nullptr, nullptr);
+        });
+      } else {
+        RedoTablePage(page_id, log_record, [&](TablePage *page) { page->SetNextPageId(log_record.GetPageId()); });
+      }
+      break;
+    case LogRecordType::kInsert:
+      RedoTablePage(page_id, log_record, [&](TablePage *page) {
+        RowId inserted_rid;
+        if (!page->InsertTuple(log_record.GetTuple(), log_record.GetTupleSize(), &inserted_rid) ||
+            inserted_rid.Get() != rid.Get()) {
+          LOG(ERROR) << "Redo of insert " << log_record.GetLSN() << " did not insert at " << rid.GetPageId() << ":"
+                     << rid.GetSlotNum();
+        }
+      });
+      break;
+    case LogRecordType::kMarkDelete:
+      RedoTablePage(page_id, log_record, [&](TablePage *page) { page->MarkDelete(rid, nullptr, nullptr, nullptr); });
+      break;
+    case LogRecordType::kApplyDelete:
+      RedoTablePage(page_id, log_record, [&](TablePage *page) { page->ApplyDelete(rid, nullptr, nullptr); });
+      break;
+    case LogRecordType::kRollbackDelete:
+      RedoTablePage(page_id, log_record, [&](TablePage *page) { page->RollbackDelete(rid, nullptr, nullptr); });
+      break;
+    case LogRecordType::kUpdate:
+      RedoTablePage(page_id, log_record, [&](TablePage *page) {
+        page->UpdateTuple(rid, log_record.GetNewTuple(), log_record.GetNewTupleSize());
+      });
+      break;
+    case LogRecordType::kCLR:
+      switch (log_record.GetUndoneType()) {
+        case LogRecordType::kApplyDelete:
+          RedoTablePage(page_id, log_record, [&](TablePage *page) { page->ApplyDelete(rid, nullptr, nullptr); });
+          break;
+        case LogRecordType::kRollbackDelete:
+          RedoTablePage(page_id, log_record, [&](TablePage *page) { page->RollbackDelete(rid, nullptr, nullptr); });
+          break;
+        case LogRecordType::kUpdate:
+          RedoTablePage(page_id, log_record, [&](TablePage *page) {
+            page->UpdateTuple(rid, log_record.GetTuple(), log_record.GetTupleSize());
+          });
+          break;
+        default:
+          break;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void RecoveryManager::RedoTablePage(page_id_t page_id, const LogRecord &log_record,
+                                    const std::function<void(TablePage *)> &redo) {
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    LOG(ERROR) << "Can not fetch page " << page_id << " to redo " << log_record.GetLSN();
+    return;
+  }
+  // the LSN of a page allocated again is 0, no table change has LSN 0
+  if (page->GetLSN() >= log_record.GetLSN()) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return;
+  }
+  redo(page);
+  page->SetLSN(log_record.GetLSN());
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  redone_count_++;
+}
+
+bool RecoveryManager::MayNeedRedo(page_id_t page_id, lsn_t lsn) const {
+  auto page = dirty_pages_.find(page_id);
+  return page != dirty_pages_.end() && lsn >= page->second && lsn >= redo_floor_;
+}
+
+void RecoveryManager::AddDirtyPage(page_id_t page_id, lsn_t lsn) {
+  auto page = dirty_pages_.emplace(page_id, lsn);
+  if (!page.second) {
+    page.first->second = std::min(page.first->second, lsn);
+  }
+}
+
+void RecoveryManager::GetChangedPages(const LogRecord &log_record, std::vector<page_id_t> &pages) {
+  switch (log_record.GetType()) {
+    case LogRecordType::kAllocatePage:
+      pages.push_back(log_record.GetPageId());
+      break;
+    case LogRecordType::kPageWrite:
+      for (auto &page_write : PageLogScope::ParsePageWrite(log_record.GetData(), log_record.GetDataSize())) {
+        pages.push_back(page_write.page_id_);
+      }
+      break;
+    case LogRecordType::kNewPage:
+      pages.push_back(log_record.GetPageId());
+      if (log_record.GetPrevPageId() != INVALID_PAGE_ID) {
+        pages.push_back(log_record.GetPrevPageId());
+      }
+      break;
+    case LogRecordType::kInsert:
+    case LogRecordType::kMarkDelete:
+    case LogRecordType::kApplyDelete:
+    case LogRecordType::kRollbackDelete:
+    case LogRecordType::kUpdate:
+      pages.push_back(log_record.GetRowId().GetPageId());
+      break;
+    case LogRecordType::kCLR:
+      // an undone index change is in page writes
+      if (log_record.GetUndoneType() != LogRecordType::kIndexInsert &&
+          log_record.GetUndoneType() != LogRecordType::kIndexDelete) {
+        pages.push_back(log_record.GetRowId().GetPageId());
+      }
+      break;
+    default:
+      break;
+  }
+}
@@ -0,0 +1,249 @@
+#include "transaction/transaction_manager.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "catalog/catalog.h"
+#include "glog/logging.h"
+#include "page/table_page.h"
+
+TransactionManager::TransactionManager(CatalogManager *catalog, BufferPoolManager *buffer_pool_manager,
+                                       LogManager *log_manager, LockManager *lock_manager,
+                                       VersionManager *version_manager)
+        : catalog_(catalog),
+          buffer_pool_manager_(buffer_pool_manager),
+          log_manager_(log_manager),
+          lock_manager_(lock_manager),
+          version_manager_(version_manager) {}
+
+TransactionManager::~TransactionManager() {
+  for (auto &txn : txn_map_) {
+    delete txn.second;
+  }
+}
+
+Transaction *TransactionManager::Begin(IsolationLevel isolation_level, bool read_only) {
+  auto txn = new Transaction(next_txn_id_++);
+  txn->SetIsolationLevel(isolation_level);
+  txn->SetReadOnly(read_only);
+  if (version_manager_ != nullptr && isolation_level == IsolationLevel::kSnapshot) {
+    version_manager_->BeginSnapshot(txn);
+  }
+  if (read_only) {
+    return txn;
+  }
+  size_t offset = 0;
+  // a checkpoint which begins after the begin record lists the transaction as active
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (log_manager_ != nullptr) {
+    LogRecord log_record(txn->GetTransactionId(), INVALID_LSN, LogRecordType::kBegin);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&log_record, &offset));
+  }
+  txn_map_.emplace(txn->GetTransactionId(), txn);
+  begin_offsets_.emplace(txn->GetTransactionId(), offset);
+  return txn;
+}
+
+void TransactionManager::Commit(Transaction *txn) {
+  if (txn->IsReadOnly()) {
+    EndReadOnly(txn);
+    return;
+  }
+  lsn_t lsn = INVALID_LSN;
+  {
+    // a checkpoint which begins after the commit record does not list the transaction as active
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (log_manager_ != nullptr) {
+      LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::kCommit);
+      lsn = log_manager_->AppendLogRecord(&log_record);
+    }
+    txn_map_.erase(txn->GetTransactionId());
+    begin_offsets_.erase(txn->GetTransactionId());
+  }
+  if (log_manager_ != nullptr) {
+    log_manager_->Flush(lsn);
+  }
+  // the changes of txn are seen by the snapshots taken from now on, before another writer can lock its rows
+  if (version_manager_ != nullptr) {
+    version_manager_->Commit(txn);
+  }
+  // a transaction waiting for a row deleted by txn finds it marked deleted, or gone
+  if (lock_manager_ != nullptr) {
+    lock_manager_->ReleaseAll(txn);
+  }
+  // a crash before this leaves the rows marked deleted, which no one reads any more
+  if (version_manager_ != nullptr) {
+    version_manager_->ApplyDeletes(txn);
+  } else {
+    for (auto &row : txn->GetDeletedRows()) {
+      row.first->ApplyDelete(row.second, nullptr);
+    }
+  }
+  delete txn;
+}
+
+void TransactionManager::Abort(Transaction *txn) {
+  if (txn->IsReadOnly()) {
+    EndReadOnly(txn);
+    return;
+  }
+  AbortAll({txn});
+}
+
+void TransactionManager::AbortAll(const std::vector<Transaction *> &txns) {
+  if (log_manager_ != nullptr) {
+    struct Change {
+      lsn_t lsn_;
+      size_t offset_;
+      Transaction *txn_;
+    };
+    std::vector<Change> changes;
+    // the record to undo next of every transaction, the records after it are undone already
+    std::unordered_map<Transaction *, lsn_t> undo_next;
+    for (auto txn : txns) {
+      for (auto &record : txn->GetLogRecords()) {
+        changes.push_back(Change{record.first, record.second, txn});
+      }
+      undo_next[txn] = INT32_MAX;
+    }
+    std::sort(changes.begin(), changes.end(), [](const Change &a, const Change &b) { return a.lsn_ > b.lsn_; });
+    // the records are read back from disk
+    log_manager_->Flush(INT32_MAX);
+    std::vector<char> buffer;
+    LogRecord log_record;
+    for (auto &change : changes) {
+      lsn_t &next = undo_next[change.txn_];
+      if (change.lsn_ > next) {
+        continue;
+      }
+      if (!log_manager_->ReadLogRecord(change.offset_, buffer, &log_record) || log_record.GetLSN() != change.lsn_) {
+        LOG(ERROR) << "Can not read log record " << change.lsn_ << " of transaction "
+                   << change.txn_->GetTransactionId();
+        continue;
+      }
+      if (log_record.GetType() == LogRecordType::kCLR) {
+        next = log_record.GetUndoNextLSN();
+        continue;
+      }
+      if (log_record.IsUndoable()) {
+        Undo(log_record, change.txn_);
+      }
+      next = log_record.GetPrevLSN();
+    }
+  }
+  for (auto txn : txns) {
+    // the versions kept go once every change is undone, a snapshot reads them until then
+    if (version_manager_ != nullptr) {
+      version_manager_->Abort(txn);
+    }
+    End(txn, LogRecordType::kAbort);
+  }
+}
+
+Transaction *TransactionManager::Resume(txn_id_t txn_id, size_t begin_offset) {
+  auto txn = new Transaction(txn_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  txn_map_.emplace(txn_id, txn);
+  begin_offsets_.emplace(txn_id, begin_offset);
+  return txn;
+}
+
+void TransactionManager::SetNextTransactionId(txn_id_t txn_id) {
+  next_txn_id_ = txn_id;
+}
+
+std::vector<ActiveTransaction> TransactionManager::GetActiveTransactions() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<ActiveTransaction> txns;
+  for (auto &txn : txn_map_) {
+    txns.push_back(ActiveTransaction{txn.first, txn.second->GetPrevLSN(), begin_offsets_[txn.first]});
+  }
+  return txns;
+}
+
+void TransactionManager::Undo(const LogRecord &log_record, Transaction *txn) {
+  LogRecordType type = log_record.GetType();
+  const RowId &rid = log_record.GetRowId();
+  if (type == LogRecordType::kIndexInsert || type == LogRecordType::kIndexDelete) {
+    IndexInfo *index_info = nullptr;
+    // an index dropped meanwhile has nothing left to undo
+    if (catalog_->GetIndex(log_record.GetIndexId(), index_info) == DB_SUCCESS) {
+      Row key(rid);
+      key.DeserializeFrom(const_cast<char *>(log_record.GetKey()), index_info->GetIndexKeySchema());
+      if (type == LogRecordType::kIndexInsert) {
+        index_info->GetIndex()->RemoveEntry(key, rid, nullptr);
+      } else {
+        index_info->GetIndex()->InsertEntry(key, rid, nullptr);
+      }
+    }
+    // the pages of the index are logged by page writes, so the compensation has nothing to redo
+    LogRecord clr(txn->GetTransactionId(), txn->GetPrevLSN(), log_record.GetPrevLSN(), type, rid, nullptr, 0);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&clr));
+    return;
+  }
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    LOG(ERROR) << "Can not fetch page " << rid.GetPageId() << " to roll back transaction "
+               << txn->GetTransactionId();
+    return;
+  }
+  page->WLatch();
+  LogRecordType undone_type = LogRecordType::kInvalid;
+  const char *tuple = nullptr;
+  uint32_t tuple_size = 0;
+  switch (type) {
+    case LogRecordType::kInsert:
+      page->ApplyDelete(rid, nullptr, nullptr);
+      // unlocked before the slot can be taken by another insert, which locks it under the latch
+      if (lock_manager_ != nullptr) {
+        lock_manager_->Unlock(txn, rid);
+      }
+      if (version_manager_ != nullptr) {
+        version_manager_->Rollback(txn, rid);
+      }
+      undone_type = LogRecordType::kApplyDelete;
+      break;
+    case LogRecordType::kMarkDelete:
+      page->RollbackDelete(rid, nullptr, nullptr);
+      undone_type = LogRecordType::kRollbackDelete;
+      break;
+    case LogRecordType::kUpdate:
+      tuple = log_record.GetTuple();
+      tuple_size = log_record.GetTupleSize();
+      if (!page->UpdateTuple(rid, tuple, tuple_size)) {
+        LOG(ERROR) << "No room to roll back the update of " << rid.GetPageId() << ":" << rid.GetSlotNum();
+      }
+      undone_type = LogRecordType::kUpdate;
+      break;
+    default:
+      break;
+  }
+  LogRecord clr(txn->GetTransactionId(), txn->GetPrevLSN(), log_record.GetPrevLSN(), undone_type, rid, tuple,
+                tuple_size);
+  lsn_t lsn = log_manager_->AppendLogRecord(&clr);
+  page->SetLSN(lsn);
+  txn->SetPrevLSN(lsn);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+}
+
+void TransactionManager::EndReadOnly(Transaction *txn) {
+  if (version_manager_ != nullptr) {
+    version_manager_->EndSnapshot(txn);
+  }
+  delete txn;
+}
+
+void TransactionManager::End(Transaction *txn, LogRecordType type) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (log_manager_ != nullptr) {
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), type);
+    log_manager_->AppendLogRecord(&log_record);
+  }
+  txn_map_.erase(txn->GetTransactionId());
+  begin_offsets_.erase(txn->GetTransactionId());
+  if (lock_manager_ != nullptr) {
+    lock_manager_->ReleaseAll(txn);
+  }
+  delete txn;
+}
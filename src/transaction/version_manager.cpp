@@ -0,0 +1,326 @@
+#include "transaction/version_manager.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "storage/table_heap.h"
+
+VersionManager::VersionManager(size_t shard_count)
+        : shard_count_(std::max<size_t>(1, shard_count)), shards_(new Shard[shard_count_]) {}
+
+VersionManager::~VersionManager() {
+  Stop();
+}
+
+void VersionManager::BeginSnapshot(Transaction *txn) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  txn->SetReadTs(clock_);
+  snapshots_[clock_]++;
+  snapshot_txns_.emplace(txn->GetTransactionId(), clock_);
+}
+
+bool VersionManager::RecordWrite(TableHeap *table, const RowId &rid, Transaction *txn, const char *tuple,
+                                 uint32_t tuple_size, bool exists) {
+  Shard &shard = GetShard(rid);
+  std::scoped_lock<std::mutex> shard_lock(shard.latch_);
+  auto inserted = shard.chains_.try_emplace(rid.Get());
+  VersionChain &chain = inserted.first->second;
+  if (inserted.second) {
+    // without a chain the row in the page is seen by every snapshot
+    chain.table_ = table;
+    chain_count_++;
+  } else if (tuple != nullptr && chain.writer_ != txn->GetTransactionId()) {
+    // the chain of a new row is of the row deleted from its slot, which every snapshot sees gone
+    bool visible = true;
+    if (chain.writer_ != INVALID_TXN_ID) {
+      // the writer has committed and is stamping its versions, else its lock would still be held
+      std::scoped_lock<std::mutex> lock(latch_);
+      auto committing = committing_.find(chain.writer_);
+      if (committing == committing_.end()) {
+        visible = false;
+      } else {
+        chain.writer_ = INVALID_TXN_ID;
+        chain.begin_ts_ = committing->second;
+      }
+    }
+    if (visible && txn->GetIsolationLevel() == IsolationLevel::kSnapshot) {
+      visible = chain.begin_ts_ <= txn->GetReadTs();
+    }
+    if (!visible) {
+      txn->SetState(TransactionState::kAborted);
+      return false;
+    }
+  }
+  if (chain.writer_ != txn->GetTransactionId()) {
+    Version version{chain.begin_ts_, tuple != nullptr, {}};
+    if (tuple != nullptr) {
+      version.tuple_.assign(tuple, tuple + tuple_size);
+    }
+    chain.older_.push_front(std::move(version));
+    chain.writer_ = txn->GetTransactionId();
+    version_count_++;
+    txn->AddWrittenRow(rid);
+  }
+  chain.exists_ = exists;
+  if (tuple != nullptr && !exists) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    table_deletes_[table].deleters_.insert(txn->GetTransactionId());
+  }
+  return true;
+}
+
+Visibility VersionManager::GetVisibleVersion(const RowId &rid, Transaction *txn, std::vector<char> *tuple) {
+  if (chain_count_.load() == 0) {
+    return Visibility::kCurrent;
+  }
+  Shard &shard = GetShard(rid);
+  std::scoped_lock<std::mutex> shard_lock(shard.latch_);
+  auto it = shard.chains_.find(rid.Get());
+  if (it == shard.chains_.end()) {
+    return Visibility::kCurrent;
+  }
+  VersionChain &chain = it->second;
+  if (chain.writer_ == txn->GetTransactionId()) {
+    return Visibility::kCurrent;
+  }
+  timestamp_t begin_ts = chain.begin_ts_;
+  if (chain.writer_ != INVALID_TXN_ID) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto committing = committing_.find(chain.writer_);
+    begin_ts = committing == committing_.end() ? std::numeric_limits<timestamp_t>::max() : committing->second;
+  }
+  if (begin_ts <= txn->GetReadTs()) {
+    return Visibility::kCurrent;
+  }
+  for (auto &version : chain.older_) {
+    if (version.begin_ts_ <= txn->GetReadTs()) {
+      if (!version.exists_) {
+        return Visibility::kNone;
+      }
+      *tuple = version.tuple_;
+      return Visibility::kOlder;
+    }
+  }
+  return Visibility::kNone;
+}
+
+void VersionManager::Commit(Transaction *txn) {
+  txn_id_t txn_id = txn->GetTransactionId();
+  timestamp_t commit_ts;
+  timestamp_t oldest;
+  {
+    // a snapshot taken from here on sees the changes of txn
+    std::scoped_lock<std::mutex> lock(latch_);
+    commit_ts = ++clock_;
+    committing_.emplace(txn_id, commit_ts);
+    RemoveSnapshot(txn);
+    for (auto &table : table_deletes_) {
+      if (table.second.deleters_.erase(txn_id) > 0) {
+        table.second.last_commit_ts_ = commit_ts;
+      }
+    }
+    oldest = OldestSnapshot();
+  }
+  txn->SetCommitTs(commit_ts);
+  for (auto &rid : txn->GetWrittenRows()) {
+    Shard &shard = GetShard(rid);
+    std::scoped_lock<std::mutex> shard_lock(shard.latch_);
+    auto it = shard.chains_.find(rid.Get());
+    if (it == shard.chains_.end() || it->second.writer_ != txn_id) {
+      continue;
+    }
+    it->second.writer_ = INVALID_TXN_ID;
+    it->second.begin_ts_ = commit_ts;
+    // no snapshot reads an older version, the rows deleted are removed by ApplyDeletes
+    if (commit_ts <= oldest && it->second.exists_) {
+      EraseChain(shard, it);
+    }
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  committing_.erase(txn_id);
+}
+
+void VersionManager::ApplyDeletes(Transaction *txn) {
+  if (txn->GetCommitTs() > GetOldestSnapshot()) {
+    return;
+  }
+  apply_latch_.RLock();
+  for (auto &row : txn->GetDeletedRows()) {
+    bool apply = false;
+    {
+      Shard &shard = GetShard(row.second);
+      std::scoped_lock<std::mutex> shard_lock(shard.latch_);
+      auto it = shard.chains_.find(row.second.Get());
+      // the garbage collection which erased the chain removes the row
+      if (it != shard.chains_.end() && it->second.writer_ == INVALID_TXN_ID && !it->second.exists_) {
+        EraseChain(shard, it);
+        apply = true;
+      }
+    }
+    if (apply) {
+      row.first->ApplyDelete(row.second, nullptr);
+    }
+  }
+  apply_latch_.RUnlock();
+}
+
+void VersionManager::Rollback(Transaction *txn, const RowId &rid) {
+  Shard &shard = GetShard(rid);
+  std::scoped_lock<std::mutex> shard_lock(shard.latch_);
+  auto it = shard.chains_.find(rid.Get());
+  if (it == shard.chains_.end() || it->second.writer_ != txn->GetTransactionId()) {
+    return;
+  }
+  // the version before txn was committed, its writer held the lock txn waited for
+  VersionChain &chain = it->second;
+  chain.writer_ = INVALID_TXN_ID;
+  chain.begin_ts_ = chain.older_.front().begin_ts_;
+  chain.exists_ = chain.older_.front().exists_;
+  chain.older_.pop_front();
+  version_count_--;
+  if (chain.older_.empty()) {
+    shard.chains_.erase(it);
+    chain_count_--;
+  }
+}
+
+void VersionManager::Abort(Transaction *txn) {
+  for (auto &rid : txn->GetWrittenRows()) {
+    Rollback(txn, rid);
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (auto &table : table_deletes_) {
+    table.second.deleters_.erase(txn->GetTransactionId());
+  }
+  RemoveSnapshot(txn);
+}
+
+void VersionManager::EndSnapshot(Transaction *txn) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  RemoveSnapshot(txn);
+}
+
+bool VersionManager::HasDeletesAfter(TableHeap *table, Transaction *txn) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto it = table_deletes_.find(table);
+  if (it == table_deletes_.end()) {
+    return false;
+  }
+  auto &deleters = it->second.deleters_;
+  return deleters.size() > deleters.count(txn->GetTransactionId()) || it->second.last_commit_ts_ > txn->GetReadTs();
+}
+
+void VersionManager::Forget(TableHeap *table) {
+  apply_latch_.WLock();
+  for (size_t i = 0; i < shard_count_; i++) {
+    Shard &shard = shards_[i];
+    std::scoped_lock<std::mutex> shard_lock(shard.latch_);
+    for (auto it = shard.chains_.begin(); it != shard.chains_.end();) {
+      if (it->second.table_ == table) {
+        it = EraseChain(shard, it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    table_deletes_.erase(table);
+  }
+  apply_latch_.WUnlock();
+}
+
+void VersionManager::CollectGarbage() {
+  timestamp_t oldest = GetOldestSnapshot();
+  std::vector<std::pair<TableHeap *, RowId>> deletes;
+  apply_latch_.RLock();
+  for (size_t i = 0; i < shard_count_; i++) {
+    Shard &shard = shards_[i];
+    std::scoped_lock<std::mutex> shard_lock(shard.latch_);
+    for (auto it = shard.chains_.begin(); it != shard.chains_.end();) {
+      VersionChain &chain = it->second;
+      if (chain.writer_ == INVALID_TXN_ID && chain.begin_ts_ <= oldest) {
+        if (!chain.exists_) {
+          deletes.emplace_back(chain.table_, RowId(it->first));
+        }
+        it = EraseChain(shard, it);
+        continue;
+      }
+      // the oldest snapshot reads the first version committed before it, the versions after are dropped
+      auto seen = std::find_if(chain.older_.begin(), chain.older_.end(),
+                               [oldest](const Version &version) { return version.begin_ts_ <= oldest; });
+      if (seen != chain.older_.end() && ++seen != chain.older_.end()) {
+        size_t dropped = chain.older_.end() - seen;
+        chain.older_.erase(seen, chain.older_.end());
+        version_count_ -= dropped;
+        reclaimed_count_ += dropped;
+      }
+      ++it;
+    }
+  }
+  for (auto &row : deletes) {
+    row.first->ApplyDelete(row.second, nullptr);
+  }
+  apply_latch_.RUnlock();
+}
+
+void VersionManager::Start(std::chrono::milliseconds interval) {
+  std::scoped_lock<std::mutex> lock(gc_latch_);
+  if (gc_thread_.joinable()) {
+    return;
+  }
+  stop_ = false;
+  gc_thread_ = std::thread(&VersionManager::RunGarbageCollectionThread, this, interval);
+}
+
+void VersionManager::Stop() {
+  {
+    std::scoped_lock<std::mutex> lock(gc_latch_);
+    if (!gc_thread_.joinable()) {
+      return;
+    }
+    stop_ = true;
+  }
+  stop_cv_.notify_one();
+  gc_thread_.join();
+  CollectGarbage();
+}
+
+timestamp_t VersionManager::GetOldestSnapshot() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return OldestSnapshot();
+}
+
+timestamp_t VersionManager::OldestSnapshot() const {
+  return snapshots_.empty() ? clock_ : snapshots_.begin()->first;
+}
+
+void VersionManager::RemoveSnapshot(Transaction *txn) {
+  auto snapshot = snapshot_txns_.find(txn->GetTransactionId());
+  if (snapshot == snapshot_txns_.end()) {
+    return;
+  }
+  auto it = snapshots_.find(snapshot->second);
+  if (--it->second == 0) {
+    snapshots_.erase(it);
+  }
+  snapshot_txns_.erase(snapshot);
+}
+
+std::unordered_map<int64_t, VersionManager::VersionChain>::iterator VersionManager::EraseChain(
+        Shard &shard, std::unordered_map<int64_t, VersionChain>::iterator chain) {
+  size_t dropped = chain->second.older_.size();
+  version_count_ -= dropped;
+  reclaimed_count_ += dropped;
+  chain_count_--;
+  return shard.chains_.erase(chain);
+}
+
+void VersionManager::RunGarbageCollectionThread(std::chrono::milliseconds interval) {
+  std::unique_lock<std::mutex> lock(gc_latch_);
+  while (!stop_cv_.wait_for(lock, interval, [this]() { return stop_; })) {
+    lock.unlock();
+    CollectGarbage();
+    lock.lock();
+  }
+}
@@ -1,8 +1,10 @@
+#include <chrono>
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 
 TEST(BufferPoolManagerTest, BinaryDataTest) {
@@ -15,7 +17,7 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   remove(db_name.c_str());
   auto *disk_manager = new DiskManager(db_name);
-  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
 
   page_id_t page_id_temp;
   auto *page0 = bpm->NewPage(page_id_temp);
@@ -70,4 +72,97 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+TEST(BufferPoolManagerTest, FlusherTest) {
+  const std::string db_name = "bpm_test.db";
+  const size_t buffer_pool_size = 10;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: fill the buffer pool with dirty pages.
+  page_id_t page_ids[buffer_pool_size];
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    auto *page = bpm->NewPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_ids[i]);
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+  }
+
+  // Scenario: the flusher writes every page, pages with consecutive ids together.
+  FlusherOptions options;
+  options.low_watermark = 0.5;
+  options.high_watermark = 1.0;
+  options.interval = std::chrono::milliseconds(1);
+  bpm->StartFlusher(options);
+  for (int i = 0; i < 1000 && bpm->GetBackgroundWriteCount() < buffer_pool_size; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(buffer_pool_size, bpm->GetBackgroundWriteCount());
+
+  // Scenario: victims are clean now, so new pages need no write on the eviction path.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(0, bpm->GetForegroundWriteCount());
+
+  // Scenario: the evicted pages are read back with the content written by the flusher.
+  bpm->StopFlusher();
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, PrefetchFreePageTest) {
+  const std::string db_name = "bpm_test.db";
+  const size_t buffer_pool_size = 3;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: free pages, e.g. named by a stale pointer, are not read ahead.
+  page_id_t page_ids[buffer_pool_size + 1];
+  for (size_t i = 0; i < buffer_pool_size + 1; i++) {
+    auto *page = bpm->NewPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_ids[i]);
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+    EXPECT_EQ(true, bpm->FlushPage(page_ids[i]));
+  }
+  EXPECT_EQ(PrefetchResult::kFailed, bpm->PrefetchPage(page_ids[buffer_pool_size] + 1));
+  EXPECT_EQ(PrefetchResult::kFailed, bpm->PrefetchPage(page_ids[buffer_pool_size] + 1000));
+
+  // Scenario: a page read ahead just before it was freed keeps its frame once it is allocated again,
+  // with new content.
+  EXPECT_EQ(PrefetchResult::kStarted, bpm->PrefetchPage(page_ids[0]));
+  disk_manager->DeAllocatePage(page_ids[0]);
+  page_id_t page_id_temp;
+  auto *page = bpm->NewPage(page_id_temp);
+  ASSERT_NE(nullptr, page);
+  ASSERT_EQ(page_ids[0], page_id_temp);
+  EXPECT_EQ(std::string(), std::string(page->GetData()));
+  snprintf(page->GetData(), PAGE_SIZE, "new page");
+  EXPECT_EQ(page, bpm->FetchPage(page_id_temp));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  page = bpm->FetchPage(page_id_temp);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("new page", std::string(page->GetData()));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,102 @@
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: access frames 1 to 6 once, then access 1 and 2 again.
+  for (int i = 1; i <= 6; i++) {
+    lru_k_replacer.Pin(i);
+  }
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(2);
+  for (int i = 1; i <= 6; i++) {
+    lru_k_replacer.Unpin(i);
+  }
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Scenario: frames referenced once have an infinite distance and go first, least recent first.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+
+  // Scenario: consecutive accesses to the same frame count as one reference.
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Unpin(3);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+
+  // Scenario: frames with K references are evicted by their K-th most recent reference.
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+
+  // Scenario: the history of a victim is dropped, 1 has a single reference again.
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Remove(2);
+  EXPECT_EQ(0, lru_k_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, RetainedHistoryTest) {
+  LRUKReplacer lru_k_replacer(3, 2);
+
+  // Scenario: pages 10 and 11 are referenced twice, page 12 once.
+  lru_k_replacer.Load(0, 10);
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.Load(1, 11);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Load(2, 12);
+  lru_k_replacer.Pin(2);
+  for (int i = 0; i < 3; i++) {
+    lru_k_replacer.Unpin(i);
+  }
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(0, value);
+
+  // Scenario: page 12 comes back into frame 0 and has two references with its retained history.
+  lru_k_replacer.Load(0, 12);
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.Load(2, 13);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(0, value);
+
+  // Scenario: the history of a removed page is not retained.
+  lru_k_replacer.Load(1, 11);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Remove(1);
+  lru_k_replacer.Load(1, 11);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Load(2, 14);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+}
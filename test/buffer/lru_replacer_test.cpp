@@ -39,4 +39,23 @@ TEST(LRUReplacerTest, SampleTest) {
   EXPECT_EQ(6, value);
   lru_replacer.Victim(&value);
   EXPECT_EQ(4, value);
-}
\ No newline at end of file
+}
+TEST(LRUReplacerTest, VictimIfTest) {
+  LRUReplacer lru_replacer(7);
+  for (int i = 1; i <= 6; i++) {
+    lru_replacer.Unpin(i);
+  }
+
+  // Scenario: the least recently used frame satisfying the predicate is the victim.
+  int value;
+  EXPECT_TRUE(lru_replacer.VictimIf(&value, [](frame_id_t frame_id) { return frame_id % 2 == 0; }));
+  EXPECT_EQ(2, value);
+  EXPECT_FALSE(lru_replacer.VictimIf(&value, [](frame_id_t frame_id) { return frame_id > 6; }));
+  EXPECT_EQ(5, lru_replacer.Size());
+
+  // Scenario: frames failing the predicate keep their position.
+  lru_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+}
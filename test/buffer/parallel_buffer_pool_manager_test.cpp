@@ -0,0 +1,144 @@
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "parallel_bpm_test.db";
+  const size_t num_instances = 4;
+  const size_t pool_size = 2;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+
+  // Scenario: new pages are spread over all instances, until every frame is pinned.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_instances * pool_size; i++) {
+    auto *page = bpm->NewPage(page_id_temp);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(i, page_id_temp);
+    snprintf(page->GetData(), PAGE_SIZE, "page-%zu", i);
+  }
+  ASSERT_EQ(nullptr, bpm->NewPage(page_id_temp));
+  ASSERT_EQ(INVALID_PAGE_ID, page_id_temp);
+  // Scenario: the ids allocated for a failed new page are released.
+  for (size_t i = 0; i < num_instances; i++) {
+    ASSERT_TRUE(bpm->IsPageFree(num_instances * pool_size + i));
+  }
+
+  // Scenario: a new page whose id belongs to a full instance takes the next id of an instance with room.
+  ASSERT_TRUE(bpm->UnpinPage(1, true));
+  auto *page = bpm->NewPage(page_id_temp);
+  ASSERT_NE(nullptr, page);
+  ASSERT_EQ(static_cast<page_id_t>(num_instances * pool_size + 1), page_id_temp);
+  ASSERT_TRUE(bpm->IsPageFree(num_instances * pool_size));
+  ASSERT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  ASSERT_TRUE(bpm->UnpinPage(0, true));
+  page = bpm->NewPage(page_id_temp);
+  ASSERT_NE(nullptr, page);
+  ASSERT_EQ(static_cast<page_id_t>(num_instances * pool_size), page_id_temp);
+  ASSERT_TRUE(bpm->UnpinPage(page_id_temp, false));
+
+  // Scenario: evicted pages are read back from disk.
+  page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  ASSERT_STREQ("page-0", page->GetData());
+  ASSERT_TRUE(bpm->UnpinPage(0, false));
+  ASSERT_FALSE(bpm->CheckAllUnpinned());
+  for (size_t i = 2; i < num_instances * pool_size; i++) {
+    ASSERT_TRUE(bpm->UnpinPage(i, false));
+  }
+  ASSERT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(ParallelBufferPoolManagerTest, SkippedPageLogTest) {
+  const std::string db_name = "parallel_bpm_test.db";
+  const std::string log_name = "parallel_bpm_test.log";
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *bpm = new ParallelBufferPoolManager(2, 1, disk_manager, ReplacerType::kLRU, log_manager);
+  page_id_t page_id_temp;
+  ASSERT_NE(nullptr, bpm->NewPage(page_id_temp));
+  ASSERT_NE(nullptr, bpm->NewPage(page_id_temp));
+  ASSERT_EQ(nullptr, bpm->NewPage(page_id_temp));
+  // Scenario: the ids skipped by the failed new page are given back like any page, with a log record.
+  log_manager->Flush(log_manager->GetNextLSN() - 1);
+  std::vector<page_id_t> deallocated;
+  std::vector<char> buffer;
+  LogRecord record;
+  for (size_t offset = 0; log_manager->ReadLogRecord(offset, buffer, &record); offset += record.GetSize()) {
+    if (record.GetType() == LogRecordType::kDeallocatePage) {
+      deallocated.push_back(record.GetPageId());
+    }
+  }
+  ASSERT_EQ(std::vector<page_id_t>({2, 3}), deallocated);
+  ASSERT_TRUE(bpm->IsPageFree(2));
+  ASSERT_TRUE(bpm->IsPageFree(3));
+  ASSERT_TRUE(bpm->UnpinPage(0, false));
+  ASSERT_TRUE(bpm->UnpinPage(1, false));
+
+  delete bpm;
+  delete log_manager;
+  delete disk_manager;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+TEST(ParallelBufferPoolManagerTest, ConcurrentFetchTest) {
+  const std::string db_name = "parallel_bpm_test.db";
+  const int num_threads = 8;
+  const int page_nums = 64;
+  const int rounds = 2000;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  // smaller than the pages touched, so that fetches also evict pages
+  auto *bpm = new ParallelBufferPoolManager(4, 12, disk_manager);
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < page_nums; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    memcpy(page->GetData(), &page_id, sizeof(page_id_t));
+    bpm->UnpinPage(page_id, true);
+    page_ids.push_back(page_id);
+  }
+  std::vector<std::thread> threads;
+  std::vector<int> errors(num_threads, 0);
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < rounds; i++) {
+        page_id_t page_id = page_ids[(i * 7 + t * 13) % page_nums];
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        page_id_t stored;
+        memcpy(&stored, page->GetData(), sizeof(page_id_t));
+        errors[t] += (stored != page_id);
+        bpm->UnpinPage(page_id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < num_threads; t++) {
+    ASSERT_EQ(0, errors[t]);
+  }
+  ASSERT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,49 @@
+#include "buffer/two_queue_replacer.h"
+#include "gtest/gtest.h"
+
+TEST(TwoQueueReplacerTest, SampleTest) {
+  TwoQueueReplacer two_queue_replacer(8);
+
+  // Scenario: frames 0 and 1 are referenced twice and move to Am, frames 2 to 7 are referenced once.
+  for (int i = 0; i < 8; i++) {
+    two_queue_replacer.Pin(i);
+  }
+  two_queue_replacer.Pin(0);
+  two_queue_replacer.Pin(1);
+  for (int i = 0; i < 8; i++) {
+    two_queue_replacer.Unpin(i);
+  }
+  EXPECT_EQ(8, two_queue_replacer.Size());
+
+  // Scenario: A1 holds more than a quarter of the frames, victims come from A1 in FIFO order.
+  int value;
+  for (int i = 2; i < 6; i++) {
+    two_queue_replacer.Victim(&value);
+    EXPECT_EQ(i, value);
+  }
+
+  // Scenario: once A1 is small enough, victims come from Am in LRU order.
+  two_queue_replacer.Pin(0);
+  two_queue_replacer.Unpin(0);
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(0, value);
+
+  // Scenario: A1 is used when Am is empty.
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+
+  // Scenario: consecutive accesses to the same frame count as one reference, so 6 stays in A1
+  // while 7, referenced for the second time, moves to Am.
+  two_queue_replacer.Pin(6);
+  two_queue_replacer.Pin(6);
+  two_queue_replacer.Unpin(6);
+  two_queue_replacer.Pin(7);
+  two_queue_replacer.Unpin(7);
+  two_queue_replacer.Victim(&value);
+  EXPECT_EQ(7, value);
+  two_queue_replacer.Remove(6);
+  EXPECT_EQ(0, two_queue_replacer.Size());
+  EXPECT_FALSE(two_queue_replacer.Victim(&value));
+}
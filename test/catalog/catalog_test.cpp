@@ -37,6 +37,46 @@ TEST(CatalogTest, CatalogMetaTest) {
   }
 }
 
+TEST(CatalogTest, TableMetaRowFormatTest) {
+  SimpleMemHeap heap;
+  char *buf = reinterpret_cast<char *>(heap.Allocate(PAGE_SIZE));
+  memset(buf, 0, PAGE_SIZE);
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableMetadata *meta = TableMetadata::Create(1, "table-1", 2, 3, schema.get(), &heap);
+  ASSERT_EQ(ROW_FORMAT_VERSION, meta->GetRowFormatVersion());
+  uint32_t size = meta->SerializeTo(buf);
+  ASSERT_EQ(meta->GetSerializedSize(), size);
+  TableMetadata *other = nullptr;
+  ASSERT_EQ(size, TableMetadata::DeserializeFrom(buf, other, &heap));
+  EXPECT_EQ(ROW_FORMAT_VERSION, other->GetRowFormatVersion());
+  EXPECT_EQ("table-1", other->GetTableName());
+  // metadata written before tables had a free space map has the legacy magic, neither a row format version nor
+  // a free space map page id, and its rows are in format version 1
+  const uint32_t legacy_magic_num = 344528;
+  const uint32_t name_size = sizeof(table_id_t) + sizeof(uint32_t) + 7;
+  char *legacy = reinterpret_cast<char *>(heap.Allocate(PAGE_SIZE));
+  memset(legacy, 0, PAGE_SIZE);
+  char *pos = legacy;
+  memcpy(pos, &legacy_magic_num, sizeof(uint32_t));
+  pos += sizeof(uint32_t);
+  memcpy(pos, buf + 2 * sizeof(uint32_t), name_size + sizeof(page_id_t));
+  pos += name_size + sizeof(page_id_t);
+  uint32_t schema_offset = 2 * sizeof(uint32_t) + name_size + 2 * sizeof(page_id_t);
+  memcpy(pos, buf + schema_offset, size - schema_offset);
+  ASSERT_EQ(size - sizeof(uint32_t) - sizeof(page_id_t), TableMetadata::DeserializeFrom(legacy, other, &heap));
+  EXPECT_EQ(1u, other->GetRowFormatVersion());
+  EXPECT_EQ(1u, other->GetTableId());
+  EXPECT_EQ("table-1", other->GetTableName());
+  EXPECT_EQ(2u, other->GetFirstPageId());
+  EXPECT_EQ(INVALID_PAGE_ID, other->GetFreeSpaceMapPageId());
+  ASSERT_EQ(2u, other->GetSchema()->GetColumnCount());
+  EXPECT_EQ("name", other->GetSchema()->GetColumn(1)->GetName());
+}
+
 TEST(CatalogTest, CatalogTableTest) {
   SimpleMemHeap heap;
   /** Stage 2: Testing simple operation */
@@ -77,7 +117,7 @@ TEST(CatalogTest, CatalogIndexTest) {
   ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_01->GetTable("table-1", table_info));
   std::vector<Column *> columns = {
           ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
-          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
           ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
   };
   auto schema = std::make_shared<Schema>(columns);
@@ -115,6 +155,23 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(row, ret, &txn));
     ASSERT_EQ(rid.Get(), ret[i].Get());
   }
+  // a non-unique index keeps all the rows with the same key
+  IndexInfo *account_index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-2", {"account"}, &txn, account_index_info, false));
+  ASSERT_FALSE(account_index_info->GetIndexMeta()->IsUnique());
+  std::vector<Field> account_fields{Field(TypeId::kTypeFloat, 1.5f)};
+  Row account_key(account_fields);
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(DB_SUCCESS, account_index_info->GetIndex()->InsertEntry(account_key, RowId(1000, i), nullptr));
+  }
+  // so does a hash index
+  IndexInfo *hash_index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-3", {"account"}, &txn, hash_index_info, false,
+                                                IndexType::kHash));
+  ASSERT_EQ(IndexType::kHash, hash_index_info->GetIndexMeta()->GetIndexType());
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(DB_SUCCESS, hash_index_info->GetIndex()->InsertEntry(account_key, RowId(1000, i), nullptr));
+  }
   delete db_01;
   /** Stage 2: Testing catalog loading */
   auto db_02 = new DBStorageEngine(db_file_name, false);
@@ -134,5 +191,101 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(DB_SUCCESS, index_info_02->GetIndex()->ScanKey(row, ret_02, &txn));
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
+  ASSERT_TRUE(index_info_02->GetIndexMeta()->IsUnique());
+  IndexInfo *account_index_info_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetIndex("table-1", "index-2", account_index_info_02));
+  ASSERT_FALSE(account_index_info_02->GetIndexMeta()->IsUnique());
+  std::vector<RowId> account_ret;
+  ASSERT_EQ(DB_SUCCESS, account_index_info_02->GetIndex()->ScanKey(account_key, account_ret, &txn));
+  ASSERT_EQ(10u, account_ret.size());
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(RowId(1000, i).Get(), account_ret[i].Get());
+  }
+  IndexInfo *hash_index_info_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetIndex("table-1", "index-3", hash_index_info_02));
+  ASSERT_EQ(IndexType::kHash, hash_index_info_02->GetIndexMeta()->GetIndexType());
+  ASSERT_EQ(IndexType::kBPlusTree, account_index_info_02->GetIndexMeta()->GetIndexType());
+  std::vector<RowId> hash_ret;
+  ASSERT_EQ(DB_SUCCESS, hash_index_info_02->GetIndex()->ScanKey(account_key, hash_ret, &txn));
+  ASSERT_EQ(10u, hash_ret.size());
   delete db_02;
-}
\ No newline at end of file
+}
+TEST(CatalogTest, CatalogWideIndexKeyTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 60, 1, true, false),
+          ALLOC_COLUMN(heap)("address", TypeId::kTypeChar, 100, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), &txn, table_info));
+  std::vector<std::string> index_keys{"name"};
+  IndexInfo *index_info = nullptr;
+  // a key of name takes up to 63 bytes, the row id of a non-unique B+ tree index would not fit behind it
+  ASSERT_EQ(DB_INDEX_KEY_TOO_LONG, catalog_01->CreateIndex("table-1", "index-1", index_keys, &txn, index_info,
+                                                          false));
+  ASSERT_EQ(DB_INDEX_NOT_FOUND, catalog_01->GetIndex("table-1", "index-1", index_info));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-1", index_keys, &txn, index_info));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-2", index_keys, &txn, index_info, false,
+                                                IndexType::kHash));
+  std::vector<std::string> narrow_keys{"id"};
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-3", narrow_keys, &txn, index_info, false));
+  // a key of address takes up to 103 bytes, no index can hold it
+  std::vector<std::string> wide_keys{"address"};
+  ASSERT_EQ(DB_INDEX_KEY_TOO_LONG, catalog_01->CreateIndex("table-1", "index-4", wide_keys, &txn, index_info));
+  ASSERT_EQ(DB_INDEX_KEY_TOO_LONG, catalog_01->CreateIndex("table-1", "index-4", wide_keys, &txn, index_info, true,
+                                                          IndexType::kHash));
+  ASSERT_EQ(DB_INDEX_KEY_TOO_LONG, catalog_01->CreateIndex("table-1", "index-4", wide_keys, &txn, index_info, false,
+                                                          IndexType::kHash));
+  ASSERT_EQ(DB_INDEX_NOT_FOUND, catalog_01->GetIndex("table-1", "index-4", index_info));
+  delete db_01;
+}
+
+TEST(CatalogTest, CatalogFailedIndexTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), &txn, table_info));
+  // enough rows with the same account to fill several pages of either index
+  for (int i = 0; i < 2000; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeFloat, 1.5f)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  auto count_used_pages = [&]() {
+    int used = 0;
+    for (page_id_t page_id = 0; page_id < 1000; page_id++) {
+      used += db_01->bpm_->IsPageFree(page_id) ? 0 : 1;
+    }
+    return used;
+  };
+  int used = count_used_pages();
+  std::vector<std::string> index_keys{"account"};
+  IndexInfo *index_info = nullptr;
+  // a unique index is not created over duplicate keys, and the pages built before they were found are freed
+  ASSERT_EQ(DB_FAILED, catalog_01->CreateIndex("table-1", "index-1", index_keys, &txn, index_info));
+  ASSERT_EQ(nullptr, index_info);
+  ASSERT_EQ(DB_FAILED, catalog_01->CreateIndex("table-1", "index-2", index_keys, &txn, index_info, true,
+                                               IndexType::kHash));
+  ASSERT_EQ(nullptr, index_info);
+  ASSERT_EQ(used, count_used_pages());
+  ASSERT_EQ(DB_INDEX_NOT_FOUND, catalog_01->GetIndex("table-1", "index-1", index_info));
+  ASSERT_EQ(DB_INDEX_NOT_FOUND, catalog_01->GetIndex("table-1", "index-2", index_info));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-1", index_keys, &txn, index_info, false));
+  std::vector<RowId> result;
+  std::vector<Field> key_fields{Field(TypeId::kTypeFloat, 1.5f)};
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(Row(key_fields), result, &txn));
+  ASSERT_EQ(2000u, result.size());
+  delete db_01;
+}
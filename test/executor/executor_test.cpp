@@ -0,0 +1,318 @@
+#include <cstdio>
+#include <regex>
+#include <sstream>
+#include <string>
+
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+
+extern "C" {
+int yyparse(void);
+#include "parser/minisql_lex.h"
+#include "parser/parser.h"
+}
+
+static const std::string db_name = "executor_test_db";
+
+/**
+ * Parse and execute one statement, and return what it printed
+ * @param context the session the statement runs in, nullptr for a new one
+ */
+static std::string RunSql(ExecuteEngine *engine, const std::string &sql, dberr_t *result = nullptr,
+                          ExecuteContext *context = nullptr) {
+  YY_BUFFER_STATE bp = yy_scan_string(sql.c_str());
+  yy_switch_to_buffer(bp);
+  MinisqlParserInit();
+  yyparse();
+  EXPECT_EQ(0, MinisqlParserGetError()) << sql;
+  std::stringstream output;
+  auto *old_buf = std::cout.rdbuf(output.rdbuf());
+  ExecuteContext new_context;
+  dberr_t ret = engine->Execute(MinisqlGetParserRootNode(), context != nullptr ? context : &new_context);
+  std::cout.rdbuf(old_buf);
+  MinisqlParserFinish();
+  yy_delete_buffer(bp);
+  yylex_destroy();
+  if (result != nullptr) {
+    *result = ret;
+  }
+  return output.str();
+}
+
+/**
+ * @return the number of records a statement reported it affected, -1 if it did not report one
+ */
+static int AffectedRecords(const std::string &output) {
+  std::smatch match;
+  if (!std::regex_search(output, match, std::regex("Affects (\\d+) Record"))) {
+    return -1;
+  }
+  return std::stoi(match[1]);
+}
+
+static int Count(ExecuteEngine *engine, const std::string &sql) {
+  return AffectedRecords(RunSql(engine, sql));
+}
+
+TEST(ExecutorTest, PipelineTest) {
+  const int row_nums = 1000;
+  remove(db_name.c_str());
+  {
+    ExecuteEngine engine;
+    RunSql(&engine, "create database " + db_name + ";");
+    RunSql(&engine, "use " + db_name + ";");
+    RunSql(&engine, "create table t(id int, name char(16), score float, primary key(id));");
+    int expected = 0;
+    for (int i = 0; i < row_nums; i++) {
+      std::string insert = "insert into t values(" + std::to_string(i) + ", \"name" + std::to_string(i) + "\", " +
+                           std::to_string(i % 100) + ");";
+      ASSERT_EQ(1, Count(&engine, insert)) << insert;
+      expected += (i < 300 && i % 100 > 50);
+    }
+    // the primary key rejects a duplicate
+    dberr_t ret;
+    RunSql(&engine, "insert into t values(5, \"dup\", 1.0);", &ret);
+    EXPECT_EQ(DB_FAILED, ret);
+
+    EXPECT_EQ(row_nums, Count(&engine, "select * from t;"));
+    // index scan
+    std::string output = RunSql(&engine, "select name from t where id = 500;");
+    EXPECT_EQ(1, AffectedRecords(output));
+    EXPECT_NE(std::string::npos, output.find("name500"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where id = 500 and score < 0;"));
+    // index range scans
+    EXPECT_EQ(99, Count(&engine, "select * from t where id > 100 and id < 200;"));
+    EXPECT_EQ(101, Count(&engine, "select * from t where id >= 100 and id <= 200;"));
+    EXPECT_EQ(9, Count(&engine, "select * from t where id > 990;"));
+    EXPECT_EQ(10, Count(&engine, "select * from t where id > 100 and id > 500 and id <= 510;"));
+    EXPECT_EQ(4, Count(&engine, "select * from t where id < 10 and score > 5;"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where id > 500 and id < 400;"));
+    // sequential scans
+    EXPECT_EQ(expected, Count(&engine, "select id from t where id < 300 and score > 50;"));
+    EXPECT_EQ(2, Count(&engine, "select * from t where id = 5 or id = 7;"));
+    EXPECT_EQ(1, Count(&engine, "select * from t where name = \"name42\";"));
+    EXPECT_EQ(row_nums / 100, Count(&engine, "select * from t where score = 99;"));
+
+    // update in place
+    EXPECT_EQ(100, Count(&engine, "update t set score = 1.5 where id >= 900;"));
+    EXPECT_EQ(100, Count(&engine, "select * from t where score = 1.5;"));
+    // rows which no longer fit into their pages move, each is updated once and stays in the index
+    std::string long_name(200, 'x');
+    EXPECT_EQ(row_nums, Count(&engine, "update t set name = \"" + long_name + "\";"));
+    EXPECT_EQ(row_nums, Count(&engine, "select * from t where name = \"" + long_name + "\";"));
+    for (int i = 0; i < row_nums; i += 37) {
+      output = RunSql(&engine, "select name from t where id = " + std::to_string(i) + ";");
+      EXPECT_EQ(1, AffectedRecords(output)) << i;
+      EXPECT_NE(std::string::npos, output.find(long_name)) << i;
+    }
+    // index columns are not updated
+    RunSql(&engine, "update t set id = 1 where id = 2;", &ret);
+    EXPECT_EQ(DB_FAILED, ret);
+    // an update through a range scan, of rows which move and whose index entries change with them
+    std::string longer_name(400, 'z');
+    EXPECT_EQ(100, Count(&engine, "update t set name = \"" + longer_name + "\" where id >= 200 and id < 300;"));
+    EXPECT_EQ(100, Count(&engine, "select * from t where id >= 200 and id < 300 and name = \"" + longer_name + "\";"));
+    // a row which fits no page fails the update, the rows updated before it are restored
+    RunSql(&engine, "create table u(id int, a char(16), b char(16), primary key(id));");
+    for (int i = 0; i < 3; i++) {
+      ASSERT_EQ(1, Count(&engine, "insert into u values(" + std::to_string(i) + ", \"a\", \"b\");"));
+    }
+    std::string half_page(VARCHAR_MAX_LEN - 8, 'y');
+    output = RunSql(&engine, "update u set a = \"" + half_page + "\", b = \"" + half_page + "\";", &ret);
+    EXPECT_EQ(DB_FAILED, ret);
+    EXPECT_EQ(0, AffectedRecords(output));
+    EXPECT_EQ(3, Count(&engine, "select * from u where a = \"a\" and b = \"b\";"));
+
+    // delete, from the table and the index
+    EXPECT_EQ(100, Count(&engine, "delete from t where id < 100;"));
+    EXPECT_EQ(row_nums - 100, Count(&engine, "select * from t;"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where id = 50;"));
+    EXPECT_EQ(50, Count(&engine, "select * from t where id >= 50 and id < 150;"));
+    EXPECT_EQ(1, Count(&engine, "delete from t where id = 150;"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where id = 150;"));
+    EXPECT_EQ(1, Count(&engine, "insert into t values(150, \"again\", 2.0);"));
+    EXPECT_EQ(1, Count(&engine, "select * from t where id = 150;"));
+    EXPECT_EQ(row_nums - 100, Count(&engine, "delete from t;"));
+    EXPECT_EQ(0, Count(&engine, "select * from t;"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where id = 150;"));
+  }
+  remove(db_name.c_str());
+}
+
+TEST(ExecutorTest, CreateIndexTest) {
+  const int row_nums = 1000;
+  remove(db_name.c_str());
+  {
+    ExecuteEngine engine;
+    RunSql(&engine, "create database " + db_name + ";");
+    RunSql(&engine, "use " + db_name + ";");
+    RunSql(&engine, "create table t(id int, name char(16), score float);");
+    for (int i = 0; i < row_nums; i++) {
+      std::string insert = "insert into t values(" + std::to_string(i) + ", \"name" + std::to_string(i) + "\", " +
+                           std::to_string(i % 100) + ");";
+      ASSERT_EQ(1, Count(&engine, insert)) << insert;
+    }
+    // the index is built out of the rows already in the table
+    dberr_t ret;
+    RunSql(&engine, "create index idx_id on t(id);", &ret);
+    EXPECT_EQ(DB_SUCCESS, ret);
+    for (int i = 0; i < row_nums; i += 37) {
+      std::string output = RunSql(&engine, "select name from t where id = " + std::to_string(i) + ";");
+      EXPECT_EQ(1, AffectedRecords(output)) << i;
+      EXPECT_NE(std::string::npos, output.find("name" + std::to_string(i))) << i;
+    }
+    EXPECT_EQ(99, Count(&engine, "select * from t where id > 100 and id < 200;"));
+    // and kept up to date afterwards
+    EXPECT_EQ(1, Count(&engine, "delete from t where id = 500;"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where id = 500;"));
+    EXPECT_EQ(1, Count(&engine, "insert into t values(500, \"again\", 2.0);"));
+    EXPECT_EQ(1, Count(&engine, "select * from t where id = 500;"));
+    // created indexes are not unique
+    EXPECT_EQ(1, Count(&engine, "insert into t values(501, \"dup\", 2.0);"));
+    EXPECT_EQ(2, Count(&engine, "select * from t where id = 501;"));
+    RunSql(&engine, "create index idx_score on t(score);", &ret);
+    EXPECT_EQ(DB_SUCCESS, ret);
+    EXPECT_EQ(row_nums / 100, Count(&engine, "select * from t where score = 99;"));
+    EXPECT_EQ(row_nums / 10, Count(&engine, "select * from t where score >= 10 and score < 20;"));
+    EXPECT_EQ(row_nums / 100, Count(&engine, "delete from t where score = 99;"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where score = 99;"));
+    EXPECT_EQ(row_nums / 100 + 2, Count(&engine, "select * from t where score = 2;"));
+    // hash indexes answer lookups, a B+ tree on the same column still answers ranges
+    RunSql(&engine, "create index idx_name on t(name) using hash;", &ret);
+    EXPECT_EQ(DB_SUCCESS, ret);
+    RunSql(&engine, "create index idx_id_hash on t(id) using hash;", &ret);
+    EXPECT_EQ(DB_SUCCESS, ret);
+    RunSql(&engine, "create index idx_bad on t(id) using bitmap;", &ret);
+    EXPECT_EQ(DB_FAILED, ret);
+    // an index whose keys may not fit is refused, and so is a table whose primary key may not
+    RunSql(&engine, "create table w(id int, address char(100), primary key(address));", &ret);
+    EXPECT_EQ(DB_INDEX_KEY_TOO_LONG, ret);
+    RunSql(&engine, "create table w(id int, address char(100));", &ret);
+    EXPECT_EQ(DB_SUCCESS, ret);
+    RunSql(&engine, "create index idx_address on w(address) using hash;", &ret);
+    EXPECT_EQ(DB_INDEX_KEY_TOO_LONG, ret);
+    EXPECT_EQ(1, Count(&engine, "select * from t where name = \"name42\";"));
+    EXPECT_EQ(2, Count(&engine, "select * from t where id = 501;"));
+    // the row with id 199 has score 99 and is gone
+    EXPECT_EQ(98, Count(&engine, "select * from t where id > 100 and id < 200;"));
+    EXPECT_EQ(1, Count(&engine, "delete from t where name = \"name42\";"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where name = \"name42\";"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where id = 42;"));
+    EXPECT_EQ(1, Count(&engine, "insert into t values(42, \"name42\", 2.0);"));
+    EXPECT_EQ(1, Count(&engine, "select * from t where name = \"name42\";"));
+    EXPECT_EQ(1, Count(&engine, "select * from t where id = 42;"));
+  }
+  remove(db_name.c_str());
+}
+
+TEST(ExecutorTest, NullTest) {
+  const int row_nums = 300;
+  remove(db_name.c_str());
+  {
+    ExecuteEngine engine;
+    RunSql(&engine, "create database " + db_name + ";");
+    RunSql(&engine, "use " + db_name + ";");
+    RunSql(&engine, "create table t(id int, name char(16), score float, primary key(id));");
+    for (int i = 0; i < row_nums; i++) {
+      std::string name = i % 3 == 0 ? "null" : "\"name" + std::to_string(i) + "\"";
+      std::string score = i % 5 == 0 ? "null" : std::to_string(i % 100);
+      std::string insert = "insert into t values(" + std::to_string(i) + ", " + name + ", " + score + ");";
+      ASSERT_EQ(1, Count(&engine, insert)) << insert;
+    }
+    // nulls are kept by the rows, and do not shift the fields after them
+    EXPECT_EQ(row_nums / 3, Count(&engine, "select * from t where name is null;"));
+    EXPECT_EQ(row_nums - row_nums / 5, Count(&engine, "select * from t where score not null;"));
+    EXPECT_EQ(row_nums / 15, Count(&engine, "select * from t where name is null and score is null;"));
+    EXPECT_EQ(1, Count(&engine, "select * from t where name = \"name7\" and score = 7;"));
+    EXPECT_EQ(1, Count(&engine, "select * from t where id = 3 and name is null and score = 3;"));
+    // and by the rows an update writes
+    EXPECT_EQ(row_nums / 3, Count(&engine, "update t set score = 1.5 where name is null;"));
+    EXPECT_EQ(row_nums / 3, Count(&engine, "select * from t where name is null and score = 1.5;"));
+    EXPECT_EQ(1, Count(&engine, "update t set name = null where id = 1;"));
+    EXPECT_EQ(row_nums / 3 + 1, Count(&engine, "select * from t where name is null;"));
+  }
+  remove(db_name.c_str());
+}
+
+TEST(ExecutorTest, TransactionTest) {
+  remove(db_name.c_str());
+  {
+    ExecuteEngine engine;
+    RunSql(&engine, "create database " + db_name + ";");
+    RunSql(&engine, "use " + db_name + ";");
+    RunSql(&engine, "create table t(id int, name char(16), primary key(id));");
+    ASSERT_EQ(1, Count(&engine, "insert into t values(1, \"one\");"));
+    ASSERT_EQ(1, Count(&engine, "insert into t values(2, \"two\");"));
+    ExecuteContext session;
+    dberr_t ret;
+    RunSql(&engine, "commit;", &ret, &session);
+    EXPECT_EQ(DB_FAILED, ret);
+    RunSql(&engine, "begin;", &ret, &session);
+    ASSERT_EQ(DB_SUCCESS, ret);
+    RunSql(&engine, "begin;", &ret, &session);
+    EXPECT_EQ(DB_FAILED, ret);
+
+    // a rollback undoes every statement of the transaction
+    EXPECT_EQ(1, AffectedRecords(RunSql(&engine, "insert into t values(3, \"three\");", nullptr, &session)));
+    EXPECT_EQ(1, AffectedRecords(RunSql(&engine, "delete from t where id = 1;", nullptr, &session)));
+    EXPECT_EQ(1, AffectedRecords(RunSql(&engine, "update t set name = \"2\" where id = 2;", nullptr, &session)));
+    EXPECT_EQ(2, AffectedRecords(RunSql(&engine, "select * from t;", nullptr, &session)));
+    RunSql(&engine, "rollback;", &ret, &session);
+    ASSERT_EQ(DB_SUCCESS, ret);
+    EXPECT_EQ(nullptr, session.txn_);
+    EXPECT_EQ(2, Count(&engine, "select * from t;"));
+    EXPECT_EQ(1, Count(&engine, "select * from t where id = 1;"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where id = 3;"));
+    EXPECT_EQ(1, Count(&engine, "select * from t where name = \"two\";"));
+
+    RunSql(&engine, "begin;", &ret, &session);
+    RunSql(&engine, "insert into t values(3, \"three\");", nullptr, &session);
+    RunSql(&engine, "delete from t where id = 1;", nullptr, &session);
+    RunSql(&engine, "commit;", &ret, &session);
+    ASSERT_EQ(DB_SUCCESS, ret);
+    EXPECT_EQ(2, Count(&engine, "select * from t;"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where id = 1;"));
+    EXPECT_EQ(1, Count(&engine, "select * from t where id = 3;"));
+
+    // a transaction reads the snapshot taken when it began, a row another one changed since is read as it was,
+    // without waiting
+    ExecuteContext older, younger;
+    RunSql(&engine, "begin;", nullptr, &older);
+    RunSql(&engine, "begin;", nullptr, &younger);
+    EXPECT_EQ(1, AffectedRecords(RunSql(&engine, "update t set name = \"old\" where id = 2;", nullptr, &older)));
+    EXPECT_EQ(1, AffectedRecords(RunSql(&engine, "select * from t where id = 2;", &ret, &younger)));
+    EXPECT_EQ(DB_SUCCESS, ret);
+    EXPECT_EQ(1, Count(&engine, "select * from t where name = \"two\";"));
+    RunSql(&engine, "commit;", &ret, &older);
+    ASSERT_EQ(DB_SUCCESS, ret);
+    EXPECT_EQ(1, Count(&engine, "select * from t where name = \"old\";"));
+    EXPECT_EQ(1, AffectedRecords(RunSql(&engine, "select * from t where name = \"two\";", nullptr, &younger)));
+    EXPECT_EQ(0, AffectedRecords(RunSql(&engine, "select * from t where name = \"old\";", nullptr, &younger)));
+    // the first of two transactions to change a row wins, the other one is rolled back
+    RunSql(&engine, "update t set name = \"young\" where id = 2;", &ret, &younger);
+    EXPECT_EQ(DB_FAILED, ret);
+    EXPECT_EQ(nullptr, younger.txn_);
+    EXPECT_EQ(1, Count(&engine, "select * from t where name = \"old\";"));
+
+    // a failed statement rolls back its transaction
+    RunSql(&engine, "begin;", nullptr, &session);
+    RunSql(&engine, "insert into t values(4, \"four\");", nullptr, &session);
+    RunSql(&engine, "insert into t values(4, \"four\");", &ret, &session);
+    EXPECT_EQ(DB_FAILED, ret);
+    EXPECT_EQ(nullptr, session.txn_);
+    EXPECT_EQ(0, Count(&engine, "select * from t where id = 4;"));
+    EXPECT_EQ(2, Count(&engine, "select * from t;"));
+
+    // a row deleted since the snapshot of a transaction is still read by it, also where its index entry is gone
+    RunSql(&engine, "begin;", nullptr, &session);
+    EXPECT_EQ(1, AffectedRecords(RunSql(&engine, "select * from t where id = 3;", nullptr, &session)));
+    EXPECT_EQ(1, Count(&engine, "delete from t where id = 3;"));
+    EXPECT_EQ(0, Count(&engine, "select * from t where id = 3;"));
+    EXPECT_EQ(1, AffectedRecords(RunSql(&engine, "select * from t where id = 3;", nullptr, &session)));
+    EXPECT_EQ(2, AffectedRecords(RunSql(&engine, "select * from t;", nullptr, &session)));
+    RunSql(&engine, "commit;", &ret, &session);
+    ASSERT_EQ(DB_SUCCESS, ret);
+    EXPECT_EQ(1, Count(&engine, "select * from t;"));
+  }
+  remove(db_name.c_str());
+}
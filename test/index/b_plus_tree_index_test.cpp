@@ -1,9 +1,11 @@
+#include <memory>
 #include <string>
 
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/b_plus_tree_index.h"
 #include "index/generic_key.h"
+#include "utils/utils.h"
 
 static const std::string db_name = "bp_tree_index_test.db";
 
@@ -78,4 +80,181 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     ASSERT_EQ(i, (*iter).second.GetSlotNum());
     i++;
   }
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, BPlusTreeIndexScanRangeTest) {
+  using INDEX_KEY_TYPE = GenericKey<8>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<8>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 1, true, false)
+  };
+  std::vector<uint32_t> index_key_map{0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  // even keys only, enough of them to span many leaves
+  const int key_nums = 4000;
+  for (int i = 0; i < key_nums; i += 2) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    Row row(fields);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(row, RowId(i / 100, i % 100), nullptr));
+  }
+  auto make_key = [](int value) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+    return std::make_unique<Row>(fields);
+  };
+  // scan the range, check the keys come in order and return their number
+  auto scan = [&](const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive, int first) {
+    std::unique_ptr<IndexRangeIterator> iterator;
+    EXPECT_EQ(DB_SUCCESS, index->ScanRange(lo, lo_inclusive, hi, hi_inclusive, iterator, nullptr));
+    int count = 0;
+    RowId rid;
+    while (iterator->Next(rid)) {
+      int key = first + 2 * count;
+      EXPECT_EQ(RowId(key / 100, key % 100), rid);
+      count++;
+    }
+    return count;
+  };
+  auto lo = make_key(1000), hi = make_key(2000);
+  ASSERT_EQ(501, scan(lo.get(), true, hi.get(), true, 1000));
+  ASSERT_EQ(499, scan(lo.get(), false, hi.get(), false, 1002));
+  ASSERT_EQ(500, scan(lo.get(), true, hi.get(), false, 1000));
+  // bounds which are not keys
+  auto odd_lo = make_key(999), odd_hi = make_key(2001);
+  ASSERT_EQ(501, scan(odd_lo.get(), false, odd_hi.get(), false, 1000));
+  // open ends
+  ASSERT_EQ(key_nums / 2, scan(nullptr, true, nullptr, true, 0));
+  ASSERT_EQ(1000, scan(nullptr, true, hi.get(), false, 0));
+  ASSERT_EQ(1500, scan(lo.get(), true, nullptr, true, 1000));
+  auto last = make_key(key_nums - 2), past = make_key(key_nums);
+  ASSERT_EQ(1, scan(last.get(), true, nullptr, true, key_nums - 2));
+  ASSERT_EQ(0, scan(last.get(), false, nullptr, true, key_nums));
+  ASSERT_EQ(0, scan(past.get(), true, nullptr, true, key_nums));
+  // empty ranges
+  ASSERT_EQ(0, scan(hi.get(), true, lo.get(), true, 0));
+  ASSERT_EQ(0, scan(lo.get(), false, lo.get(), true, 0));
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexBulkLoadTest) {
+  using INDEX_KEY_TYPE = GenericKey<8>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<8>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 1, true, false)
+  };
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr, &heap);
+  const int row_nums = 20000;
+  std::vector<int> ids;
+  for (int i = 0; i < row_nums; i++) {
+    ids.push_back(i);
+  }
+  ShuffleArray(ids);
+  std::vector<RowId> rids(row_nums);
+  for (int id : ids) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeFloat, 1.0f)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids[id] = row.GetRowId();
+  }
+  std::vector<uint32_t> index_key_map{0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  // a sort buffer of a few pages makes the load merge many runs
+  for (size_t sort_buffer_size : {DEFAULT_SORT_BUFFER_SIZE, static_cast<size_t>(4 * PAGE_SIZE)}) {
+    auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_, true, DEFAULT_FILL_FACTOR,
+                                             sort_buffer_size);
+    ASSERT_EQ(DB_SUCCESS, index->BulkLoad(table_heap, index_key_map, nullptr));
+    int next = 0;
+    for (auto iter = index->GetBeginIterator(); iter != index->GetEndIterator(); ++iter) {
+      ASSERT_EQ(rids[next], (*iter).second);
+      next++;
+    }
+    ASSERT_EQ(row_nums, next);
+    std::vector<RowId> ret;
+    std::vector<Field> fields{Field(TypeId::kTypeInt, row_nums / 3)};
+    Row key(fields);
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key, ret, nullptr));
+    ASSERT_EQ(rids[row_nums / 3], ret[0]);
+    ASSERT_EQ(DB_SUCCESS, index->Destroy());
+  }
+  // the keys of the account column are not unique
+  std::vector<uint32_t> account_key_map{1};
+  auto *account_schema = Schema::ShallowCopySchema(&table_schema, account_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(1, account_schema, engine.bpm_);
+  ASSERT_EQ(DB_FAILED, index->BulkLoad(table_heap, account_key_map, nullptr));
+  ASSERT_TRUE(index->GetBeginIterator() == index->GetEndIterator());
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexNonUniqueTest) {
+  using INDEX_KEY_TYPE = GenericKey<16>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<16>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("status", TypeId::kTypeInt, 1, true, false)
+  };
+  std::vector<uint32_t> index_key_map{1};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_, false);
+  auto make_key = [](int status) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, status)};
+    return std::make_unique<Row>(fields);
+  };
+  // a few statuses over many rows, inserted in random order
+  const int row_nums = 6000, status_nums = 6;
+  std::vector<int> ids;
+  for (int i = 0; i < row_nums; i++) {
+    ids.push_back(i);
+  }
+  ShuffleArray(ids);
+  for (int id : ids) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(*make_key(id % status_nums), RowId(id / 100, id % 100), nullptr));
+  }
+  // all the rows of a key, in row id order
+  for (int status = 0; status < status_nums; status++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(*make_key(status), ret, nullptr));
+    ASSERT_EQ(static_cast<size_t>(row_nums / status_nums), ret.size());
+    for (size_t i = 0; i < ret.size(); i++) {
+      int id = static_cast<int>(i) * status_nums + status;
+      ASSERT_EQ(RowId(id / 100, id % 100), ret[i]);
+    }
+  }
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(*make_key(status_nums), ret, nullptr));
+  // ranges include or exclude all the rows of their bounds
+  auto count = [&](int lo, bool lo_inclusive, int hi, bool hi_inclusive) {
+    std::unique_ptr<IndexRangeIterator> iterator;
+    auto lo_key = make_key(lo), hi_key = make_key(hi);
+    index->ScanRange(lo_key.get(), lo_inclusive, hi_key.get(), hi_inclusive, iterator, nullptr);
+    int rows = 0;
+    RowId rid;
+    while (iterator->Next(rid)) {
+      rows++;
+    }
+    return rows;
+  };
+  ASSERT_EQ(3 * row_nums / status_nums, count(1, true, 3, true));
+  ASSERT_EQ(row_nums / status_nums, count(1, false, 3, false));
+  ASSERT_EQ(2 * row_nums / status_nums, count(1, true, 3, false));
+  // remove takes out the entry of one row only
+  for (int id = 0; id < row_nums; id += 2) {
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(*make_key(id % status_nums), RowId(id / 100, id % 100), nullptr));
+  }
+  ret.clear();
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(*make_key(0), ret, nullptr));
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(*make_key(1), ret, nullptr));
+  ASSERT_EQ(static_cast<size_t>(row_nums / status_nums), ret.size());
+  ASSERT_EQ(DB_SUCCESS, index->Destroy());
+}
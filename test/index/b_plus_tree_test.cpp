@@ -1,3 +1,7 @@
+#include <atomic>
+#include <functional>
+#include <thread>
+
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/b_plus_tree.h"
@@ -60,4 +64,194 @@ TEST(BPlusTreeTests, SampleTest) {
     ASSERT_TRUE(tree.GetValue(delete_seq[i], ans));
     ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
   }
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, BulkLoadTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  const int n = 10000;
+  for (double fill_factor : {1.0, 0.7}) {
+    BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 4, 5);
+    int next = 0;
+    ASSERT_TRUE(tree.BulkLoad(n, [&](std::pair<int, int> &item) {
+      item = {2 * next, next};
+      next++;
+      return true;
+    }, fill_factor));
+    ASSERT_TRUE(tree.Check());
+    vector<int> ans;
+    for (int i = 0; i < n; i++) {
+      ASSERT_TRUE(tree.GetValue(2 * i, ans));
+      ASSERT_EQ(i, ans.back());
+      ASSERT_FALSE(tree.GetValue(2 * i + 1, ans));
+    }
+    // the tree keeps working after the bulk load
+    vector<int> delete_seq;
+    for (int i = 0; i < n; i++) {
+      delete_seq.push_back(2 * i);
+    }
+    ShuffleArray(delete_seq);
+    for (int i = 0; i < n / 2; i++) {
+      tree.Remove(delete_seq[i]);
+    }
+    for (int i = 0; i < n; i++) {
+      ASSERT_TRUE(tree.Insert(2 * i + 1, -i));
+    }
+    ASSERT_TRUE(tree.Check());
+    for (int i = 0; i < n; i++) {
+      ASSERT_EQ(i >= n / 2, tree.GetValue(delete_seq[i], ans));
+      ASSERT_TRUE(tree.GetValue(2 * i + 1, ans));
+      ASSERT_EQ(-i, ans.back());
+    }
+    tree.Destroy();
+  }
+  // duplicate keys leave the tree empty
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 4, 5);
+  int next = 0;
+  ASSERT_FALSE(tree.BulkLoad(n, [&](std::pair<int, int> &item) {
+    item = {next == n / 2 ? next - 1 : next, next};
+    next++;
+    return true;
+  }));
+  ASSERT_TRUE(tree.IsEmpty());
+  ASSERT_TRUE(tree.Check());
+}
+
+TEST(BPlusTreeTests, ConcurrentTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  // small pages, so that the threads split and merge pages all the time
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 4, 5);
+  const int num_threads = 8;
+  const int n = 4000;
+  auto run = [num_threads](const std::function<void(int)> &work) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back(work, t);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  };
+  // Scenario: thread t inserts the keys k with k % num_threads == t, in random order
+  run([&](int t) {
+    vector<int> keys;
+    for (int k = t; k < n; k += num_threads) {
+      keys.push_back(k);
+    }
+    ShuffleArray(keys);
+    for (int k : keys) {
+      ASSERT_TRUE(tree.Insert(k, -k));
+    }
+  });
+  ASSERT_TRUE(tree.Check());
+  vector<int> ans;
+  for (int k = 0; k < n; k++) {
+    ASSERT_TRUE(tree.GetValue(k, ans)) << k;
+    ASSERT_EQ(-k, ans.back());
+  }
+  // Scenario: half of the threads remove the odd keys and insert new ones, while the others look up the even keys
+  run([&](int t) {
+    if (t % 2 == 0) {
+      vector<int> found;
+      for (int round = 0; round < 4; round++) {
+        for (int k = 0; k < n; k += 2) {
+          ASSERT_TRUE(tree.GetValue(k, found)) << k;
+          ASSERT_EQ(-k, found.back());
+        }
+      }
+      return;
+    }
+    for (int k = t; k < n; k += num_threads) {
+      tree.Remove(k);
+      ASSERT_TRUE(tree.Insert(n + k, k));
+    }
+  });
+  ASSERT_TRUE(tree.Check());
+  for (int k = 0; k < n; k++) {
+    ASSERT_EQ(k % 2 == 0, tree.GetValue(k, ans)) << k;
+    ASSERT_EQ(k % 2 == 1, tree.GetValue(n + k, ans)) << k;
+  }
+  // Scenario: all threads remove their keys concurrently, until the tree is empty
+  run([&](int t) {
+    for (int k = t; k < 2 * n; k += num_threads) {
+      tree.Remove(k);
+    }
+  });
+  ASSERT_TRUE(tree.IsEmpty());
+  ASSERT_TRUE(tree.Check());
+  ASSERT_TRUE(tree.Insert(1, 1));
+  ASSERT_TRUE(tree.GetValue(1, ans));
+  tree.Destroy();
+}
+
+TEST(BPlusTreeTests, ConcurrentScanTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  // small pages, so that the leaves the iterators are in split and merge all the time
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 4, 5);
+  const int num_writers = 4;
+  const int num_scanners = 4;
+  const int n = 2000;
+  for (int k = 0; k < n; k += 2) {
+    ASSERT_TRUE(tree.Insert(k, -k));
+  }
+  std::atomic<bool> done{false};
+  // the writers insert and remove the odd keys over and over, the even keys stay
+  auto writer = [&](int t) {
+    vector<int> keys;
+    for (int k = 2 * t + 1; k < n; k += 2 * num_writers) {
+      keys.push_back(k);
+    }
+    for (int round = 0; round < 20; round++) {
+      ShuffleArray(keys);
+      for (int k : keys) {
+        ASSERT_TRUE(tree.Insert(k, -k));
+      }
+      ShuffleArray(keys);
+      for (int k : keys) {
+        tree.Remove(k);
+      }
+    }
+  };
+  // every scan finds the keys in order, each even key once, from the first key or from the middle
+  auto scanner = [&](int t) {
+    int scans = 0;
+    while (!done || scans < 2) {
+      int from = scans % 2 == 0 ? 0 : n / 2 + t;
+      auto iter = from == 0 ? tree.Begin() : tree.Begin(from);
+      int last = from - 1;
+      int evens = 0;
+      for (; iter != tree.End(); ++iter) {
+        int key = (*iter).first;
+        ASSERT_LT(last, key);
+        ASSERT_EQ(-key, (*iter).second);
+        evens += key % 2 == 0 ? 1 : 0;
+        last = key;
+      }
+      ASSERT_EQ(n / 2 - (from + 1) / 2, evens) << from;
+      scans++;
+    }
+  };
+  vector<std::thread> threads;
+  for (int t = 0; t < num_scanners; t++) {
+    threads.emplace_back(scanner, t);
+  }
+  vector<std::thread> writers;
+  for (int t = 0; t < num_writers; t++) {
+    writers.emplace_back(writer, t);
+  }
+  for (auto &thread : writers) {
+    thread.join();
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(tree.Check());
+  int expected = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter, expected += 2) {
+    ASSERT_EQ(expected, (*iter).first);
+  }
+  ASSERT_EQ(n, expected);
+  tree.Destroy();
+}
@@ -0,0 +1,152 @@
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/basic_comparator.h"
+#include "index/extendible_hash_index.h"
+#include "index/extendible_hash_table.h"
+#include "index/generic_key.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "hash_table_test.db";
+
+TEST(ExtendibleHashTableTests, SampleTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  ExtendibleHashTable<int, int, BasicComparator<int>> table(0, engine.bpm_, comparator, true);
+  // Insert enough keys to split the buckets many times
+  const int n = 20000;
+  vector<int> keys;
+  for (int i = 0; i < n; i++) {
+    keys.push_back(i);
+  }
+  ShuffleArray(keys);
+  for (int key : keys) {
+    ASSERT_TRUE(table.Insert(key, -key));
+  }
+  ASSERT_TRUE(table.Check());
+  ASSERT_GT(table.GetGlobalDepth(), 4u);
+  // a unique table keeps one value per key
+  ASSERT_FALSE(table.Insert(5, 5));
+  vector<int> ans;
+  for (int i = 0; i < n; i++) {
+    ans.clear();
+    ASSERT_TRUE(table.GetValue(i, ans)) << i;
+    ASSERT_EQ(1u, ans.size());
+    ASSERT_EQ(-i, ans[0]);
+  }
+  ASSERT_FALSE(table.GetValue(n, ans));
+  // Remove half of the keys
+  for (int i = 0; i < n / 2; i++) {
+    ASSERT_TRUE(table.Remove(keys[i], -keys[i]));
+  }
+  ASSERT_FALSE(table.Remove(keys[0], -keys[0]));
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(i >= n / 2, table.GetValue(keys[i], ans)) << keys[i];
+  }
+  ASSERT_TRUE(table.Check());
+  // Remove the rest, the emptied buckets are merged and the table keeps working
+  for (int i = n / 2; i < n; i++) {
+    ASSERT_TRUE(table.Remove(keys[i], -keys[i]));
+  }
+  for (int i = 0; i < n; i++) {
+    ASSERT_FALSE(table.GetValue(i, ans));
+  }
+  for (int i = 0; i < n; i += 3) {
+    ASSERT_TRUE(table.Insert(i, i));
+  }
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(i % 3 == 0, table.GetValue(i, ans));
+  }
+  ASSERT_TRUE(table.Check());
+  table.Destroy();
+  ASSERT_FALSE(table.GetValue(0, ans));
+}
+
+TEST(ExtendibleHashTableTests, DuplicateKeyTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  ExtendibleHashTable<int, int, BasicComparator<int>> table(0, engine.bpm_, comparator);
+  // far more values of one key than fit into a bucket, they go on in overflow pages
+  const int n = 5000;
+  for (int i = 0; i < n; i++) {
+    ASSERT_TRUE(table.Insert(7, i));
+    ASSERT_TRUE(table.Insert(i + 100, i));
+  }
+  ASSERT_FALSE(table.Insert(7, 0));
+  ASSERT_TRUE(table.Check());
+  vector<int> ans;
+  ASSERT_TRUE(table.GetValue(7, ans));
+  ASSERT_EQ(static_cast<size_t>(n), ans.size());
+  for (int i = 0; i < n; i += 2) {
+    ASSERT_TRUE(table.Remove(7, i));
+  }
+  ans.clear();
+  ASSERT_TRUE(table.GetValue(7, ans));
+  ASSERT_EQ(static_cast<size_t>(n / 2), ans.size());
+  for (int value : ans) {
+    ASSERT_EQ(1, value % 2);
+  }
+  for (int i = 0; i < n; i++) {
+    ans.clear();
+    ASSERT_TRUE(table.GetValue(i + 100, ans));
+    ASSERT_EQ(vector<int>{i}, ans);
+  }
+  ASSERT_TRUE(table.Check());
+
+  // the directory is found again through the index roots page
+  ExtendibleHashTable<int, int, BasicComparator<int>> reopened(0, engine.bpm_, comparator);
+  ans.clear();
+  ASSERT_TRUE(reopened.GetValue(7, ans));
+  ASSERT_EQ(static_cast<size_t>(n / 2), ans.size());
+  ASSERT_EQ(table.GetGlobalDepth(), reopened.GetGlobalDepth());
+  table.Destroy();
+}
+
+TEST(ExtendibleHashTableTests, HashIndexTest) {
+  using INDEX_KEY_TYPE = GenericKey<8>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<8>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+  };
+  std::vector<uint32_t> index_key_map{0};
+  const TableSchema table_schema(columns);
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto make_key = [](int32_t id) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+    return Row(fields);
+  };
+  ExtendibleHashIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE> unique_index(0, key_schema, engine.bpm_);
+  ExtendibleHashIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE> index(1, key_schema, engine.bpm_, false);
+  const int n = 3000;
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(DB_SUCCESS, unique_index.InsertEntry(make_key(i), RowId(i, 0), nullptr));
+    ASSERT_EQ(DB_SUCCESS, index.InsertEntry(make_key(i % 100), RowId(i, 0), nullptr));
+  }
+  ASSERT_EQ(DB_FAILED, unique_index.InsertEntry(make_key(10), RowId(0, 1), nullptr));
+  std::vector<RowId> result;
+  for (int i = 0; i < n; i++) {
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, unique_index.ScanKey(make_key(i), result, nullptr));
+    ASSERT_EQ(1u, result.size());
+    ASSERT_EQ(RowId(i, 0), result[0]);
+  }
+  result.clear();
+  ASSERT_EQ(DB_SUCCESS, index.ScanKey(make_key(42), result, nullptr));
+  ASSERT_EQ(static_cast<size_t>(n / 100), result.size());
+  ASSERT_EQ(DB_SUCCESS, index.RemoveEntry(make_key(42), RowId(42, 0), nullptr));
+  result.clear();
+  ASSERT_EQ(DB_SUCCESS, index.ScanKey(make_key(42), result, nullptr));
+  ASSERT_EQ(static_cast<size_t>(n / 100 - 1), result.size());
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index.ScanKey(make_key(n), result, nullptr));
+  // hash indexes do not scan ranges
+  std::unique_ptr<IndexRangeIterator> iterator;
+  Row lo = make_key(0);
+  ASSERT_EQ(DB_FAILED, index.ScanRange(&lo, true, nullptr, false, iterator, nullptr));
+  ASSERT_EQ(DB_SUCCESS, unique_index.Destroy());
+  ASSERT_EQ(DB_SUCCESS, index.Destroy());
+}
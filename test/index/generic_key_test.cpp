@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "index/generic_key.h"
+#include "index/key_search.h"
+#include "record/schema.h"
+
+using KeyType = GenericKey<32>;
+
+static int CompareFields(const Field &lhs, const Field &rhs) {
+  if (lhs.IsNull() || rhs.IsNull()) {
+    return static_cast<int>(!lhs.IsNull()) - static_cast<int>(!rhs.IsNull());
+  }
+  if (lhs.CompareLessThan(rhs) == CmpBool::kTrue) {
+    return -1;
+  }
+  return lhs.CompareGreaterThan(rhs) == CmpBool::kTrue ? 1 : 0;
+}
+
+static int Sign(int val) { return (val > 0) - (val < 0); }
+
+static void CheckOrder(std::vector<Field> &values, Schema *schema) {
+  for (auto &lhs : values) {
+    for (auto &rhs : values) {
+      std::vector<Field> lhs_fields{Field(lhs)};
+      std::vector<Field> rhs_fields{Field(rhs)};
+      Row lhs_row(lhs_fields);
+      Row rhs_row(rhs_fields);
+      KeyType lhs_key, rhs_key;
+      lhs_key.SerializeFromKey(lhs_row, schema);
+      rhs_key.SerializeFromKey(rhs_row, schema);
+      GenericComparator<32> comparator(schema);
+      ASSERT_EQ(CompareFields(lhs, rhs), Sign(comparator(lhs_key, rhs_key)));
+      // round trip
+      Row decoded(INVALID_ROWID);
+      lhs_key.DeserializeToKey(decoded, schema);
+      ASSERT_EQ(1u, decoded.GetFieldCount());
+      ASSERT_EQ(0, CompareFields(lhs, *decoded.GetField(0)));
+    }
+  }
+}
+
+TEST(GenericKeyTest, IntOrderTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false)};
+  Schema schema(columns);
+  std::vector<Field> values;
+  for (int32_t val : {INT32_MIN, INT32_MIN + 1, -256, -1, 0, 1, 255, 256, INT32_MAX}) {
+    values.emplace_back(TypeId::kTypeInt, val);
+  }
+  values.emplace_back(TypeId::kTypeInt);
+  CheckOrder(values, &schema);
+}
+
+TEST(GenericKeyTest, FloatOrderTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 0, true, false)};
+  Schema schema(columns);
+  std::vector<Field> values;
+  for (float val : {-1e30f, -2.5f, -1.0f, -1e-30f, -0.0f, 0.0f, 1e-30f, 1.0f, 2.5f, 1e30f}) {
+    values.emplace_back(TypeId::kTypeFloat, val);
+  }
+  values.emplace_back(TypeId::kTypeFloat);
+  CheckOrder(values, &schema);
+}
+
+TEST(GenericKeyTest, CharOrderTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 0, true, false)};
+  Schema schema(columns);
+  std::vector<std::string> strings = {"", "a", "ab", "b", "minisql", std::string("a\0", 2),
+                                      std::string("a\0b", 3), std::string("\0", 1), "\x7f", "\xff"};
+  std::vector<Field> values;
+  for (auto &str : strings) {
+    values.emplace_back(TypeId::kTypeChar, const_cast<char *>(str.data()), str.size(), true);
+  }
+  values.emplace_back(TypeId::kTypeChar);
+  CheckOrder(values, &schema);
+}
+
+TEST(GenericKeyTest, CompositeOrderTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 8, 0, true, false),
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 1, true, false)
+  };
+  Schema schema(columns);
+  GenericComparator<32> comparator(&schema);
+  auto make_key = [&schema](const char *name, int32_t id) {
+    std::vector<Field> fields{
+            Field(TypeId::kTypeChar, const_cast<char *>(name), strlen(name), true),
+            Field(TypeId::kTypeInt, id)
+    };
+    Row row(fields);
+    KeyType key;
+    key.SerializeFromKey(row, &schema);
+    return key;
+  };
+  // the first field decides, even if it is a prefix of the other one
+  ASSERT_LT(comparator(make_key("a", 100), make_key("ab", -100)), 0);
+  ASSERT_LT(comparator(make_key("ab", -100), make_key("ab", 100)), 0);
+  ASSERT_EQ(0, comparator(make_key("ab", 7), make_key("ab", 7)));
+  ASSERT_LE(GetGenericKeyMaxSize(&schema), 32u);
+}
+
+/**
+ * Compares KeySearch with std::lower_bound on sorted arrays of every size up to a full leaf,
+ * probing every key, the gaps between them and both ends.
+ */
+template<size_t KeySize>
+static void CheckKeySearch(Schema *schema) {
+  using Key = GenericKey<KeySize>;
+  using Pair = std::pair<Key, RowId>;
+  GenericComparator<KeySize> comparator(schema);
+  auto make_key = [schema](int32_t value) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+    Row row(fields);
+    Key key;
+    key.SerializeFromKey(row, schema);
+    return key;
+  };
+  auto less = [&comparator](const Pair &lhs, const Key &rhs) { return comparator(lhs.first, rhs) < 0; };
+  for (int size = 0; size <= 260; size += (size < 40 ? 1 : 31)) {
+    std::vector<Pair> pairs;
+    for (int i = 0; i < size; i++) {
+      pairs.emplace_back(make_key(2 * i - size), RowId(i, 0));
+    }
+    for (int probe = -size - 2; probe <= size + 2; probe++) {
+      Key key = make_key(probe);
+      int expected = static_cast<int>(std::lower_bound(pairs.begin(), pairs.end(), key, less) - pairs.begin());
+      ASSERT_EQ(expected, (KeySearch<Key, GenericComparator<KeySize>>::LowerBound(pairs.data(), size, key,
+                                                                                  comparator)))
+                << "size " << size << " probe " << probe;
+    }
+  }
+}
+
+TEST(GenericKeyTest, KeySearchTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)};
+  Schema schema(columns);
+  CheckKeySearch<8>(&schema);
+  CheckKeySearch<16>(&schema);
+  CheckKeySearch<64>(&schema);
+}
@@ -117,4 +117,143 @@ TEST(TupleTest, RowTest) {
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
-}
\ No newline at end of file
+}
+
+TEST(TupleTest, ArenaMemHeapTest) {
+  ArenaMemHeap arena(64);
+  std::vector<char *> pieces;
+  for (int i = 0; i < 100; i++) {
+    auto *piece = static_cast<char *>(arena.Allocate(i % 7 + 1));
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(piece) % alignof(std::max_align_t));
+    memset(piece, i, i % 7 + 1);
+    pieces.push_back(piece);
+  }
+  // larger than a block
+  auto *large = static_cast<char *>(arena.Allocate(10000));
+  memset(large, 0xff, 10000);
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < i % 7 + 1; j++) {
+      ASSERT_EQ(static_cast<char>(i), pieces[i][j]);
+    }
+  }
+  // the memory of the last block is handed out again
+  arena.Reset();
+  ASSERT_EQ(large, arena.Allocate(16));
+}
+
+TEST(TupleTest, RowReuseTest) {
+  SimpleMemHeap heap;
+  TablePage table_page;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  std::vector<RowId> row_ids;
+  for (int i = 0; i < 10; i++) {
+    std::string name = "name" + std::to_string(i);
+    std::vector<Field> fields = {
+            Field(TypeId::kTypeInt, i),
+            Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), false)
+    };
+    Row row(fields);
+    ASSERT_TRUE(table_page.InsertTuple(row, schema.get(), nullptr, nullptr, nullptr));
+    row_ids.push_back(row.GetRowId());
+  }
+  const char *page_begin = table_page.GetData();
+  const char *page_end = page_begin + PAGE_SIZE;
+  auto in_page = [&](const Field *field) {
+    return field->GetData() >= page_begin && field->GetData() < page_end;
+  };
+  // one row is read again and again
+  Row row(INVALID_ROWID);
+  std::vector<Row> copies;
+  for (int i = 0; i < 10; i++) {
+    row.Clear(row_ids[i]);
+    ASSERT_TRUE(table_page.GetTuple(&row, schema.get(), nullptr, nullptr, i % 2 == 0));
+    ASSERT_EQ(2u, row.GetFieldCount());
+    ASSERT_EQ(row_ids[i], row.GetRowId());
+    std::string name = "name" + std::to_string(i);
+    ASSERT_EQ(name, std::string(row.GetField(1)->GetData(), row.GetField(1)->GetLength()));
+    // char fields copy their data unless they are allowed to point into the page
+    ASSERT_EQ(i % 2 != 0, in_page(row.GetField(1)));
+    copies.emplace_back(row);
+    ASSERT_FALSE(in_page(copies.back().GetField(1)));
+  }
+  // the copies keep their data when the page changes
+  for (auto row_id : row_ids) {
+    ASSERT_TRUE(table_page.MarkDelete(row_id, nullptr, nullptr, nullptr));
+    table_page.ApplyDelete(row_id, nullptr, nullptr);
+  }
+  for (int i = 0; i < 10; i++) {
+    Field id(TypeId::kTypeInt, i);
+    ASSERT_EQ(CmpBool::kTrue, copies[i].GetField(0)->CompareEquals(id));
+    std::string name = "name" + std::to_string(i);
+    ASSERT_EQ(name, std::string(copies[i].GetField(1)->GetData(), copies[i].GetField(1)->GetLength()));
+  }
+}
+
+TEST(TupleTest, NullRowTest) {
+  SimpleMemHeap heap;
+  TablePage table_page;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false),
+          ALLOC_COLUMN(heap)("remark", TypeId::kTypeChar, 64, 3, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  // every combination of null and non-null fields
+  std::vector<std::vector<Field>> rows;
+  std::vector<RowId> row_ids;
+  for (int mask = 0; mask < 16; mask++) {
+    std::vector<Field> fields = {
+            mask & 1 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, mask),
+            mask & 2 ? Field(TypeId::kTypeChar) : Field(TypeId::kTypeChar, chars[1], strlen(chars[1]), false),
+            mask & 4 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, mask * 1.5f),
+            mask & 8 ? Field(TypeId::kTypeChar) : Field(TypeId::kTypeChar, chars[2], strlen(chars[2]), false)
+    };
+    Row row(fields);
+    ASSERT_TRUE(table_page.InsertTuple(row, schema.get(), nullptr, nullptr, nullptr));
+    rows.push_back(fields);
+    row_ids.push_back(row.GetRowId());
+  }
+  for (int mask = 0; mask < 16; mask++) {
+    Row row(row_ids[mask]);
+    ASSERT_TRUE(table_page.GetTuple(&row, schema.get(), nullptr, nullptr));
+    ASSERT_EQ(4u, row.GetFieldCount());
+    for (uint32_t i = 0; i < 4; i++) {
+      ASSERT_EQ(rows[mask][i].IsNull(), row.GetField(i)->IsNull()) << mask << " " << i;
+      if (!rows[mask][i].IsNull()) {
+        ASSERT_EQ(CmpBool::kTrue, row.GetField(i)->CompareEquals(rows[mask][i])) << mask << " " << i;
+      }
+    }
+  }
+  // a single field is read out of the serialized row
+  std::vector<Field> fields = {
+          Field(TypeId::kTypeInt, 7),
+          Field(TypeId::kTypeChar, chars[0], strlen(chars[0]), false),
+          Field(TypeId::kTypeFloat),
+          Field(TypeId::kTypeChar, chars[2], strlen(chars[2]), false)
+  };
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  uint32_t size = row.SerializeTo(buffer, schema.get());
+  ASSERT_EQ(row.GetSerializedSize(schema.get()), size);
+  ASSERT_EQ(size, Row::GetSerializedSize(buffer, schema.get()));
+  ASSERT_TRUE(Row::IsFieldNull(buffer, 2));
+  ASSERT_FALSE(Row::IsFieldNull(buffer, 1));
+  ArenaMemHeap arena;
+  for (uint32_t i = 0; i < 4; i++) {
+    Field *field = Row::DeserializeField(buffer, schema.get(), i, &arena);
+    ASSERT_EQ(fields[i].IsNull(), field->IsNull());
+    if (!fields[i].IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, field->CompareEquals(fields[i]));
+    }
+    field->~Field();
+  }
+  Field *remark = Row::DeserializeField(buffer, schema.get(), 3, &arena, false);
+  ASSERT_EQ(buffer + size - strlen(chars[2]), remark->GetData());
+}
@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk_manager.h"
+
+/**
+ * Runs the same random batches of asynchronous reads and writes and returns everything read back,
+ * followed by every page written, read back in runs.
+ */
+static std::vector<char> RunWorkload(DiskManager *disk_mgr) {
+  // a run of pages across the end of the first extent is split into two writes
+  const std::vector<page_id_t> run_starts = {0, 17, 64, static_cast<page_id_t>(DiskManager::BITMAP_SIZE) - 2};
+  const size_t run_length = 4;
+  std::mt19937 rng(2022);
+  std::vector<char> data(run_starts.size() * run_length * PAGE_SIZE);
+  for (auto &c : data) {
+    c = static_cast<char>(rng());
+  }
+  std::vector<PageIORequest> writes;
+  for (size_t i = 0; i < run_starts.size(); i++) {
+    writes.push_back(PageIORequest{true, run_starts[i], data.data() + i * run_length * PAGE_SIZE, run_length});
+  }
+  for (auto &handle : disk_mgr->SubmitBatch(writes)) {
+    EXPECT_TRUE(handle->Wait());
+  }
+
+  // single page reads of written pages, of a hole and of pages beyond the end of the file
+  std::vector<page_id_t> read_ids = {1, 18, 19, 40, 66, static_cast<page_id_t>(DiskManager::BITMAP_SIZE) + 1,
+                                     static_cast<page_id_t>(DiskManager::BITMAP_SIZE) + 100};
+  std::vector<char> result((read_ids.size() + 1) * PAGE_SIZE, 'x');
+  std::vector<AsyncIOHandlePtr> handles;
+  for (size_t i = 0; i < read_ids.size(); i++) {
+    handles.push_back(disk_mgr->ReadPageAsync(read_ids[i], result.data() + i * PAGE_SIZE));
+  }
+  handles.push_back(disk_mgr->WritePageAsync(10, data.data()));
+  for (auto &handle : handles) {
+    EXPECT_TRUE(handle->Wait());
+    EXPECT_TRUE(handle->IsDone());
+  }
+  // the last slot is filled by a synchronous read of the page written asynchronously
+  disk_mgr->ReadPage(10, result.data() + read_ids.size() * PAGE_SIZE);
+  EXPECT_EQ(0, memcmp(data.data(), result.data() + read_ids.size() * PAGE_SIZE, PAGE_SIZE));
+  EXPECT_EQ(0, memcmp(data.data() + PAGE_SIZE, result.data(), PAGE_SIZE));
+
+  std::vector<char> pages(run_starts.size() * run_length * PAGE_SIZE);
+  std::vector<PageIORequest> reads;
+  for (size_t i = 0; i < run_starts.size(); i++) {
+    reads.push_back(PageIORequest{false, run_starts[i], pages.data() + i * run_length * PAGE_SIZE, run_length});
+  }
+  for (auto &handle : disk_mgr->SubmitBatch(reads)) {
+    EXPECT_TRUE(handle->Wait());
+  }
+  EXPECT_TRUE(data == pages);
+  result.insert(result.end(), pages.begin(), pages.end());
+  return result;
+}
+
+TEST(AsyncIOTest, EngineEquivalenceTest) {
+  const std::string db_name = "async_io_test.db";
+  std::vector<std::vector<char>> results;
+  for (auto backend : {DiskIOBackend::kFstream, DiskIOBackend::kFileDescriptor}) {
+    for (auto type : {AsyncIOEngineType::kThreadPool, AsyncIOEngineType::kIOUring}) {
+      remove(db_name.c_str());
+      DiskManager disk_mgr(db_name, backend, type);
+      if (backend == DiskIOBackend::kFileDescriptor && disk_mgr.GetAsyncIOEngineType() != type) {
+        // io_uring is not supported by this kernel, the thread pool is already covered
+        continue;
+      }
+      results.push_back(RunWorkload(&disk_mgr));
+      disk_mgr.Close();
+    }
+  }
+  remove(db_name.c_str());
+  ASSERT_GE(results.size(), 3);
+  for (size_t i = 1; i < results.size(); i++) {
+    EXPECT_TRUE(results[0] == results[i]) << "engine " << i << " differs";
+  }
+}
+
+TEST(AsyncIOTest, ManyInFlightTest) {
+  const std::string db_name = "async_io_test.db";
+  const int page_nums = 1000;
+  for (auto type : {AsyncIOEngineType::kThreadPool, AsyncIOEngineType::kIOUring}) {
+    remove(db_name.c_str());
+    DiskManager disk_mgr(db_name, DiskIOBackend::kFileDescriptor, type);
+    // more requests than slots in the queue
+    std::vector<char> data(page_nums * PAGE_SIZE);
+    std::vector<PageIORequest> requests;
+    for (int i = 0; i < page_nums; i++) {
+      memset(data.data() + i * PAGE_SIZE, i, PAGE_SIZE);
+      requests.push_back(PageIORequest{true, i, data.data() + i * PAGE_SIZE, 1});
+    }
+    for (auto &handle : disk_mgr.SubmitBatch(requests)) {
+      EXPECT_TRUE(handle->Wait());
+    }
+    std::vector<char> pages(page_nums * PAGE_SIZE);
+    for (int i = 0; i < page_nums; i++) {
+      requests[i] = PageIORequest{false, i, pages.data() + i * PAGE_SIZE, 1};
+    }
+    for (auto &handle : disk_mgr.SubmitBatch(requests)) {
+      EXPECT_TRUE(handle->Wait());
+    }
+    EXPECT_TRUE(data == pages);
+    disk_mgr.Close();
+  }
+  remove(db_name.c_str());
+}
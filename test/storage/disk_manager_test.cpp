@@ -1,4 +1,10 @@
+#include <sys/stat.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "storage/disk_manager.h"
@@ -55,4 +61,129 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
   remove(db_name.c_str());
-}
\ No newline at end of file
+}
+
+TEST(DiskManagerTest, MetaDataPersistenceTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const uint32_t page_nums = DiskManager::BITMAP_SIZE + 100;
+  for (uint32_t i = 0; i < page_nums; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  disk_mgr->DeAllocatePage(7);
+  disk_mgr->DeAllocatePage(DiskManager::BITMAP_SIZE + 3);
+  // Scenario: allocation does not touch the file until the meta data is flushed.
+  struct stat stat_buf;
+  ASSERT_EQ(0, stat(db_name.c_str(), &stat_buf));
+  EXPECT_EQ(0, stat_buf.st_size);
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: bitmaps and meta page are read back after reopening.
+  disk_mgr = new DiskManager(db_name);
+  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(2, meta_page->GetExtentNums());
+  EXPECT_EQ(page_nums - 2, meta_page->GetAllocatedPages());
+  EXPECT_EQ(DiskManager::BITMAP_SIZE - 1, meta_page->GetExtentUsedPage(0));
+  EXPECT_TRUE(disk_mgr->IsPageFree(7));
+  EXPECT_FALSE(disk_mgr->IsPageFree(8));
+  EXPECT_TRUE(disk_mgr->IsPageFree(page_nums));
+  EXPECT_EQ(7, disk_mgr->AllocatePage());
+  EXPECT_EQ(DiskManager::BITMAP_SIZE + 3, disk_mgr->AllocatePage());
+  EXPECT_EQ(page_nums, disk_mgr->AllocatePage());
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, ReservePagesTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  for (page_id_t i = 0; i < 3; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  // Scenario: reserved pages are skipped by AllocatePage.
+  ASSERT_EQ(3, disk_mgr->ReservePages(64));
+  EXPECT_EQ(67, disk_mgr->AllocatePage());
+  EXPECT_TRUE(disk_mgr->AllocateReservedPage(3));
+  EXPECT_TRUE(disk_mgr->AllocateReservedPage(4));
+  EXPECT_FALSE(disk_mgr->AllocateReservedPage(4));
+  EXPECT_FALSE(disk_mgr->AllocateReservedPage(68));
+  // Scenario: a run which does not fit into the rest of an extent is taken from the next one.
+  ASSERT_EQ(static_cast<page_id_t>(DiskManager::BITMAP_SIZE),
+            disk_mgr->ReservePages(DiskManager::BITMAP_SIZE - 64));
+  disk_mgr->ReleasePages(DiskManager::BITMAP_SIZE, DiskManager::BITMAP_SIZE - 64);
+  EXPECT_TRUE(disk_mgr->IsPageFree(DiskManager::BITMAP_SIZE));
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: pages still reserved at close are free after reopening.
+  disk_mgr = new DiskManager(db_name);
+  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(6, meta_page->GetAllocatedPages());
+  EXPECT_FALSE(disk_mgr->IsPageFree(4));
+  EXPECT_TRUE(disk_mgr->IsPageFree(5));
+  EXPECT_FALSE(disk_mgr->IsPageFree(67));
+  EXPECT_EQ(5, disk_mgr->AllocatePage());
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, BackendReadWriteTest) {
+  std::string db_name = "disk_test.db";
+  const int page_nums = 64;
+  for (auto backend : {DiskIOBackend::kFileDescriptor, DiskIOBackend::kFstream}) {
+    remove(db_name.c_str());
+    auto *disk_mgr = new DiskManager(db_name, backend);
+    char data[PAGE_SIZE * 4];
+    // Scenario: a page beyond the end of the file reads as zeros.
+    disk_mgr->ReadPage(page_nums, data);
+    EXPECT_EQ(0, data[0]);
+    EXPECT_EQ(0, data[PAGE_SIZE - 1]);
+    for (int i = 0; i < page_nums; i++) {
+      memset(data, i, PAGE_SIZE);
+      disk_mgr->WritePage(i, data);
+    }
+    for (int i = 0; i < 4; i++) {
+      memset(data + i * PAGE_SIZE, 'a' + i, PAGE_SIZE);
+    }
+    disk_mgr->WritePages(page_nums, data, 4);
+    // Scenario: once synced, the pages are in the file for any other reader.
+    disk_mgr->Sync();
+    {
+      std::ifstream file(db_name, std::ios::binary);
+      std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+      EXPECT_NE(std::string::npos, content.find(std::string(PAGE_SIZE, 'd')));
+    }
+    disk_mgr->Close();
+    delete disk_mgr;
+
+    // Scenario: the pages are read back concurrently by the other backend.
+    disk_mgr = new DiskManager(db_name, backend == DiskIOBackend::kFstream ? DiskIOBackend::kFileDescriptor
+                                                                           : DiskIOBackend::kFstream);
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4, 0);
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back([&, t]() {
+        char page[PAGE_SIZE];
+        for (int i = t; i < page_nums; i += 4) {
+          disk_mgr->ReadPage(i, page);
+          if (page[0] != static_cast<char>(i) || page[PAGE_SIZE - 1] != static_cast<char>(i)) {
+            mismatches[t]++;
+          }
+        }
+        disk_mgr->ReadPage(page_nums + t, page);
+        if (page[0] != 'a' + t || page[PAGE_SIZE - 1] != 'a' + t) {
+          mismatches[t]++;
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(std::vector<int>(4, 0), mismatches);
+    delete disk_mgr;
+  }
+  remove(db_name.c_str());
+}
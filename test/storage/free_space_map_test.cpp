@@ -0,0 +1,91 @@
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "page/free_space_map_page.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+static string db_file_name = "free_space_map_test.db";
+
+TEST(FreeSpaceMapTest, FreeSpaceMapPageTest) {
+  char buf[PAGE_SIZE];
+  memset(buf, 0, sizeof(buf));
+  auto page = reinterpret_cast<FreeSpaceMapPage *>(buf);
+  page->Init(5);
+  ASSERT_EQ(5, page->GetPageId());
+  ASSERT_EQ(INVALID_PAGE_ID, page->GetNextPageId());
+  uint32_t slot;
+  for (uint32_t i = 0; i < FreeSpaceMapPage::MAX_ENTRIES; i++) {
+    ASSERT_TRUE(page->Append(i + 100, i % (FreeSpaceMapPage::MAX_CATEGORY + 1), slot));
+    ASSERT_EQ(i, slot);
+  }
+  ASSERT_TRUE(page->IsFull());
+  ASSERT_FALSE(page->Append(0, 0, slot));
+  page->SetCategory(3, 0);
+  page->SetCategory(4, FreeSpaceMapPage::MAX_CATEGORY);
+  for (uint32_t i = 0; i < FreeSpaceMapPage::MAX_ENTRIES; i++) {
+    uint8_t expected = i % (FreeSpaceMapPage::MAX_CATEGORY + 1);
+    if (i == 3) expected = 0;
+    if (i == 4) expected = FreeSpaceMapPage::MAX_CATEGORY;
+    ASSERT_EQ(i + 100, page->GetTablePageId(i));
+    ASSERT_EQ(expected, page->GetCategory(i));
+  }
+  // categories are conservative in both directions
+  ASSERT_EQ(0, FreeSpaceMapPage::ToCategory(FreeSpaceMapPage::CATEGORY_UNIT - 1));
+  ASSERT_EQ(1, FreeSpaceMapPage::RequiredCategory(1));
+  ASSERT_EQ(1, FreeSpaceMapPage::RequiredCategory(FreeSpaceMapPage::CATEGORY_UNIT));
+  ASSERT_EQ(FreeSpaceMapPage::MAX_CATEGORY, FreeSpaceMapPage::ToCategory(PAGE_SIZE));
+  ASSERT_GT(FreeSpaceMapPage::RequiredCategory(PAGE_SIZE), FreeSpaceMapPage::MAX_CATEGORY);
+}
+
+TEST(FreeSpaceMapTest, ReuseFreedSpaceTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  char characters[64];
+  memset(characters, 'a', sizeof(characters));
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 64, false)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  // free every row of the first page
+  page_id_t first_page_id = table_heap->GetFirstPageId();
+  size_t freed = 0;
+  for (auto &rid : rids) {
+    if (rid.GetPageId() == first_page_id) {
+      ASSERT_TRUE(table_heap->MarkDelete(rid, nullptr));
+      table_heap->ApplyDelete(rid, nullptr);
+      freed++;
+    }
+  }
+  ASSERT_GT(freed, 0u);
+  // reopen the heap, the free space map should be loaded from disk
+  TableHeap *reopened = TableHeap::Create(engine.bpm_, first_page_id, table_heap->GetFreeSpaceMapPageId(),
+                                          schema.get(), nullptr, nullptr, &heap);
+  // rows go to the freed page until its recorded free space drops below one category unit
+  std::vector<Field> sample{Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeChar, characters, 64, false)};
+  uint32_t row_size = Row(sample).GetSerializedSize(schema.get()) + TablePage::SIZE_TUPLE;
+  size_t reused = 0;
+  while (true) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeChar, characters, 64, false)};
+    Row row(fields);
+    ASSERT_TRUE(reopened->InsertTuple(row, nullptr));
+    if (row.GetRowId().GetPageId() != first_page_id) {
+      break;
+    }
+    reused++;
+  }
+  ASSERT_LE(reused, freed);
+  ASSERT_GE(reused, freed - FreeSpaceMapPage::CATEGORY_UNIT / row_size - 1);
+}
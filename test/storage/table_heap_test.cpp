@@ -1,3 +1,4 @@
+#include <thread>
 #include <vector>
 #include <unordered_map>
 
@@ -6,6 +7,7 @@
 #include "record/field.h"
 #include "record/schema.h"
 #include "storage/table_heap.h"
+#include "transaction/lock_manager.h"
 #include "utils/utils.h"
 
 static string db_file_name = "table_heap_test.db";
@@ -54,3 +56,241 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
 }
 
+
+TEST(TableHeapTest, ReadAheadScanTest) {
+  // the heap is larger than the buffer pool, so a scan from the first page starts on a cold cache
+  DBStorageEngine engine(db_file_name, true, 64, 1);
+  SimpleMemHeap heap;
+  const int row_nums = 10000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  char name[64] = "read_ahead";
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+
+  for (size_t window : {static_cast<size_t>(0), static_cast<size_t>(DEFAULT_READ_AHEAD_WINDOW)}) {
+    engine.bpm_->SetReadAheadWindow(window);
+    size_t prefetch_count = engine.bpm_->GetPrefetchCount();
+    std::vector<bool> seen(row_nums, false);
+    int count = 0;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+      int32_t id;
+      iter->GetField(0)->SerializeTo(reinterpret_cast<char *>(&id));
+      ASSERT_FALSE(seen[id]);
+      seen[id] = true;
+      count++;
+    }
+    ASSERT_EQ(row_nums, count);
+    if (window == 0) {
+      ASSERT_EQ(prefetch_count, engine.bpm_->GetPrefetchCount());
+    } else {
+      ASSERT_LT(prefetch_count, engine.bpm_->GetPrefetchCount());
+    }
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(TableHeapTest, PageRunTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  // two tables growing at the same time draw their pages from their own runs
+  TableHeap *table_heaps[2];
+  for (auto &table_heap : table_heaps) {
+    table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  }
+  char name[64] = "page_run";
+  for (int i = 0; i < 20000; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heaps[i % 2]->InsertTuple(row, nullptr));
+  }
+  for (auto table_heap : table_heaps) {
+    PageRunStats stats = table_heap->GetPageRunStats();
+    ASSERT_LT(DEFAULT_PAGE_RUN_SIZE, stats.num_pages);
+    // a run ends where the reserved run ends at the latest
+    ASSERT_LE(stats.num_runs, stats.num_pages / DEFAULT_PAGE_RUN_SIZE + 2);
+  }
+}
+
+TEST(TableHeapTest, ConcurrentInsertTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int thread_nums = 4;
+  const int row_nums = 3000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  // threads filling pages at the same time link new pages to the end of the heap concurrently,
+  // and every other row is deleted again, which changes the free space map from several threads as well
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_nums; t++) {
+    threads.emplace_back([&, t]() {
+      char name[64] = "concurrent";
+      for (int i = t; i < thread_nums * row_nums; i += thread_nums) {
+        Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+        Row row(fields);
+        ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+        if (i % 2 == 1) {
+          ASSERT_TRUE(table_heap->MarkDelete(row.GetRowId(), nullptr));
+          table_heap->ApplyDelete(row.GetRowId(), nullptr);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::vector<int> seen(thread_nums * row_nums, 0);
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    int32_t id;
+    iter->GetField(0)->SerializeTo(reinterpret_cast<char *>(&id));
+    ASSERT_EQ(0, id % 2);
+    seen[id]++;
+  }
+  for (int i = 0; i < thread_nums * row_nums; i += 2) {
+    ASSERT_EQ(1, seen[i]) << i;
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(TableHeapTest, ScanDeletedWhileLockedTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  LockManager lock_manager;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, &lock_manager, &heap);
+  std::vector<RowId> rids;
+  for (int i = 0; i < 3; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  // the scan of the older transaction waits for the lock of the second row, which is deleted meanwhile
+  Transaction reader(0), writer(1);
+  ASSERT_TRUE(lock_manager.LockExclusive(&writer, rids[1]));
+  auto iter = table_heap->Begin(&reader);
+  ASSERT_EQ(rids[0], iter->GetRowId());
+  std::thread scanner([&]() { ++iter; });
+  while (lock_manager.GetWaitCount() == 0) {
+    std::this_thread::yield();
+  }
+  ASSERT_TRUE(table_heap->MarkDelete(rids[1], &writer));
+  table_heap->ApplyDelete(rids[1], &writer);
+  lock_manager.ReleaseAll(&writer);
+  scanner.join();
+  // the row gone is passed over
+  ASSERT_EQ(rids[2], iter->GetRowId());
+  ASSERT_EQ(1u, iter->GetFieldCount());
+  ASSERT_TRUE(++iter == table_heap->End());
+  lock_manager.ReleaseAll(&reader);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(TableHeapTest, ScanRowTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 2000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name" + std::to_string(i);
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()),
+                                                    static_cast<uint32_t>(name.size()), false)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  // the iterator reuses its row, copies of it keep their fields after the iterator moved on
+  std::vector<Row> copies;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    copies.emplace_back(*iter);
+  }
+  ASSERT_EQ(static_cast<size_t>(row_nums), copies.size());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  for (auto &row : copies) {
+    int32_t id;
+    row.GetField(0)->SerializeTo(reinterpret_cast<char *>(&id));
+    std::string name = "name" + std::to_string(id);
+    ASSERT_EQ(name, std::string(row.GetField(1)->GetData(), row.GetField(1)->GetLength()));
+  }
+  // a scan keeps the page of its row pinned, until it is given up
+  {
+    auto iter = table_heap->Begin(nullptr);
+    for (int i = 0; i < row_nums / 2; i++) {
+      ++iter;
+    }
+    ASSERT_FALSE(engine.bpm_->CheckAllUnpinned());
+    auto copy = iter;
+    copy++;
+    ASSERT_EQ(copies[row_nums / 2 + 1].GetRowId(), copy->GetRowId());
+    ASSERT_EQ(copies[row_nums / 2].GetRowId(), iter->GetRowId());
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(TableHeapTest, FilteredScanTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 3000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name" + std::to_string(i);
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), static_cast<uint32_t>(name.size()), false),
+                  Field(TypeId::kTypeFloat, static_cast<float>(i % 10))};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  // the rows whose account is 3 and whose id is odd, of which only the name and the id
+  Schema *table_schema = schema.get();
+  TupleFilter filter = [table_schema](char *tuple) {
+    Field account = Row::ReadField(tuple, table_schema, 2);
+    Field id = Row::ReadField(tuple, table_schema, 0);
+    return account.CompareEquals(Field(TypeId::kTypeFloat, 3.0f)) == CmpBool::kTrue &&
+           id.CompareLessThan(Field(TypeId::kTypeInt, 1000)) == CmpBool::kTrue;
+  };
+  int count = 0;
+  for (auto iter = table_heap->Begin(nullptr, filter, {1, 0}); iter != table_heap->End(); ++iter) {
+    ASSERT_EQ(2u, iter->GetFieldCount());
+    int32_t id;
+    iter->GetField(1)->SerializeTo(reinterpret_cast<char *>(&id));
+    ASSERT_EQ(3, id % 10);
+    ASSERT_LT(id, 1000);
+    std::string name = "name" + std::to_string(id);
+    ASSERT_EQ(name, std::string(iter->GetField(0)->GetData(), iter->GetField(0)->GetLength()));
+    count++;
+  }
+  ASSERT_EQ(100, count);
+  // no row passes
+  auto begin = table_heap->Begin(nullptr, [](char *) { return false; }, {0});
+  ASSERT_TRUE(begin == table_heap->End());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
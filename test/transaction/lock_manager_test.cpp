@@ -0,0 +1,140 @@
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "transaction/lock_manager.h"
+
+TEST(LockManagerTest, CompatibilityTest) {
+  const LockMode is = LockMode::kIntentionShared, ix = LockMode::kIntentionExclusive, s = LockMode::kShared,
+                 six = LockMode::kSharedIntentionExclusive, x = LockMode::kExclusive;
+  const std::vector<LockMode> modes{is, ix, s, six, x};
+  const bool compatible[5][5] = {{true, true, true, true, false},
+                                 {true, true, false, false, false},
+                                 {true, false, true, false, false},
+                                 {true, false, false, false, false},
+                                 {false, false, false, false, false}};
+  for (size_t i = 0; i < modes.size(); i++) {
+    for (size_t j = 0; j < modes.size(); j++) {
+      EXPECT_EQ(compatible[i][j], LockManager::Compatible(modes[i], modes[j])) << i << " " << j;
+    }
+  }
+  EXPECT_EQ(six, LockManager::Supremum(ix, s));
+  EXPECT_EQ(six, LockManager::Supremum(s, ix));
+  EXPECT_EQ(ix, LockManager::Supremum(is, ix));
+  EXPECT_EQ(six, LockManager::Supremum(six, is));
+  EXPECT_EQ(x, LockManager::Supremum(six, x));
+}
+
+TEST(LockManagerTest, WaitDieTest) {
+  LockManager lock_manager;
+  Transaction t0(0), t1(1), t2(2);
+  RowId rid(3, 4);
+  // shared locks go together
+  ASSERT_TRUE(lock_manager.LockShared(&t1, rid));
+  ASSERT_TRUE(lock_manager.LockShared(&t2, rid));
+  // a younger transaction asking for a lock an older one holds dies
+  ASSERT_FALSE(lock_manager.LockExclusive(&t2, rid));
+  EXPECT_EQ(TransactionState::kAborted, t2.GetState());
+  EXPECT_EQ(1u, lock_manager.GetDieCount());
+  lock_manager.ReleaseAll(&t2);
+  // an upgrade without another holder is granted at once, a lock held already is kept
+  ASSERT_TRUE(lock_manager.LockExclusive(&t1, rid));
+  ASSERT_TRUE(lock_manager.LockShared(&t1, rid));
+  EXPECT_EQ(LockMode::kExclusive, t1.GetLocks().begin()->second);
+  // an older transaction waits until the younger one releases the lock
+  std::atomic<bool> granted{false};
+  std::thread waiter([&]() {
+    ASSERT_TRUE(lock_manager.LockShared(&t0, rid));
+    granted = true;
+  });
+  while (lock_manager.GetWaitCount() == 0) {
+    std::this_thread::yield();
+  }
+  EXPECT_FALSE(granted);
+  lock_manager.ReleaseAll(&t1);
+  waiter.join();
+  EXPECT_TRUE(granted);
+  EXPECT_EQ(TransactionState::kActive, t0.GetState());
+  // a lock which can not be granted at once is not waited for if asked so, the transaction stays active
+  Transaction t3(3);
+  ASSERT_FALSE(lock_manager.LockExclusive(&t3, rid, false));
+  EXPECT_EQ(TransactionState::kActive, t3.GetState());
+  lock_manager.ReleaseAll(&t0);
+  ASSERT_TRUE(lock_manager.LockExclusive(&t3, rid, false));
+  lock_manager.ReleaseAll(&t3);
+  EXPECT_TRUE(t3.GetLocks().empty());
+}
+
+TEST(LockManagerTest, TableLockTest) {
+  LockManager lock_manager;
+  Transaction t0(0), t1(1), t2(2);
+  ASSERT_TRUE(lock_manager.LockTable(&t1, 7, LockMode::kIntentionExclusive));
+  ASSERT_TRUE(lock_manager.LockTable(&t2, 7, LockMode::kIntentionShared));
+  // a table is not mixed up with the row whose key would be the same
+  ASSERT_TRUE(lock_manager.LockExclusive(&t2, RowId(0, 7)));
+  // IX and S make SIX, which the IS of another transaction goes with
+  ASSERT_TRUE(lock_manager.LockTable(&t1, 7, LockMode::kShared));
+  EXPECT_EQ(LockMode::kSharedIntentionExclusive, t1.GetLocks().begin()->second);
+  ASSERT_FALSE(lock_manager.LockTable(&t2, 7, LockMode::kIntentionExclusive));
+  lock_manager.ReleaseAll(&t2);
+  lock_manager.ReleaseAll(&t1);
+  ASSERT_TRUE(lock_manager.LockTable(&t0, 7, LockMode::kExclusive));
+  lock_manager.ReleaseAll(&t0);
+}
+
+/**
+ * Transactions lock a few of many rows in random order and are retried under their id when they die,
+ * every one of them ends and no lock is granted to two writers at once
+ */
+TEST(LockManagerTest, ConcurrentTest) {
+  const int thread_count = 8;
+  const int txns_per_thread = 200;
+  const int row_count = 16;
+  LockManager lock_manager(4);
+  std::vector<std::atomic<int>> holders(row_count);
+  std::atomic<int> txn_id{0};
+  std::atomic<bool> exclusive_violated{false};
+  auto worker = [&](int seed) {
+    std::mt19937 random(seed);
+    for (int i = 0; i < txns_per_thread; i++) {
+      Transaction txn(txn_id++);
+      while (true) {
+        std::vector<int> locked;
+        bool aborted = false;
+        for (int j = 0; j < 4 && !aborted; j++) {
+          int row = static_cast<int>(random() % row_count);
+          bool exclusive = random() % 2 == 0;
+          RowId rid(row, 0);
+          auto held = txn.GetLocks().find(static_cast<uint64_t>(rid.Get()));
+          bool had_exclusive = held != txn.GetLocks().end() && held->second == LockMode::kExclusive;
+          aborted = exclusive ? !lock_manager.LockExclusive(&txn, rid) : !lock_manager.LockShared(&txn, rid);
+          if (!aborted && exclusive && !had_exclusive) {
+            if (holders[row]++ != 0) {
+              exclusive_violated = true;
+            }
+            locked.push_back(row);
+          }
+        }
+        for (int row : locked) {
+          holders[row]--;
+        }
+        lock_manager.ReleaseAll(&txn);
+        if (!aborted) {
+          break;
+        }
+        txn.SetState(TransactionState::kActive);
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_count; i++) {
+    threads.emplace_back(worker, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(exclusive_violated);
+  EXPECT_EQ(thread_count * txns_per_thread, txn_id);
+}
@@ -0,0 +1,209 @@
+#include <cstdio>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+#include "transaction/log_manager.h"
+
+static const std::string db_file_name = "log_manager_test.db";
+
+/**
+ * Read every record of the log
+ */
+static std::vector<LogRecord> ReadAllLog(DiskManager *disk_manager, std::vector<char> &log) {
+  log.clear();
+  char buf[PAGE_SIZE];
+  size_t count;
+  while ((count = disk_manager->ReadLog(buf, PAGE_SIZE, log.size())) > 0) {
+    log.insert(log.end(), buf, buf + count);
+  }
+  std::vector<LogRecord> records;
+  size_t offset = 0;
+  LogRecord record;
+  while (uint32_t size = LogRecord::DeserializeFrom(log.data() + offset, log.size() - offset, &record)) {
+    records.push_back(record);
+    offset += size;
+  }
+  EXPECT_EQ(log.size(), offset);
+  return records;
+}
+
+TEST(LogManagerTest, LogRecordTest) {
+  char buf[PAGE_SIZE];
+  const char tuple[] = "old tuple";
+  const char new_tuple[] = "the new tuple";
+  LogRecord update(3, 7, RowId(5, 2), tuple, sizeof(tuple), new_tuple, sizeof(new_tuple));
+  update.SetLSN(8);
+  uint32_t size = update.SerializeTo(buf);
+  ASSERT_EQ(update.GetSize(), size);
+  LogRecord record;
+  ASSERT_EQ(size, LogRecord::DeserializeFrom(buf, size, &record));
+  EXPECT_EQ(LogRecordType::kUpdate, record.GetType());
+  EXPECT_EQ(8, record.GetLSN());
+  EXPECT_EQ(3, record.GetTxnId());
+  EXPECT_EQ(7, record.GetPrevLSN());
+  EXPECT_EQ(RowId(5, 2), record.GetRowId());
+  EXPECT_EQ(std::string(tuple), std::string(record.GetTuple(), record.GetTupleSize() - 1));
+  EXPECT_EQ(std::string(new_tuple), std::string(record.GetNewTuple(), record.GetNewTupleSize() - 1));
+  // a record cut off at the end of the log is not read
+  ASSERT_EQ(0u, LogRecord::DeserializeFrom(buf, size - 1, &record));
+
+  LogRecord new_page(INVALID_TXN_ID, INVALID_LSN, 4, 9);
+  size = new_page.SerializeTo(buf);
+  LogRecord commit(3, 8, LogRecordType::kCommit);
+  size += commit.SerializeTo(buf + size);
+  memset(buf + size, 0, LogRecord::HEADER_SIZE);
+  uint32_t offset = LogRecord::DeserializeFrom(buf, PAGE_SIZE, &record);
+  ASSERT_EQ(new_page.GetSize(), offset);
+  EXPECT_EQ(LogRecordType::kNewPage, record.GetType());
+  EXPECT_EQ(4, record.GetPrevPageId());
+  EXPECT_EQ(9, record.GetPageId());
+  offset += LogRecord::DeserializeFrom(buf + offset, PAGE_SIZE - offset, &record);
+  EXPECT_EQ(LogRecordType::kCommit, record.GetType());
+  EXPECT_EQ(size, offset);
+  // zeroed space after the last record
+  EXPECT_EQ(0u, LogRecord::DeserializeFrom(buf + offset, PAGE_SIZE - offset, &record));
+}
+
+TEST(LogManagerTest, ConcurrentAppendTest) {
+  remove(db_file_name.c_str());
+  DiskManager disk_manager(db_file_name);
+  remove(disk_manager.GetLogFileName().c_str());
+  const int num_threads = 4;
+  const int num_records = 500;
+  {
+    // a small buffer, so that appends wait for the flush thread
+    LogManager log_manager(&disk_manager, 4 * PAGE_SIZE);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&log_manager, t]() {
+        std::string tuple(100 + t * 200, static_cast<char>('a' + t));
+        lsn_t prev_lsn = INVALID_LSN;
+        for (int i = 0; i < num_records; i++) {
+          LogRecord record(t, prev_lsn, LogRecordType::kInsert, RowId(t, i), tuple.data(), tuple.size());
+          prev_lsn = log_manager.AppendLogRecord(&record);
+          if (i % 50 == 49) {
+            // commit
+            log_manager.Flush(prev_lsn);
+            ASSERT_GE(log_manager.GetPersistentLSN(), prev_lsn);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    ASSERT_EQ(num_threads * num_records, log_manager.GetNextLSN());
+    ASSERT_EQ(num_threads * num_records - 1, log_manager.GetPersistentLSN());
+  }
+  std::vector<char> log;
+  auto records = ReadAllLog(&disk_manager, log);
+  ASSERT_EQ(static_cast<size_t>(num_threads * num_records), records.size());
+  std::map<txn_id_t, lsn_t> last_lsn;
+  for (size_t i = 0; i < records.size(); i++) {
+    auto &record = records[i];
+    ASSERT_EQ(static_cast<lsn_t>(i), record.GetLSN());
+    ASSERT_EQ(LogRecordType::kInsert, record.GetType());
+    // the records of every thread are chained
+    auto iter = last_lsn.find(record.GetTxnId());
+    ASSERT_EQ(iter == last_lsn.end() ? INVALID_LSN : iter->second, record.GetPrevLSN());
+    last_lsn[record.GetTxnId()] = record.GetLSN();
+    ASSERT_EQ(static_cast<uint32_t>(100 + record.GetTxnId() * 200), record.GetTupleSize());
+    ASSERT_EQ('a' + record.GetTxnId(), record.GetTuple()[record.GetTupleSize() - 1]);
+  }
+  disk_manager.Close();
+  remove(db_file_name.c_str());
+  remove(disk_manager.GetLogFileName().c_str());
+}
+
+TEST(LogManagerTest, WriteAheadTest) {
+  remove(db_file_name.c_str());
+  auto disk_manager = new DiskManager(db_file_name);
+  remove(disk_manager->GetLogFileName().c_str());
+  auto log_manager = new LogManager(disk_manager);
+  // the table is larger than the buffer pool, so that pages are written while it is changed
+  auto bpm = new BufferPoolManagerInstance(16, disk_manager, ReplacerType::kLRU, log_manager);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  Schema schema(columns);
+  Transaction txn(1);
+  TableHeap *table_heap = TableHeap::Create(bpm, &schema, &txn, log_manager, nullptr, &heap);
+  const int row_nums = 3000;
+  char name[64] = "write ahead";
+  std::vector<RowId> row_ids;
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, false)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, &txn));
+    row_ids.push_back(row.GetRowId());
+  }
+  std::vector<Field> new_fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeChar, name, 10, false)};
+  Row new_row(new_fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(new_row, row_ids[0], &txn));
+  ASSERT_TRUE(table_heap->MarkDelete(row_ids[1], &txn));
+  table_heap->ApplyDelete(row_ids[1], &txn);
+  ASSERT_TRUE(table_heap->MarkDelete(row_ids[2], &txn));
+  table_heap->RollbackDelete(row_ids[2], &txn);
+  // every page on disk has its log records on disk
+  char data[PAGE_SIZE];
+  size_t pages_on_disk = 0;
+  for (page_id_t page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    bpm->UnpinPage(page_id, false);
+    disk_manager->ReadPage(page_id, data);
+    auto page_on_disk = reinterpret_cast<TablePage *>(data);
+    if (page_on_disk->GetTablePageId() == page_id) {
+      pages_on_disk++;
+      ASSERT_LE(page_on_disk->GetLSN(), log_manager->GetPersistentLSN());
+    }
+    page_id = next_page_id;
+  }
+  ASSERT_GT(pages_on_disk, 0u);
+  lsn_t last_lsn = txn.GetPrevLSN();
+  delete bpm;
+  delete log_manager;
+  // the changes are logged in order and chained through the transaction
+  std::vector<char> log;
+  auto records = ReadAllLog(disk_manager, log);
+  ASSERT_LT(static_cast<size_t>(last_lsn), records.size());
+  std::map<LogRecordType, int> counts;
+  lsn_t prev_lsn = INVALID_LSN;
+  std::vector<LogRecord> txn_records;
+  for (size_t i = 0; i < records.size(); i++) {
+    ASSERT_EQ(static_cast<lsn_t>(i), records[i].GetLSN());
+    counts[records[i].GetType()]++;
+    // page allocations and the pages of the free space map are logged outside of the transaction
+    if (records[i].GetTxnId() == INVALID_TXN_ID) {
+      continue;
+    }
+    ASSERT_EQ(1, records[i].GetTxnId());
+    ASSERT_EQ(prev_lsn, records[i].GetPrevLSN());
+    prev_lsn = records[i].GetLSN();
+    txn_records.push_back(records[i]);
+  }
+  ASSERT_EQ(last_lsn, prev_lsn);
+  ASSERT_GT(counts[LogRecordType::kAllocatePage], 1);
+  ASSERT_GT(counts[LogRecordType::kPageWrite], 0);
+  ASSERT_EQ(row_nums, counts[LogRecordType::kInsert]);
+  ASSERT_EQ(1, counts[LogRecordType::kUpdate]);
+  ASSERT_EQ(2, counts[LogRecordType::kMarkDelete]);
+  ASSERT_EQ(1, counts[LogRecordType::kApplyDelete]);
+  ASSERT_EQ(1, counts[LogRecordType::kRollbackDelete]);
+  ASSERT_GT(counts[LogRecordType::kNewPage], 1);
+  auto &update = txn_records[txn_records.size() - 5];
+  ASSERT_EQ(LogRecordType::kUpdate, update.GetType());
+  ASSERT_EQ(row_ids[0], update.GetRowId());
+  ASSERT_EQ(new_row.GetSerializedSize(&schema), update.GetNewTupleSize());
+  delete disk_manager;
+  remove(db_file_name.c_str());
+  remove("log_manager_test.log");
+}
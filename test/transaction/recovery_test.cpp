@@ -0,0 +1,297 @@
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+
+static const std::string db_file_name = "recovery_test.db";
+static const uint32_t buffer_pool_size = 16;
+
+/**
+ * The workload: transaction i inserts the rows 2i and 2i+1, every third one deletes a row inserted three
+ * transactions before, every fourth one updates a row of the transaction before, and every fifth one is aborted.
+ */
+static bool IsAborted(int i) { return i % 5 == 4; }
+
+static std::string RowName(int32_t id) { return "row " + std::to_string(id); }
+
+/**
+ * @return id and name of the rows in the table once the first txns transactions ended
+ */
+static std::map<int32_t, std::string> ExpectedRows(int txns) {
+  std::map<int32_t, std::string> rows;
+  for (int i = 0; i < txns; i++) {
+    if (IsAborted(i)) {
+      continue;
+    }
+    rows[2 * i] = RowName(2 * i);
+    rows[2 * i + 1] = RowName(2 * i + 1);
+    if (i % 3 == 0 && i >= 3) {
+      rows.erase(2 * (i - 3));
+    }
+    auto updated = rows.find(2 * (i - 1) + 1);
+    if (i % 4 == 1 && updated != rows.end()) {
+      updated->second = "updated by " + std::to_string(i);
+    }
+  }
+  return rows;
+}
+
+class Workload {
+public:
+  explicit Workload(DBStorageEngine *engine) : engine_(engine) {
+    engine_->catalog_mgr_->GetTable("t", table_info_);
+    engine_->catalog_mgr_->GetTableIndexes("t", indexes_);
+    engine_->catalog_mgr_->GetIndex("t", "t_id", id_index_);
+  }
+
+  void Run(int i) {
+    Transaction *txn = engine_->txn_mgr_->Begin();
+    Insert(2 * i, RowName(2 * i), txn);
+    Insert(2 * i + 1, RowName(2 * i + 1), txn);
+    RowId rid;
+    if (i % 3 == 0 && i >= 3 && Find(2 * (i - 3), &rid)) {
+      Delete(rid, txn);
+    }
+    if (i % 4 == 1 && Find(2 * (i - 1) + 1, &rid)) {
+      Update(rid, 2 * (i - 1) + 1, "updated by " + std::to_string(i), txn);
+    }
+    if (IsAborted(i)) {
+      engine_->txn_mgr_->Abort(txn);
+    } else {
+      engine_->txn_mgr_->Commit(txn);
+    }
+  }
+
+  bool Find(int32_t id, RowId *rid) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+    Row key(fields);
+    std::vector<RowId> result;
+    if (id_index_->GetIndex()->ScanKey(key, result, nullptr) != DB_SUCCESS || result.empty()) {
+      return false;
+    }
+    *rid = result[0];
+    return true;
+  }
+
+private:
+  static Row MakeRow(int32_t id, const std::string &name) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    return Row(fields);
+  }
+
+  void Insert(int32_t id, const std::string &name, Transaction *txn) {
+    Row row = MakeRow(id, name);
+    ASSERT_TRUE(table_info_->GetTableHeap()->InsertTuple(row, txn));
+    for (auto index_info : indexes_) {
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(index_info->GetIndexKey(row), row.GetRowId(), txn));
+    }
+  }
+
+  void Delete(const RowId &rid, Transaction *txn) {
+    Row row(rid);
+    ASSERT_TRUE(table_info_->GetTableHeap()->GetTuple(&row, txn));
+    for (auto index_info : indexes_) {
+      index_info->GetIndex()->RemoveEntry(index_info->GetIndexKey(row), rid, txn);
+    }
+    ASSERT_TRUE(table_info_->GetTableHeap()->MarkDelete(rid, txn));
+  }
+
+  void Update(const RowId &rid, int32_t id, const std::string &name, Transaction *txn) {
+    Row old_row(rid);
+    ASSERT_TRUE(table_info_->GetTableHeap()->GetTuple(&old_row, txn));
+    Row row = MakeRow(id, name);
+    ASSERT_TRUE(table_info_->GetTableHeap()->UpdateTuple(row, rid, txn));
+    for (auto index_info : indexes_) {
+      index_info->GetIndex()->RemoveEntry(index_info->GetIndexKey(old_row), rid, txn);
+      index_info->GetIndex()->InsertEntry(index_info->GetIndexKey(row), row.GetRowId(), txn);
+    }
+  }
+
+  DBStorageEngine *engine_;
+  TableInfo *table_info_{nullptr};
+  std::vector<IndexInfo *> indexes_;
+  IndexInfo *id_index_{nullptr};
+};
+
+/**
+ * Run transactions from first on with frequent checkpoints until killed, reporting on fd how many ended
+ */
+static void RunChild(int first, int fd) {
+  auto engine = new DBStorageEngine(db_file_name, first == 0, buffer_pool_size);
+  SimpleMemHeap heap;
+  if (first == 0) {
+    std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                     ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false)};
+    TableInfo *table_info = nullptr;
+    IndexInfo *index_info = nullptr;
+    engine->catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info);
+    engine->catalog_mgr_->CreateIndex("t", "t_id", {"id"}, nullptr, index_info);
+    engine->catalog_mgr_->CreateIndex("t", "t_name", {"name"}, nullptr, index_info, false, IndexType::kHash);
+  }
+  engine->checkpoint_mgr_->Stop();
+  engine->checkpoint_mgr_->Start(std::chrono::milliseconds(20));
+  Workload workload(engine);
+  int ended = first;
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(ended)), write(fd, &ended, sizeof(ended)));
+  for (int i = first; i < first + 100000; i++) {
+    workload.Run(i);
+    ended = i + 1;
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(ended)), write(fd, &ended, sizeof(ended)));
+  }
+}
+
+/**
+ * Check that the table and its indexes hold the rows of the first txns transactions
+ * @return false if the table does not hold them
+ */
+static bool CheckRows(DBStorageEngine *engine, int txns) {
+  std::map<int32_t, std::string> expected = ExpectedRows(txns);
+  TableInfo *table_info = nullptr;
+  EXPECT_EQ(DB_SUCCESS, engine->catalog_mgr_->GetTable("t", table_info));
+  std::map<int32_t, std::string> rows;
+  std::map<int32_t, RowId> row_ids;
+  TableHeap *table_heap = table_info->GetTableHeap();
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    char id_data[sizeof(int32_t)];
+    it->GetField(0)->SerializeTo(id_data);
+    int32_t id = MACH_READ_INT32(id_data);
+    rows[id] = std::string(it->GetField(1)->GetData(), it->GetField(1)->GetLength());
+    row_ids[id] = it->GetRowId();
+  }
+  if (rows != expected) {
+    return false;
+  }
+  IndexInfo *id_index = nullptr;
+  IndexInfo *name_index = nullptr;
+  EXPECT_EQ(DB_SUCCESS, engine->catalog_mgr_->GetIndex("t", "t_id", id_index));
+  EXPECT_EQ(DB_SUCCESS, engine->catalog_mgr_->GetIndex("t", "t_name", name_index));
+  for (int32_t id = 0; id < 2 * (txns + 1); id++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+    Row key(fields);
+    std::vector<RowId> result;
+    dberr_t ret = id_index->GetIndex()->ScanKey(key, result, nullptr);
+    auto row = expected.find(id);
+    if (row == expected.end()) {
+      EXPECT_TRUE(ret != DB_SUCCESS || result.empty()) << "row " << id << " left in the index";
+      continue;
+    }
+    EXPECT_EQ(DB_SUCCESS, ret) << "row " << id << " missing in the index";
+    EXPECT_EQ(1u, result.size());
+    if (!result.empty()) {
+      EXPECT_EQ(row_ids[id].Get(), result[0].Get());
+    }
+    std::vector<Field> name_fields{
+            Field(TypeId::kTypeChar, const_cast<char *>(row->second.c_str()), row->second.size(), true)};
+    Row name_key(name_fields);
+    std::vector<RowId> name_result;
+    EXPECT_EQ(DB_SUCCESS, name_index->GetIndex()->ScanKey(name_key, name_result, nullptr));
+    EXPECT_EQ(1u, name_result.size()) << row->second;
+    if (!name_result.empty()) {
+      EXPECT_EQ(row_ids[id].Get(), name_result[0].Get());
+    }
+  }
+  return true;
+}
+
+/**
+ * Run the workload in a child until it is killed after delay_ms
+ * @return number of transactions which ended
+ */
+static int Crash(int first, int delay_ms) {
+  int fds[2];
+  EXPECT_EQ(0, pipe(fds));
+  pid_t pid = fork();
+  EXPECT_GE(pid, 0);
+  if (pid == 0) {
+    close(fds[0]);
+    RunChild(first, fds[1]);
+    _exit(1);
+  }
+  close(fds[1]);
+  // the child is ready once the database is open
+  int ended = first;
+  int reported;
+  EXPECT_EQ(static_cast<ssize_t>(sizeof(reported)), read(fds[0], &reported, sizeof(reported)));
+  usleep(delay_ms * 1000);
+  kill(pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+  while (read(fds[0], &reported, sizeof(reported)) == static_cast<ssize_t>(sizeof(reported))) {
+    ended = reported;
+  }
+  close(fds[0]);
+  return ended;
+}
+
+TEST(RecoveryTest, CrashTest) {
+  std::mt19937 random(20221017);
+  std::uniform_int_distribution<int> delay(50, 400);
+  int ended = 0;
+  for (int round = 0; round < 5; round++) {
+    ended = Crash(ended, delay(random));
+    // the transaction running at the crash may have committed without being reported
+    auto engine = new DBStorageEngine(db_file_name, false, buffer_pool_size);
+    if (!CheckRows(engine, ended)) {
+      ended++;
+      ASSERT_TRUE(CheckRows(engine, ended)) << "round " << round << ", " << ended << " transactions";
+    }
+    delete engine;
+  }
+  ASSERT_GT(ended, 0);
+  // the last database is opened after a clean shutdown
+  auto engine = new DBStorageEngine(db_file_name, false, buffer_pool_size);
+  ASSERT_TRUE(CheckRows(engine, ended));
+  delete engine;
+  remove(db_file_name.c_str());
+  remove("recovery_test.log");
+  remove("recovery_test.dat");
+}
+
+static std::string ReadFile(const std::string &file_name) {
+  std::ifstream in(file_name, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+TEST(RecoveryTest, ParallelRedoTest) {
+  Crash(0, 300);
+  // redo of copies of the crashed database by one and by several workers writes the same pages
+  std::vector<std::string> db_names;
+  for (size_t workers : {1, 2, 5}) {
+    std::string name = "recovery_test_" + std::to_string(workers);
+    std::filesystem::copy_file(db_file_name, name + ".db", std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::copy_file("recovery_test.log", name + ".log", std::filesystem::copy_options::overwrite_existing);
+    auto disk_manager = new DiskManager(name + ".db");
+    auto log_manager = new LogManager(disk_manager);
+    auto bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, ReplacerType::kLRU, log_manager);
+    RecoveryManager recovery_manager(disk_manager, bpm, log_manager, workers);
+    recovery_manager.Redo();
+    ASSERT_EQ(workers, recovery_manager.GetRedoWorkers());
+    ASSERT_GT(recovery_manager.GetRedoneCount(), 0u);
+    bpm->FlushAllPages();
+    delete bpm;
+    delete log_manager;
+    delete disk_manager;
+    db_names.push_back(name);
+  }
+  std::string expected = ReadFile(db_names[0] + ".db");
+  ASSERT_FALSE(expected.empty());
+  for (auto &name : db_names) {
+    ASSERT_TRUE(expected == ReadFile(name + ".db")) << name;
+    remove((name + ".db").c_str());
+    remove((name + ".log").c_str());
+  }
+  remove(db_file_name.c_str());
+  remove("recovery_test.log");
+  remove("recovery_test.dat");
+}
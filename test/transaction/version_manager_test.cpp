@@ -0,0 +1,283 @@
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+
+static const std::string db_file_name = "version_manager_test.db";
+
+class VersionManagerTest : public testing::Test {
+protected:
+  void SetUp() override {
+    engine_ = new DBStorageEngine(db_file_name);
+    // garbage is only collected when a test asks for it
+    engine_->version_mgr_->Stop();
+    std::vector<Column *> columns = {ALLOC_COLUMN(heap_)("id", TypeId::kTypeInt, 0, false, false),
+                                     ALLOC_COLUMN(heap_)("name", TypeId::kTypeChar, 16, 1, true, false)};
+    TableInfo *table_info = nullptr;
+    engine_->catalog_mgr_->CreateTable("t", new Schema(columns), nullptr, table_info);
+    table_heap_ = table_info->GetTableHeap();
+    Transaction *txn = engine_->txn_mgr_->Begin();
+    for (int32_t id = 0; id < 10; id++) {
+      Row row = MakeRow(id, "row " + std::to_string(id));
+      ASSERT_TRUE(table_heap_->InsertTuple(row, txn));
+      rids_.push_back(row.GetRowId());
+    }
+    engine_->txn_mgr_->Commit(txn);
+  }
+
+  void TearDown() override {
+    delete engine_;
+    remove(db_file_name.c_str());
+  }
+
+  static Row MakeRow(int32_t id, const std::string &name) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    return Row(fields);
+  }
+
+  /**
+   * @return the name of the row at rid which txn reads, empty if it reads none
+   */
+  std::string ReadName(const RowId &rid, Transaction *txn) {
+    Row row(rid);
+    if (!table_heap_->GetTuple(&row, txn)) {
+      return "";
+    }
+    const Field *name = row.GetField(1);
+    return std::string(name->GetData(), strnlen(name->GetData(), name->GetLength()));
+  }
+
+  size_t CountRows(Transaction *txn) {
+    size_t count = 0;
+    for (auto it = table_heap_->Begin(txn); it != table_heap_->End(); ++it) {
+      count++;
+    }
+    return count;
+  }
+
+  SimpleMemHeap heap_;
+  DBStorageEngine *engine_{nullptr};
+  TableHeap *table_heap_{nullptr};
+  std::vector<RowId> rids_;
+};
+
+TEST_F(VersionManagerTest, SnapshotTest) {
+  VersionManager *version_manager = engine_->version_mgr_;
+  // the versions before the rows were inserted went at the commit, no snapshot was taken before
+  size_t reclaimed = version_manager->GetReclaimedCount();
+  EXPECT_EQ(rids_.size(), reclaimed);
+  EXPECT_EQ(0u, version_manager->GetVersionCount());
+  Transaction *reader = engine_->txn_mgr_->Begin(IsolationLevel::kSnapshot, true);
+  Transaction *writer = engine_->txn_mgr_->Begin();
+  Row updated = MakeRow(0, "updated");
+  ASSERT_TRUE(table_heap_->UpdateTuple(updated, rids_[0], writer));
+  ASSERT_TRUE(table_heap_->MarkDelete(rids_[1], writer));
+  Row inserted = MakeRow(10, "row 10");
+  ASSERT_TRUE(table_heap_->InsertTuple(inserted, writer));
+  // the writer reads its own changes, the reader the rows as they were, without waiting for the writer's locks
+  EXPECT_EQ("updated", ReadName(rids_[0], writer));
+  EXPECT_EQ("", ReadName(rids_[1], writer));
+  EXPECT_EQ(10u, CountRows(writer));
+  EXPECT_EQ("row 0", ReadName(rids_[0], reader));
+  EXPECT_EQ("row 1", ReadName(rids_[1], reader));
+  EXPECT_EQ("", ReadName(inserted.GetRowId(), reader));
+  EXPECT_EQ(10u, CountRows(reader));
+  engine_->txn_mgr_->Commit(writer);
+
+  // committed after the reader began, the changes stay unseen by it, a new snapshot sees them
+  EXPECT_EQ("row 0", ReadName(rids_[0], reader));
+  EXPECT_EQ("row 1", ReadName(rids_[1], reader));
+  EXPECT_EQ(10u, CountRows(reader));
+  Transaction *later = engine_->txn_mgr_->Begin(IsolationLevel::kSnapshot, true);
+  EXPECT_EQ("updated", ReadName(rids_[0], later));
+  EXPECT_EQ("", ReadName(rids_[1], later));
+  EXPECT_EQ("row 10", ReadName(inserted.GetRowId(), later));
+  EXPECT_EQ(10u, CountRows(later));
+  engine_->txn_mgr_->Commit(later);
+
+  // the versions the reader sees are kept until it ends, the row deleted is removed only then
+  EXPECT_EQ(3u, version_manager->GetVersionCount());
+  version_manager->CollectGarbage();
+  EXPECT_EQ(3u, version_manager->GetVersionCount());
+  engine_->txn_mgr_->Commit(reader);
+  version_manager->CollectGarbage();
+  EXPECT_EQ(0u, version_manager->GetVersionCount());
+  EXPECT_EQ(reclaimed + 3, version_manager->GetReclaimedCount());
+  Transaction *txn = engine_->txn_mgr_->Begin(IsolationLevel::kRepeatableRead);
+  EXPECT_EQ("updated", ReadName(rids_[0], txn));
+  EXPECT_EQ("", ReadName(rids_[1], txn));
+  EXPECT_EQ(10u, CountRows(txn));
+  engine_->txn_mgr_->Commit(txn);
+  // the slot of the row deleted is free again
+  Row reinserted = MakeRow(11, "row 11");
+  ASSERT_TRUE(table_heap_->InsertTuple(reinserted, nullptr));
+  EXPECT_EQ(rids_[1].Get(), reinserted.GetRowId().Get());
+}
+
+TEST_F(VersionManagerTest, WriteConflictTest) {
+  Transaction *first = engine_->txn_mgr_->Begin();
+  Transaction *second = engine_->txn_mgr_->Begin();
+  Transaction *locking = engine_->txn_mgr_->Begin(IsolationLevel::kRepeatableRead);
+  Row first_row = MakeRow(0, "first");
+  ASSERT_TRUE(table_heap_->UpdateTuple(first_row, rids_[0], first));
+  engine_->txn_mgr_->Commit(first);
+  // the row changed since the snapshot of second began, the first writer wins
+  Row second_row = MakeRow(0, "second");
+  EXPECT_FALSE(table_heap_->UpdateTuple(second_row, rids_[0], second));
+  EXPECT_EQ(TransactionState::kAborted, second->GetState());
+  engine_->txn_mgr_->Abort(second);
+  // a transaction which reads the latest rows changes them as they are now
+  EXPECT_EQ("first", ReadName(rids_[0], locking));
+  Row locking_row = MakeRow(0, "locking");
+  EXPECT_TRUE(table_heap_->UpdateTuple(locking_row, rids_[0], locking));
+  engine_->txn_mgr_->Commit(locking);
+
+  // a row deleted since the snapshot can not be deleted again, or updated
+  Transaction *late = engine_->txn_mgr_->Begin();
+  Transaction *deleter = engine_->txn_mgr_->Begin();
+  ASSERT_TRUE(table_heap_->MarkDelete(rids_[1], deleter));
+  engine_->txn_mgr_->Commit(deleter);
+  EXPECT_EQ("row 1", ReadName(rids_[1], late));
+  EXPECT_FALSE(table_heap_->MarkDelete(rids_[1], late));
+  EXPECT_EQ(TransactionState::kAborted, late->GetState());
+  engine_->txn_mgr_->Abort(late);
+  Transaction *txn = engine_->txn_mgr_->Begin();
+  EXPECT_EQ("locking", ReadName(rids_[0], txn));
+  EXPECT_EQ("", ReadName(rids_[1], txn));
+  engine_->txn_mgr_->Commit(txn);
+}
+
+TEST_F(VersionManagerTest, RollbackTest) {
+  VersionManager *version_manager = engine_->version_mgr_;
+  Transaction *reader = engine_->txn_mgr_->Begin(IsolationLevel::kSnapshot, true);
+  Transaction *writer = engine_->txn_mgr_->Begin();
+  Row updated = MakeRow(0, "updated");
+  ASSERT_TRUE(table_heap_->UpdateTuple(updated, rids_[0], writer));
+  Row updated_twice = MakeRow(0, "updated twice");
+  ASSERT_TRUE(table_heap_->UpdateTuple(updated_twice, rids_[0], writer));
+  ASSERT_TRUE(table_heap_->MarkDelete(rids_[1], writer));
+  Row inserted = MakeRow(10, "row 10");
+  ASSERT_TRUE(table_heap_->InsertTuple(inserted, writer));
+  EXPECT_EQ(3u, version_manager->GetVersionCount());
+  engine_->txn_mgr_->Abort(writer);
+  // the versions of a transaction rolled back are dropped with its changes
+  EXPECT_EQ(0u, version_manager->GetVersionCount());
+  EXPECT_EQ("row 0", ReadName(rids_[0], reader));
+  EXPECT_EQ("row 1", ReadName(rids_[1], reader));
+  EXPECT_EQ(10u, CountRows(reader));
+  engine_->txn_mgr_->Commit(reader);
+  Transaction *txn = engine_->txn_mgr_->Begin();
+  EXPECT_EQ("row 0", ReadName(rids_[0], txn));
+  EXPECT_EQ("row 1", ReadName(rids_[1], txn));
+  EXPECT_EQ("", ReadName(inserted.GetRowId(), txn));
+  EXPECT_EQ(10u, CountRows(txn));
+  engine_->txn_mgr_->Commit(txn);
+}
+
+/**
+ * Writers update random rows while snapshots are read, a snapshot always finds the sum it began with
+ */
+TEST_F(VersionManagerTest, ConcurrentTest) {
+  const int writer_count = 4;
+  const int txns_per_writer = 200;
+  std::atomic<bool> done{false};
+  std::atomic<int> wrong_snapshots{0};
+  auto sum = [this](Transaction *txn) {
+    int64_t total = 0;
+    for (auto it = table_heap_->Begin(txn); it != table_heap_->End(); ++it) {
+      const Field *name = it->GetField(1);
+      total += std::stoi(std::string(name->GetData(), strnlen(name->GetData(), name->GetLength())).substr(4));
+    }
+    return total;
+  };
+  // moves one unit from one row to another, so that the sum stays
+  auto writer = [&](int seed) {
+    std::mt19937 random(seed);
+    for (int i = 0; i < txns_per_writer;) {
+      size_t from = random() % rids_.size(), to = random() % rids_.size();
+      if (from == to) {
+        continue;
+      }
+      Transaction *txn = engine_->txn_mgr_->Begin();
+      bool ok = true;
+      for (auto rid_delta : {std::make_pair(from, -1), std::make_pair(to, 1)}) {
+        RowId rid = rids_[rid_delta.first];
+        Row old_row(rid);
+        ok = ok && table_heap_->GetTuple(&old_row, txn);
+        if (ok) {
+          const Field *name = old_row.GetField(1);
+          int value = std::stoi(std::string(name->GetData(), strnlen(name->GetData(), name->GetLength())).substr(4));
+          Row row = MakeRow(static_cast<int32_t>(rid_delta.first), "row " + std::to_string(value + rid_delta.second));
+          ok = table_heap_->UpdateTuple(row, rid, txn);
+        }
+      }
+      if (ok) {
+        engine_->txn_mgr_->Commit(txn);
+        i++;
+      } else {
+        engine_->txn_mgr_->Abort(txn);
+      }
+    }
+  };
+  int64_t expected = sum(nullptr);
+  std::thread reader([&]() {
+    while (!done) {
+      Transaction *txn = engine_->txn_mgr_->Begin(IsolationLevel::kSnapshot, true);
+      if (sum(txn) != expected) {
+        wrong_snapshots++;
+      }
+      engine_->txn_mgr_->Commit(txn);
+      engine_->version_mgr_->CollectGarbage();
+    }
+  });
+  std::vector<std::thread> writers;
+  for (int i = 0; i < writer_count; i++) {
+    writers.emplace_back(writer, i);
+  }
+  for (auto &thread : writers) {
+    thread.join();
+  }
+  done = true;
+  reader.join();
+  EXPECT_EQ(0, wrong_snapshots);
+  EXPECT_EQ(expected, sum(nullptr));
+  engine_->version_mgr_->CollectGarbage();
+  EXPECT_EQ(0u, engine_->version_mgr_->GetVersionCount());
+}
+
+TEST_F(VersionManagerTest, DropWhileCollectingTest) {
+  const int round_count = 20;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap_)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap_)("name", TypeId::kTypeChar, 16, 1, true, false)};
+  for (int round = 0; round < round_count; round++) {
+    std::string table_name = "dropped" + std::to_string(round);
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine_->catalog_mgr_->CreateTable(table_name, new Schema(columns), nullptr, table_info));
+    TableHeap *table_heap = table_info->GetTableHeap();
+    std::vector<RowId> rids;
+    for (int32_t id = 0; id < 200; id++) {
+      Row row = MakeRow(id, "row " + std::to_string(id));
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      rids.push_back(row.GetRowId());
+    }
+    // the rows deleted while a snapshot sees them are left to the garbage collection
+    Transaction *reader = engine_->txn_mgr_->Begin(IsolationLevel::kSnapshot, true);
+    Transaction *writer = engine_->txn_mgr_->Begin();
+    for (auto &rid : rids) {
+      ASSERT_TRUE(table_heap->MarkDelete(rid, writer));
+    }
+    engine_->txn_mgr_->Commit(writer);
+    engine_->txn_mgr_->Commit(reader);
+    // the table is dropped while they are removed, never after
+    std::thread collector([this]() { engine_->version_mgr_->CollectGarbage(); });
+    ASSERT_EQ(DB_SUCCESS, engine_->catalog_mgr_->DropTable(table_name));
+    collector.join();
+    EXPECT_EQ(0u, engine_->version_mgr_->GetVersionCount());
+  }
+}